@@ -22,38 +22,179 @@
  */
 
 #include <float.h>
+#ifdef _WIN32
+#include <malloc.h>
+#endif
 #include <math.h>
 #include <omp.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
 
+/* Vectorized kernels of the Viterbi matrix update (see
+ * update_row_of_states()) are compiled unless LVCSR_NO_SIMD is defined. The
+ * SSE2 kernel is used on all x86 processors which have SSE2. AVX2 and AVX-512
+ * kernels are compiled by GCC-compatible compilers only (without any -march
+ * option), and they are selected at runtime if the processor supports them.
+ */
+#if !defined(LVCSR_NO_SIMD) && (defined(__SSE2__) || defined(_M_X64) \
+    || (defined(_M_IX86_FP) && (_M_IX86_FP >= 2)))
+#define USE_SSE2_KERNEL
+#include <emmintrin.h>
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define USE_AVX_KERNELS
+#include <immintrin.h>
+#endif
+#endif
+
 #include "bond005_lvcsr_lib.h"
 
-#define INTERVAL_10MSECS 100000.0
-#define MAX_REPEATS_OF_PHONEME 2
-#define HISTOGRAM_SIZE 20
+#define MEMORY_ALIGNMENT 64
+
+#define WORD_IS_INACTIVE 0
+#define WORD_IS_ACTIVE 1
+#define WORD_IS_ENTERED 2
+
+#define STREAM_IS_CLOSED 0
+#define STREAM_IS_OPENED 1
+#define STREAM_IS_BROKEN 2
 
-/* Structure for representation of one cell of the matrix which is used in the
- * Viterbi Beam Search algorithm (see X.Huang, Spoken Language Processing,
- * pp.618-620). */
-typedef struct _TViterbiMatrixCell {
-    float cost; // total cost
-    int btp;    // backtrack pointer
-} TViterbiMatrixCell;
+#define MIN_TRACEBACK_CAPACITY 256
+#define MIN_WORD_ENDS_CAPACITY 256
+#define MIN_NBEST_PATHS_CAPACITY 256
+
+#define FIRST_STATES_ROW 0
+#define MIDDLE_STATES_ROW 1
+#define LAST_STATES_ROW 2
+
+#define DENSE_BUCKET_DIVISOR 4
+#define THREAD_PART_ALIGNMENT 16
+
+/* log10(FLT_EPSILON): scores of the compiled language model which aren't
+   greater than this value are scores of probabilities which aren't greater
+   than FLT_EPSILON, and transitions with such scores are possible only from
+   the first entry of the linear words lexicon, like in the original decoder
+   (see calculate_transitions_between_words()) */
+#define MIN_TRANSITION_SCORE ((float)-6.923689900271567)
 
 /* Structure for representation of traceback array. This array is used to
  * record the decision about the best word end hypothesis and its start time
- * for each time frame. */
+ * for each time frame. Also each item keeps bounds of its frame and cost of
+ * the best word end of this frame, so that times and scores of recognized
+ * words can be found (see get_words_sequence_by_traceback()). */
 typedef struct _TTracebackArrayItem {
     int start_time;
     int predecessor_word;
+    double cost;                /* total cost of the best word end of the
+                                   frame (costs of the Viterbi matrix plus
+                                   its cost_offset) */
+    long unsigned frame_start_time; /* bounds of the frame in 100ns units */
+    long unsigned frame_end_time;
 } TTracebackArrayItem;
 typedef TTracebackArrayItem* TTracebackArray;
 
+/* Structure for representation of the traceback array of the recognized
+ * phonemes sequence. Words of items before the first_time are committed (see
+ * commit_stable_words()), so these items are removed, and the item of the time
+ * t is located at the position t-first_time of the items array. Therefore the
+ * length of the traceback array doesn't depend on length of the phonemes
+ * sequence if the best words sequence becomes stable from time to time. */
+typedef struct _TTraceback {
+    TTracebackArray items;
+    int first_time;             /* time of the first item */
+    int capacity;               /* maximal number of items */
+    unsigned char *marks;       /* marks of items at search of the common
+                                   words history (see commit_stable_words()) */
+    double committed_cost;      /* cost of the end of committed words
+                                   sequence, or zero if it is empty */
+} TTraceback;
+
+/* Structure for representation of one word end which is recorded for the word
+ * lattice. */
+typedef struct _TWordEndItem {
+    int word;                   /* index of word in vocabulary */
+    int predecessor_time;       /* last time of the predecessor word, or -1 if
+                                   this word begins the phonemes sequence */
+    float cost;                 /* total cost of the word end */
+} TWordEndItem;
+
+/* Structure for representation of the table of word ends which are recorded
+ * at recognition for creation of the word lattice (see
+ * create_word_lattice_by_workspace()). Word ends of each time point are stored
+ * contiguously, and their number is limited by the lattice_size parameter (see
+ * TDecoderParameters), so memory of this table is proportional to length of
+ * the phonemes sequence. */
+typedef struct _TWordEndsTable {
+    TWordEndItem *items;        /* word ends of all recorded time points */
+    int items_number;
+    int items_capacity;
+    int *times_offsets;         /* positions of the first word ends of time
+                                   points in the items array (word ends of the
+                                   time t are located from times_offsets[t] to
+                                   times_offsets[t+1]-1) */
+    int times_number;           /* number of recorded time points */
+    int times_capacity;
+    double *costs_offsets;      /* offsets of costs of word ends of each time
+                                   point (costs of word ends are kept as in
+                                   the Viterbi matrix of their time, see
+                                   cost_offset of TViterbiMatrix) */
+    float *selected_costs;      /* buffer for costs of word ends at limitation
+                                   of their number */
+    int selected_capacity;
+    unsigned char *required_words;  /* marks of words whose ends are
+                                       predecessors of entered words */
+    int required_capacity;
+} TWordEndsTable;
+
+/* Structure for representation of one partial path of the A* search in the
+ * word lattice (see find_nbest_in_word_lattice()). Each path is stored as
+ * its last node and the reference to the path without this node. */
+typedef struct _TNBestPath {
+    int node;                   /* last node of the path */
+    int previous;               /* index of the path without the last node, or
+                                   -1 for the path of the start node only */
+    int words_number;           /* number of words in the path */
+    unsigned int hash;          /* hash of the words sequence of the path */
+    float score;                /* total score of the path */
+} TNBestPath;
+
+/* Structure for representation of the item of the priority queue of the A*
+ * search (the binary heap with the greatest priority at the top). */
+typedef struct _TNBestQueueItem {
+    float priority;             /* score of the path plus the best score of
+                                   its continuation to the end node */
+    int path;                   /* index of the path */
+} TNBestQueueItem;
+
+/* Structure for representation of the prefix of word at grouping of words by
+ * their prefixes for the fast match (see create_prefixes_of_words()). */
+typedef struct _TWordPrefix {
+    int length;                 /* number of states of the prefix */
+    int is_whole_word;          /* 1 if the prefix is the whole word */
+    int phonemes[MAX_FAST_MATCH_DEPTH + 1]; /* phonemes of states of the
+                                   prefix (-1 after its end) */
+    int word;                   /* lexicon index of the word */
+} TWordPrefix;
+
+/* Type of the function which calculates the row of states of words with equal
+ * length at the current time of the Viterbi matrix (see
+ * update_row_of_states()). */
+typedef void (*TStatesRowKernel)(
+        int row_type, float prev_costs[], int prev_btps[],
+        float prev_state_costs[], int prev_state_btps[], float penalties[],
+        float phoneme_weight, float dead_cost, int n, float cur_costs[],
+        int cur_btps[], float *max_cost, float *min_cost);
+
 /* Structure for representation of whole matrix which is used in the Viterbi
  * Beam Search algorithm (see X.Huang, Spoken Language Processing,
- * pp.618-620). */
+ * pp.618-620). Words are grouped into buckets by their lengths, and states of
+ * each bucket are stored transposed: the state s of the word w corresponds to
+ * the position states_offsets[w]+s*states_strides[w] in each array of costs
+ * and backtrack pointers, where the zero state of each word is its initial
+ * pseudo-state, and the stride is number of words in the bucket. So the same
+ * states of all words of the bucket form one contiguous row, and these words
+ * are calculated together (see update_row_of_states()). Words aren't
+ * renumbered by this layout, i.e. the word w is still the lexicon entry w. */
 typedef struct _TViterbiMatrix {
     int times_number;           /* times number (i.e. length of recognized
                                    phones sequence) */
@@ -65,14 +206,277 @@ typedef struct _TViterbiMatrix {
                                    variants of transcription) */
     int *words_sizes;           /* lengths of words (i.e. numbers of states in
                                    each word) */
-    TViterbiMatrixCell ***cells;/* 3-dimension matrix for the Viterbi Beam
-                                   Search algorithm */
+    int vocabulary_size;        /* number of words in vocabulary (maximal
+                                   index of word in lexicon plus one) */
+    int *entries_offsets;       /* start positions of lexicon entries of each
+                                   vocabulary word in the entries_indexes
+                                   array (its length is vocabulary_size+1) */
+    int *entries_indexes;       /* indexes of lexicon entries grouped by
+                                   vocabulary words */
+    int *word_ends;             /* lexicon indexes of alive word ends at the
+                                   current time (this array is rebuilt at
+                                   each time step) */
+    float *word_ends_max_costs; /* prefix maximums of costs of alive word
+                                   ends at the current time */
+    float *bigram_best_costs;   /* the best costs of transitions into words
+                                   over explicit bigrams which are pushed from
+                                   alive word ends (-FLT_MAX if there are no
+                                   such transitions) */
+    int *bigram_predecessors;   /* the best predecessors of words over
+                                   explicit bigrams (-1 if there are no such
+                                   transitions) */
+    int *reached_words;         /* words into which transitions over explicit
+                                   bigrams were pushed at the current time */
+    int states_number;          /* total number of states of all words
+                                   (including initial pseudo-states) */
+    int *states_offsets;        /* positions of initial pseudo-states of words
+                                   */
+    int *states_strides;        /* distances between successive states of
+                                   words (numbers of words in their buckets) */
+    int *last_states;           /* positions of last states of words */
+    int buckets_number;         /* number of buckets of words with equal
+                                   lengths */
+    int *buckets_lengths;       /* lengths of words of each bucket (buckets
+                                   are sorted by ascending of lengths) */
+    int *buckets_sizes;         /* numbers of words in buckets */
+    int *buckets_offsets;       /* positions of the first initial pseudo-state
+                                   of each bucket */
+    int *words_buckets;         /* buckets of all words */
+    int *buckets_activity;      /* numbers of active words in buckets at the
+                                   current time, or -1 for buckets which are
+                                   calculated densely (i.e. all their words
+                                   are calculated as rows of states) */
+    int *states_phonemes;       /* phonemes indexes of all words states (-1
+                                   for initial pseudo-states) */
+    float *costs[2];            /* total costs of all states in two time
+                                   slots (the slot t%2 is used at the time t,
+                                   and the other slot keeps the previous time
+                                   point) */
+    int *btps[2];               /* backtrack pointers of all states in two time
+                                   slots */
+    void *states_memory;        /* aligned memory block which contains all
+                                   arrays of costs and backtrack pointers */
+    float *penalties;           /* penalties of all states for the current
+                                   input phoneme, which are gathered from the
+                                   confusion penalties matrix if the emission
+                                   table isn't used (this array is placed in
+                                   the states_memory block too) */
+    float *emission_table;      /* table of emission penalties which is shared
+                                   by all workspaces of the decoder (see
+                                   create_emission_table()), or NULL */
+    int emission_row_size;      /* distance between rows of this table */
+    TStatesRowKernel update_row_of_states; /* kernel which is selected for
+                                   the processor at creation of the matrix
+                                   (see select_states_row_kernel()) */
+    int hypotheses_number;      /* total number of real states of all words
+                                   (without initial pseudo-states) */
+    int *active_words;          /* lexicon indexes of active words (i.e. words
+                                   which have at least one unpruned state at
+                                   the current time) in ascending order */
+    unsigned char *words_activity; /* activity flags of all lexicon words
+                                   (WORD_IS_INACTIVE, WORD_IS_ACTIVE or
+                                   WORD_IS_ENTERED) */
+    int active_words_number;    /* number of active words at the last
+                                   calculated time */
+    float dead_cost;            /* hypotheses of the last calculated time with
+                                   costs which aren't greater than this value
+                                   were pruned */
+    double cost_offset;         /* sum of the best costs which were subtracted
+                                   from costs of hypotheses in the fixed-point
+                                   mode (see normalize_viterbi_matrix()), so
+                                   the total cost of each hypothesis is its
+                                   cost plus this offset */
+    int *predecessors;          /* best predecessors of all lexicon words at
+                                   the current time (see
+                                   calculate_transitions_between_words()) */
+    int *histogram;             /* histogram for pruning (its length is the
+                                   histogram_size of TDecoderParameters) */
+    float *selected_costs;      /* buffer for costs of hypotheses at
+                                   limitation of their number (NULL if the
+                                   max_active_hypotheses is zero) */
+    int threads_number;         /* maximal number of threads which calculate
+                                   time points together (each of them owns
+                                   one slot of arrays below) */
+    float *threads_max_costs;   /* ranges of alive costs which are found by
+                                   threads in the state update */
+    float *threads_min_costs;
+    int *threads_histograms;    /* histograms of threads for pruning (rows of
+                                   histogram_size bins) */
+    int *threads_numbers;       /* numbers of items (alive hypotheses or
+                                   active words) which are found by threads */
+    int *threads_parts_sizes;   /* sizes of parts of threads in the buffer
+                                   of selected costs */
+    int *threads_best_words;    /* active words with the best last states
+                                   which are found by threads */
+    int *threads_words;         /* active words which are found by threads,
+                                   each thread writes them from the start of
+                                   its range of words */
+    int *entering_words_offsets;/* start positions of lists of words which
+                                   can be continued by each input phoneme in
+                                   the entering_words array, which are shared
+                                   by all workspaces of the decoder (see
+                                   create_lists_of_entering_words()), or NULL
+                                   */
+    int *entering_words_numbers;/* lengths of these lists (-1 if the list
+                                   isn't created, i.e. all words are used) */
+    int *entering_words;        /* lexicon indexes of words of all lists in
+                                   ascending order within each list */
+    int fast_match_depth;       /* maximal number of next input phonemes which
+                                   are matched with beginnings of words (see
+                                   select_words_by_fast_match()) */
+    int fast_match_size;        /* number of the best words which are entered
+                                   at each time point (0 if the fast match
+                                   isn't used) */
+    int prefixes_number;        /* number of distinct prefixes of words, i.e.
+                                   of their first fast_match_depth+1 states
+                                   at most */
+    int *words_prefixes;        /* prefixes of all lexicon words, which are
+                                   shared by all workspaces of the decoder as
+                                   well as arrays of prefixes (see
+                                   create_prefixes_of_words()) */
+    int *prefixes_lengths;      /* numbers of states of prefixes */
+    unsigned char *prefixes_ends; /* 1 if the prefix is the whole word */
+    int *prefixes_phonemes;     /* phonemes of states of prefixes (rows of
+                                   fast_match_depth+1 items) */
+    float *prefixes_scores;     /* scores of prefixes at the current time */
+    float *fast_match_costs;    /* buffer for scores of words at selection of
+                                   the best ones */
+    int *fast_match_words;      /* lexicon indexes of words which are selected
+                                   by the fast match in ascending order */
 } TViterbiMatrix;
 
-typedef struct _THistogram {
-    int number;
-    float left, right;
-} THistogram;
+/* Structure for representation of the words tree which is compiled for the
+ * Viterbi Beam Search algorithm. Phoneme nodes of the words tree are numbered
+ * in breadth-first order, so nodes which follow the root node have numbers
+ * from 0 to first_nodes_number-1, and all next nodes of any node have
+ * successive numbers. Each word node (i.e. each leaf) of the words tree has
+ * own pause state, which follows the last phoneme node of this word like the
+ * last state of word in the linear words lexicon. Costs and backtrack pointers
+ * of phoneme nodes are stored at positions from 0 to nodes_number-1, and
+ * costs and backtrack pointers of pause states are stored after them. */
+typedef struct _TWordsTreeMatrix {
+    int times_number;           /* times number (i.e. length of recognized
+                                   phones sequence) */
+    int nodes_number;           /* number of phoneme nodes */
+    int first_nodes_number;     /* number of phoneme nodes which follow the
+                                   root node */
+    int *nodes_phonemes;        /* phonemes indexes of phoneme nodes */
+    int *nodes_parents;         /* numbers of parent nodes of phoneme nodes
+                                   (-1 for nodes which follow the root) */
+    int leaves_number;          /* number of word nodes */
+    int *leaves_words;          /* indexes of words in vocabulary */
+    int *leaves_nodes;          /* numbers of last phoneme nodes of words */
+    int states_number;          /* nodes_number + leaves_number */
+    float *costs[2];            /* total costs of all states in two time
+                                   slots (the slot t%2 is used at the time t) */
+    int *btps[2];               /* backtrack pointers of all states in two time
+                                   slots (backtrack pointer is the time of
+                                   predecessor word end, or -1) */
+    void *states_memory;        /* aligned memory block which contains all
+                                   arrays of costs and backtrack pointers */
+    float *penalties;           /* penalties of all states for the current
+                                   input phoneme (see TViterbiMatrix) */
+    float *emission_table;      /* shared table of emission penalties, or
+                                   NULL */
+    int emission_row_size;      /* distance between rows of this table */
+    float *lookahead_scores;    /* shared scores of the language model
+                                   lookahead of all states (see
+                                   create_lookahead_scores()), which are
+                                   added to costs of hypotheses for pruning
+                                   only */
+    float dead_cost;            /* hypotheses of the last calculated time with
+                                   pruning costs (costs plus lookahead scores)
+                                   which aren't greater than this value were
+                                   pruned */
+    double cost_offset;         /* sum of the best costs which were subtracted
+                                   from costs of hypotheses (see
+                                   TViterbiMatrix) */
+    int *histogram;             /* histogram for pruning */
+    float *selected_costs;      /* buffer for costs of hypotheses at
+                                   limitation of their number (NULL if the
+                                   max_active_hypotheses is zero) */
+} TWordsTreeMatrix;
+
+/* Structure for representation of all data which are used for recognition of
+ * one phonemes sequence. Each thread of recognition has own workspace, so
+ * different phonemes sequences can be recognized simultaneously. */
+typedef struct _TRecognitionWorkspace {
+    int use_words_tree;         /* 1 if the words tree is used, 0 if the
+                                   linear words lexicon is used */
+    TViterbiMatrix linear_data; /* Viterbi matrix for the linear words
+                                   lexicon */
+    TWordsTreeMatrix tree_data; /* Viterbi matrix for the words tree */
+    TTraceback traceback;
+    int records_word_ends;      /* 1 if word ends are recorded for the word
+                                   lattice, 0 otherwise */
+    TWordEndsTable word_ends;   /* recorded word ends */
+    int *phonemes_sequence;     /* recognized phonemes sequence */
+    float *phonemes_weights;    /* weights of recognized phonemes */
+    int *phonemes_repeats;      /* numbers of frames of recognized phonemes
+                                   (greater than 1 for segments only) */
+    long unsigned *frames_start_times; /* start times of frames of phonemes
+                                          sequence in 100ns units */
+    long unsigned *frames_end_times;   /* end times of these frames */
+    int capacity;               /* maximal length of phonemes sequence which
+                                   can be recognized without reallocation */
+    TTranscriptionNode *words_sequence; /* words sequence which is found by
+                                           the traceback array (its length is
+                                           capacity of the traceback array) */
+    TTranscriptionNode *committed_words; /* committed beginning of the best
+                                            words sequence */
+    int committed_words_number;
+    int committed_words_capacity;
+} TRecognitionWorkspace;
+
+/* Structure of the decoder (see decoder_create()). The phonemes stream (see
+ * decoder_push()) is recognized by the first workspace. */
+struct _TDecoder {
+    TDecoderModels models;
+    TDecoderParameters parameters;
+    TRecognitionWorkspace *workspaces; /* workspaces of all threads */
+    int workspaces_number;
+    int stream_state;           /* STREAM_IS_CLOSED if the stream isn't being
+                                   recognized, STREAM_IS_OPENED if the first
+                                   workspace recognizes the current utterance,
+                                   or STREAM_IS_BROKEN if recognition of the
+                                   current utterance is failed */
+    float *pauses_weights;      /* weights of time points of pauses which are
+                                   pushed after the last phoneme of the
+                                   current utterance */
+    int *pauses_repeats;        /* numbers of frames of these time points */
+    long unsigned *pauses_start_times; /* start times of time points of
+                                          these pauses in 100ns units */
+    long unsigned *pauses_end_times;   /* end times of these time points */
+    int pauses_number;
+    int pauses_capacity;
+    float *emission_table;      /* table of emission penalties which is shared
+                                   by all workspaces (see
+                                   create_emission_table()), or NULL */
+    float *quantized_penalties; /* rounded copy of the confusion penalties
+                                   matrix in the fixed-point mode (see
+                                   quantize_models_of_decoder()), or NULL */
+    float *quantized_backoff_scores; /* rounded copies of scores of the
+                                        language model in this mode, or
+                                        NULL */
+    float *quantized_bigrams_scores;
+    float *quantized_successors_scores;
+    float *lookahead_scores;    /* scores of the language model lookahead of
+                                   states of the words tree, which are shared
+                                   by all workspaces (see
+                                   create_lookahead_scores()), or NULL */
+    int *entering_words_offsets; /* lists of words which can be continued by
+                                    each input phoneme (see
+                                    create_lists_of_entering_words()), or
+                                    NULL */
+    int *entering_words_numbers;
+    int *entering_words;
+    int *words_prefixes;        /* prefixes of words for the fast match which
+                                   are shared by all workspaces (see
+                                   create_prefixes_of_words()), or NULL */
+    int *prefixes_lengths;
+    unsigned char *prefixes_ends;
+    int *prefixes_phonemes;
+};
 
 void set_new_file_extension(char src[], char extension[])
 {
@@ -106,2768 +510,8214 @@ void set_new_file_extension(char src[], char extension[])
     }
 }
 
-/* This function allocates memory for data used in the Viterbi Beam Search
- * algorithm. The data are represented by three-dimension matrix (see
- * description of TViterbiMatrix structure). First dimension is time, second
- * dimension is words lexicon, and third dimension is words states.
- *
- * The time dimension size is equal to 2 always to use sparingly the allocated
- * memory (only current and previous time points are being saved at each step).
- *
- * The words dimension size is equal to words lexicon size.
- *
- * The states dimension size is different for various words. Each word has as
- * many states as it has phonemes according to the lexicon. Besides, additional
- * state as initial pseudo-state is inserted in front of the real first word
- * state (this pseudo-state is necessary for implementation of inter-word
- * transition rules).
- */
-static void create_viterbi_matrix(
-        TViterbiMatrix* data, int words_number, TLinearWordsLexicon lexicon[])
+/* This function allocates memory block with the given size, and start of this
+ * block is aligned to the cache line boundary (MEMORY_ALIGNMENT bytes). Such
+ * block must be freed by the free_aligned_memory() function. */
+static void *malloc_aligned_memory(size_t size)
 {
-    int t, w, s;
-    if ((data == NULL) || (words_number <= 0) || (lexicon == NULL))
-    {
-        return;
-    }
-    data->times_number = 0;
-    data->words_number = words_number;
-    data->words_sizes = malloc(sizeof(int) * words_number);
-    data->words_indexes = malloc(sizeof(int) * words_number);
-    for (w = 0; w < words_number; w++)
+#ifdef _WIN32
+    return _aligned_malloc(size, MEMORY_ALIGNMENT);
+#else
+    void *ptr = NULL;
+    if (posix_memalign(&ptr, MEMORY_ALIGNMENT, size) != 0)
     {
-        data->words_sizes[w] = lexicon[w].phonemes_number;
-        data->words_indexes[w] = lexicon[w].word_index;
+        return NULL;
     }
-    data->cells = malloc(2 * sizeof(TViterbiMatrixCell**));
-    for (t = 0; t < 2; t++)
+    return ptr;
+#endif
+}
+
+static void free_aligned_memory(void *ptr)
+{
+#ifdef _WIN32
+    _aligned_free(ptr);
+#else
+    free(ptr);
+#endif
+}
+
+/* This function calculates the row of states of words with equal length at
+ * the current time of the Viterbi matrix, i.e. the same state (the first one,
+ * one of middle ones or the last one according to the row_type) of n words.
+ * The prev_costs and prev_btps are the same states at the previous time. For
+ * middle states the prev_state_costs and prev_state_btps are previous states
+ * of these words at the previous time, and for last states they are previous
+ * states at the current time (they are calculated already). Penalties of
+ * states for the input phoneme are given in the penalties array (see
+ * select_penalties_of_viterbi_matrix()), and hypotheses of the previous time
+ * with costs which aren't greater than the dead_cost are impossible. Range of
+ * alive costs (from the min_cost to the max_cost) is corrected by calculated
+ * states. This is the scalar kernel, and vectorized kernels give identical
+ * results, because they calculate the same sums in the same order.
+ */
+static void update_row_of_states(
+        int row_type, float prev_costs[], int prev_btps[],
+        float prev_state_costs[], int prev_state_btps[], float penalties[],
+        float phoneme_weight, float dead_cost, int n, float cur_costs[],
+        int cur_btps[], float *max_cost, float *min_cost)
+{
+    int j;
+    float tmp_val1, tmp_val2, tmp_d;
+
+    for (j = 0; j < n; j++)
     {
-        data->cells[t] = malloc(words_number * sizeof(TViterbiMatrixCell*));
-        for (w = 0; w < words_number; w++)
+        tmp_d = phoneme_weight;
+        tmp_val1 = -FLT_MAX;
+        tmp_val2 = -FLT_MAX;
+        if (penalties[j] > (-FLT_MAX + FLT_EPSILON))
+        {
+            tmp_d += penalties[j];
+            if ((row_type == MIDDLE_STATES_ROW)
+                    && (prev_state_costs[j] > dead_cost))
+            {
+                tmp_val1 = prev_state_costs[j] + tmp_d;
+            }
+            if (prev_costs[j] > dead_cost)
+            {
+                tmp_val2 = prev_costs[j] + tmp_d;
+            }
+        }
+        if (row_type == LAST_STATES_ROW)
+        {
+            tmp_val1 = prev_state_costs[j];
+        }
+        if ((row_type != FIRST_STATES_ROW) && (tmp_val1 >= tmp_val2))
+        {
+            cur_costs[j] = tmp_val1;
+            cur_btps[j] = prev_state_btps[j];
+        }
+        else
         {
-            data->cells[t][w] = malloc((data->words_sizes[w]+1)
-                                       * sizeof(TViterbiMatrixCell));
-            for (s = 0; s <= data->words_sizes[w]; s++)
+            cur_costs[j] = tmp_val2;
+            cur_btps[j] = prev_btps[j];
+        }
+        if (cur_costs[j] > (-FLT_MAX + FLT_EPSILON))
+        {
+            if (cur_costs[j] > *max_cost)
+            {
+                *max_cost = cur_costs[j];
+            }
+            if (cur_costs[j] < *min_cost)
             {
-                data->cells[t][w][s].btp = -1;
-                data->cells[t][w][s].cost = -FLT_MAX;
+                *min_cost = cur_costs[j];
             }
         }
     }
 }
 
-/* This function shifts the Viterbi matrix data from right to left along time
- * axis.
- */
-static void shift_viterbi_matrix(TViterbiMatrix data)
+#ifdef USE_SSE2_KERNEL
+/* This function selects items of a where the mask is set, and items of b
+ * otherwise. */
+static __m128 select_ps_sse2(__m128 mask, __m128 a, __m128 b)
 {
-    int w, s;
-    for (w = 0; w < data.words_number; w++)
-    {
-        for (s = 0; s <= data.words_sizes[w]; s++)
-        {
-            data.cells[0][w][s].btp = data.cells[1][w][s].btp;
-            data.cells[0][w][s].cost = data.cells[1][w][s].cost;
-
-            data.cells[1][w][s].btp = -1;
-            data.cells[1][w][s].cost = -FLT_MAX;
-        }
-    }
+    return _mm_or_ps(_mm_and_ps(mask, a), _mm_andnot_ps(mask, b));
 }
 
-/* This function initializes all cells of the given Viterbi matrix as follows:
- * -FLT_MAX values will be assigned to all costs, and NULL values will be
- * assigned to all backtrack pointers (herewith memory allocated for these
- * backtrack pointers will be freed). */
-static void initialize_values_of_viterbi_matrix(TViterbiMatrix data)
+/* This function is the SSE2 kernel of update_row_of_states(), which
+ * calculates four states at once. Comparisons are replaced by masks: the
+ * impossible hypothesis gets the -FLT_MAX cost by selection instead of
+ * branching, and the backtrack pointer is selected by the same mask as the
+ * cost. Remaining states are calculated by the scalar kernel. */
+static void update_row_of_states_sse2(
+        int row_type, float prev_costs[], int prev_btps[],
+        float prev_state_costs[], int prev_state_btps[], float penalties[],
+        float phoneme_weight, float dead_cost, int n, float cur_costs[],
+        int cur_btps[], float *max_cost, float *min_cost)
 {
-    int t, w, s;
-    for (t = 0; t < 2; t++)
+    __m128 weight = _mm_set1_ps(phoneme_weight);
+    __m128 dead = _mm_set1_ps(dead_cost);
+    __m128 impossible = _mm_set1_ps(-FLT_MAX);
+    __m128 alive_bound = _mm_set1_ps(-FLT_MAX + FLT_EPSILON);
+    __m128 greatest = _mm_set1_ps(FLT_MAX);
+    __m128 max_costs = _mm_set1_ps(*max_cost);
+    __m128 min_costs = _mm_set1_ps(*min_cost);
+    __m128 d, possible, cost1, cost2, mask, cost, btp1, btp2, alive;
+    float range[4];
+    int j, i;
+
+    if (n < 4)
+    {
+        update_row_of_states(row_type, prev_costs, prev_btps,
+                             prev_state_costs, prev_state_btps, penalties,
+                             phoneme_weight, dead_cost, n, cur_costs,
+                             cur_btps, max_cost, min_cost);
+        return;
+    }
+    for (j = 0; (j + 4) <= n; j += 4)
     {
-        for (w = 0; w < data.words_number; w++)
+        d = _mm_loadu_ps(penalties + j);
+        possible = _mm_cmpgt_ps(d, alive_bound);
+        d = _mm_add_ps(weight, d);
+        cost2 = _mm_loadu_ps(prev_costs + j);
+        mask = _mm_and_ps(possible, _mm_cmpgt_ps(cost2, dead));
+        cost2 = select_ps_sse2(mask, _mm_add_ps(cost2, d), impossible);
+        btp2 = _mm_castsi128_ps(_mm_loadu_si128((__m128i*)(prev_btps + j)));
+        if (row_type == FIRST_STATES_ROW)
+        {
+            cost = cost2;
+            btp1 = btp2;
+        }
+        else
         {
-            for (s = 0; s <= data.words_sizes[w]; s++)
+            cost1 = _mm_loadu_ps(prev_state_costs + j);
+            if (row_type == MIDDLE_STATES_ROW)
             {
-                data.cells[t][w][s].btp = -1;
-                data.cells[t][w][s].cost = -FLT_MAX;
+                mask = _mm_and_ps(possible, _mm_cmpgt_ps(cost1, dead));
+                cost1 = select_ps_sse2(mask, _mm_add_ps(cost1, d),
+                                       impossible);
             }
+            mask = _mm_cmpge_ps(cost1, cost2);
+            cost = select_ps_sse2(mask, cost1, cost2);
+            btp1 = _mm_castsi128_ps(_mm_loadu_si128(
+                                        (__m128i*)(prev_state_btps + j)));
+            btp1 = select_ps_sse2(mask, btp1, btp2);
+        }
+        _mm_storeu_ps(cur_costs + j, cost);
+        _mm_storeu_si128((__m128i*)(cur_btps + j), _mm_castps_si128(btp1));
+        alive = _mm_cmpgt_ps(cost, alive_bound);
+        max_costs = _mm_max_ps(max_costs,
+                               select_ps_sse2(alive, cost, impossible));
+        min_costs = _mm_min_ps(min_costs,
+                               select_ps_sse2(alive, cost, greatest));
+    }
+    _mm_storeu_ps(range, max_costs);
+    for (i = 0; i < 4; i++)
+    {
+        if (range[i] > *max_cost)
+        {
+            *max_cost = range[i];
+        }
+    }
+    _mm_storeu_ps(range, min_costs);
+    for (i = 0; i < 4; i++)
+    {
+        if (range[i] < *min_cost)
+        {
+            *min_cost = range[i];
         }
     }
+    update_row_of_states(row_type, prev_costs + j, prev_btps + j,
+                         prev_state_costs + j, prev_state_btps + j,
+                         penalties + j, phoneme_weight, dead_cost, n - j,
+                         cur_costs + j, cur_btps + j, max_cost, min_cost);
 }
-
-/* This function frees all memory which was allocated for the Viterbi matrix.
- */
-static void delete_viterbi_matrix(TViterbiMatrix* data)
+#endif
+
+#ifdef USE_AVX_KERNELS
+/* This function is the AVX2 kernel of update_row_of_states(), which
+ * calculates eight states at once like the SSE2 kernel does it. Remaining
+ * states are calculated by the SSE2 kernel, and upper halves of AVX registers
+ * are cleared before it, because mixing of dirty AVX registers with SSE2
+ * instructions is very slow. */
+__attribute__((target("avx2")))
+static void update_row_of_states_avx2(
+        int row_type, float prev_costs[], int prev_btps[],
+        float prev_state_costs[], int prev_state_btps[], float penalties[],
+        float phoneme_weight, float dead_cost, int n, float cur_costs[],
+        int cur_btps[], float *max_cost, float *min_cost)
 {
-    int t, w;
-    if (data == NULL)
-    {
+    __m256 weight = _mm256_set1_ps(phoneme_weight);
+    __m256 dead = _mm256_set1_ps(dead_cost);
+    __m256 impossible = _mm256_set1_ps(-FLT_MAX);
+    __m256 alive_bound = _mm256_set1_ps(-FLT_MAX + FLT_EPSILON);
+    __m256 greatest = _mm256_set1_ps(FLT_MAX);
+    __m256 max_costs = _mm256_set1_ps(*max_cost);
+    __m256 min_costs = _mm256_set1_ps(*min_cost);
+    __m256 d, possible, cost1, cost2, mask, cost, btp1, btp2, alive;
+    float range[8];
+    int j, i;
+
+    if (n < 8)
+    {
+        _mm256_zeroupper();
+        update_row_of_states_sse2(row_type, prev_costs, prev_btps,
+                                  prev_state_costs, prev_state_btps,
+                                  penalties, phoneme_weight, dead_cost, n,
+                                  cur_costs, cur_btps, max_cost, min_cost);
         return;
     }
-    if ((data->words_number <= 0) || (data->times_number <= 0)
-            || (data->words_sizes == NULL) || (data->words_indexes == NULL)
-            || (data->cells == NULL))
+    for (j = 0; (j + 8) <= n; j += 8)
+    {
+        d = _mm256_loadu_ps(penalties + j);
+        possible = _mm256_cmp_ps(d, alive_bound, _CMP_GT_OQ);
+        d = _mm256_add_ps(weight, d);
+        cost2 = _mm256_loadu_ps(prev_costs + j);
+        mask = _mm256_and_ps(possible,
+                             _mm256_cmp_ps(cost2, dead, _CMP_GT_OQ));
+        cost2 = _mm256_blendv_ps(impossible, _mm256_add_ps(cost2, d), mask);
+        btp2 = _mm256_castsi256_ps(_mm256_loadu_si256(
+                                       (__m256i*)(prev_btps + j)));
+        if (row_type == FIRST_STATES_ROW)
+        {
+            cost = cost2;
+            btp1 = btp2;
+        }
+        else
+        {
+            cost1 = _mm256_loadu_ps(prev_state_costs + j);
+            if (row_type == MIDDLE_STATES_ROW)
+            {
+                mask = _mm256_and_ps(possible, _mm256_cmp_ps(cost1, dead,
+                                                             _CMP_GT_OQ));
+                cost1 = _mm256_blendv_ps(impossible,
+                                         _mm256_add_ps(cost1, d), mask);
+            }
+            mask = _mm256_cmp_ps(cost1, cost2, _CMP_GE_OQ);
+            cost = _mm256_blendv_ps(cost2, cost1, mask);
+            btp1 = _mm256_castsi256_ps(_mm256_loadu_si256(
+                                           (__m256i*)(prev_state_btps + j)));
+            btp1 = _mm256_blendv_ps(btp2, btp1, mask);
+        }
+        _mm256_storeu_ps(cur_costs + j, cost);
+        _mm256_storeu_si256((__m256i*)(cur_btps + j),
+                            _mm256_castps_si256(btp1));
+        alive = _mm256_cmp_ps(cost, alive_bound, _CMP_GT_OQ);
+        max_costs = _mm256_max_ps(max_costs,
+                                  _mm256_blendv_ps(impossible, cost, alive));
+        min_costs = _mm256_min_ps(min_costs,
+                                  _mm256_blendv_ps(greatest, cost, alive));
+    }
+    _mm256_storeu_ps(range, max_costs);
+    for (i = 0; i < 8; i++)
+    {
+        if (range[i] > *max_cost)
+        {
+            *max_cost = range[i];
+        }
+    }
+    _mm256_storeu_ps(range, min_costs);
+    for (i = 0; i < 8; i++)
     {
-        return;
+        if (range[i] < *min_cost)
+        {
+            *min_cost = range[i];
+        }
     }
+    _mm256_zeroupper();
+    update_row_of_states_sse2(row_type, prev_costs + j, prev_btps + j,
+                              prev_state_costs + j, prev_state_btps + j,
+                              penalties + j, phoneme_weight, dead_cost,
+                              n - j, cur_costs + j, cur_btps + j, max_cost,
+                              min_cost);
+}
 
-    for (t = 0; t < 2; t++)
+/* This function is the AVX-512 kernel of update_row_of_states(), which
+ * calculates sixteen states at once by means of mask registers. Remaining
+ * states are calculated by the AVX2 kernel (each processor with AVX-512
+ * supports AVX2 too). */
+__attribute__((target("avx512f")))
+static void update_row_of_states_avx512(
+        int row_type, float prev_costs[], int prev_btps[],
+        float prev_state_costs[], int prev_state_btps[], float penalties[],
+        float phoneme_weight, float dead_cost, int n, float cur_costs[],
+        int cur_btps[], float *max_cost, float *min_cost)
+{
+    __m512 weight = _mm512_set1_ps(phoneme_weight);
+    __m512 dead = _mm512_set1_ps(dead_cost);
+    __m512 impossible = _mm512_set1_ps(-FLT_MAX);
+    __m512 alive_bound = _mm512_set1_ps(-FLT_MAX + FLT_EPSILON);
+    __m512 max_costs = _mm512_set1_ps(*max_cost);
+    __m512 min_costs = _mm512_set1_ps(*min_cost);
+    __m512 d, cost1, cost2, cost;
+    __m512i btp1, btp2;
+    __mmask16 possible, mask, alive;
+    float range[16];
+    int j, i;
+
+    if (n < 16)
+    {
+        update_row_of_states_avx2(row_type, prev_costs, prev_btps,
+                                  prev_state_costs, prev_state_btps,
+                                  penalties, phoneme_weight, dead_cost, n,
+                                  cur_costs, cur_btps, max_cost, min_cost);
+        return;
+    }
+    for (j = 0; (j + 16) <= n; j += 16)
     {
-        if (data->cells[t] == NULL)
+        d = _mm512_loadu_ps(penalties + j);
+        possible = _mm512_cmp_ps_mask(d, alive_bound, _CMP_GT_OQ);
+        d = _mm512_add_ps(weight, d);
+        cost2 = _mm512_loadu_ps(prev_costs + j);
+        mask = possible & _mm512_cmp_ps_mask(cost2, dead, _CMP_GT_OQ);
+        cost2 = _mm512_mask_add_ps(impossible, mask, cost2, d);
+        btp2 = _mm512_loadu_si512(prev_btps + j);
+        if (row_type == FIRST_STATES_ROW)
         {
-            continue;
+            cost = cost2;
+            btp1 = btp2;
         }
-        for (w = 0; w < data->words_number; w++)
+        else
         {
-            if (data->cells[t][w] == NULL)
+            cost1 = _mm512_loadu_ps(prev_state_costs + j);
+            if (row_type == MIDDLE_STATES_ROW)
             {
-                continue;
+                mask = possible & _mm512_cmp_ps_mask(cost1, dead,
+                                                     _CMP_GT_OQ);
+                cost1 = _mm512_mask_add_ps(impossible, mask, cost1, d);
             }
-            free(data->cells[t][w]);
-            data->cells[t][w] = NULL;
+            mask = _mm512_cmp_ps_mask(cost1, cost2, _CMP_GE_OQ);
+            cost = _mm512_mask_blend_ps(mask, cost2, cost1);
+            btp1 = _mm512_mask_blend_epi32(
+                        mask, btp2, _mm512_loadu_si512(prev_state_btps + j));
         }
-        free(data->cells[t]);
-        data->cells[t] = NULL;
+        _mm512_storeu_ps(cur_costs + j, cost);
+        _mm512_storeu_si512(cur_btps + j, btp1);
+        alive = _mm512_cmp_ps_mask(cost, alive_bound, _CMP_GT_OQ);
+        max_costs = _mm512_mask_max_ps(max_costs, alive, max_costs, cost);
+        min_costs = _mm512_mask_min_ps(min_costs, alive, min_costs, cost);
     }
-
-    free(data->words_sizes);
-    data->words_sizes = NULL;
-    free(data->words_indexes);
-    data->words_indexes = NULL;
-    free(data->cells);
-    data->cells = NULL;
-    data->words_number = 0;
-    data->times_number = 0;
-}
-
-/* This function finds the bigram like "start_word_i->end_word_i" in the
- * language model. Starting position of search is specified by the
- * cur_bigram_i argument. As result this function returns probability of the
- * found bigram or 0 if the bigram isn't found. Also, specified starting
- * position of bigram search is being shifted from left to right in process of
- * this search, and such changing of starting position is saved. */
-static float find_bigram(TLanguageModel language_model, float lambda,
-                         int start_word_i, int end_word_i, int *cur_bigram_i)
-{
-    int i = *cur_bigram_i;
-    float bigram_probability = 0.0;
-
-    while (i < language_model.bigrams[end_word_i].begins_number)
+    _mm512_storeu_ps(range, max_costs);
+    for (i = 0; i < 16; i++)
     {
-        if (language_model.bigrams[end_word_i].begins[i].word_i>=start_word_i)
+        if (range[i] > *max_cost)
         {
-            break;
+            *max_cost = range[i];
         }
-        i++;
     }
-    *cur_bigram_i = i;
-    if (i < language_model.bigrams[end_word_i].begins_number)
+    _mm512_storeu_ps(range, min_costs);
+    for (i = 0; i < 16; i++)
     {
-        if (language_model.bigrams[end_word_i].begins[i].word_i==start_word_i)
+        if (range[i] < *min_cost)
         {
-            bigram_probability
-                    = language_model.bigrams[end_word_i].begins[i].probability;
+            *min_cost = range[i];
         }
     }
-
-    bigram_probability = lambda * bigram_probability + (1.0 - lambda)
-            * language_model.unigrams_probabilities[end_word_i];
-
-    return bigram_probability;
+    update_row_of_states_avx2(row_type, prev_costs + j, prev_btps + j,
+                              prev_state_costs + j, prev_state_btps + j,
+                              penalties + j, phoneme_weight, dead_cost,
+                              n - j, cur_costs + j, cur_btps + j, max_cost,
+                              min_cost);
 }
+#endif
 
-static void prune_hypotheses(TViterbiMatrix data, int t, float pruning_coeff,
-                             THistogram histogram[])
+/* This function selects the fastest kernel of update_row_of_states() which is
+ * supported by the processor. Instruction sets are checked at runtime, so the
+ * same binary can be used on different processors. */
+static TStatesRowKernel select_states_row_kernel()
 {
-    int w, s, i;
-    float max_cost, min_cost, dcost, cost_threshold;
-    int number_of_all_hypotheses = 0, number_of_unpruned_hypotheses = 0;
-    int max_number_of_unpruned_hypotheses;
+#ifdef USE_AVX_KERNELS
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx512f"))
+    {
+        return update_row_of_states_avx512;
+    }
+    if (__builtin_cpu_supports("avx2"))
+    {
+        return update_row_of_states_avx2;
+    }
+#endif
+#ifdef USE_SSE2_KERNEL
+    return update_row_of_states_sse2;
+#else
+    return update_row_of_states;
+#endif
+}
 
-    if (pruning_coeff <= 0)
+/* This function allocates memory for data used in the Viterbi Beam Search
+ * algorithm. The data are represented by two time slots of costs and backtrack
+ * pointers (see description of TViterbiMatrix structure). The time dimension
+ * size is equal to 2 always to use sparingly the allocated memory (only
+ * current and previous time points are being saved at each step).
+ *
+ * Each word has as many states as it has phonemes according to the lexicon.
+ * Besides, additional state as initial pseudo-state is inserted in front of
+ * the real first word state (this pseudo-state is necessary for implementation
+ * of inter-word transition rules). States of words are laid out by buckets of
+ * equal lengths (see description of TViterbiMatrix structure), so costs and
+ * backtrack pointers of the whole lexicon at one time point are two flat
+ * arrays, and the same states of words of one bucket are adjacent. All four
+ * arrays and the array of penalties of
+ * states are placed in one memory block, and each of them is aligned to the
+ * cache line boundary.
+ *
+ * Also lexicon entries are grouped by vocabulary words, so that all entries
+ * (i.e. all variants of transcription) of any word can be found quickly at
+ * calculation of inter-word transitions. Buffers for pruning are allocated
+ * according to the pruning parameters, and per-thread slots are allocated for
+ * the maximal number of OpenMP threads (see update_viterbi_matrix()).
+ */
+static void create_viterbi_matrix(
+        TViterbiMatrix* data, int words_number, TLinearWordsLexicon lexicon[],
+        TDecoderParameters pruning)
+{
+    int t, w, s, i, b, row_size, max_length;
+    int *buckets_of_lengths;
+    if ((data == NULL) || (words_number <= 0) || (lexicon == NULL))
     {
         return;
     }
-
-    w = 0; s = 1;
-    max_cost = data.cells[t][w][s].cost;
-    min_cost = data.cells[t][w][s].cost;
-    for (w = 0; w < data.words_number; w++)
+    data->times_number = 0;
+    data->words_number = words_number;
+    data->words_sizes = malloc(sizeof(int) * words_number);
+    data->words_indexes = malloc(sizeof(int) * words_number);
+    data->vocabulary_size = 0;
+    for (w = 0; w < words_number; w++)
     {
-        for (s = 1; s <= data.words_sizes[w]; s++)
+        data->words_sizes[w] = lexicon[w].phonemes_number;
+        data->words_indexes[w] = lexicon[w].word_index;
+        if (lexicon[w].word_index >= data->vocabulary_size)
         {
-            if (data.cells[t][w][s].cost <= (-FLT_MAX + FLT_EPSILON))
-            {
-                continue;
-            }
-            if (data.cells[t][w][s].cost > max_cost)
-            {
-                max_cost = data.cells[t][w][s].cost;
-            }
-            if (data.cells[t][w][s].cost < min_cost)
-            {
-                min_cost = data.cells[t][w][s].cost;
-            }
+            data->vocabulary_size = lexicon[w].word_index + 1;
         }
-        number_of_all_hypotheses += data.words_sizes[w];
     }
-    if ((max_cost <= (-FLT_MAX + FLT_EPSILON))
-            || (min_cost <= (-FLT_MAX + FLT_EPSILON)))
+    data->entries_offsets = malloc(sizeof(int) * (data->vocabulary_size + 1));
+    data->entries_indexes = malloc(sizeof(int) * words_number);
+    memset(data->entries_offsets, 0,
+           sizeof(int) * (data->vocabulary_size + 1));
+    for (w = 0; w < words_number; w++)
     {
-        return;
+        data->entries_offsets[data->words_indexes[w] + 1]++;
     }
-    if ((max_cost - min_cost) <= FLT_EPSILON)
+    for (i = 0; i < data->vocabulary_size; i++)
     {
-        return;
+        data->entries_offsets[i + 1] += data->entries_offsets[i];
     }
-    max_number_of_unpruned_hypotheses = (int)floor(
-                (1.0 - pruning_coeff) * number_of_all_hypotheses + 0.5);
-    if (max_number_of_unpruned_hypotheses >= number_of_all_hypotheses)
+    for (w = 0; w < words_number; w++)
     {
-        return;
+        i = data->words_indexes[w];
+        data->entries_indexes[data->entries_offsets[i]] = w;
+        data->entries_offsets[i]++;
     }
-
-    dcost = (max_cost - min_cost) / (HISTOGRAM_SIZE - 1);
-    histogram[0].number = 0;
-    histogram[0].left = max_cost - dcost;
-    histogram[0].right = max_cost;
-    for (i = 1; i < (HISTOGRAM_SIZE - 1); i++)
+    for (i = data->vocabulary_size; i > 0; i--)
+    {
+        data->entries_offsets[i] = data->entries_offsets[i - 1];
+    }
+    data->entries_offsets[0] = 0;
+    data->word_ends = malloc(sizeof(int) * words_number);
+    data->word_ends_max_costs = malloc(sizeof(float) * words_number);
+    data->bigram_best_costs = malloc(sizeof(float) * words_number);
+    data->bigram_predecessors = malloc(sizeof(int) * words_number);
+    data->reached_words = malloc(sizeof(int) * words_number);
+    for (w = 0; w < words_number; w++)
     {
-        histogram[i].number = 0;
-        histogram[i].right = histogram[i-1].left;
-        histogram[i].left = histogram[i].right - dcost;
+        data->bigram_best_costs[w] = -FLT_MAX;
+        data->bigram_predecessors[w] = -1;
     }
-    histogram[HISTOGRAM_SIZE-1].right = histogram[HISTOGRAM_SIZE-2].left;
-    histogram[HISTOGRAM_SIZE-1].left = -FLT_MAX;
-    histogram[HISTOGRAM_SIZE-1].number = 0;
 
-    for (w = 0; w < data.words_number; w++)
+    /* buckets of words with equal lengths are laid out one after another in
+       ascending order of lengths, and words of each bucket keep their order */
+    max_length = 0;
+    for (w = 0; w < words_number; w++)
     {
-        for (s = 1; s <= data.words_sizes[w]; s++)
+        if (data->words_sizes[w] > max_length)
         {
-            i = 0;
-            while (i < HISTOGRAM_SIZE)
-            {
-                if ((histogram[i].left <= data.cells[t][w][s].cost)
-                        && (data.cells[t][w][s].cost <= histogram[i].right))
-                {
-                    histogram[i].number++;
-                    break;
-                }
-                i++;
-            }
+            max_length = data->words_sizes[w];
+        }
+    }
+    buckets_of_lengths = malloc(sizeof(int) * (max_length + 1));
+    for (i = 0; i <= max_length; i++)
+    {
+        buckets_of_lengths[i] = 0;
+    }
+    for (w = 0; w < words_number; w++)
+    {
+        buckets_of_lengths[data->words_sizes[w]]++;
+    }
+    data->buckets_number = 0;
+    for (i = 0; i <= max_length; i++)
+    {
+        if (buckets_of_lengths[i] > 0)
+        {
+            data->buckets_number++;
+        }
+    }
+    data->buckets_lengths = malloc(sizeof(int) * data->buckets_number);
+    data->buckets_sizes = malloc(sizeof(int) * data->buckets_number);
+    data->buckets_offsets = malloc(sizeof(int) * data->buckets_number);
+    data->buckets_activity = malloc(sizeof(int) * data->buckets_number);
+    data->states_number = 0;
+    for (i = 0, b = 0; i <= max_length; i++)
+    {
+        if (buckets_of_lengths[i] <= 0)
+        {
+            continue;
+        }
+        data->buckets_lengths[b] = i;
+        data->buckets_sizes[b] = 0;
+        data->buckets_offsets[b] = data->states_number;
+        data->buckets_activity[b] = 0;
+        data->states_number += (i + 1) * buckets_of_lengths[i];
+        buckets_of_lengths[i] = b++;
+    }
+    data->states_offsets = malloc(sizeof(int) * words_number);
+    data->states_strides = malloc(sizeof(int) * words_number);
+    data->last_states = malloc(sizeof(int) * words_number);
+    data->words_buckets = malloc(sizeof(int) * words_number);
+    for (w = 0; w < words_number; w++)
+    {
+        b = buckets_of_lengths[data->words_sizes[w]];
+        data->words_buckets[w] = b;
+        data->states_offsets[w] = data->buckets_offsets[b]
+                + data->buckets_sizes[b];
+        data->buckets_sizes[b]++;
+    }
+    free(buckets_of_lengths);
+    for (w = 0; w < words_number; w++)
+    {
+        b = data->words_buckets[w];
+        data->states_strides[w] = data->buckets_sizes[b];
+        data->last_states[w] = data->states_offsets[w]
+                + data->words_sizes[w] * data->states_strides[w];
+    }
+    data->hypotheses_number = data->states_number - words_number;
+    data->active_words = malloc(sizeof(int) * words_number);
+    data->words_activity = malloc(sizeof(unsigned char) * words_number);
+    memset(data->words_activity, WORD_IS_INACTIVE,
+           sizeof(unsigned char) * words_number);
+    data->active_words_number = 0;
+    data->dead_cost = -FLT_MAX + FLT_EPSILON;
+    data->cost_offset = 0.0;
+    data->predecessors = malloc(sizeof(int) * words_number);
+    data->histogram = malloc(sizeof(int) * pruning.histogram_size);
+    data->selected_costs = NULL;
+    if (pruning.max_active_hypotheses > 0)
+    {
+        data->selected_costs = malloc(sizeof(float)
+                                      * data->hypotheses_number);
+    }
+    data->threads_number = omp_get_max_threads();
+    data->threads_max_costs = malloc(sizeof(float) * data->threads_number);
+    data->threads_min_costs = malloc(sizeof(float) * data->threads_number);
+    data->threads_histograms = malloc(sizeof(int) * pruning.histogram_size
+                                      * data->threads_number);
+    data->threads_numbers = malloc(sizeof(int) * data->threads_number);
+    data->threads_parts_sizes = malloc(sizeof(int) * data->threads_number);
+    data->threads_best_words = malloc(sizeof(int) * data->threads_number);
+    data->threads_words = malloc(sizeof(int) * words_number);
+    data->states_phonemes = malloc(sizeof(int) * data->states_number);
+    for (w = 0; w < words_number; w++)
+    {
+        i = data->states_offsets[w];
+        data->states_phonemes[i] = -1;
+        for (s = 1; s <= data->words_sizes[w]; s++)
+        {
+            i += data->states_strides[w];
+            data->states_phonemes[i] = lexicon[w].phonemes_indexes[s-1];
         }
     }
 
-    i = 1;
-    cost_threshold = histogram[0].left;
-    number_of_unpruned_hypotheses = histogram[0].number;
-    while (i < HISTOGRAM_SIZE)
+    row_size = MEMORY_ALIGNMENT / sizeof(float);
+    row_size = ((data->states_number + row_size - 1) / row_size) * row_size;
+    data->states_memory = malloc_aligned_memory(
+                row_size * (3 * sizeof(float) + 2 * sizeof(int)));
+    data->costs[0] = (float*)data->states_memory;
+    data->costs[1] = data->costs[0] + row_size;
+    data->btps[0] = (int*)(data->costs[1] + row_size);
+    data->btps[1] = data->btps[0] + row_size;
+    data->penalties = (float*)(data->btps[1] + row_size);
+    data->emission_table = NULL;
+    data->emission_row_size = 0;
+    data->update_row_of_states = select_states_row_kernel();
+    data->entering_words_offsets = NULL;
+    data->entering_words_numbers = NULL;
+    data->entering_words = NULL;
+    data->fast_match_depth = 0;
+    data->fast_match_size = 0;
+    data->prefixes_number = 0;
+    data->words_prefixes = NULL;
+    data->prefixes_lengths = NULL;
+    data->prefixes_ends = NULL;
+    data->prefixes_phonemes = NULL;
+    data->prefixes_scores = NULL;
+    data->fast_match_costs = NULL;
+    data->fast_match_words = NULL;
+    for (t = 0; t < 2; t++)
     {
-        if (number_of_unpruned_hypotheses > max_number_of_unpruned_hypotheses)
+        for (i = 0; i < data->states_number; i++)
         {
-            break;
+            data->costs[t][i] = -FLT_MAX;
+            data->btps[t][i] = -1;
         }
-        cost_threshold = histogram[i].left;
-        number_of_unpruned_hypotheses += histogram[i].number;
-        i++;
     }
+}
 
-    for (w = 0; w < data.words_number; w++)
+/* This function initializes cells of the given Viterbi matrix before
+ * recognition of new phonemes sequence: -FLT_MAX values will be assigned to
+ * costs, and -1 values will be assigned to backtrack pointers. States of
+ * inactive words are impossible in both time slots already (see
+ * update_active_words()), so only words from the active words list of the
+ * previous sequence are reset, in both time slots, and they become inactive.
+ * Backtrack pointers of other words can be left from the previous sequence,
+ * but they are never read for impossible states.
+ */
+static void initialize_values_of_viterbi_matrix(TViterbiMatrix data)
+{
+    int t, j, w, s;
+    for (j = 0; j < data.active_words_number; j++)
     {
-        for (s = 1; s <= data.words_sizes[w]; s++)
+        w = data.active_words[j];
+        for (s = data.states_offsets[w]; s <= data.last_states[w];
+             s += data.states_strides[w])
         {
-            if ((data.cells[t][w][s].cost <= cost_threshold)
-                    && (data.cells[t][w][s].cost > (-FLT_MAX + FLT_EPSILON)))
+            for (t = 0; t < 2; t++)
             {
-                data.cells[t][w][s].cost = -FLT_MAX;
-                data.cells[t][w][s].btp = -1;
+                data.costs[t][s] = -FLT_MAX;
+                data.btps[t][s] = -1;
             }
         }
+        data.words_activity[w] = WORD_IS_INACTIVE;
     }
 }
 
-static int calculate_viterbi_matrix(
-        TViterbiMatrix data, TTracebackArray traceback_array,
-        int src_phonemes_sequence[], float src_phonemes_weights[],
-        int phonemes_vocabulary_size, float confusion_penalties[],
-        TLinearWordsLexicon words_lexicon[], float pruning_coeff,
-        TLanguageModel language_model, float lambda)
+/* This function frees all memory which was allocated for the Viterbi matrix.
+ */
+static void delete_viterbi_matrix(TViterbiMatrix* data)
 {
-    int nwords = data.words_number;
-    int is_ok = 1;
-    int bigram_i, inp_phoneme_i, trg_phoneme_i;
-    int t_count, t = 0, w, s, S, i, v, v_max;
-    float tmp_val1, tmp_val2, tmp_d, bigram_probability;
-    int *predecessors = malloc(sizeof(int) * data.words_number);
-    THistogram histogram_for_pruning[HISTOGRAM_SIZE];
-    //double start_time, end_time; // for debug
+    if (data == NULL)
+    {
+        return;
+    }
+    if ((data->words_number <= 0)
+            || (data->words_sizes == NULL) || (data->words_indexes == NULL)
+            || (data->states_memory == NULL))
+    {
+        return;
+    }
 
-    t = 0; s = 1;
-    inp_phoneme_i = src_phonemes_sequence[t];
-    for (w = 0; w < data.words_number; w++)
+    free_aligned_memory(data->states_memory);
+    data->states_memory = NULL;
+    data->costs[0] = NULL;
+    data->costs[1] = NULL;
+    data->btps[0] = NULL;
+    data->btps[1] = NULL;
+    free(data->states_offsets);
+    data->states_offsets = NULL;
+    free(data->states_strides);
+    data->states_strides = NULL;
+    free(data->last_states);
+    data->last_states = NULL;
+    free(data->words_buckets);
+    data->words_buckets = NULL;
+    free(data->buckets_lengths);
+    data->buckets_lengths = NULL;
+    free(data->buckets_sizes);
+    data->buckets_sizes = NULL;
+    free(data->buckets_offsets);
+    data->buckets_offsets = NULL;
+    free(data->buckets_activity);
+    data->buckets_activity = NULL;
+    data->buckets_number = 0;
+    free(data->states_phonemes);
+    data->states_phonemes = NULL;
+    data->states_number = 0;
+    free(data->active_words);
+    data->active_words = NULL;
+    free(data->words_activity);
+    data->words_activity = NULL;
+    data->hypotheses_number = 0;
+    data->active_words_number = 0;
+    free(data->predecessors);
+    data->predecessors = NULL;
+    free(data->histogram);
+    data->histogram = NULL;
+    if (data->selected_costs != NULL)
+    {
+        free(data->selected_costs);
+        data->selected_costs = NULL;
+    }
+    free(data->threads_max_costs);
+    data->threads_max_costs = NULL;
+    free(data->threads_min_costs);
+    data->threads_min_costs = NULL;
+    free(data->threads_histograms);
+    data->threads_histograms = NULL;
+    free(data->threads_numbers);
+    data->threads_numbers = NULL;
+    free(data->threads_parts_sizes);
+    data->threads_parts_sizes = NULL;
+    free(data->threads_best_words);
+    data->threads_best_words = NULL;
+    free(data->threads_words);
+    data->threads_words = NULL;
+    data->threads_number = 0;
+
+    free(data->words_sizes);
+    data->words_sizes = NULL;
+    free(data->words_indexes);
+    data->words_indexes = NULL;
+    free(data->entries_offsets);
+    data->entries_offsets = NULL;
+    free(data->entries_indexes);
+    data->entries_indexes = NULL;
+    free(data->word_ends);
+    data->word_ends = NULL;
+    free(data->word_ends_max_costs);
+    data->word_ends_max_costs = NULL;
+    free(data->bigram_best_costs);
+    data->bigram_best_costs = NULL;
+    free(data->bigram_predecessors);
+    data->bigram_predecessors = NULL;
+    free(data->reached_words);
+    data->reached_words = NULL;
+    free(data->prefixes_scores);
+    data->prefixes_scores = NULL;
+    free(data->fast_match_costs);
+    data->fast_match_costs = NULL;
+    free(data->fast_match_words);
+    data->fast_match_words = NULL;
+    data->vocabulary_size = 0;
+    data->words_number = 0;
+    data->times_number = 0;
+}
+
+/* This function finds the part of n items (from the *first item to the *last
+ * one, excluding it) which is owned by the calling thread of the team (see
+ * update_viterbi_matrix()). Items are divided into equal contiguous parts in
+ * order of threads, and sizes of parts are multiples of the given alignment,
+ * so that adjacent parts don't share cache lines. Outside of the parallel
+ * region the calling thread owns all items.
+ */
+static void get_part_of_thread(int n, int alignment, int *first, int *last)
+{
+    int threads_number = omp_get_num_threads();
+    int part_size = (n + threads_number - 1) / threads_number;
+
+    part_size = ((part_size + alignment - 1) / alignment) * alignment;
+    *first = omp_get_thread_num() * part_size;
+    if (*first > n)
+    {
+        *first = n;
+    }
+    *last = (part_size < (n - *first)) ? (*first + part_size) : n;
+}
+
+/* This function interpolates the given probability of bigram which is ended in
+ * the end_word_i word with the unigram probability of this word (see the
+ * deleted interpolation smoothing algorithm). */
+static float interpolate_bigram_probability(
+        TLanguageModel language_model, float lambda, float bigram_probability,
+        int end_word_i)
+{
+    return lambda * bigram_probability + (1.0 - lambda)
+            * language_model.unigrams_probabilities[end_word_i];
+}
+
+/* This function finds the score of bigram like "start_word_i->end_word_i" in
+ * the compiled language model by binary search. If this bigram isn't found,
+ * then the backoff score of the end_word_i word is returned. */
+static float get_bigram_score(TCompiledLanguageModel language_model,
+                              int start_word_i, int end_word_i)
+{
+    int first = language_model.bigrams_offsets[end_word_i];
+    int last = language_model.bigrams_offsets[end_word_i+1];
+    int middle;
+
+    while (first < last)
     {
-        trg_phoneme_i = words_lexicon[w].phonemes_indexes[s-1];
-        i = trg_phoneme_i * phonemes_vocabulary_size + inp_phoneme_i;
-        //i = inp_phoneme_i * phonemes_vocabulary_size + trg_phoneme_i;
-        if (confusion_penalties[i] > (-FLT_MAX + FLT_EPSILON))
+        middle = first + (last - first) / 2;
+        if (language_model.bigrams_begins[middle] < start_word_i)
         {
-            data.cells[t][w][s].cost = src_phonemes_weights[t]
-                    + confusion_penalties[i];
+            first = middle + 1;
         }
         else
         {
-            data.cells[t][w][s].cost = -FLT_MAX;
+            last = middle;
         }
     }
-
-    for (t_count = 1; t_count < data.times_number; t_count++)
+    if ((first < language_model.bigrams_offsets[end_word_i+1])
+            && (language_model.bigrams_begins[first] == start_word_i))
     {
-        t++;
-        if (t >= 2)
-        {
-            t = 1;
-            shift_viterbi_matrix(data);
-        }
-        inp_phoneme_i = src_phonemes_sequence[t_count];
-        //start_time = omp_get_wtime(); // for debug
-        for (w = 0; w < nwords; w++)
+        return language_model.bigrams_scores[first];
+    }
+
+    return language_model.backoff_scores[end_word_i];
+}
+
+/* This function calculates costs of transitions into the initial pseudo-state
+ * of each word at the time t (the t_count is number of this time in the
+ * recognized phonemes sequence), and it writes the best predecessor of each
+ * word into the predecessors array.
+ *
+ * Because the bigram probability is interpolated linearly with the unigram
+ * probability, the best transition into the word w is the best of two values.
+ * The first value is the best cost of word end plus the backoff score of the
+ * word w (see compile_language_model()), and the second value is the best
+ * transition over explicit bigrams which are ended in the word w. These
+ * transitions are pushed from alive word ends over the forward index of bigrams
+ * (see compile_language_model()) before words are entered, so costs of word
+ * ends are read before they can be changed by entering. Therefore each time
+ * step requires O(W + B) operations instead of O(W^2), where W is the words
+ * lexicon size and B is the number of bigrams which are started in alive word
+ * ends. Costs and predecessors are identical to ones which are found by
+ * exhaustive search over all pairs of words (in case of equal costs the
+ * predecessor with minimal lexicon index is selected).
+ *
+ * Only words from the active words list (see update_active_words()) can be
+ * predecessors. This differs from the original serial loop over all words of
+ * the lexicon, where an inactive word of one phoneme (its first state is its
+ * last state), which was entered earlier in this loop, was a predecessor of
+ * next words with the cost of its entry. Now such word is a predecessor from
+ * the next time only, so results for lexicons with words of one phoneme can
+ * differ from the original ones even without pruning. Any inactive word which
+ * gets alive transition into its initial pseudo-state becomes entered: all its
+ * states at the time t are written anew, because they aren't calculated by
+ * the state update of this time. Transitions with costs which aren't greater
+ * than the cost_threshold (see prune_hypotheses()) are pruned as well as other
+ * hypotheses of this time, and word ends with such costs are considered as
+ * pruned ones. Also word ends with costs less than the best word end cost
+ * minus the word_end_beam (if it is greater than zero) aren't used as
+ * predecessors.
+ *
+ * If the entering_words list isn't NULL, then transitions are calculated only
+ * into words of this list (see create_lists_of_entering_words()) and into the
+ * active word with the best last state, whose predecessor is used by the
+ * traceback (see update_viterbi_matrix()). Transitions into other words are
+ * useless, because they are impossible at the next time point. Words are
+ * processed in ascending order in both cases.
+ */
+static void calculate_transitions_between_words(
+        TViterbiMatrix data, int t, int t_count, int active_words_number,
+        float cost_threshold, float word_end_beam,
+        TCompiledLanguageModel language_model, int entering_words[],
+        int entering_words_number, int predecessors[])
+{
+    int w, v, i, j, k, n, s, e, first, last, word_i, v_best;
+    int n_ends = 0, n_words = data.words_number, v_max = -1, v_max_pos = 0;
+    int n_reached = 0;
+    float *costs = data.costs[t];
+    int *btps = data.btps[t];
+    float cost, best_cost, bigram_best_cost, backoff_best_cost;
+    float bigram_score, backoff_score, first_word_cost = -FLT_MAX;
+    float dead_cost = (cost_threshold > (-FLT_MAX + FLT_EPSILON))
+            ? cost_threshold : (-FLT_MAX + FLT_EPSILON);
+
+    /* word ends and transitions over explicit bigrams are found by one
+       thread, and then words are entered by all threads of the team */
+    #pragma omp single copyprivate(dead_cost, n_ends, n_words, v_max, \
+                                   v_max_pos, n_reached, first_word_cost)
+    {
+        if (word_end_beam > 0.0)
         {
-            s = 1;
-            trg_phoneme_i = words_lexicon[w].phonemes_indexes[s-1];
-            tmp_val1 = data.cells[t-1][w][s].cost;
-            if (tmp_val1 > (-FLT_MAX + FLT_EPSILON))
+            best_cost = -FLT_MAX;
+            for (i = 0; i < active_words_number; i++)
             {
-                tmp_d = src_phonemes_weights[t_count];
-                i = trg_phoneme_i * phonemes_vocabulary_size + inp_phoneme_i;
-                //i = inp_phoneme_i * phonemes_vocabulary_size + trg_phoneme_i;
-                if (confusion_penalties[i] > (-FLT_MAX + FLT_EPSILON))
-                {
-                    tmp_d += confusion_penalties[i];
-                    tmp_val1 += tmp_d;
-                }
-                else
+                v = data.active_words[i];
+                cost = costs[data.last_states[v]];
+                if (cost > best_cost)
                 {
-                    tmp_val1 = -FLT_MAX;
+                    best_cost = cost;
                 }
             }
-            data.cells[t][w][s].cost = tmp_val1;
-            data.cells[t][w][s].btp = data.cells[t-1][w][s].btp;
+            if ((best_cost - word_end_beam) > dead_cost)
+            {
+                dead_cost = best_cost - word_end_beam;
+            }
+        }
 
-            for (s = 2; s < data.words_sizes[w]; s++)
+        for (i = 0; i < active_words_number; i++)
+        {
+            v = data.active_words[i];
+            if (v == 0)
             {
-                trg_phoneme_i = words_lexicon[w].phonemes_indexes[s-1];
-                tmp_d = src_phonemes_weights[t_count];
-                i = trg_phoneme_i * phonemes_vocabulary_size + inp_phoneme_i;
-                //i = inp_phoneme_i * phonemes_vocabulary_size + trg_phoneme_i;
-                if (confusion_penalties[i] > (-FLT_MAX + FLT_EPSILON))
-                {
-                    tmp_d += confusion_penalties[i];
-                    tmp_val1 = data.cells[t-1][w][s-1].cost;
-                    if (tmp_val1 > (-FLT_MAX + FLT_EPSILON))
-                    {
-                        tmp_val1 += tmp_d;
-                    }
-                    tmp_val2 = data.cells[t-1][w][s].cost;
-                    if (tmp_val2 > (-FLT_MAX + FLT_EPSILON))
-                    {
-                        tmp_val2 += tmp_d;
-                    }
-                }
-                else
-                {
-                    tmp_val1 = -FLT_MAX;
-                    tmp_val2 = -FLT_MAX;
-                }
-                if (tmp_val1 >= tmp_val2)
-                {
-                    data.cells[t][w][s].cost = tmp_val1;
-                    data.cells[t][w][s].btp = data.cells[t-1][w][s-1].btp;
-                }
-                else
+                continue;
+            }
+            cost = costs[data.last_states[v]];
+            if (cost > dead_cost)
+            {
+                data.word_ends[n_ends] = v;
+                if ((n_ends > 0)
+                        && (data.word_ends_max_costs[n_ends-1] > cost))
                 {
-                    data.cells[t][w][s].cost = tmp_val2;
-                    data.cells[t][w][s].btp = data.cells[t-1][w][s].btp;
+                    cost = data.word_ends_max_costs[n_ends-1];
                 }
+                data.word_ends_max_costs[n_ends] = cost;
+                n_ends++;
             }
+        }
+        /* the end of the first lexicon entry is read before words are
+           entered as well as other word ends */
+        if (data.words_activity[0] == WORD_IS_ACTIVE)
+        {
+            first_word_cost = costs[data.last_states[0]];
+        }
 
-            s = data.words_sizes[w];
-            tmp_val1 = data.cells[t][w][s-1].cost;
-            tmp_val2 = data.cells[t-1][w][s].cost;
-            if (tmp_val2 > (-FLT_MAX + FLT_EPSILON))
+        if (entering_words != NULL)
+        {
+            for (i = 0; i < active_words_number; i++)
             {
-                trg_phoneme_i = words_lexicon[w].phonemes_indexes[s-1];
-                tmp_d = src_phonemes_weights[t_count];
-                i = trg_phoneme_i * phonemes_vocabulary_size + inp_phoneme_i;
-                //i = inp_phoneme_i * phonemes_vocabulary_size + trg_phoneme_i;
-                if (confusion_penalties[i] > (-FLT_MAX + FLT_EPSILON))
-                {
-                    tmp_val2 += (tmp_d + confusion_penalties[i]);
-                }
-                else
+                v = data.active_words[i];
+                if ((v_max < 0) || (costs[data.last_states[v]]
+                                    > costs[data.last_states[v_max]]))
                 {
-                    tmp_val2 = -FLT_MAX;
+                    v_max = v;
                 }
             }
-            if (tmp_val1 >= tmp_val2)
+            while ((v_max_pos < entering_words_number)
+                   && (entering_words[v_max_pos] < v_max))
             {
-                data.cells[t][w][s].cost = tmp_val1;
-                data.cells[t][w][s].btp = data.cells[t][w][s-1].btp;
+                v_max_pos++;
             }
-            else
+            if ((v_max_pos < entering_words_number)
+                    && (entering_words[v_max_pos] == v_max))
             {
-                data.cells[t][w][s].cost = tmp_val2;
-                data.cells[t][w][s].btp = data.cells[t-1][w][s].btp;
+                v_max = -1;
             }
+            n_words = entering_words_number + ((v_max >= 0) ? 1 : 0);
         }
-        //end_time = omp_get_wtime(); // for debug
-        //printf("%.4f\t", end_time - start_time); // for debug
-
-        //start_time = omp_get_wtime(); // for debug
-        prune_hypotheses(data, t, pruning_coeff, histogram_for_pruning);
-        //end_time = omp_get_wtime(); // for debug
-        //printf("%.4f\t", end_time - start_time); // for debug
 
-        //start_time = omp_get_wtime(); // for debug
-        #pragma omp parallel for private(v,v_max,S,bigram_i,\
-                                         bigram_probability,tmp_val1,tmp_val2)
-        for (w = 0; w < data.words_number; w++)
+        /* transitions from other lexicon entries over explicit bigrams are
+           pushed from alive word ends (they are ordered by increase,
+           therefore the predecessor with minimal index is kept in case of
+           equal costs) */
+        for (n = 0; n < n_ends; n++)
         {
-            bigram_i = 0;
-            v_max = 0;
-            S = data.words_sizes[v_max];
-            if (data.cells[t][v_max][S].cost > (-FLT_MAX + FLT_EPSILON))
-            {
-                bigram_probability = find_bigram(
-                            language_model, lambda, data.words_indexes[v_max],
-                            data.words_indexes[w], &bigram_i);
-                if (bigram_probability > 0.0)
+            k = data.word_ends[n];
+            cost = costs[data.last_states[k]];
+            word_i = data.words_indexes[k];
+            for (i = language_model.successors_offsets[word_i];
+                 i < language_model.successors_offsets[word_i+1]; i++)
+            {
+                v = language_model.successors_ends[i];
+                if (v >= data.vocabulary_size)
                 {
-                    tmp_val1 = log10(bigram_probability)
-                            + data.cells[t][v_max][S].cost;
+                    break;
                 }
-                else
+                bigram_score = language_model.successors_scores[i];
+                if (bigram_score <= MIN_TRANSITION_SCORE)
                 {
-                    tmp_val1 = -FLT_MAX;
+                    continue;
                 }
-            }
-            else
-            {
-                tmp_val1 = -FLT_MAX;
-            }
-            for (v = 1; v < data.words_number; v++)
-            {
-                S = data.words_sizes[v];
-                if (data.cells[t][v][S].cost > (-FLT_MAX + FLT_EPSILON))
+                for (j = data.entries_offsets[v];
+                     j < data.entries_offsets[v+1]; j++)
                 {
-                    bigram_probability = find_bigram(
-                                language_model, lambda, data.words_indexes[v],
-                                data.words_indexes[w], &bigram_i);
-                    if (bigram_probability > FLT_EPSILON)
+                    w = data.entries_indexes[j];
+                    if (data.bigram_predecessors[w] < 0)
                     {
-                        tmp_val2 = log10(bigram_probability)
-                                + data.cells[t][v][S].cost;
-                        if (tmp_val2 > tmp_val1)
-                        {
-                            v_max = v;
-                            tmp_val1 = tmp_val2;
-                        }
+                        data.reached_words[n_reached++] = w;
+                    }
+                    else if ((cost + bigram_score)
+                             <= data.bigram_best_costs[w])
+                    {
+                        continue;
                     }
+                    data.bigram_best_costs[w] = cost + bigram_score;
+                    data.bigram_predecessors[w] = k;
                 }
             }
+        }
+    }
+    if ((n_ends == 0) && (first_word_cost <= dead_cost))
+    {
+        /* there are no alive word ends, therefore all transitions are
+           impossible */
+        return;
+    }
 
-            data.cells[t][w][0].cost = tmp_val1;
-            data.cells[t][w][0].btp = t_count-1;
+    #pragma omp for
+    for (e = 0; e < n_words; e++)
+    {
+        if (entering_words == NULL)
+        {
+            w = e;
+        }
+        else if ((v_max < 0) || (e < v_max_pos))
+        {
+            w = entering_words[e];
+        }
+        else
+        {
+            w = (e == v_max_pos) ? v_max : entering_words[e-1];
+        }
 
-            if (data.cells[t][w][0].cost > data.cells[t][w][1].cost)
+        /* transition from the first lexicon entry (unlike other entries,
+           scores which aren't greater than MIN_TRANSITION_SCORE are used) */
+        v_best = 0;
+        best_cost = -FLT_MAX;
+        if (first_word_cost > dead_cost)
+        {
+            bigram_score = get_bigram_score(
+                        language_model, data.words_indexes[v_best],
+                        data.words_indexes[w]);
+            if (bigram_score > (-FLT_MAX + FLT_EPSILON))
             {
-                data.cells[t][w][1].cost = data.cells[t][w][0].cost;
-                data.cells[t][w][1].btp = data.cells[t][w][0].btp;
+                best_cost = bigram_score + first_word_cost;
             }
+        }
 
-            predecessors[w] = v_max;
+        /* transitions from other lexicon entries over explicit bigrams */
+        bigram_best_cost = data.bigram_best_costs[w];
+        v = (data.bigram_predecessors[w] >= 0) ? data.bigram_predecessors[w]
+                                                : data.words_number;
+
+        /* transitions from other lexicon entries over unigram backoff */
+        backoff_best_cost = -FLT_MAX;
+        backoff_score = language_model.backoff_scores[data.words_indexes[w]];
+        if ((n_ends > 0) && (backoff_score > MIN_TRANSITION_SCORE))
+        {
+            backoff_best_cost = backoff_score
+                    + data.word_ends_max_costs[n_ends-1];
         }
-        //end_time = omp_get_wtime(); // for debug
-        //printf("%.4f\n", end_time - start_time); // for debug
 
-        v_max = 0;
-        for (v = 1; v < data.words_number; v++)
+        if (backoff_best_cost > bigram_best_cost)
         {
-            if (data.cells[t][v][data.words_sizes[v]].cost
-                    > data.cells[t][v_max][data.words_sizes[v_max]].cost)
+            bigram_best_cost = backoff_best_cost;
+            v = data.words_number;
+        }
+        if ((backoff_best_cost > (-FLT_MAX + FLT_EPSILON))
+                && (backoff_best_cost >= bigram_best_cost))
+        {
+            /* the first word end whose backoff transition is the best */
+            first = 0; last = n_ends - 1;
+            while (first < last)
+            {
+                n = first + (last - first) / 2;
+                cost = backoff_score + data.word_ends_max_costs[n];
+                if (cost >= bigram_best_cost)
+                {
+                    last = n;
+                }
+                else
+                {
+                    first = n + 1;
+                }
+            }
+            if (data.word_ends[last] < v)
             {
-                v_max = v;
+                v = data.word_ends[last];
             }
         }
-        if (data.cells[t][v_max][data.words_sizes[v_max]].cost
-                <= (-FLT_MAX + FLT_EPSILON))
+
+        if ((v < data.words_number) && (bigram_best_cost > best_cost))
         {
-            is_ok = 0;
-            break;
+            best_cost = bigram_best_cost;
+            v_best = v;
+        }
+        predecessors[w] = v_best;
+        if (best_cost <= cost_threshold)
+        {
+            best_cost = -FLT_MAX;
+        }
+
+        i = data.states_offsets[w];
+        s = i + data.states_strides[w];
+        if (data.words_activity[w] == WORD_IS_ACTIVE)
+        {
+            costs[i] = best_cost;
+            btps[i] = t_count-1;
+            if (costs[i] > costs[s])
+            {
+                costs[s] = costs[i];
+                btps[s] = btps[i];
+            }
+        }
+        else if (best_cost > (-FLT_MAX + FLT_EPSILON))
+        {
+            costs[i] = best_cost;
+            btps[i] = t_count-1;
+            costs[s] = best_cost;
+            btps[s] = t_count-1;
+            for (j = s + data.states_strides[w]; j <= data.last_states[w];
+                 j += data.states_strides[w])
+            {
+                costs[j] = -FLT_MAX;
+                btps[j] = -1;
+            }
+            data.words_activity[w] = WORD_IS_ENTERED;
         }
-        traceback_array[t_count-1].predecessor_word
-                = data.words_indexes[predecessors[v_max]];
-        traceback_array[t_count-1].start_time
-                = data.cells[t][v_max][data.words_sizes[v_max]].btp;
     }
-    if (is_ok)
+
+    #pragma omp single nowait
+    for (i = 0; i < n_reached; i++)
     {
-        v_max = 0;
-        for (v = 1; v < data.words_number; v++)
+        w = data.reached_words[i];
+        data.bigram_best_costs[w] = -FLT_MAX;
+        data.bigram_predecessors[w] = -1;
+    }
+}
+
+/* This function rebuilds the list of active words after calculation of the
+ * time t. Active word, all states of which were pruned (i.e. their costs
+ * aren't greater than the cost_threshold) or became impossible, is excluded
+ * from this list, and entered word (see calculate_transitions_between_words())
+ * is included into it. Lexicon indexes in the list are sorted by ascending.
+ * States of the excluded word become impossible in both time slots, so that
+ * calculation of the whole row of states (see update_viterbi_matrix()) keeps
+ * them impossible until this word is entered again. Each thread of the team
+ * checks its own range of lexicon, and then the list is joined from parts of
+ * threads in their order. The active word with the best last state (the
+ * first of such words in case of equal costs) is written into the best_word,
+ * or -1 if there isn't any active word. As result, this function returns new
+ * number of active words.
+ */
+static int update_active_words(TViterbiMatrix data, int t,
+                               float cost_threshold, int *best_word)
+{
+    int w, s, first, last, stride, i, first_w, last_w;
+    int n = 0, offset = 0, total = 0, v_max = -1;
+    int thread_i = omp_get_thread_num();
+    float *costs = data.costs[t];
+    float dead_cost = (cost_threshold > (-FLT_MAX + FLT_EPSILON))
+            ? cost_threshold : (-FLT_MAX + FLT_EPSILON);
+
+    get_part_of_thread(data.words_number, THREAD_PART_ALIGNMENT, &first_w,
+                       &last_w);
+    for (w = first_w; w < last_w; w++)
+    {
+        if (data.words_activity[w] == WORD_IS_INACTIVE)
+        {
+            continue;
+        }
+        if (data.words_activity[w] == WORD_IS_ACTIVE)
         {
-            if (data.cells[t][v][data.words_sizes[v]].cost
-                    > data.cells[t][v_max][data.words_sizes[v_max]].cost)
+            stride = data.states_strides[w];
+            first = data.states_offsets[w] + stride;
+            last = data.last_states[w];
+            for (s = first; s <= last; s += stride)
+            {
+                if (costs[s] > dead_cost)
+                {
+                    break;
+                }
+            }
+            if (s > last)
             {
-                v_max = v;
+                for (s = first; s <= last; s += stride)
+                {
+                    data.costs[0][s] = -FLT_MAX;
+                    data.costs[1][s] = -FLT_MAX;
+                }
+                data.words_activity[w] = WORD_IS_INACTIVE;
+                continue;
             }
         }
-        if (data.cells[t][v_max][data.words_sizes[v_max]].cost
-                <= (-FLT_MAX + FLT_EPSILON))
+        data.words_activity[w] = WORD_IS_ACTIVE;
+        data.threads_words[first_w + n] = w;
+        n++;
+        if ((v_max < 0) || (costs[data.last_states[w]]
+                            > costs[data.last_states[v_max]]))
         {
-            is_ok = 0;
+            v_max = w;
         }
-        else
+    }
+    data.threads_numbers[thread_i] = n;
+    data.threads_best_words[thread_i] = v_max;
+    #pragma omp barrier
+
+    v_max = -1;
+    for (i = 0; i < omp_get_num_threads(); i++)
+    {
+        if (i < thread_i)
+        {
+            offset += data.threads_numbers[i];
+        }
+        total += data.threads_numbers[i];
+        w = data.threads_best_words[i];
+        if ((w >= 0) && ((v_max < 0) || (costs[data.last_states[w]]
+                                         > costs[data.last_states[v_max]])))
         {
-            traceback_array[data.times_number-1].predecessor_word
-                    = data.words_indexes[v_max];
-            traceback_array[data.times_number-1].start_time
-                    = data.cells[t][v_max][data.words_sizes[v_max]].btp;
+            v_max = w;
         }
     }
+    memcpy(data.active_words + offset, data.threads_words + first_w,
+           n * sizeof(int));
+    *best_word = v_max;
+    #pragma omp barrier
 
-    free(predecessors);
+    return total;
+}
 
-    return is_ok;
+/* This function adds the cost into the histogram which divides the cost range
+ * from max_cost down to the minimal cost into (histogram_size - 1) equal bins,
+ * and the last bin of histogram is kept for the minimal cost (the
+ * bins_per_cost is number of bins per unit of cost). Number of bin is
+ * calculated directly, therefore this operation doesn't depend on the
+ * histogram size.
+ */
+static void add_cost_to_histogram(int histogram[], int histogram_size,
+                                  float max_cost, float bins_per_cost,
+                                  float cost)
+{
+    int i = (int)((max_cost - cost) * bins_per_cost);
+    if (i >= histogram_size)
+    {
+        i = histogram_size - 1;
+    }
+    histogram[i]++;
 }
 
-static int get_words_sequence_by_traceback_array(
-        TTracebackArray traceback_array, int traceback_array_length,
-        int recognized_words_sequence[])
+/* This function finds the cost threshold of histogram pruning, so that number
+ * of hypotheses with costs greater than this threshold would be as close as
+ * possible to the max_number_of_unpruned_hypotheses. If all bins of histogram
+ * must be kept, then -FLT_MAX is returned (i.e. nothing is pruned).
+ */
+static float find_threshold_by_histogram(
+        int histogram[], int histogram_size, float max_cost,
+        float bins_per_cost, int max_number_of_unpruned_hypotheses)
 {
-    int tmp, i = traceback_array_length - 1, n = 0;
+    int i = 0;
+    int number_of_unpruned_hypotheses = histogram[0];
 
-    while (i >= 0)
+    while (number_of_unpruned_hypotheses <= max_number_of_unpruned_hypotheses)
     {
-        if (traceback_array[i].start_time < 0)
+        i++;
+        if (i >= (histogram_size - 1))
         {
-            break;
+            return -FLT_MAX;
         }
-        recognized_words_sequence[n++] = traceback_array[i].predecessor_word;
-        i = traceback_array[i].start_time - 1;
-    }
-
-    for (i = 0; i < (n / 2); i++)
-    {
-        tmp = recognized_words_sequence[i];
-        recognized_words_sequence[i] = recognized_words_sequence[n-i-1];
-        recognized_words_sequence[n-i-1] = tmp;
+        number_of_unpruned_hypotheses += histogram[i];
     }
 
-    return n;
+    return max_cost - (i + 1) / bins_per_cost;
 }
 
-static int create_phonemes_sequence_by_transcription(
-        TTranscriptionNode transcription[], int transcription_length,
-        int phonemes_sequence[], float phonemes_weights[])
+/* This function selects the k-th greatest cost of the given array (k is
+ * counted from 1) by the Hoare's selection algorithm, so it requires O(n)
+ * operations on average. Order of costs in the array is changed.
+ */
+static float select_kth_greatest_cost(float costs[], int n, int k)
 {
-    int is_ok = 1;
-    int start_ind = -1, end_ind = -1, i, j, k;
-    int number_of_steps_10ms, phonemes_sequence_length = 0;
-    float cur_phoneme_weight;
+    int left = 0, right = n - 1, i, j;
+    float pivot, tmp;
 
-    for (i = 0; i < transcription_length; i++)
+    k--;
+    while (left < right)
     {
-        if (transcription[i].probability <= 0.0)
-        {
-            is_ok = 0;
-            break;
-        }
-        if (start_ind < 0)
+        pivot = costs[left + (right - left) / 2];
+        i = left;
+        j = right;
+        while (i <= j)
         {
-            if (transcription[i].node_data > 0)
+            while (costs[i] > pivot)
             {
-                start_ind = i;
+                i++;
             }
-        }
-        else
-        {
-            if (transcription[i].node_data > 0)
+            while (costs[j] < pivot)
             {
-                end_ind = -1;
+                j--;
             }
-            else
+            if (i <= j)
             {
-                end_ind = i-1;
+                tmp = costs[i];
+                costs[i] = costs[j];
+                costs[j] = tmp;
+                i++;
+                j--;
             }
         }
+        if (k <= j)
+        {
+            right = j;
+        }
+        else if (k >= i)
+        {
+            left = i;
+        }
+        else
+        {
+            break;
+        }
     }
-    if (!is_ok)
+
+    return costs[k];
+}
+
+/* This function raises the cost threshold of pruning so that number of
+ * unpruned hypotheses would be limited both by the histogram pruning (if
+ * bins_per_cost is greater than zero, i.e. the histogram is filled) and by
+ * the maximal number of active hypotheses (costs of hypotheses which are
+ * above the current threshold are collected into the selected_costs array in
+ * this case). As result, this function returns new cost threshold.
+ */
+static float limit_number_of_hypotheses(
+        TDecoderParameters pruning, float cost_threshold, int histogram[],
+        float max_cost, float bins_per_cost, int number_of_alive_hypotheses,
+        int max_number_of_unpruned_hypotheses, float selected_costs[],
+        int number_of_selected_hypotheses)
+{
+    float cost;
+
+    if ((bins_per_cost > 0.0) && (number_of_alive_hypotheses
+                                  > max_number_of_unpruned_hypotheses))
     {
-        return -1;
+        cost = find_threshold_by_histogram(histogram, pruning.histogram_size,
+                                           max_cost, bins_per_cost,
+                                           max_number_of_unpruned_hypotheses);
+        if (cost > cost_threshold)
+        {
+            cost_threshold = cost;
+        }
     }
-    if (start_ind < 0)
+    if ((pruning.max_active_hypotheses > 0)
+            && (number_of_selected_hypotheses > pruning.max_active_hypotheses))
     {
-        return 0;
+        cost = select_kth_greatest_cost(selected_costs,
+                                        number_of_selected_hypotheses,
+                                        pruning.max_active_hypotheses + 1);
+        if (cost > cost_threshold)
+        {
+            cost_threshold = cost;
+        }
     }
-    if (end_ind < 0)
+
+    return cost_threshold;
+}
+
+/* This function returns the width of the beam pruning relative to the best
+ * hypothesis, or zero if the beam pruning isn't used. In the fixed-point mode
+ * the beam isn't wider than 2^(23-fixed_point_bits), so that costs of alive
+ * hypotheses stay in the range of exact sums after normalization (see
+ * normalize_viterbi_matrix()).
+ */
+static float calculate_beam_width(TDecoderParameters pruning)
+{
+    float beam_width = pruning.beam_width;
+    float max_beam_width;
+
+    if (pruning.fixed_point_bits <= 0)
     {
-        end_ind = transcription_length - 1;
+        return beam_width;
     }
+    max_beam_width = (float)ldexp(1.0, 23 - pruning.fixed_point_bits);
+    if ((beam_width <= 0.0) || (beam_width > max_beam_width))
+    {
+        beam_width = max_beam_width;
+    }
+    return beam_width;
+}
 
-    for (i = start_ind; i <= end_ind; i++)
+/* This function prunes hypotheses of active words at the time t. There are
+ * three kinds of pruning (see TDecoderParameters), which can be used together:
+ * the beam pruning relative to the best hypothesis, the histogram pruning (the
+ * pruning_coeff is part of all hypotheses, i.e. real states of all words,
+ * which must be pruned), and limitation of number of active hypotheses. The
+ * max_cost and the min_cost are maximal and minimal costs of alive hypotheses
+ * at the time t, which are found in the state update of this time, so only
+ * one pass over hypotheses is necessary to fill the histogram. Pruned
+ * hypotheses aren't rewritten, and the returned cost threshold is applied when
+ * they are read (hypotheses with cost which isn't greater than this threshold
+ * are considered as pruned ones). Each thread of the team fills its own
+ * histogram and its own part of the buffer of selected costs by its part of
+ * active words, and then the threshold is found by one thread over parts of
+ * all threads. If nothing is pruned, then this function returns -FLT_MAX.
+ */
+static float prune_hypotheses(TViterbiMatrix data, int t,
+                              int active_words_number, float max_cost,
+                              float min_cost, TDecoderParameters pruning,
+                              int histogram[], float selected_costs[])
+{
+    int w, s, i, j, first, last, first_j, last_j, n = 0, offset = 0;
+    int thread_i = omp_get_thread_num();
+    int *thread_histogram = data.threads_histograms
+            + thread_i * pruning.histogram_size;
+    float *costs = data.costs[t];
+    float cost_threshold = -FLT_MAX + FLT_EPSILON, bins_per_cost = 0.0;
+    int number_of_alive_hypotheses = 0, number_of_selected_hypotheses = 0;
+    int max_number_of_unpruned_hypotheses = data.hypotheses_number;
+    float beam_width = calculate_beam_width(pruning);
+
+    if (max_cost <= (-FLT_MAX + FLT_EPSILON))
     {
-        number_of_steps_10ms = (int)floor((transcription[i].end_time
-                                           - transcription[i].start_time)
-                                          / INTERVAL_10MSECS + 0.5);
-        if (number_of_steps_10ms > MAX_REPEATS_OF_PHONEME)
-        {
-            number_of_steps_10ms = MAX_REPEATS_OF_PHONEME;
-        }
-        else
+        return -FLT_MAX;
+    }
+    if ((beam_width > 0.0) && ((max_cost - beam_width) > cost_threshold))
+    {
+        cost_threshold = max_cost - beam_width;
+        if (min_cost < cost_threshold)
         {
-            if (number_of_steps_10ms < 1)
-            {
-                number_of_steps_10ms = 1;
-            }
+            min_cost = cost_threshold;
         }
-        phonemes_sequence_length += number_of_steps_10ms;
     }
-    if (phonemes_sequence == NULL)
+    if (pruning.pruning_coeff > 0.0)
     {
-        return phonemes_sequence_length;
+        max_number_of_unpruned_hypotheses = (int)floor(
+                    (1.0 - pruning.pruning_coeff) * data.hypotheses_number
+                    + 0.5);
+        if ((max_number_of_unpruned_hypotheses < data.hypotheses_number)
+                && ((max_cost - min_cost) > FLT_EPSILON))
+        {
+            memset(thread_histogram, 0, pruning.histogram_size * sizeof(int));
+            bins_per_cost = (pruning.histogram_size - 1)
+                    / (max_cost - min_cost);
+        }
     }
 
-    j = 0;
-    for (i = start_ind; i <= end_ind; i++)
+    if ((bins_per_cost > 0.0) || (pruning.max_active_hypotheses > 0))
     {
-        number_of_steps_10ms = (int)floor((transcription[i].end_time
-                                           - transcription[i].start_time)
-                                          / INTERVAL_10MSECS + 0.5);
-        if (number_of_steps_10ms > MAX_REPEATS_OF_PHONEME)
+        get_part_of_thread(active_words_number, THREAD_PART_ALIGNMENT,
+                           &first_j, &last_j);
+        if (pruning.max_active_hypotheses > 0)
         {
-            number_of_steps_10ms = MAX_REPEATS_OF_PHONEME;
+            /* the part of buffer of each thread is enough for all states of
+               its words */
+            for (j = first_j; j < last_j; j++)
+            {
+                n += data.words_sizes[data.active_words[j]];
+            }
+            data.threads_parts_sizes[thread_i] = n;
+            #pragma omp barrier
+            for (i = 0; i < thread_i; i++)
+            {
+                offset += data.threads_parts_sizes[i];
+            }
+            n = 0;
         }
-        else
+        for (j = first_j; j < last_j; j++)
         {
-            if (number_of_steps_10ms < 1)
+            w = data.active_words[j];
+            first = data.states_offsets[w] + data.states_strides[w];
+            last = data.last_states[w];
+            for (s = first; s <= last; s += data.states_strides[w])
             {
-                number_of_steps_10ms = 1;
+                if (costs[s] <= cost_threshold)
+                {
+                    continue;
+                }
+                if (bins_per_cost > 0.0)
+                {
+                    add_cost_to_histogram(thread_histogram,
+                                          pruning.histogram_size, max_cost,
+                                          bins_per_cost, costs[s]);
+                }
+                if (pruning.max_active_hypotheses > 0)
+                {
+                    selected_costs[offset + n] = costs[s];
+                }
+                n++;
             }
         }
-        cur_phoneme_weight = log10(transcription[i].probability);
-        for (k = 0; k < number_of_steps_10ms; k++)
+        data.threads_numbers[thread_i] = n;
+        #pragma omp barrier
+
+        #pragma omp single copyprivate(cost_threshold)
         {
-            phonemes_sequence[j+k] = transcription[i].node_data;
-            phonemes_weights[j+k] = cur_phoneme_weight;
+            if (bins_per_cost > 0.0)
+            {
+                memset(histogram, 0, pruning.histogram_size * sizeof(int));
+            }
+            offset = 0;
+            for (i = 0; i < omp_get_num_threads(); i++)
+            {
+                n = data.threads_numbers[i];
+                if (bins_per_cost > 0.0)
+                {
+                    for (j = 0; j < pruning.histogram_size; j++)
+                    {
+                        histogram[j] += data.threads_histograms[
+                                i * pruning.histogram_size + j];
+                    }
+                    number_of_alive_hypotheses += n;
+                }
+                if (pruning.max_active_hypotheses > 0)
+                {
+                    if (offset > number_of_selected_hypotheses)
+                    {
+                        memmove(selected_costs + number_of_selected_hypotheses,
+                                selected_costs + offset, n * sizeof(float));
+                    }
+                    offset += data.threads_parts_sizes[i];
+                    number_of_selected_hypotheses += n;
+                }
+            }
+            cost_threshold = limit_number_of_hypotheses(
+                        pruning, cost_threshold, histogram, max_cost,
+                        bins_per_cost, number_of_alive_hypotheses,
+                        max_number_of_unpruned_hypotheses, selected_costs,
+                        number_of_selected_hypotheses);
         }
-        j += number_of_steps_10ms;
     }
 
-    return phonemes_sequence_length;
+    return (cost_threshold > (-FLT_MAX + FLT_EPSILON))
+            ? cost_threshold : -FLT_MAX;
 }
 
-static int compare_begins_of_bigrams(const void *ptr1, const void *ptr2)
+/* This function starts recording of word ends of the time t into the table of
+ * word ends, whose costs are given with the cost_offset of the Viterbi matrix.
+ * Time points between the last recorded time and the time t don't have any
+ * word end.
+ */
+static void start_word_ends_of_time(TWordEndsTable *table, int t,
+                                    double cost_offset)
 {
-    TWordBigramBegin *item1 = (TWordBigramBegin*)ptr1;
-    TWordBigramBegin *item2 = (TWordBigramBegin*)ptr2;
-
-    return (item1->word_i - item2->word_i);
+    if ((t + 2) > table->times_capacity)
+    {
+        table->times_capacity = 2 * (t + 2);
+        table->times_offsets = realloc(table->times_offsets,
+                                       table->times_capacity * sizeof(int));
+        table->costs_offsets = realloc(table->costs_offsets,
+                                       table->times_capacity
+                                       * sizeof(double));
+    }
+    table->times_offsets[0] = 0;
+    while (table->times_number < t)
+    {
+        table->costs_offsets[table->times_number] = cost_offset;
+        table->times_number++;
+        table->times_offsets[table->times_number] = table->items_number;
+    }
+    table->costs_offsets[t] = cost_offset;
 }
 
-static int compare_items_of_words_lexicon(const void *ptr1, const void *ptr2)
+/* This function adds the word end into the table of word ends (recording of
+ * word ends of its time must be started by start_word_ends_of_time()). */
+static void add_word_end(TWordEndsTable *table, int word, int predecessor_time,
+                         float cost)
 {
-    TLinearWordsLexicon *item1 = (TLinearWordsLexicon*)ptr1;
-    TLinearWordsLexicon *item2 = (TLinearWordsLexicon*)ptr2;
+    TWordEndItem *item;
 
-    return (item1->word_index - item2->word_index);
+    if (table->items_number >= table->items_capacity)
+    {
+        table->items_capacity *= 2;
+        if (table->items_capacity < MIN_WORD_ENDS_CAPACITY)
+        {
+            table->items_capacity = MIN_WORD_ENDS_CAPACITY;
+        }
+        table->items = realloc(table->items, table->items_capacity
+                               * sizeof(TWordEndItem));
+    }
+    item = table->items + table->items_number;
+    item->word = word;
+    item->predecessor_time = predecessor_time;
+    item->cost = cost;
+    table->items_number++;
 }
 
-int read_string(FILE *read_file, char *str)
+/* This function finishes recording of word ends of the current time into the
+ * table of word ends. Word ends with costs less than the best word end cost
+ * minus the lattice_beam (if it is greater than zero) are removed, and only
+ * the lattice_size best word ends are kept (if it is greater than zero).
+ * But ends of words which are marked in the required_words array (if it isn't
+ * NULL) are kept always, because they are predecessors of words entered at the
+ * next time, and the best path of the lattice goes through them.
+ */
+static void finish_word_ends_of_time(TWordEndsTable *table, float lattice_beam,
+                                     int lattice_size,
+                                     unsigned char required_words[])
 {
-    int start_pos = 0, end_pos = 0;
-
-    if ((read_file == NULL) || (str == NULL))
-    {
-        return 0;
-    }
+    int first = table->times_offsets[table->times_number];
+    int n = table->items_number - first, i, j;
+    float best_cost, cost_threshold = -FLT_MAX, cost;
 
-    memset(str, 0, BUFFER_SIZE);
-    if (fgets(str, BUFFER_SIZE, read_file) == NULL)
-    {
-        return 0;
-    }
-
-    while (str[start_pos] != 0)
+    if (n > 0)
     {
-        if ((str[start_pos] != ' ') && (str[start_pos] != '\t')
-                && (str[start_pos] != '\n') && (str[start_pos] != '\r'))
+        best_cost = table->items[first].cost;
+        for (i = first + 1; i < table->items_number; i++)
         {
-            break;
+            if (table->items[i].cost > best_cost)
+            {
+                best_cost = table->items[i].cost;
+            }
         }
-        start_pos++;
-    }
-    if (str[start_pos] == 0)
-    {
-        memset(str, 0, BUFFER_SIZE);
-        return 0;
-    }
-
-    end_pos = strlen(str) - 1;
-    while (end_pos > start_pos)
-    {
-        if ((str[end_pos] != ' ') && (str[end_pos] != '\t')
-                && (str[end_pos] != '\n') && (str[end_pos] != '\r'))
+        if (lattice_beam > 0.0)
         {
-            break;
+            cost_threshold = best_cost - lattice_beam;
         }
-        end_pos--;
+        if ((lattice_size > 0) && (n > lattice_size))
+        {
+            if (n > table->selected_capacity)
+            {
+                table->selected_capacity = n;
+                table->selected_costs = realloc(table->selected_costs,
+                                                n * sizeof(float));
+            }
+            for (i = 0; i < n; i++)
+            {
+                table->selected_costs[i] = table->items[first + i].cost;
+            }
+            cost = select_kth_greatest_cost(table->selected_costs, n,
+                                            lattice_size);
+            if (cost > cost_threshold)
+            {
+                cost_threshold = cost;
+            }
+        }
+        j = first;
+        n = 0;
+        for (i = first; i < table->items_number; i++)
+        {
+            if ((required_words != NULL)
+                    && required_words[table->items[i].word])
+            {
+                table->items[j++] = table->items[i];
+            }
+            else if ((table->items[i].cost >= cost_threshold)
+                     && ((lattice_size <= 0) || (n < lattice_size)))
+            {
+                table->items[j++] = table->items[i];
+                n++;
+            }
+        }
+        table->items_number = j;
     }
-    str[end_pos+1] = 0;
+    table->times_number++;
+    table->times_offsets[table->times_number] = table->items_number;
+}
 
-    if (start_pos > 0)
+/* This function records alive word ends of the time t of the Viterbi matrix
+ * (the t_count is number of this time) into the table of word ends. Word ends
+ * are recorded before transitions between words of this time, so that each
+ * recorded word end can be predecessor of words which are entered at this
+ * time. The word which is entered at the time t_count gets the backtrack
+ * pointer t_count-1 (see calculate_transitions_between_words()), therefore
+ * the last time of its predecessor is its backtrack pointer plus one. Word
+ * ends which are outside of the word end beam aren't predecessors, so they
+ * aren't recorded. Recording is finished after transitions by the
+ * finish_word_ends_of_viterbi_matrix() function.
+ */
+static void record_word_ends_of_viterbi_matrix(
+        TViterbiMatrix data, int t, int t_count, int active_words_number,
+        float dead_cost, TWordEndsTable *word_ends)
+{
+    int j, v, s;
+    float *costs = data.costs[t];
+    int *btps = data.btps[t];
+
+    start_word_ends_of_time(word_ends, t_count, data.cost_offset);
+    for (j = 0; j < active_words_number; j++)
     {
-        memmove(&str[0], &str[start_pos], end_pos-start_pos+2);
+        v = data.active_words[j];
+        s = data.last_states[v];
+        if (costs[s] > dead_cost)
+        {
+            add_word_end(word_ends, data.words_indexes[v],
+                         (btps[s] >= 0) ? (btps[s] + 1) : -1, costs[s]);
+        }
     }
-
-    return (end_pos - start_pos + 1);
 }
 
-int prepare_filename(char *filename)
+/* This function finishes recording of word ends of the time t of the Viterbi
+ * matrix after transitions between words of this time (see
+ * record_word_ends_of_viterbi_matrix()). Best predecessors (see the
+ * predecessors array) of the lattice_size best words which are entered at this
+ * time are kept in the table of word ends independently of the lattice beam
+ * and the lattice size. Without them word ends on the best path could be lost
+ * if their costs are low but transitions from them are good, and entry costs
+ * of next words would be underestimated. Number of such predecessors isn't
+ * greater than the lattice_size, so memory of the table is still bounded.
+ */
+static void finish_word_ends_of_viterbi_matrix(
+        TViterbiMatrix data, int t, TDecoderParameters pruning,
+        int predecessors[], TWordEndsTable *word_ends)
 {
-    int i, n;
+    int w, i, n = 0;
+    float *costs = data.costs[t];
+    float lattice_beam = pruning.lattice_beam, entry_threshold = -FLT_MAX;
 
-    if (filename == NULL)
+    if ((pruning.word_end_beam > 0.0) && ((lattice_beam <= 0.0)
+                                          || (pruning.word_end_beam
+                                              < lattice_beam)))
     {
-        return 0;
+        lattice_beam = pruning.word_end_beam;
     }
-
-    n = strlen(filename);
-    if (n <= 0)
+    if (word_ends->required_capacity < data.vocabulary_size)
     {
-        return 0;
+        word_ends->required_capacity = data.vocabulary_size;
+        word_ends->required_words = realloc(
+                    word_ends->required_words,
+                    data.vocabulary_size * sizeof(unsigned char));
+        memset(word_ends->required_words, 0,
+               data.vocabulary_size * sizeof(unsigned char));
     }
-    if (filename[0] == '"')
+    if (word_ends->selected_capacity < data.words_number)
     {
-        if (n > 1)
+        word_ends->selected_capacity = data.words_number;
+        word_ends->selected_costs = realloc(
+                    word_ends->selected_costs,
+                    data.words_number * sizeof(float));
+    }
+    for (w = 0; w < data.words_number; w++)
+    {
+        i = data.states_offsets[w];
+        if ((data.words_activity[w] != WORD_IS_INACTIVE)
+                && (costs[i] > (-FLT_MAX + FLT_EPSILON)))
         {
-            if (filename[n-1] == '"')
-            {
-                if (n > 2)
-                {
-                    filename[n-1] = 0;
-                    memmove(&filename[0], &filename[1], (n-1) * sizeof(char));
-                    n -= 2;
+            word_ends->selected_costs[n++] = costs[i];
+        }
+    }
+    if ((pruning.lattice_size > 0) && (n > pruning.lattice_size))
+    {
+        entry_threshold = select_kth_greatest_cost(word_ends->selected_costs,
+                                                   n, pruning.lattice_size);
+    }
+    for (w = 0; w < data.words_number; w++)
+    {
+        i = data.states_offsets[w];
+        if ((data.words_activity[w] != WORD_IS_INACTIVE)
+                && (costs[i] > (-FLT_MAX + FLT_EPSILON))
+                && (costs[i] >= entry_threshold))
+        {
+            word_ends->required_words[
+                    data.words_indexes[predecessors[w]]] = 1;
+        }
+    }
+    finish_word_ends_of_time(word_ends, lattice_beam, pruning.lattice_size,
+                             word_ends->required_words);
+    for (w = 0; w < data.words_number; w++)
+    {
+        word_ends->required_words[data.words_indexes[predecessors[w]]] = 0;
+    }
+}
 
-                    i = 0;
-                    while (i < n)
-                    {
-                        if ((filename[i]!=' ') && (filename[i]!='\t')
-                                && (filename[i]!='\n')  && (filename[i]!='\r'))
-                        {
-                            break;
-                        }
-                        i++;
-                    }
-                    if (i < n)
-                    {
-                        memmove(&filename[0], &filename[i], n-i+1);
-                        n = n-i;
+/* This function returns penalties of confusions of phonemes of all states of
+ * the Viterbi matrix with the input phoneme inp_phoneme_i, i.e. the row which
+ * is indexed by the state number. If the emission table is created, then its
+ * row of the input phoneme is returned. Else penalties are gathered from the
+ * confusion_penalties matrix into the penalties array of the Viterbi matrix:
+ * penalties of states of dense buckets (see buckets_activity) in the part of
+ * their words which is owned by the calling thread (see get_part_of_thread())
+ * and of states of words from the words list which are in other buckets, or
+ * penalties of all states if this list is NULL.
+ */
+static float *select_penalties_of_viterbi_matrix(
+        TViterbiMatrix data, int inp_phoneme_i, int phonemes_vocabulary_size,
+        float confusion_penalties[], int words[], int words_number)
+{
+    int b, j, k, w, s, first, last;
 
-                        i = n-1;
-                        while (i > 0)
-                        {
-                            if ((filename[i]!=' ')&&(filename[i]!='\t')
-                                    &&(filename[i]!='\r')&&(filename[i]!='\n'))
-                            {
-                                break;
-                            }
-                            i--;
-                        }
-                        filename[i+1] = 0;
-                        n = i+1;
-                    }
-                    else
-                    {
-                        filename[0] = 0;
-                        n = 0;
-                    }
-                }
-                else
-                {
-                    n = 0;
-                }
-            }
-            else
+    if (data.emission_table != NULL)
+    {
+        return data.emission_table + inp_phoneme_i * data.emission_row_size;
+    }
+    if (words == NULL)
+    {
+        for (s = 0; s < data.states_number; s++)
+        {
+            if (data.states_phonemes[s] >= 0)
             {
-                n = 0;
+                data.penalties[s] = confusion_penalties[
+                        data.states_phonemes[s] * phonemes_vocabulary_size
+                        + inp_phoneme_i];
             }
         }
-        else
+        return data.penalties;
+    }
+    for (b = 0; b < data.buckets_number; b++)
+    {
+        if (data.buckets_activity[b] >= 0)
         {
-            n = 0;
+            continue;
+        }
+        get_part_of_thread(data.buckets_sizes[b], THREAD_PART_ALIGNMENT,
+                           &first, &last);
+        for (k = 1; k <= data.buckets_lengths[b]; k++)
+        {
+            j = data.buckets_offsets[b] + k * data.buckets_sizes[b];
+            for (s = j + first; s < j + last; s++)
+            {
+                data.penalties[s] = confusion_penalties[
+                        data.states_phonemes[s] * phonemes_vocabulary_size
+                        + inp_phoneme_i];
+            }
         }
     }
-    else
+    for (j = 0; j < words_number; j++)
     {
-        if (filename[n-1] == '"')
+        w = words[j];
+        if (data.buckets_activity[data.words_buckets[w]] < 0)
         {
-            n = 0;
+            continue;
+        }
+        last = data.last_states[w];
+        for (s = data.states_offsets[w] + data.states_strides[w]; s <= last;
+             s += data.states_strides[w])
+        {
+            data.penalties[s] = confusion_penalties[
+                    data.states_phonemes[s] * phonemes_vocabulary_size
+                    + inp_phoneme_i];
         }
     }
+    return data.penalties;
+}
 
-    return n;
+/* This function calculates the cost of one time point of the state with the
+ * given penalty of confusion (see select_penalties_of_viterbi_matrix()) for
+ * the input phoneme with the phoneme_weight. If such confusion is impossible,
+ * then this function returns -FLT_MAX.
+ */
+static float calculate_cost_of_time_point(float penalty, float phoneme_weight)
+{
+    if (penalty <= (-FLT_MAX + FLT_EPSILON))
+    {
+        return -FLT_MAX;
+    }
+    return phoneme_weight + penalty;
 }
 
-int find_in_vocabulary(char *vocabulary[], int vocabulary_size,
-                       char *found_name, int *is_equal)
+/* This function corrects the range of alive costs (from the min_cost to the
+ * max_cost) by the given cost.
+ */
+static void update_range_of_costs(float cost, float *max_cost,
+                                  float *min_cost)
 {
-    if (is_equal != NULL)
+    if (cost <= (-FLT_MAX + FLT_EPSILON))
     {
-        *is_equal = 0;
+        return;
     }
-    if ((found_name == NULL) || (vocabulary_size <= 0) || (vocabulary == NULL))
+    if (cost > *max_cost)
     {
-        return -1;
+        *max_cost = cost;
     }
-
-    int compare_res, first_pos = 0, last_pos = vocabulary_size, middle_pos;
-
-    compare_res = strcmp(vocabulary[0], found_name);
-    if (compare_res >= 0)
+    if (cost < *min_cost)
     {
-        if ((compare_res == 0) && (is_equal != NULL))
-        {
-            *is_equal = 1;
-        }
-        return 0;
+        *min_cost = cost;
     }
+}
 
-    compare_res = strcmp(vocabulary[last_pos-1], found_name);
-    if (compare_res <= 0)
-    {
-        if (compare_res == 0)
+/* This function calculates states of the word w at the time t of the Viterbi
+ * matrix for the segment, i.e. for the input phoneme (its penalties of
+ * states are given, see select_penalties_of_viterbi_matrix()) which lasts the
+ * given number of time points (repeats > 1). The segment isn't
+ * expanded into separate time points: for each state s the best path over
+ * these time points is found exactly. Such path begins in some state a (not
+ * more than repeats-1 states before the state s) and passes all states from a
+ * to s, and extra time points are spent in the state with the best cost of
+ * one time point. The state a continues the hypothesis of the previous time
+ * in this state or in the state a-1 (the first state and the pause state
+ * continue their own hypotheses only), so words begin and end on bounds of
+ * segments only. Range of alive costs is corrected by calculated states.
+ */
+static void update_word_by_segment(
+        TViterbiMatrix data, int t, int w, float penalties[],
+        float phoneme_weight, int repeats, float dead_cost,
+        float *max_cost, float *min_cost)
+{
+    int stride = data.states_strides[w];
+    int first = data.states_offsets[w] + stride, last = data.last_states[w];
+    int s, a, k, btp, best_btp;
+    float cost, best_cost, sum_of_costs, max_of_costs, point_cost;
+    float *prev_costs = data.costs[1-t], *cur_costs = data.costs[t];
+    int *prev_btps = data.btps[1-t], *cur_btps = data.btps[t];
+
+    for (s = first; s <= last; s += stride)
+    {
+        best_cost = -FLT_MAX;
+        best_btp = -1;
+        sum_of_costs = 0.0;
+        max_of_costs = -FLT_MAX;
+        for (a = s, k = 0; (a >= first) && (k < repeats); a -= stride, k++)
         {
-            if (is_equal != NULL)
+            point_cost = calculate_cost_of_time_point(penalties[a],
+                                                      phoneme_weight);
+            if (point_cost <= (-FLT_MAX + FLT_EPSILON))
             {
-                *is_equal = 1;
+                break;
+            }
+            sum_of_costs += point_cost;
+            if (point_cost > max_of_costs)
+            {
+                max_of_costs = point_cost;
+            }
+            cost = -FLT_MAX;
+            btp = -1;
+            if ((a > first) && (a < last)
+                    && (prev_costs[a-stride] > dead_cost))
+            {
+                cost = prev_costs[a-stride];
+                btp = prev_btps[a-stride];
+            }
+            if ((prev_costs[a] > dead_cost) && (prev_costs[a] > cost))
+            {
+                cost = prev_costs[a];
+                btp = prev_btps[a];
+            }
+            if (cost <= (-FLT_MAX + FLT_EPSILON))
+            {
+                continue;
+            }
+            cost += sum_of_costs + (repeats - k - 1) * max_of_costs;
+            if (cost > best_cost)
+            {
+                best_cost = cost;
+                best_btp = btp;
             }
         }
-        return last_pos-1;
+        if ((s == last) && (s > first) && (cur_costs[s-stride] >= best_cost))
+        {
+            best_cost = cur_costs[s-stride];
+            best_btp = cur_btps[s-stride];
+        }
+        cur_costs[s] = best_cost;
+        cur_btps[s] = best_btp;
+        update_range_of_costs(best_cost, max_cost, min_cost);
     }
+}
 
-    while (first_pos < last_pos)
+/* This function starts recognition of new phonemes sequence by the Viterbi
+ * matrix: the matrix is reset (see initialize_values_of_viterbi_matrix()), and
+ * hypotheses of the first states of all words are calculated for the first
+ * phoneme (the inp_phoneme_i with the phoneme_weight) of the sequence, and
+ * their backtrack pointers are set to -1. If this phoneme is
+ * the segment which lasts several time points (repeats > 1), then the word
+ * can pass up to repeats of its first states during this segment (the extra
+ * time points are spent in the state with the best cost of one time point).
+ */
+static void start_viterbi_matrix(
+        TViterbiMatrix *viterbi_matrix, int inp_phoneme_i,
+        float phoneme_weight, int repeats, int phonemes_vocabulary_size,
+        float confusion_penalties[])
+{
+    TViterbiMatrix data = *viterbi_matrix;
+    int active_words_number = 0;
+    int w, s, k, first, last;
+    float point_cost, sum_of_costs, max_of_costs;
+    float *penalties;
+
+    initialize_values_of_viterbi_matrix(data);
+    penalties = select_penalties_of_viterbi_matrix(
+                data, inp_phoneme_i, phonemes_vocabulary_size,
+                confusion_penalties, NULL, 0);
+    for (w = 0; w < data.words_number; w++)
     {
-        middle_pos = first_pos + (last_pos - first_pos) / 2;
-        compare_res = strcmp(found_name, vocabulary[middle_pos]);
-        if (compare_res == 0)
+        first = data.states_offsets[w] + data.states_strides[w];
+        last = data.last_states[w];
+        sum_of_costs = 0.0;
+        max_of_costs = -FLT_MAX;
+        /* the first state is written even if it is the last one (the word
+           of one state), and other states are passed inside the segment */
+        for (s = first, k = 0; ((k == 0) || (s < last)) && (k < repeats);
+             s += data.states_strides[w], k++)
         {
-            if (is_equal != NULL)
+            point_cost = calculate_cost_of_time_point(penalties[s],
+                                                      phoneme_weight);
+            if (point_cost <= (-FLT_MAX + FLT_EPSILON))
             {
-                *is_equal = 1;
+                break;
             }
-            last_pos = middle_pos;
-            break;
+            sum_of_costs += point_cost;
+            if (point_cost > max_of_costs)
+            {
+                max_of_costs = point_cost;
+            }
+            data.costs[0][s] = sum_of_costs + (repeats - k - 1) * max_of_costs;
+            data.btps[0][s] = -1;
         }
-        else if (compare_res < 0)
+        if (data.costs[0][first] > (-FLT_MAX + FLT_EPSILON))
         {
-            last_pos = middle_pos;
+            data.words_activity[w] = WORD_IS_ACTIVE;
+            data.active_words[active_words_number++] = w;
         }
-        else {
-            first_pos = middle_pos + 1;
+        else
+        {
+            data.words_activity[w] = WORD_IS_INACTIVE;
         }
     }
 
-    return last_pos;
+    viterbi_matrix->times_number = 1;
+    viterbi_matrix->active_words_number = active_words_number;
+    viterbi_matrix->dead_cost = -FLT_MAX + FLT_EPSILON;
+    viterbi_matrix->cost_offset = 0.0;
 }
 
-int find_in_unsorted_vocabulary(char *vocabulary[], int vocabulary_size,
-                                char *found_name)
+/* This function calculates the score of the prefix p for the fast match, i.e.
+ * the best path over states of this prefix for the next input phonemes (the
+ * next_phonemes_number of single time points), like paths in states of words
+ * (see update_row_of_states()): the path starts in the first state, which is
+ * written by the entry into the word, and at each time point it stays in its
+ * state or passes to the next one, and the last state of word can be reached
+ * without the input phoneme. If the prefix is the whole word, then the path can
+ * end the word before the last input phoneme, and following input phonemes
+ * belong to next words, so they aren't scored (therefore the score isn't less
+ * than the score of the same path in the Viterbi matrix). Weights of input
+ * phonemes are equal for all words, so they aren't included. As result, this
+ * function returns the score of the prefix, or -FLT_MAX if these input
+ * phonemes can't continue its words.
+ */
+static float calculate_score_of_prefix(
+        TViterbiMatrix data, int p, int next_phonemes[],
+        int next_phonemes_number, int phonemes_vocabulary_size,
+        float confusion_penalties[])
 {
-    int i, res = -1;
+    int length = data.prefixes_lengths[p];
+    int is_whole_word = data.prefixes_ends[p];
+    int *phonemes = data.prefixes_phonemes + p * (data.fast_match_depth + 1);
+    int middle_number = (is_whole_word && (length > 1)) ? (length - 1)
+                                                         : length;
+    int j, k;
+    float scores[MAX_FAST_MATCH_DEPTH + 1];
+    float cost, penalty, best_score = -FLT_MAX;
 
-    if ((found_name == NULL) || (vocabulary_size <= 0) || (vocabulary == NULL))
+    scores[0] = 0.0;
+    for (k = 1; k < length; k++)
     {
-        return -1;
+        scores[k] = -FLT_MAX;
     }
-
-    for (i = 0; i < vocabulary_size; i++)
+    if (is_whole_word && (length == 1))
     {
-        if (vocabulary[i] != NULL)
+        best_score = 0.0;
+    }
+    for (j = 0; j < next_phonemes_number; j++)
+    {
+        for (k = ((j + 1) < middle_number) ? (j + 1) : (middle_number - 1);
+             k >= 0; k--)
         {
-            if (strcmp(vocabulary[i], found_name) == 0)
+            cost = scores[k];
+            if ((k > 0) && (scores[k-1] > cost))
             {
-                res = i;
-                break;
+                cost = scores[k-1];
+            }
+            penalty = confusion_penalties[phonemes[k] * phonemes_vocabulary_size
+                                          + next_phonemes[j]];
+            scores[k] = -FLT_MAX;
+            if ((cost > (-FLT_MAX + FLT_EPSILON))
+                    && (penalty > (-FLT_MAX + FLT_EPSILON)))
+            {
+                scores[k] = cost + penalty;
+            }
+        }
+        if (middle_number < length)
+        {
+            /* the last state of the whole word */
+            cost = -FLT_MAX;
+            penalty = confusion_penalties[phonemes[length-1]
+                                          * phonemes_vocabulary_size
+                                          + next_phonemes[j]];
+            if ((scores[length-1] > (-FLT_MAX + FLT_EPSILON))
+                    && (penalty > (-FLT_MAX + FLT_EPSILON)))
+            {
+                cost = scores[length-1] + penalty;
+            }
+            if (scores[length-2] > cost)
+            {
+                cost = scores[length-2];
+            }
+            scores[length-1] = cost;
+            if (cost > best_score)
+            {
+                best_score = cost;
             }
         }
     }
+    for (k = 0; k < length; k++)
+    {
+        if (scores[k] > best_score)
+        {
+            best_score = scores[k];
+        }
+    }
 
-    return res;
+    return best_score;
 }
 
-int string_to_transcription_node(char *str, char *phonemes_vocabulary[],
-                                 int phonemes_number, PTranscriptionNode node)
+/* This function selects words which are entered at the current time by the
+ * fast match: all prefixes of words are scored for the next input phonemes
+ * (see calculate_score_of_prefix()), and the fast_match_size words with the
+ * best scores of their prefixes are selected (words with the same score as
+ * the last of them are selected too). Words which can't be continued by the
+ * next input phonemes aren't selected, so only words of the list of words
+ * which can be continued by the first of them are checked (see
+ * create_lists_of_entering_words()). Prefixes are scored by all threads of the
+ * team. Then each thread keeps the fast_match_size best scores of its part of
+ * checked words, and the threshold score is found by one thread over the kept
+ * scores of all threads, which contain the fast_match_size best scores of all
+ * words. After that each thread selects words of its part by this threshold,
+ * and lexicon indexes of selected words are joined in the fast_match_words
+ * array in ascending order. As result, this function returns number of
+ * selected words.
+ */
+static int select_words_by_fast_match(
+        TViterbiMatrix data, int next_phonemes[], int next_phonemes_number,
+        int phonemes_vocabulary_size, float confusion_penalties[])
 {
-    char *start_time_label = NULL, *end_time_label = NULL;
-    char *node_name = NULL, *probability_str = NULL;
+    int *checked_words = NULL, checked_words_number = data.words_number;
+    int p, w, i, first, last, n = 0, kept_number, offset = 0, total = 0;
+    int thread_i = omp_get_thread_num();
+    float *thread_costs;
+    float score, threshold = -FLT_MAX;
 
-    if ((phonemes_number <= 0) || (phonemes_vocabulary == NULL)
-            || (str == NULL))
+    if (next_phonemes_number > data.fast_match_depth)
     {
-        return 0;
+        next_phonemes_number = data.fast_match_depth;
     }
-
-    start_time_label = strtok(str, " \t");
-    if (start_time_label == NULL)
+    if ((data.entering_words_numbers != NULL)
+            && (data.entering_words_numbers[next_phonemes[0]] >= 0))
     {
-        return 0;
+        checked_words = data.entering_words
+                + data.entering_words_offsets[next_phonemes[0]];
+        checked_words_number = data.entering_words_numbers[next_phonemes[0]];
     }
-    end_time_label = strtok(NULL, " \t");
-    if (end_time_label == NULL)
+    #pragma omp for
+    for (p = 0; p < data.prefixes_number; p++)
     {
-        return 0;
+        data.prefixes_scores[p] = calculate_score_of_prefix(
+                    data, p, next_phonemes, next_phonemes_number,
+                    phonemes_vocabulary_size, confusion_penalties);
     }
-    node_name = strtok(NULL, " \t");
-    if (node_name == NULL)
+
+    get_part_of_thread(checked_words_number, THREAD_PART_ALIGNMENT, &first,
+                       &last);
+    thread_costs = data.fast_match_costs + first;
+    for (i = first; i < last; i++)
     {
-        return 0;
-    }
-    probability_str = strtok(NULL, " \t");
-    if (probability_str != NULL)
-    {
-        if (strtok(NULL, " \t") != NULL)
+        w = (checked_words != NULL) ? checked_words[i] : i;
+        score = data.prefixes_scores[data.words_prefixes[w]];
+        if (score > (-FLT_MAX + FLT_EPSILON))
         {
-            return 0;
+            data.threads_words[first + n] = w;
+            thread_costs[n++] = score;
         }
     }
-
-    if (sscanf(start_time_label, "%lu", &(node->start_time)) != 1)
+    kept_number = n;
+    if (n > data.fast_match_size)
     {
-        return 0;
+        threshold = select_kth_greatest_cost(thread_costs, n,
+                                             data.fast_match_size);
+        kept_number = 0;
+        for (i = 0; i < n; i++)
+        {
+            if (thread_costs[i] >= threshold)
+            {
+                thread_costs[kept_number++] = thread_costs[i];
+            }
+        }
     }
+    data.threads_numbers[thread_i] = kept_number;
+    data.threads_parts_sizes[thread_i] = last - first;
+    #pragma omp barrier
 
-    if (sscanf(end_time_label, "%lu", &(node->end_time)) != 1)
-    {
-        return 0;
-    }
-    if (node->end_time <= node->start_time)
+    #pragma omp single copyprivate(threshold)
     {
-        return 0;
+        for (i = 0; i < omp_get_num_threads(); i++)
+        {
+            if (offset > total)
+            {
+                memmove(data.fast_match_costs + total,
+                        data.fast_match_costs + offset,
+                        data.threads_numbers[i] * sizeof(float));
+            }
+            offset += data.threads_parts_sizes[i];
+            total += data.threads_numbers[i];
+        }
+        /* if there are exactly fast_match_size kept scores, then the least
+           of them isn't greater than scores of all alive words */
+        threshold = -FLT_MAX;
+        if (total >= data.fast_match_size)
+        {
+            threshold = select_kth_greatest_cost(data.fast_match_costs, total,
+                                                 data.fast_match_size);
+        }
     }
 
-    node->node_data = find_in_unsorted_vocabulary(
-                phonemes_vocabulary, phonemes_number, node_name);
-    if (node->node_data < 0)
+    /* the common threshold isn't less than thresholds of threads, so words
+       which aren't kept by their threads aren't selected */
+    kept_number = 0;
+    for (i = 0; i < n; i++)
     {
-        return 0;
+        w = data.threads_words[first + i];
+        if (data.prefixes_scores[data.words_prefixes[w]] >= threshold)
+        {
+            data.threads_words[first + kept_number++] = w;
+        }
     }
+    data.threads_numbers[thread_i] = kept_number;
+    #pragma omp barrier
 
-    if (probability_str == NULL)
-    {
-        node->probability = 1.0;
-    }
-    else
+    offset = 0;
+    total = 0;
+    for (i = 0; i < omp_get_num_threads(); i++)
     {
-        if (sscanf(probability_str, "%f", &(node->probability)) != 1)
-        {
-            return 0;
-        }
-        if ((node->probability < 0.0) || (node->probability > 1.0))
+        if (i < thread_i)
         {
-            return 0;
+            offset += data.threads_numbers[i];
         }
+        total += data.threads_numbers[i];
     }
+    memcpy(data.fast_match_words + offset, data.threads_words + first,
+           kept_number * sizeof(int));
+    #pragma omp barrier
 
-    return 1;
+    return total;
 }
 
-int select_word_and_transcription(char *str, char **word_substr,
-                                  char **transcription_substr)
+/* This function subtracts the best_cost of the time t of the Viterbi matrix
+ * from costs of all states of active words at this time. It is used in the
+ * fixed-point mode after each time point, so costs don't grow with length of
+ * the phonemes sequence, and their sums stay exact (see calculate_beam_width()).
+ * The caller adds the best_cost to the cost_offset of the matrix, therefore
+ * total costs of hypotheses aren't changed. This function is called by all
+ * threads of the team, and each thread normalizes its part of active words.
+ */
+static void normalize_viterbi_matrix(TViterbiMatrix data, int t,
+                                     int active_words_number, float best_cost)
 {
-    int i, j;
+    int j, w, s;
+    float *costs = data.costs[t];
 
-    if ((str == NULL) || (word_substr == NULL)
-            || (transcription_substr == NULL))
+    #pragma omp for
+    for (j = 0; j < active_words_number; j++)
     {
-        return 0;
+        w = data.active_words[j];
+        for (s = data.states_offsets[w]; s <= data.last_states[w];
+             s += data.states_strides[w])
+        {
+            if (costs[s] > (-FLT_MAX + FLT_EPSILON))
+            {
+                costs[s] -= best_cost;
+            }
+        }
     }
+}
 
-    *word_substr = NULL;
-    *transcription_substr = NULL;
+/* This function calculates the next time point of the Viterbi matrix for the
+ * next phoneme (the inp_phoneme_i with the phoneme_weight) of the recognized
+ * sequence, i.e. the time t_count which is equal to the number of already
+ * calculated time points. The decision about the best word end of the previous
+ * time point is written into the traceback array, and the cost of the best
+ * word end of this time is written into the item of the time t_count (so the
+ * traceback array must be able to keep it). Alive word ends of this time are
+ * recorded into the word_ends table if it isn't NULL. If the next phoneme is
+ * the segment which lasts several time points (repeats > 1), then the time
+ * t_count corresponds to the whole segment (see update_word_by_segment()). The
+ * next_phonemes are input phonemes of following time points which are known
+ * and aren't segments (their number is next_phonemes_number, it can be zero).
+ * If word ends aren't recorded, then words which can't be continued by the
+ * first of them aren't entered at this time (see
+ * calculate_transitions_between_words()), and if the fast match is used, then
+ * only words which are selected by it are entered (see
+ * select_words_by_fast_match()).
+ *
+ * This function is called by all threads of the team (see
+ * recognize_phonemes_sequence()). Each thread calculates states of its part
+ * of words of every dense bucket and of its part of the active words list
+ * (see get_part_of_thread()), so parts of threads are fixed at each stage.
+ * Stages are separated by barriers, partial results of threads (ranges of
+ * costs, histograms and lists of words) are combined in order of threads,
+ * and serial stages are done by one thread, so results don't depend on
+ * number of threads. As result, this function returns 1 in case of success,
+ * or 0 if all hypotheses became impossible (the same value in all threads).
+ */
+static int update_viterbi_matrix(
+        TViterbiMatrix *viterbi_matrix, TTraceback traceback,
+        TWordEndsTable *word_ends, int inp_phoneme_i, float phoneme_weight,
+        int repeats, int next_phonemes[], int next_phonemes_number,
+        int phonemes_vocabulary_size, float confusion_penalties[],
+        TDecoderParameters pruning, TCompiledLanguageModel language_model)
+{
+    TViterbiMatrix data = *viterbi_matrix;
+    int active_words_number = data.active_words_number;
+    int t_count = data.times_number, t = data.times_number % 2;
+    int w, s, b, i, j, k, n, v_max, row, first, last, first_j, last_j;
+    int thread_i = omp_get_thread_num(), result = 1;
+    float cost_threshold;
+    float max_cost = -FLT_MAX, min_cost = FLT_MAX, dead_cost = data.dead_cost;
+    float *prev_costs = data.costs[1-t], *cur_costs = data.costs[t];
+    int *prev_btps = data.btps[1-t], *cur_btps = data.btps[t];
+    float *penalties;
+    int *entering_words = NULL, entering_words_number = 0;
+    //double start_time, end_time; // for debug
 
-    i = 0;
-    while (str[i] != 0)
+    //start_time = omp_get_wtime(); // for debug
+    /* buckets with many active words are calculated densely, i.e. by whole
+       rows of states (inactive words have impossible costs in both time
+       slots, so their rows remain impossible), and other buckets are
+       calculated by active words only */
+    #pragma omp single
     {
-        if (str[i] == '=')
+        for (b = 0; b < data.buckets_number; b++)
         {
-            break;
+            data.buckets_activity[b] = 0;
+        }
+        for (j = 0; j < active_words_number; j++)
+        {
+            data.buckets_activity[data.words_buckets[data.active_words[j]]]++;
+        }
+        for (b = 0; b < data.buckets_number; b++)
+        {
+            if ((repeats <= 1) && (DENSE_BUCKET_DIVISOR
+                                   * data.buckets_activity[b]
+                                   >= data.buckets_sizes[b]))
+            {
+                data.buckets_activity[b] = -1;
+            }
         }
-        i++;
     }
-    if (str[i] != '=')
-    {
-        return 0;
+    get_part_of_thread(active_words_number, THREAD_PART_ALIGNMENT, &first_j,
+                       &last_j);
+    /* penalties of states for the input phoneme are taken from the emission
+       table as one contiguous row, so the loop below only adds and compares
+       (else each thread gathers penalties of its own states) */
+    penalties = select_penalties_of_viterbi_matrix(
+                data, inp_phoneme_i, phonemes_vocabulary_size,
+                confusion_penalties, data.active_words + first_j,
+                last_j - first_j);
+    /* hypotheses with costs which aren't greater than the dead_cost were
+       pruned at the previous time, so they are considered as impossible */
+    if (repeats > 1)
+    {
+        for (j = first_j; j < last_j; j++)
+        {
+            update_word_by_segment(data, t, data.active_words[j], penalties,
+                                   phoneme_weight, repeats, dead_cost,
+                                   &max_cost, &min_cost);
+        }
     }
-
-    j = i - 1;
-    while (j >= 0)
+    else
     {
-        if ((str[j] != ' ') && (str[j] != '\t') && (str[j] != '\n')
-                && (str[j] != '\r'))
+        for (b = 0; b < data.buckets_number; b++)
         {
-            break;
+            if (data.buckets_activity[b] >= 0)
+            {
+                continue;
+            }
+            n = data.buckets_sizes[b];
+            get_part_of_thread(n, THREAD_PART_ALIGNMENT, &first, &last);
+            if (first >= last)
+            {
+                continue;
+            }
+            row = data.buckets_offsets[b] + n + first;
+            data.update_row_of_states(
+                        FIRST_STATES_ROW, prev_costs + row, prev_btps + row,
+                        NULL, NULL, penalties + row, phoneme_weight,
+                        dead_cost, last - first, cur_costs + row,
+                        cur_btps + row, &max_cost, &min_cost);
+            for (k = 2; k < data.buckets_lengths[b]; k++)
+            {
+                row += n;
+                data.update_row_of_states(
+                            MIDDLE_STATES_ROW, prev_costs + row,
+                            prev_btps + row, prev_costs + row - n,
+                            prev_btps + row - n, penalties + row,
+                            phoneme_weight, dead_cost, last - first,
+                            cur_costs + row, cur_btps + row, &max_cost,
+                            &min_cost);
+            }
+            if (data.buckets_lengths[b] > 1)
+            {
+                row += n;
+                data.update_row_of_states(
+                            LAST_STATES_ROW, prev_costs + row,
+                            prev_btps + row, cur_costs + row - n,
+                            cur_btps + row - n, penalties + row,
+                            phoneme_weight, dead_cost, last - first,
+                            cur_costs + row, cur_btps + row, &max_cost,
+                            &min_cost);
+            }
+        }
+        for (j = first_j; j < last_j; j++)
+        {
+            w = data.active_words[j];
+            if (data.buckets_activity[data.words_buckets[w]] < 0)
+            {
+                continue;
+            }
+            /* positions of the first and the last states of the word w */
+            first = data.states_offsets[w] + data.states_strides[w];
+            last = data.last_states[w];
+            update_row_of_states(FIRST_STATES_ROW, prev_costs + first,
+                                 prev_btps + first, NULL, NULL,
+                                 penalties + first, phoneme_weight, dead_cost,
+                                 1, cur_costs + first, cur_btps + first,
+                                 &max_cost, &min_cost);
+            for (s = first + data.states_strides[w]; s < last;
+                 s += data.states_strides[w])
+            {
+                update_row_of_states(
+                            MIDDLE_STATES_ROW, prev_costs + s, prev_btps + s,
+                            prev_costs + s - data.states_strides[w],
+                            prev_btps + s - data.states_strides[w],
+                            penalties + s, phoneme_weight, dead_cost, 1,
+                            cur_costs + s, cur_btps + s, &max_cost,
+                            &min_cost);
+            }
+            if (last > first)
+            {
+                update_row_of_states(
+                            LAST_STATES_ROW, prev_costs + last,
+                            prev_btps + last,
+                            cur_costs + last - data.states_strides[w],
+                            cur_btps + last - data.states_strides[w],
+                            penalties + last, phoneme_weight, dead_cost, 1,
+                            cur_costs + last, cur_btps + last, &max_cost,
+                            &min_cost);
+            }
         }
-        j--;
     }
-    j++;
-    if (j <= 0)
+    data.threads_max_costs[thread_i] = max_cost;
+    data.threads_min_costs[thread_i] = min_cost;
+    #pragma omp barrier
+    for (i = 0; i < omp_get_num_threads(); i++)
     {
-        return 0;
+        if (data.threads_max_costs[i] > max_cost)
+        {
+            max_cost = data.threads_max_costs[i];
+        }
+        if (data.threads_min_costs[i] < min_cost)
+        {
+            min_cost = data.threads_min_costs[i];
+        }
     }
-    str[j] = 0;
-    *word_substr = str;
-
-    j = i+1;
-    while (str[j] != 0)
-    {
-        if ((str[j] != ' ') && (str[j] != '\t') && (str[j] != '\n')
-                && (str[j] != '\r'))
+    //end_time = omp_get_wtime(); // for debug
+    //printf("%.4f\t", end_time - start_time); // for debug
+
+    //start_time = omp_get_wtime(); // for debug
+    cost_threshold = prune_hypotheses(data, t, active_words_number,
+                                      max_cost, min_cost, pruning,
+                                      data.histogram, data.selected_costs);
+    dead_cost = (cost_threshold > (-FLT_MAX + FLT_EPSILON))
+            ? cost_threshold : (-FLT_MAX + FLT_EPSILON);
+    //end_time = omp_get_wtime(); // for debug
+    //printf("%.4f\t", end_time - start_time); // for debug
+
+    //start_time = omp_get_wtime(); // for debug
+    if (word_ends != NULL)
+    {
+        #pragma omp single
+        record_word_ends_of_viterbi_matrix(data, t, t_count,
+                                           active_words_number, dead_cost,
+                                           word_ends);
+    }
+    if ((word_ends == NULL) && (next_phonemes_number > 0)
+            && (data.fast_match_size > 0))
+    {
+        entering_words_number = select_words_by_fast_match(
+                    data, next_phonemes, next_phonemes_number,
+                    phonemes_vocabulary_size, confusion_penalties);
+        entering_words = data.fast_match_words;
+    }
+    else if ((word_ends == NULL) && (next_phonemes_number > 0)
+             && (data.entering_words_numbers != NULL)
+             && (data.entering_words_numbers[next_phonemes[0]] >= 0))
+    {
+        entering_words = data.entering_words
+                + data.entering_words_offsets[next_phonemes[0]];
+        entering_words_number = data.entering_words_numbers[
+                next_phonemes[0]];
+    }
+    calculate_transitions_between_words(data, t, t_count,
+                                        active_words_number,
+                                        cost_threshold,
+                                        pruning.word_end_beam,
+                                        language_model, entering_words,
+                                        entering_words_number,
+                                        data.predecessors);
+    if (word_ends != NULL)
+    {
+        #pragma omp single
+        finish_word_ends_of_viterbi_matrix(data, t, pruning, data.predecessors,
+                                           word_ends);
+    }
+    active_words_number = update_active_words(data, t, cost_threshold,
+                                              &v_max);
+    //end_time = omp_get_wtime(); // for debug
+    //printf("%.4f\n", end_time - start_time); // for debug
+
+    if ((v_max < 0) || (cur_costs[data.last_states[v_max]]
+                        <= dead_cost))
+    {
+        result = 0;
+    }
+    #pragma omp single
+    {
+        viterbi_matrix->times_number = t_count + 1;
+        viterbi_matrix->active_words_number = active_words_number;
+        viterbi_matrix->dead_cost = dead_cost;
+        if (result)
         {
-            break;
+            i = t_count - 1 - traceback.first_time;
+            traceback.items[i].predecessor_word
+                    = data.words_indexes[data.predecessors[v_max]];
+            traceback.items[i].start_time = cur_btps[data.last_states[v_max]];
+            traceback.items[i+1].cost = cur_costs[data.last_states[v_max]]
+                    + data.cost_offset;
+        }
+        if (result && (pruning.fixed_point_bits > 0))
+        {
+            viterbi_matrix->dead_cost = dead_cost - max_cost;
+            viterbi_matrix->cost_offset = data.cost_offset + max_cost;
         }
-        j++;
     }
-    if (str[j] == 0)
+    if (result && (pruning.fixed_point_bits > 0))
     {
-        *word_substr = NULL;
-        return 0;
+        normalize_viterbi_matrix(data, t, active_words_number, max_cost);
     }
-    *transcription_substr = &str[j];
-    return 1;
+
+    return result;
 }
 
-int parse_transcription_str(char *transcription_str,char **phonemes_vocabulary,
-                            int phonemes_number, int phonemes_sequence[])
+/* This function writes the best word end of the last calculated time point of
+ * the Viterbi matrix into the traceback array, so that the best words sequence
+ * for all phonemes which are recognized by this moment can be found. The
+ * Viterbi matrix isn't changed, therefore recognition can be continued by the
+ * update_viterbi_matrix() function (the written item of the traceback array
+ * will be rewritten in this case). As result, this function returns 1 in case
+ * of success, or 0 if there isn't any alive word end.
+ */
+static int finish_viterbi_matrix(TViterbiMatrix data, TTraceback traceback)
 {
-    char *phoneme_name = NULL;
-    int i = 0, is_ok = 1;
+    int i, j, v, v_max = -1;
+    float *cur_costs;
+    int *cur_btps;
 
-    if ((transcription_str == NULL) || (phonemes_vocabulary == NULL)
-            || (phonemes_number <= 0) || (phonemes_sequence == NULL))
+    if (data.times_number <= 0)
     {
         return 0;
     }
-
-    phoneme_name = strtok(transcription_str, " \t");
-    if (phoneme_name == NULL)
+    cur_costs = data.costs[(data.times_number - 1) % 2];
+    cur_btps = data.btps[(data.times_number - 1) % 2];
+    for (j = 0; j < data.active_words_number; j++)
     {
-        return 0;
+        v = data.active_words[j];
+        if ((v_max < 0) || (cur_costs[data.last_states[v]]
+                            > cur_costs[data.last_states[v_max]]))
+        {
+            v_max = v;
+        }
     }
-    phonemes_sequence[i] = find_in_unsorted_vocabulary(
-                phonemes_vocabulary, phonemes_number, phoneme_name);
-    if (phonemes_sequence[i] < 0)
+    if ((v_max < 0) || (cur_costs[data.last_states[v_max]]
+                        <= data.dead_cost))
     {
         return 0;
     }
-    i++;
-    phoneme_name = strtok(NULL, " \t");
+    i = data.times_number - 1 - traceback.first_time;
+    traceback.items[i].predecessor_word = data.words_indexes[v_max];
+    traceback.items[i].start_time = cur_btps[data.last_states[v_max]];
+    traceback.items[i].cost = cur_costs[data.last_states[v_max]]
+            + data.cost_offset;
 
-    while (phoneme_name != NULL)
+    return 1;
+}
+
+static void count_nodes_of_words_tree(PWordsTreeNode node, int *nodes_number,
+                                      int *leaves_number)
+{
+    int i;
+    for (i = 0; i < node->number_of_next_nodes; i++)
     {
-        phonemes_sequence[i] = find_in_unsorted_vocabulary(
-                    phonemes_vocabulary, phonemes_number, phoneme_name);
-        if (phonemes_sequence[i] < 0)
+        if (node->next_nodes[i].node_type == WORD_NODE)
         {
-            is_ok = 0;
-            break;
+            (*leaves_number)++;
+        }
+        else if (node->next_nodes[i].node_type == PHONEME_NODE)
+        {
+            (*nodes_number)++;
+            count_nodes_of_words_tree(node->next_nodes + i, nodes_number,
+                                      leaves_number);
         }
-        i++;
-        phoneme_name = strtok(NULL, " \t");
-    }
-
-    if (!is_ok)
-    {
-        return 0;
     }
-    return i;
 }
 
-int add_word_to_words_tree(int word_index, int word_phonemes[],int word_length,
-                           PWordsTreeNode words_tree_root)
+/* This function compiles the given words tree into the flat arrays of
+ * TWordsTreeMatrix structure (see description of this structure), and it
+ * allocates memory for two time slots of costs and backtrack pointers and for
+ * buffers of pruning. As result, this function returns 1 in case of success,
+ * or 0 in case of error (if the words tree doesn't contain any word).
+ */
+static int create_words_tree_matrix(TWordsTreeMatrix* data,
+                                    PWordsTreeNode words_tree_root,
+                                    TDecoderParameters pruning)
 {
-    int is_ok = 1, i, n, next_i;
-    PWordsTreeNode next_node;
+    int t, i, n, l, q, row_size;
+    PWordsTreeNode *queue = NULL, cur;
 
-    if ((word_index < 0) || (word_phonemes == NULL) || (word_length <= 0)
-            || (words_tree_root == NULL))
+    if ((data == NULL) || (words_tree_root == NULL))
     {
         return 0;
     }
-    if (words_tree_root->node_type != INIT_NODE)
+    data->times_number = 0;
+    data->nodes_number = 0;
+    data->leaves_number = 0;
+    data->states_memory = NULL;
+    count_nodes_of_words_tree(words_tree_root, &(data->nodes_number),
+                              &(data->leaves_number));
+    if ((data->nodes_number <= 0) || (data->leaves_number <= 0))
     {
         return 0;
     }
 
-    for (i = 0; i < word_length; i++)
+    data->nodes_phonemes = malloc(sizeof(int) * data->nodes_number);
+    data->nodes_parents = malloc(sizeof(int) * data->nodes_number);
+    data->leaves_words = malloc(sizeof(int) * data->leaves_number);
+    data->leaves_nodes = malloc(sizeof(int) * data->leaves_number);
+    queue = malloc(sizeof(PWordsTreeNode) * data->nodes_number);
+    n = 0;
+    for (i = 0; i < words_tree_root->number_of_next_nodes; i++)
     {
-        if (word_phonemes[i] <= 0)
+        cur = words_tree_root->next_nodes + i;
+        if (cur->node_type == PHONEME_NODE)
         {
-            is_ok = 0;
-            break;
+            queue[n] = cur;
+            data->nodes_phonemes[n] = cur->node_data;
+            data->nodes_parents[n] = -1;
+            n++;
         }
-        n = words_tree_root->number_of_next_nodes;
-        next_i = n - 1;
-        next_node = words_tree_root->next_nodes + next_i;
-        while (next_i >= 0)
+    }
+    data->first_nodes_number = n;
+    l = 0;
+    for (q = 0; q < n; q++)
+    {
+        for (i = 0; i < queue[q]->number_of_next_nodes; i++)
         {
-            if (next_node->node_type != PHONEME_NODE)
+            cur = queue[q]->next_nodes + i;
+            if (cur->node_type == PHONEME_NODE)
             {
-                next_i--;
-                next_node--;
+                queue[n] = cur;
+                data->nodes_phonemes[n] = cur->node_data;
+                data->nodes_parents[n] = q;
+                n++;
             }
-            else
+            else if (cur->node_type == WORD_NODE)
             {
-                if (next_node->node_data == word_phonemes[i])
-                {
-                    break;
-                }
-                next_i--;
-                next_node--;
+                data->leaves_words[l] = cur->node_data;
+                data->leaves_nodes[l] = q;
+                l++;
             }
         }
-        if (next_i < 0)
-        {
-            words_tree_root->next_nodes = realloc(
-                        words_tree_root->next_nodes,
-                        (n+1) * sizeof(TWordsTreeNode));
-            next_node = words_tree_root->next_nodes + n;
-            words_tree_root->number_of_next_nodes++;
-            next_node->node_data = word_phonemes[i];
-            next_node->node_type = PHONEME_NODE;
-            next_node->number_of_next_nodes = 0;
-            next_node->next_nodes = NULL;
-        }
-        words_tree_root = next_node;
-    }
-    if (!is_ok)
-    {
-        return 0;
     }
-
-    n = words_tree_root->number_of_next_nodes;
-    next_i = n - 1;
-    next_node = words_tree_root->next_nodes + next_i;
-    while (next_i >= 0)
+    free(queue);
+
+    data->states_number = data->nodes_number + data->leaves_number;
+    row_size = MEMORY_ALIGNMENT / sizeof(float);
+    row_size = ((data->states_number + row_size - 1) / row_size) * row_size;
+    data->states_memory = malloc_aligned_memory(
+                row_size * (3 * sizeof(float) + 2 * sizeof(int)));
+    data->costs[0] = (float*)data->states_memory;
+    data->costs[1] = data->costs[0] + row_size;
+    data->btps[0] = (int*)(data->costs[1] + row_size);
+    data->btps[1] = data->btps[0] + row_size;
+    data->penalties = (float*)(data->btps[1] + row_size);
+    data->emission_table = NULL;
+    data->emission_row_size = 0;
+    data->lookahead_scores = NULL;
+    for (t = 0; t < 2; t++)
     {
-        if (next_node->node_type == WORD_NODE)
+        for (i = 0; i < data->states_number; i++)
         {
-            break;
+            data->costs[t][i] = -FLT_MAX;
+            data->btps[t][i] = -1;
         }
-        next_i--;
-        next_node--;
     }
-    if (next_i >= 0)
+    data->dead_cost = -FLT_MAX + FLT_EPSILON;
+    data->cost_offset = 0.0;
+    data->histogram = malloc(sizeof(int) * pruning.histogram_size);
+    data->selected_costs = NULL;
+    if (pruning.max_active_hypotheses > 0)
     {
-        if (next_node->node_data != word_index)
-        {
-            return 0;
-        }
-        return 1;
+        data->selected_costs = malloc(sizeof(float) * data->states_number);
     }
 
-    words_tree_root->next_nodes = realloc(
-                words_tree_root->next_nodes, (n+1) * sizeof(TWordsTreeNode));
-    next_node = words_tree_root->next_nodes + n;
-    words_tree_root->number_of_next_nodes++;
-    next_node->node_data = word_index;
-    next_node->node_type = WORD_NODE;
-    next_node->number_of_next_nodes = 0;
-    next_node->next_nodes = NULL;
     return 1;
 }
 
-void free_words_tree_node(PWordsTreeNode deleted_node)
+/* This function frees all memory which was allocated for the compiled words
+ * tree.
+ */
+static void delete_words_tree_matrix(TWordsTreeMatrix* data)
 {
-    PWordsTreeNode next_node = NULL;
-    int i;
-
-    if (deleted_node == NULL)
+    if (data == NULL)
     {
         return;
     }
-
-    if ((deleted_node->number_of_next_nodes > 0) && (deleted_node->next_nodes != NULL))
+    if (data->states_memory == NULL)
     {
-        for (i = 0; i < deleted_node->number_of_next_nodes; i++)
-        {
-            next_node = deleted_node->next_nodes + i;
-            free_words_tree_node(next_node);
-        }
-        free(deleted_node->next_nodes);
-        deleted_node->next_nodes = NULL;
+        return;
     }
+    free_aligned_memory(data->states_memory);
+    data->states_memory = NULL;
+    data->costs[0] = NULL;
+    data->costs[1] = NULL;
+    data->btps[0] = NULL;
+    data->btps[1] = NULL;
+    free(data->nodes_phonemes);
+    data->nodes_phonemes = NULL;
+    free(data->nodes_parents);
+    data->nodes_parents = NULL;
+    free(data->leaves_words);
+    data->leaves_words = NULL;
+    free(data->leaves_nodes);
+    data->leaves_nodes = NULL;
+    free(data->histogram);
+    data->histogram = NULL;
+    if (data->selected_costs != NULL)
+    {
+        free(data->selected_costs);
+        data->selected_costs = NULL;
+    }
+    data->nodes_number = 0;
+    data->first_nodes_number = 0;
+    data->leaves_number = 0;
+    data->states_number = 0;
+    data->times_number = 0;
 }
 
-int load_phonemes_MLF(char *mlf_name, char **phonemes_vocabulary,
-                      int phonemes_number, TMLFFilePart **mlf_data)
+/* This function prunes hypotheses of the compiled words tree at the time t like
+ * the prune_hypotheses() function, but by pruning costs, i.e. by costs plus
+ * scores of the language model lookahead. The max_cost and the min_cost are
+ * maximal and minimal pruning costs of alive hypotheses at the time t. As
+ * result, this function returns the threshold of pruning costs, or -FLT_MAX if
+ * nothing is pruned.
+ */
+static float prune_words_tree_hypotheses(TWordsTreeMatrix data, int t,
+                                         float max_cost, float min_cost,
+                                         TDecoderParameters pruning,
+                                         int histogram[],
+                                         float selected_costs[])
 {
-    int buffer_size = 0, n_files = 0, n_transcription = 0;
-    int reading_state = HEADER_EXPECTATION_STATE;
-    int is_ok = 1;
-    char buffer[BUFFER_SIZE];
-    FILE *mlf_file = NULL;
-    TMLFFilePart *cur_mlf_part = NULL;
-    TTranscriptionNode new_node;
-    PTranscriptionNode last_node_ptr = NULL;
+    int s;
+    float *costs = data.costs[t], *lookahead = data.lookahead_scores;
+    float cost, cost_threshold = -FLT_MAX + FLT_EPSILON, bins_per_cost = 0.0;
+    int number_of_alive_hypotheses = 0, number_of_selected_hypotheses = 0;
+    int max_number_of_unpruned_hypotheses = data.states_number;
+    float beam_width = calculate_beam_width(pruning);
 
-    if ((mlf_data == NULL) || (mlf_name == NULL)
-            || (phonemes_vocabulary == NULL) || (phonemes_number <= 0))
+    if (max_cost <= (-FLT_MAX + FLT_EPSILON))
     {
-        return 0;
+        return -FLT_MAX;
+    }
+    if ((beam_width > 0.0) && ((max_cost - beam_width) > cost_threshold))
+    {
+        cost_threshold = max_cost - beam_width;
+        if (min_cost < cost_threshold)
+        {
+            min_cost = cost_threshold;
+        }
+    }
+    if (pruning.pruning_coeff > 0.0)
+    {
+        max_number_of_unpruned_hypotheses = (int)floor(
+                    (1.0 - pruning.pruning_coeff) * data.states_number + 0.5);
+        if ((max_number_of_unpruned_hypotheses < data.states_number)
+                && ((max_cost - min_cost) > FLT_EPSILON))
+        {
+            memset(histogram, 0, pruning.histogram_size * sizeof(int));
+            bins_per_cost = (pruning.histogram_size - 1)
+                    / (max_cost - min_cost);
+        }
     }
 
-    *mlf_data = NULL;
-    new_node.start_time = 0;
-    new_node.end_time = 0;
-    new_node.probability = 1.0;
-    new_node.node_data = -1;
+    if ((bins_per_cost > 0.0) || (pruning.max_active_hypotheses > 0))
+    {
+        for (s = 0; s < data.states_number; s++)
+        {
+            cost = costs[s] + lookahead[s];
+            if (cost <= cost_threshold)
+            {
+                continue;
+            }
+            if (bins_per_cost > 0.0)
+            {
+                add_cost_to_histogram(histogram, pruning.histogram_size,
+                                      max_cost, bins_per_cost, cost);
+                number_of_alive_hypotheses++;
+            }
+            if (pruning.max_active_hypotheses > 0)
+            {
+                selected_costs[number_of_selected_hypotheses++] = cost;
+            }
+        }
+        cost_threshold = limit_number_of_hypotheses(
+                    pruning, cost_threshold, histogram, max_cost,
+                    bins_per_cost, number_of_alive_hypotheses,
+                    max_number_of_unpruned_hypotheses, selected_costs,
+                    number_of_selected_hypotheses);
+    }
 
-    mlf_file = fopen(mlf_name, "r");
-    if (mlf_file == NULL)
+    return (cost_threshold > (-FLT_MAX + FLT_EPSILON))
+            ? cost_threshold : -FLT_MAX;
+}
+
+/* This function returns penalties of confusions of phonemes of all states of
+ * the compiled words tree with the input phoneme inp_phoneme_i (pause states
+ * of leaves correspond to the pause phoneme 0), like
+ * select_penalties_of_viterbi_matrix() does it for the Viterbi matrix. If the
+ * emission table isn't created, then penalties of all states are gathered
+ * into the penalties array of the matrix.
+ */
+static float *select_penalties_of_words_tree_matrix(
+        TWordsTreeMatrix data, int inp_phoneme_i, int phonemes_vocabulary_size,
+        float confusion_penalties[])
+{
+    int s;
+
+    if (data.emission_table != NULL)
     {
-        return 0;
+        return data.emission_table + inp_phoneme_i * data.emission_row_size;
     }
-    while (!feof(mlf_file))
+    for (s = 0; s < data.nodes_number; s++)
     {
-        buffer_size = read_string(mlf_file, buffer);
-        if (buffer_size <= 0)
+        data.penalties[s] = confusion_penalties[
+                data.nodes_phonemes[s] * phonemes_vocabulary_size
+                + inp_phoneme_i];
+    }
+    for (s = data.nodes_number; s < data.states_number; s++)
+    {
+        data.penalties[s] = confusion_penalties[inp_phoneme_i];
+    }
+    return data.penalties;
+}
+
+/* This function calculates the phoneme node n of the compiled words tree at
+ * the time t for the segment, i.e. for the input phoneme (its penalties of
+ * states are given) which lasts the given number of time points (repeats > 1),
+ * like
+ * update_word_by_segment() does it for states of linear words: the best path
+ * over these time points begins in the node a (the node n or one of its
+ * repeats-1 nearest ancestors), which continues the hypothesis of the previous
+ * time in this node or in its parent, and passes all nodes from a to n. Range
+ * of alive pruning costs is corrected by the calculated node.
+ */
+static void update_words_tree_node_by_segment(
+        TWordsTreeMatrix data, int t, int n, float penalties[],
+        float phoneme_weight, int repeats, float dead_cost,
+        float *max_cost, float *min_cost)
+{
+    int a, k, parent, btp, best_btp = -1;
+    float cost, best_cost = -FLT_MAX, sum_of_costs = 0.0;
+    float max_of_costs = -FLT_MAX, point_cost;
+    float *prev_costs = data.costs[1-t];
+    float *lookahead = data.lookahead_scores;
+    int *prev_btps = data.btps[1-t];
+
+    for (a = n, k = 0; (a >= 0) && (k < repeats); a = parent, k++)
+    {
+        parent = data.nodes_parents[a];
+        point_cost = calculate_cost_of_time_point(penalties[a],
+                                                  phoneme_weight);
+        if (point_cost <= (-FLT_MAX + FLT_EPSILON))
+        {
+            break;
+        }
+        sum_of_costs += point_cost;
+        if (point_cost > max_of_costs)
+        {
+            max_of_costs = point_cost;
+        }
+        cost = -FLT_MAX;
+        btp = -1;
+        if ((parent >= 0)
+                && ((prev_costs[parent] + lookahead[parent]) > dead_cost))
+        {
+            cost = prev_costs[parent];
+            btp = prev_btps[parent];
+        }
+        if (((prev_costs[a] + lookahead[a]) > dead_cost)
+                && (prev_costs[a] > cost))
+        {
+            cost = prev_costs[a];
+            btp = prev_btps[a];
+        }
+        if (cost <= (-FLT_MAX + FLT_EPSILON))
         {
             continue;
         }
-        switch (reading_state)
+        cost += sum_of_costs + (repeats - k - 1) * max_of_costs;
+        if (cost > best_cost)
         {
-        case FILENAME_READING_STATE:
-            buffer_size = prepare_filename(buffer);
-            if (buffer_size <= 0)
+            best_cost = cost;
+            best_btp = btp;
+        }
+    }
+    data.costs[t][n] = best_cost;
+    data.btps[t][n] = best_btp;
+    if (best_cost > (-FLT_MAX + FLT_EPSILON))
+    {
+        update_range_of_costs(best_cost + lookahead[n], max_cost, min_cost);
+    }
+}
+
+/* This function calculates the pause state of the leaf l of the compiled words
+ * tree at the time t for the segment (see update_words_tree_node_by_segment()).
+ * The pause state either takes the hypothesis of the leaf node at the same
+ * time (the pause is skipped), or it ends the best path over the segment which
+ * begins in the pause state itself (this state continues its own hypothesis
+ * only) or in one of repeats-1 nearest nodes before it. Range of alive pruning
+ * costs and the best pruning cost of word ends are corrected by the calculated
+ * state.
+ */
+static void update_words_tree_leaf_by_segment(
+        TWordsTreeMatrix data, int t, int l, float penalties[],
+        float phoneme_weight, int repeats, float dead_cost,
+        float *max_cost, float *min_cost, float *best_word_end_cost)
+{
+    int s = data.nodes_number + l, a, k, parent, btp, best_btp = -1;
+    float cost, best_cost = -FLT_MAX, sum_of_costs, max_of_costs, point_cost;
+    float *prev_costs = data.costs[1-t], *cur_costs = data.costs[t];
+    float *lookahead = data.lookahead_scores;
+    int *prev_btps = data.btps[1-t];
+
+    point_cost = calculate_cost_of_time_point(penalties[s], phoneme_weight);
+    if (point_cost > (-FLT_MAX + FLT_EPSILON))
+    {
+        sum_of_costs = point_cost;
+        max_of_costs = point_cost;
+        if ((prev_costs[s] + lookahead[s]) > dead_cost)
+        {
+            best_cost = prev_costs[s];
+            best_cost += sum_of_costs + (repeats - 1) * max_of_costs;
+            best_btp = prev_btps[s];
+        }
+        a = data.leaves_nodes[l];
+        for (k = 1; (a >= 0) && (k < repeats); a = parent, k++)
+        {
+            parent = data.nodes_parents[a];
+            point_cost = calculate_cost_of_time_point(penalties[a],
+                                                      phoneme_weight);
+            if (point_cost <= (-FLT_MAX + FLT_EPSILON))
             {
-                is_ok = 0;
                 break;
             }
-            n_files++;
-            *mlf_data = realloc(*mlf_data, n_files * sizeof(TMLFFilePart));
-            cur_mlf_part = *mlf_data + n_files - 1;
-            cur_mlf_part->name = malloc((buffer_size+1) * sizeof(char));
-            memset(cur_mlf_part->name, 0, buffer_size+1);
-            strcpy(cur_mlf_part->name, buffer);
-            cur_mlf_part->transcription = NULL;
-            cur_mlf_part->transcription_size = 0;
-            last_node_ptr = NULL;
-            n_transcription = 0;
-            reading_state = EVENT_READING_STATE;
-            break;
-        case EVENT_READING_STATE:
-            if (strcmp(buffer, ".") == 0)
+            sum_of_costs += point_cost;
+            if (point_cost > max_of_costs)
             {
-                if (n_transcription <= 0)
-                {
-                    is_ok = 0;
-                }
-                else
-                {
-                    reading_state = FILENAME_READING_STATE;
-                }
+                max_of_costs = point_cost;
             }
-            else
+            cost = -FLT_MAX;
+            btp = -1;
+            if ((parent >= 0)
+                    && ((prev_costs[parent] + lookahead[parent]) > dead_cost))
             {
-                if (!string_to_transcription_node(buffer, phonemes_vocabulary,
-                                                  phonemes_number, &new_node))
-                {
-                    is_ok = 0;
-                }
-                else
-                {
-                    if (last_node_ptr != NULL)
-                    {
-                        if (last_node_ptr->end_time > new_node.start_time)
-                        {
-                            is_ok = 0;
-                        }
-                    }
-                }
-                if (is_ok)
-                {
-                    n_transcription++;
-                    cur_mlf_part->transcription_size++;
-                    cur_mlf_part->transcription = realloc(
-                                cur_mlf_part->transcription,
-                                n_transcription * sizeof(TTranscriptionNode));
-                    cur_mlf_part->transcription[n_transcription-1] = new_node;
-                    last_node_ptr = cur_mlf_part->transcription
-                            + n_transcription - 1;
-                }
+                cost = prev_costs[parent];
+                btp = prev_btps[parent];
             }
-            break;
-        default:
-            if (strcmp(buffer, MLF_HEADER) != 0)
+            if (((prev_costs[a] + lookahead[a]) > dead_cost)
+                    && (prev_costs[a] > cost))
             {
-                is_ok = 0;
+                cost = prev_costs[a];
+                btp = prev_btps[a];
             }
-            else
+            if (cost <= (-FLT_MAX + FLT_EPSILON))
             {
-                reading_state = FILENAME_READING_STATE;
+                continue;
+            }
+            cost += sum_of_costs + (repeats - k - 1) * max_of_costs;
+            if (cost > best_cost)
+            {
+                best_cost = cost;
+                best_btp = btp;
             }
-        }
-        if (!is_ok)
-        {
-            break;
         }
     }
-    fclose(mlf_file);
-    if (is_ok)
+    a = data.leaves_nodes[l];
+    if ((cur_costs[a] > (-FLT_MAX + FLT_EPSILON))
+            && (cur_costs[a] >= best_cost))
     {
-        if (reading_state != FILENAME_READING_STATE)
+        best_cost = cur_costs[a];
+        best_btp = data.btps[t][a];
+    }
+    cur_costs[s] = best_cost;
+    data.btps[t][s] = best_btp;
+    if (best_cost > (-FLT_MAX + FLT_EPSILON))
+    {
+        best_cost += lookahead[s];
+        update_range_of_costs(best_cost, max_cost, min_cost);
+        if (best_cost > *best_word_end_cost)
         {
-            is_ok = 0;
+            *best_word_end_cost = best_cost;
         }
     }
+}
 
-    if (!is_ok)
+/* This function starts recognition of new phonemes sequence by the compiled
+ * words tree: all cells of the first time slot are initialized, and
+ * hypotheses of nodes which follow the root node are calculated for the first
+ * phoneme (the inp_phoneme_i with the phoneme_weight) of the sequence. If this
+ * phoneme is the segment which lasts several time points (repeats > 1), then
+ * nodes which are not deeper than repeats are calculated too (see
+ * start_viterbi_matrix()).
+ */
+static void start_words_tree_matrix(
+        TWordsTreeMatrix *words_tree_matrix, int inp_phoneme_i,
+        float phoneme_weight, int repeats, int phonemes_vocabulary_size,
+        float confusion_penalties[])
+{
+    TWordsTreeMatrix data = *words_tree_matrix;
+    int n, a, k, s;
+    float point_cost, sum_of_costs, max_of_costs;
+    float *penalties = select_penalties_of_words_tree_matrix(
+                data, inp_phoneme_i, phonemes_vocabulary_size,
+                confusion_penalties);
+
+    for (s = 0; s < data.states_number; s++)
     {
-        free_MLF(mlf_data, n_files);
-        n_files = 0;
+        data.costs[0][s] = -FLT_MAX;
+        data.btps[0][s] = -1;
     }
-    return n_files;
+    for (n = 0; n < data.nodes_number; n++)
+    {
+        sum_of_costs = 0.0;
+        max_of_costs = -FLT_MAX;
+        for (a = n, k = 0; (a >= 0) && (k < repeats);
+             a = data.nodes_parents[a], k++)
+        {
+            point_cost = calculate_cost_of_time_point(penalties[a],
+                                                      phoneme_weight);
+            if (point_cost <= (-FLT_MAX + FLT_EPSILON))
+            {
+                break;
+            }
+            sum_of_costs += point_cost;
+            if (point_cost > max_of_costs)
+            {
+                max_of_costs = point_cost;
+            }
+        }
+        if (a < 0)
+        {
+            data.costs[0][n] = sum_of_costs + (repeats - k) * max_of_costs;
+        }
+    }
+
+    words_tree_matrix->times_number = 1;
+    words_tree_matrix->dead_cost = -FLT_MAX + FLT_EPSILON;
+    words_tree_matrix->cost_offset = 0.0;
 }
 
-int load_words_MLF(char *mlf_name, char **words_vocabulary, int words_number,
-                   TMLFFilePart **mlf_data)
+/* This function implements one time step of the Viterbi Beam Search over the
+ * compiled words tree. Words with common beginning of transcription share
+ * phoneme nodes, so each phoneme node is scored once for all these words. The
+ * language model isn't known until the word node, therefore hypotheses in
+ * phoneme nodes are scored acoustically only, and each hypothesis keeps time
+ * of the end of its predecessor word as backtrack pointer. The bigram
+ * probability for the predecessor word and the current word is applied at the
+ * word end. Besides, hypotheses are pruned by pruning costs, i.e. by their
+ * costs plus lookahead scores of their states (see create_lookahead_scores()),
+ * so pruning takes into account the best language model score which is
+ * reachable from each node. Lookahead scores aren't included into costs
+ * themselves, therefore costs of hypotheses and word ends are the same as
+ * without lookahead (unless hypotheses are pruned differently).
+ *
+ * The calculated time t_count is equal to the number of already calculated
+ * time points, and the next phoneme of the recognized sequence is the
+ * inp_phoneme_i with the phoneme_weight. The best word end of the time t_count
+ * is written into the traceback array (so it must be able to keep the item of
+ * the time t_count): its predecessor_word is this word, its start_time is the
+ * backtrack pointer plus one, so that get_words_sequence_by_traceback() can
+ * walk from the last time to the first one, and its cost is the cost of this
+ * word end. Also this best word end is the
+ * only source of transitions into nodes which follow the root node at the time
+ * t_count. Alive word ends of this time are recorded into the word_ends table
+ * if it isn't NULL. If the next phoneme is the segment which lasts several
+ * time points (repeats > 1), then the time t_count corresponds to the whole
+ * segment (see update_words_tree_node_by_segment()). As result, this function
+ * returns 1 in case of success, or 0 if there isn't any alive word end.
+ */
+static int update_words_tree_matrix(
+        TWordsTreeMatrix *words_tree_matrix, TTraceback traceback,
+        TWordEndsTable *word_ends, int inp_phoneme_i, float phoneme_weight,
+        int repeats, int phonemes_vocabulary_size, float confusion_penalties[],
+        TDecoderParameters pruning, TCompiledLanguageModel language_model)
 {
-    int buffer_size = 0, n_files = 0, n_transcription = 0;
-    int reading_state = HEADER_EXPECTATION_STATE;
-    int is_ok = 1;
-    char buffer[BUFFER_SIZE];
-    FILE *mlf_file = NULL;
-    TMLFFilePart *cur_mlf_part = NULL;
-    TTranscriptionNode new_node;
+    TWordsTreeMatrix data = *words_tree_matrix;
+    int t_count = data.times_number, t = data.times_number % 2;
+    int n, l, i, s, parent, best_leaf;
+    float tmp_val1, tmp_val2, tmp_d, cost, best_cost, cost_threshold;
+    float score, max_cost = -FLT_MAX, min_cost = FLT_MAX;
+    float dead_cost = data.dead_cost;
+    float best_word_end_cost, word_end_dead_cost;
+    float *prev_costs = data.costs[1-t], *cur_costs = data.costs[t];
+    float *lookahead = data.lookahead_scores;
+    int *prev_btps = data.btps[1-t], *cur_btps = data.btps[t];
+    float *penalties = select_penalties_of_words_tree_matrix(
+                data, inp_phoneme_i, phonemes_vocabulary_size,
+                confusion_penalties);
+
+    /* hypotheses with costs which aren't greater than the dead_cost were
+       pruned at the previous time, so they are considered as impossible */
+    for (n = 0; n < data.nodes_number; n++)
+    {
+        if (repeats > 1)
+        {
+            update_words_tree_node_by_segment(
+                        data, t, n, penalties, phoneme_weight, repeats,
+                        dead_cost, &max_cost, &min_cost);
+            continue;
+        }
+        tmp_val1 = -FLT_MAX;
+        tmp_val2 = -FLT_MAX;
+        if (penalties[n] > (-FLT_MAX + FLT_EPSILON))
+        {
+            tmp_d = phoneme_weight + penalties[n];
+            parent = data.nodes_parents[n];
+            if ((parent >= 0)
+                    && ((prev_costs[parent] + lookahead[parent]) > dead_cost))
+            {
+                tmp_val1 = prev_costs[parent] + tmp_d;
+            }
+            if ((prev_costs[n] + lookahead[n]) > dead_cost)
+            {
+                tmp_val2 = prev_costs[n] + tmp_d;
+            }
+        }
+        if ((tmp_val1 > (-FLT_MAX + FLT_EPSILON)) && (tmp_val1 >= tmp_val2))
+        {
+            cur_costs[n] = tmp_val1;
+            cur_btps[n] = prev_btps[data.nodes_parents[n]];
+        }
+        else if (tmp_val2 > (-FLT_MAX + FLT_EPSILON))
+        {
+            cur_costs[n] = tmp_val2;
+            cur_btps[n] = prev_btps[n];
+        }
+        else
+        {
+            cur_costs[n] = -FLT_MAX;
+            cur_btps[n] = -1;
+            continue;
+        }
+        cost = cur_costs[n] + lookahead[n];
+        if (cost > max_cost)
+        {
+            max_cost = cost;
+        }
+        if (cost < min_cost)
+        {
+            min_cost = cost;
+        }
+    }
 
-    if ((mlf_data == NULL) || (mlf_name == NULL) || (words_vocabulary == NULL)
-            || (words_number <= 0))
+    /* pause states which follow the last phonemes of words */
+    best_word_end_cost = -FLT_MAX;
+    for (l = 0; l < data.leaves_number; l++)
     {
-        return 0;
+        if (repeats > 1)
+        {
+            update_words_tree_leaf_by_segment(
+                        data, t, l, penalties, phoneme_weight, repeats,
+                        dead_cost, &max_cost, &min_cost, &best_word_end_cost);
+            continue;
+        }
+        n = data.leaves_nodes[l];
+        s = data.nodes_number + l;
+        tmp_val1 = cur_costs[n];
+        tmp_val2 = -FLT_MAX;
+        if (((prev_costs[s] + lookahead[s]) > dead_cost)
+                && (penalties[s] > (-FLT_MAX + FLT_EPSILON)))
+        {
+            tmp_val2 = prev_costs[s] + phoneme_weight + penalties[s];
+        }
+        if (tmp_val1 >= tmp_val2)
+        {
+            cur_costs[s] = tmp_val1;
+            cur_btps[s] = cur_btps[n];
+        }
+        else
+        {
+            cur_costs[s] = tmp_val2;
+            cur_btps[s] = prev_btps[s];
+        }
+        if (cur_costs[s] > (-FLT_MAX + FLT_EPSILON))
+        {
+            cost = cur_costs[s] + lookahead[s];
+            if (cost > max_cost)
+            {
+                max_cost = cost;
+            }
+            if (cost < min_cost)
+            {
+                min_cost = cost;
+            }
+            if (cost > best_word_end_cost)
+            {
+                best_word_end_cost = cost;
+            }
+        }
     }
 
-    *mlf_data = NULL;
-    new_node.start_time = 0;
-    new_node.end_time = 0;
-    new_node.probability = 1.0;
-    new_node.node_data = -1;
+    cost_threshold = prune_words_tree_hypotheses(
+                data, t, max_cost, min_cost, pruning, data.histogram,
+                data.selected_costs);
+    dead_cost = (cost_threshold > (-FLT_MAX + FLT_EPSILON))
+            ? cost_threshold : (-FLT_MAX + FLT_EPSILON);
+    word_end_dead_cost = dead_cost;
+    if ((pruning.word_end_beam > 0.0) && ((best_word_end_cost
+                                           - pruning.word_end_beam)
+                                          > word_end_dead_cost))
+    {
+        word_end_dead_cost = best_word_end_cost - pruning.word_end_beam;
+    }
+    words_tree_matrix->times_number = t_count + 1;
+    words_tree_matrix->dead_cost = dead_cost;
 
-    mlf_file = fopen(mlf_name, "r");
-    if (mlf_file == NULL)
+    /* word ends with language model */
+    best_leaf = -1;
+    best_cost = -FLT_MAX;
+    if (word_ends != NULL)
     {
-        return 0;
+        start_word_ends_of_time(word_ends, t_count, data.cost_offset);
     }
-    while (!feof(mlf_file))
+    for (l = 0; l < data.leaves_number; l++)
     {
-        buffer_size = read_string(mlf_file, buffer);
-        if (buffer_size <= 0)
+        s = data.nodes_number + l;
+        cost = cur_costs[s];
+        if ((cost + lookahead[s]) <= word_end_dead_cost)
         {
             continue;
         }
-        switch (reading_state)
+        if (cur_btps[s] >= 0)
         {
-        case FILENAME_READING_STATE:
-            buffer_size = prepare_filename(buffer);
-            if (buffer_size <= 0)
+            i = cur_btps[s] - traceback.first_time;
+            score = get_bigram_score(language_model,
+                                     traceback.items[i].predecessor_word,
+                                     data.leaves_words[l]);
+            if (score <= MIN_TRANSITION_SCORE)
             {
-                is_ok = 0;
-                break;
+                continue;
             }
-            n_files++;
-            *mlf_data = realloc(*mlf_data, n_files * sizeof(TMLFFilePart));
-            cur_mlf_part = *mlf_data + n_files - 1;
-            cur_mlf_part->name = malloc((buffer_size+1) * sizeof(char));
-            memset(cur_mlf_part->name, 0, buffer_size+1);
-            strcpy(cur_mlf_part->name, buffer);
-            cur_mlf_part->transcription = NULL;
-            cur_mlf_part->transcription_size = 0;
-            n_transcription = 0;
-            reading_state = EVENT_READING_STATE;
+            cost += score;
+        }
+        if (word_ends != NULL)
+        {
+            add_word_end(word_ends, data.leaves_words[l], cur_btps[s], cost);
+        }
+        if ((best_leaf < 0) || (cost > best_cost)
+                || ((cost == best_cost) && (data.leaves_words[l]
+                                            < data.leaves_words[best_leaf])))
+        {
+            best_cost = cost;
+            best_leaf = l;
+        }
+    }
+    if (word_ends != NULL)
+    {
+        finish_word_ends_of_time(word_ends, pruning.lattice_beam,
+                                 pruning.lattice_size, NULL);
+    }
+    if (best_leaf < 0)
+    {
+        return 0;
+    }
+    s = data.nodes_number + best_leaf;
+    i = t_count - traceback.first_time;
+    traceback.items[i].predecessor_word = data.leaves_words[best_leaf];
+    traceback.items[i].start_time = cur_btps[s] + 1;
+    traceback.items[i].cost = best_cost + data.cost_offset;
+
+    /* transitions from the best word end into the words tree */
+    for (n = 0; n < data.first_nodes_number; n++)
+    {
+        if (((best_cost + lookahead[n]) > cost_threshold)
+                && (best_cost > cur_costs[n]))
+        {
+            cur_costs[n] = best_cost;
+            cur_btps[n] = t_count;
+        }
+    }
+
+    /* costs are normalized by the best one in the fixed-point mode (see
+       normalize_viterbi_matrix()) */
+    if (pruning.fixed_point_bits > 0)
+    {
+        for (s = 0; s < data.states_number; s++)
+        {
+            if (cur_costs[s] > (-FLT_MAX + FLT_EPSILON))
+            {
+                cur_costs[s] -= max_cost;
+            }
+        }
+        words_tree_matrix->dead_cost = dead_cost - max_cost;
+        words_tree_matrix->cost_offset = data.cost_offset + max_cost;
+    }
+
+    return 1;
+}
+
+/* This function sets the score of the word which is the difference of costs
+ * of two word ends, i.e. the log10-probability of this word. Its probability
+ * is calculated by this score, and it can be zero because of underflow. */
+static void set_score_of_word(TTranscriptionNode *word, float score)
+{
+    word->score = score;
+    word->probability = (float)pow(10.0, score);
+}
+
+/* This function finds the words sequence by the traceback array, walking from
+ * the item of the last_time to the first one. Committed items aren't used, so
+ * the found words sequence follows the committed words sequence. The word of
+ * each used item takes time points from the start time of this item to the
+ * time of this item, and its score is difference between costs of the best
+ * word ends of this time and of the time before its start (or the end of the
+ * committed words sequence). Therefore times and scores of found words are
+ * calculated by bounds of frames and by costs of items. As result, this
+ * function returns length of the found words sequence.
+ */
+static int get_words_sequence_by_traceback(
+        TTraceback traceback, int last_time,
+        TTranscriptionNode recognized_words_sequence[])
+{
+    int i = last_time, n = 0, start_time;
+    double cost = 0.0;
+    TTracebackArrayItem *item;
+    TTranscriptionNode tmp;
+
+    while (i >= traceback.first_time)
+    {
+        item = traceback.items + (i - traceback.first_time);
+        if (item->start_time < 0)
+        {
             break;
-        case EVENT_READING_STATE:
-            if (strcmp(buffer, ".") == 0)
+        }
+        start_time = (item->start_time > traceback.first_time)
+                ? item->start_time : traceback.first_time;
+        recognized_words_sequence[n].node_data = item->predecessor_word;
+        recognized_words_sequence[n].start_time = traceback.items[
+                start_time - traceback.first_time].frame_start_time;
+        recognized_words_sequence[n].end_time = item->frame_end_time;
+        /* the score of the word is known when the previous word is found */
+        if (n > 0)
+        {
+            set_score_of_word(recognized_words_sequence + n - 1,
+                              (float)(cost - item->cost));
+        }
+        cost = item->cost;
+        n++;
+        i = item->start_time - 1;
+    }
+    if (n > 0)
+    {
+        set_score_of_word(recognized_words_sequence + n - 1,
+                          (float)(cost - traceback.committed_cost));
+    }
+
+    for (i = 0; i < (n / 2); i++)
+    {
+        tmp = recognized_words_sequence[i];
+        recognized_words_sequence[i] = recognized_words_sequence[n-i-1];
+        recognized_words_sequence[n-i-1] = tmp;
+    }
+
+    return n;
+}
+
+/* This function calculates number of frames (of the frame_duration from the
+ * decoder parameters) which correspond to the given node of phonemes
+ * transcription. Each phoneme takes one frame at least, and long phonemes are
+ * limited by the max_repeats_of_phoneme frames. */
+static int calculate_number_of_frames(TTranscriptionNode transcription_node,
+                                      TDecoderParameters parameters)
+{
+    int number_of_steps_10ms = (int)floor((transcription_node.end_time
+                                           - transcription_node.start_time)
+                                          / parameters.frame_duration + 0.5);
+    if (number_of_steps_10ms > parameters.max_repeats_of_phoneme)
+    {
+        number_of_steps_10ms = parameters.max_repeats_of_phoneme;
+    }
+    else
+    {
+        if (number_of_steps_10ms < 1)
+        {
+            number_of_steps_10ms = 1;
+        }
+    }
+    return number_of_steps_10ms;
+}
+
+/* This function calculates number of time points which correspond to the
+ * given node of phonemes transcription. If frames are used, then each frame
+ * is the separate time point (see calculate_number_of_frames()). If segments
+ * are used, then the whole node is the single time point, and its number of
+ * frames is written into the repeats. */
+static int calculate_number_of_time_points(
+        TTranscriptionNode transcription_node, TDecoderParameters parameters,
+        int *repeats)
+{
+    int number_of_frames = calculate_number_of_frames(transcription_node,
+                                                      parameters);
+    if (parameters.use_segments)
+    {
+        *repeats = number_of_frames;
+        return 1;
+    }
+    *repeats = 1;
+    return number_of_frames;
+}
+
+/* This function rounds the score (decimal logarithm) to the nearest multiple
+ * of 2^(-fixed_point_bits), if the fixed-point mode is used (see
+ * TDecoderParameters). Such multiples are added exactly, so costs of
+ * hypotheses don't depend on order of additions. Impossible scores (-FLT_MAX)
+ * aren't changed. */
+static float quantize_score(float score, int fixed_point_bits)
+{
+    if ((fixed_point_bits <= 0) || (score <= (-FLT_MAX + FLT_EPSILON)))
+    {
+        return score;
+    }
+    return (float)ldexp(floor(ldexp(score, fixed_point_bits) + 0.5),
+                        -fixed_point_bits);
+}
+
+/* This function calculates bounds (in 100ns units) of the time point with the
+ * frame_index of the transcription node which takes number_of_frames time
+ * points (see calculate_number_of_frames()). Time of the node is divided into
+ * equal parts between its time points. */
+static void calculate_bounds_of_frame(
+        TTranscriptionNode transcription_node, int number_of_frames,
+        int frame_index, long unsigned *frame_start_time,
+        long unsigned *frame_end_time)
+{
+    long unsigned duration = 0;
+
+    if (transcription_node.end_time > transcription_node.start_time)
+    {
+        duration = transcription_node.end_time
+                - transcription_node.start_time;
+    }
+    *frame_start_time = transcription_node.start_time
+            + duration * frame_index / number_of_frames;
+    *frame_end_time = transcription_node.start_time
+            + duration * (frame_index + 1) / number_of_frames;
+}
+
+/* This function expands the phonemes transcription into the sequence of time
+ * points (see calculate_number_of_time_points()), skipping pauses in the
+ * beginning and in the end of transcription. Phonemes, their weights, their
+ * numbers of frames (repeats) and bounds of time points are written into the
+ * given arrays. If the phonemes_sequence is NULL, then only the length of
+ * sequence is calculated. As result, this function returns length of the
+ * phonemes sequence, or -1 in case of error. */
+static int create_phonemes_sequence_by_transcription(
+        TTranscriptionNode transcription[], int transcription_length,
+        TDecoderParameters parameters, int phonemes_sequence[],
+        float phonemes_weights[], int phonemes_repeats[],
+        long unsigned frames_start_times[], long unsigned frames_end_times[])
+{
+    int is_ok = 1;
+    int start_ind = -1, end_ind = -1, i, j, k;
+    int number_of_steps_10ms, repeats, phonemes_sequence_length = 0;
+    float cur_phoneme_weight;
+
+    for (i = 0; i < transcription_length; i++)
+    {
+        if (transcription[i].probability <= 0.0)
+        {
+            is_ok = 0;
+            break;
+        }
+        if (start_ind < 0)
+        {
+            if (transcription[i].node_data > 0)
             {
-                if (n_transcription <= 0)
-                {
-                    is_ok = 0;
-                }
-                else
-                {
-                    reading_state = FILENAME_READING_STATE;
-                }
+                start_ind = i;
             }
-            else
+        }
+        else
+        {
+            if (transcription[i].node_data > 0)
             {
-                new_node.node_data = find_in_unsorted_vocabulary(
-                            words_vocabulary, words_number, buffer);
-                if (new_node.node_data >= 0)
-                {
-                    n_transcription++;
-                    cur_mlf_part->transcription_size++;
-                    cur_mlf_part->transcription = realloc(
-                                cur_mlf_part->transcription,
-                                n_transcription * sizeof(TTranscriptionNode));
-                    cur_mlf_part->transcription[n_transcription-1] = new_node;
-                }
-                /*if (new_node.node_data < 0)
-                {
-                    is_ok = 0;
-                }
-                else
-                {
-                    n_transcription++;
-                    cur_mlf_part->transcription_size++;
-                    cur_mlf_part->transcription = realloc(
-                                cur_mlf_part->transcription,
-                                n_transcription * sizeof(TTranscriptionNode));
-                    cur_mlf_part->transcription[n_transcription-1] = new_node;
-                }*/
-                /*new_node.node_data = find_in_vocabulary(
-                            words_vocabulary, words_number, buffer, &is_equal);
-                if (!is_equal)
-                {
-                    is_ok = 0;
-                }
-                else
-                {
-                    n_transcription++;
-                    cur_mlf_part->transcription_size++;
-                    cur_mlf_part->transcription = realloc(
-                                cur_mlf_part->transcription,
-                                n_transcription * sizeof(TTranscriptionNode));
-                    cur_mlf_part->transcription[n_transcription-1] = new_node;
-                }*/
+                end_ind = -1;
             }
-            break;
-        default:
-            if (strcmp(buffer, MLF_HEADER) != 0)
+            else
             {
-                is_ok = 0;
-                break;
+                end_ind = i-1;
             }
-            reading_state = FILENAME_READING_STATE;
-            break;
         }
-        if (!is_ok)
+    }
+    if (!is_ok)
+    {
+        return -1;
+    }
+    if (start_ind < 0)
+    {
+        return 0;
+    }
+    if (end_ind < 0)
+    {
+        end_ind = transcription_length - 1;
+    }
+
+    for (i = start_ind; i <= end_ind; i++)
+    {
+        number_of_steps_10ms = calculate_number_of_time_points(
+                    transcription[i], parameters, &repeats);
+        phonemes_sequence_length += number_of_steps_10ms;
+    }
+    if (phonemes_sequence == NULL)
+    {
+        return phonemes_sequence_length;
+    }
+
+    j = 0;
+    for (i = start_ind; i <= end_ind; i++)
+    {
+        number_of_steps_10ms = calculate_number_of_time_points(
+                    transcription[i], parameters, &repeats);
+        cur_phoneme_weight = quantize_score(
+                    log10(transcription[i].probability),
+                    parameters.fixed_point_bits);
+        for (k = 0; k < number_of_steps_10ms; k++)
         {
-            break;
+            phonemes_sequence[j+k] = transcription[i].node_data;
+            phonemes_weights[j+k] = cur_phoneme_weight;
+            phonemes_repeats[j+k] = repeats;
+            calculate_bounds_of_frame(transcription[i], number_of_steps_10ms,
+                                      k, frames_start_times + j + k,
+                                      frames_end_times + j + k);
         }
+        j += number_of_steps_10ms;
     }
-    fclose(mlf_file);
-    if (is_ok)
+
+    return phonemes_sequence_length;
+}
+
+static int compare_begins_of_bigrams(const void *ptr1, const void *ptr2)
+{
+    TWordBigramBegin *item1 = (TWordBigramBegin*)ptr1;
+    TWordBigramBegin *item2 = (TWordBigramBegin*)ptr2;
+
+    return (item1->word_i - item2->word_i);
+}
+
+static int compare_items_of_words_lexicon(const void *ptr1, const void *ptr2)
+{
+    TLinearWordsLexicon *item1 = (TLinearWordsLexicon*)ptr1;
+    TLinearWordsLexicon *item2 = (TLinearWordsLexicon*)ptr2;
+
+    return (item1->word_index - item2->word_index);
+}
+
+/* This function compares prefixes of two words without their lexicon indexes,
+ * so it returns zero if these words share one prefix. */
+static int compare_prefixes_of_words(const void *ptr1, const void *ptr2)
+{
+    TWordPrefix *item1 = (TWordPrefix*)ptr1;
+    TWordPrefix *item2 = (TWordPrefix*)ptr2;
+    int k;
+
+    if (item1->length != item2->length)
     {
-        if (reading_state != FILENAME_READING_STATE)
+        return (item1->length - item2->length);
+    }
+    if (item1->is_whole_word != item2->is_whole_word)
+    {
+        return (item1->is_whole_word - item2->is_whole_word);
+    }
+    for (k = 0; k < item1->length; k++)
+    {
+        if (item1->phonemes[k] != item2->phonemes[k])
         {
-            is_ok = 0;
+            return (item1->phonemes[k] - item2->phonemes[k]);
+        }
+    }
+
+    return 0;
+}
+
+int read_string(FILE *read_file, char *str)
+{
+    int start_pos = 0, end_pos = 0;
+
+    if ((read_file == NULL) || (str == NULL))
+    {
+        return 0;
+    }
+
+    memset(str, 0, BUFFER_SIZE);
+    if (fgets(str, BUFFER_SIZE, read_file) == NULL)
+    {
+        return 0;
+    }
+
+    while (str[start_pos] != 0)
+    {
+        if ((str[start_pos] != ' ') && (str[start_pos] != '\t')
+                && (str[start_pos] != '\n') && (str[start_pos] != '\r'))
+        {
+            break;
+        }
+        start_pos++;
+    }
+    if (str[start_pos] == 0)
+    {
+        memset(str, 0, BUFFER_SIZE);
+        return 0;
+    }
+
+    end_pos = strlen(str) - 1;
+    while (end_pos > start_pos)
+    {
+        if ((str[end_pos] != ' ') && (str[end_pos] != '\t')
+                && (str[end_pos] != '\n') && (str[end_pos] != '\r'))
+        {
+            break;
+        }
+        end_pos--;
+    }
+    str[end_pos+1] = 0;
+
+    if (start_pos > 0)
+    {
+        memmove(&str[0], &str[start_pos], end_pos-start_pos+2);
+    }
+
+    return (end_pos - start_pos + 1);
+}
+
+int prepare_filename(char *filename)
+{
+    int i, n;
+
+    if (filename == NULL)
+    {
+        return 0;
+    }
+
+    n = strlen(filename);
+    if (n <= 0)
+    {
+        return 0;
+    }
+    if (filename[0] == '"')
+    {
+        if (n > 1)
+        {
+            if (filename[n-1] == '"')
+            {
+                if (n > 2)
+                {
+                    filename[n-1] = 0;
+                    memmove(&filename[0], &filename[1], (n-1) * sizeof(char));
+                    n -= 2;
+
+                    i = 0;
+                    while (i < n)
+                    {
+                        if ((filename[i]!=' ') && (filename[i]!='\t')
+                                && (filename[i]!='\n')  && (filename[i]!='\r'))
+                        {
+                            break;
+                        }
+                        i++;
+                    }
+                    if (i < n)
+                    {
+                        memmove(&filename[0], &filename[i], n-i+1);
+                        n = n-i;
+
+                        i = n-1;
+                        while (i > 0)
+                        {
+                            if ((filename[i]!=' ')&&(filename[i]!='\t')
+                                    &&(filename[i]!='\r')&&(filename[i]!='\n'))
+                            {
+                                break;
+                            }
+                            i--;
+                        }
+                        filename[i+1] = 0;
+                        n = i+1;
+                    }
+                    else
+                    {
+                        filename[0] = 0;
+                        n = 0;
+                    }
+                }
+                else
+                {
+                    n = 0;
+                }
+            }
+            else
+            {
+                n = 0;
+            }
+        }
+        else
+        {
+            n = 0;
+        }
+    }
+    else
+    {
+        if (filename[n-1] == '"')
+        {
+            n = 0;
+        }
+    }
+
+    return n;
+}
+
+int find_in_vocabulary(char *vocabulary[], int vocabulary_size,
+                       char *found_name, int *is_equal)
+{
+    if (is_equal != NULL)
+    {
+        *is_equal = 0;
+    }
+    if ((found_name == NULL) || (vocabulary_size <= 0) || (vocabulary == NULL))
+    {
+        return -1;
+    }
+
+    int compare_res, first_pos = 0, last_pos = vocabulary_size, middle_pos;
+
+    compare_res = strcmp(vocabulary[0], found_name);
+    if (compare_res >= 0)
+    {
+        if ((compare_res == 0) && (is_equal != NULL))
+        {
+            *is_equal = 1;
+        }
+        return 0;
+    }
+
+    compare_res = strcmp(vocabulary[last_pos-1], found_name);
+    if (compare_res <= 0)
+    {
+        if (compare_res == 0)
+        {
+            if (is_equal != NULL)
+            {
+                *is_equal = 1;
+            }
+        }
+        return last_pos-1;
+    }
+
+    while (first_pos < last_pos)
+    {
+        middle_pos = first_pos + (last_pos - first_pos) / 2;
+        compare_res = strcmp(found_name, vocabulary[middle_pos]);
+        if (compare_res == 0)
+        {
+            if (is_equal != NULL)
+            {
+                *is_equal = 1;
+            }
+            last_pos = middle_pos;
+            break;
+        }
+        else if (compare_res < 0)
+        {
+            last_pos = middle_pos;
+        }
+        else {
+            first_pos = middle_pos + 1;
+        }
+    }
+
+    return last_pos;
+}
+
+int find_in_unsorted_vocabulary(char *vocabulary[], int vocabulary_size,
+                                char *found_name)
+{
+    int i, res = -1;
+
+    if ((found_name == NULL) || (vocabulary_size <= 0) || (vocabulary == NULL))
+    {
+        return -1;
+    }
+
+    for (i = 0; i < vocabulary_size; i++)
+    {
+        if (vocabulary[i] != NULL)
+        {
+            if (strcmp(vocabulary[i], found_name) == 0)
+            {
+                res = i;
+                break;
+            }
+        }
+    }
+
+    return res;
+}
+
+int string_to_transcription_node(char *str, char *phonemes_vocabulary[],
+                                 int phonemes_number, PTranscriptionNode node)
+{
+    char *start_time_label = NULL, *end_time_label = NULL;
+    char *node_name = NULL, *probability_str = NULL;
+
+    if ((phonemes_number <= 0) || (phonemes_vocabulary == NULL)
+            || (str == NULL) || (node == NULL))
+    {
+        return 0;
+    }
+    /* phonemes have no score */
+    node->score = -FLT_MAX;
+
+    start_time_label = strtok(str, " \t");
+    if (start_time_label == NULL)
+    {
+        return 0;
+    }
+    end_time_label = strtok(NULL, " \t");
+    if (end_time_label == NULL)
+    {
+        return 0;
+    }
+    node_name = strtok(NULL, " \t");
+    if (node_name == NULL)
+    {
+        return 0;
+    }
+    probability_str = strtok(NULL, " \t");
+    if (probability_str != NULL)
+    {
+        if (strtok(NULL, " \t") != NULL)
+        {
+            return 0;
+        }
+    }
+
+    if (sscanf(start_time_label, "%lu", &(node->start_time)) != 1)
+    {
+        return 0;
+    }
+
+    if (sscanf(end_time_label, "%lu", &(node->end_time)) != 1)
+    {
+        return 0;
+    }
+    if (node->end_time <= node->start_time)
+    {
+        return 0;
+    }
+
+    node->node_data = find_in_unsorted_vocabulary(
+                phonemes_vocabulary, phonemes_number, node_name);
+    if (node->node_data < 0)
+    {
+        return 0;
+    }
+
+    if (probability_str == NULL)
+    {
+        node->probability = 1.0;
+    }
+    else
+    {
+        if (sscanf(probability_str, "%f", &(node->probability)) != 1)
+        {
+            return 0;
+        }
+        if ((node->probability < 0.0) || (node->probability > 1.0))
+        {
+            return 0;
+        }
+    }
+
+    return 1;
+}
+
+int select_word_and_transcription(char *str, char **word_substr,
+                                  char **transcription_substr)
+{
+    int i, j;
+
+    if ((str == NULL) || (word_substr == NULL)
+            || (transcription_substr == NULL))
+    {
+        return 0;
+    }
+
+    *word_substr = NULL;
+    *transcription_substr = NULL;
+
+    i = 0;
+    while (str[i] != 0)
+    {
+        if (str[i] == '=')
+        {
+            break;
+        }
+        i++;
+    }
+    if (str[i] != '=')
+    {
+        return 0;
+    }
+
+    j = i - 1;
+    while (j >= 0)
+    {
+        if ((str[j] != ' ') && (str[j] != '\t') && (str[j] != '\n')
+                && (str[j] != '\r'))
+        {
+            break;
+        }
+        j--;
+    }
+    j++;
+    if (j <= 0)
+    {
+        return 0;
+    }
+    str[j] = 0;
+    *word_substr = str;
+
+    j = i+1;
+    while (str[j] != 0)
+    {
+        if ((str[j] != ' ') && (str[j] != '\t') && (str[j] != '\n')
+                && (str[j] != '\r'))
+        {
+            break;
+        }
+        j++;
+    }
+    if (str[j] == 0)
+    {
+        *word_substr = NULL;
+        return 0;
+    }
+    *transcription_substr = &str[j];
+    return 1;
+}
+
+int parse_transcription_str(char *transcription_str,char **phonemes_vocabulary,
+                            int phonemes_number, int phonemes_sequence[])
+{
+    char *phoneme_name = NULL;
+    int i = 0, is_ok = 1;
+
+    if ((transcription_str == NULL) || (phonemes_vocabulary == NULL)
+            || (phonemes_number <= 0) || (phonemes_sequence == NULL))
+    {
+        return 0;
+    }
+
+    phoneme_name = strtok(transcription_str, " \t");
+    if (phoneme_name == NULL)
+    {
+        return 0;
+    }
+    phonemes_sequence[i] = find_in_unsorted_vocabulary(
+                phonemes_vocabulary, phonemes_number, phoneme_name);
+    if (phonemes_sequence[i] < 0)
+    {
+        return 0;
+    }
+    i++;
+    phoneme_name = strtok(NULL, " \t");
+
+    while (phoneme_name != NULL)
+    {
+        phonemes_sequence[i] = find_in_unsorted_vocabulary(
+                    phonemes_vocabulary, phonemes_number, phoneme_name);
+        if (phonemes_sequence[i] < 0)
+        {
+            is_ok = 0;
+            break;
+        }
+        i++;
+        phoneme_name = strtok(NULL, " \t");
+    }
+
+    if (!is_ok)
+    {
+        return 0;
+    }
+    return i;
+}
+
+int add_word_to_words_tree(int word_index, int word_phonemes[],int word_length,
+                           PWordsTreeNode words_tree_root)
+{
+    int is_ok = 1, i, n, next_i;
+    PWordsTreeNode next_node;
+
+    if ((word_index < 0) || (word_phonemes == NULL) || (word_length <= 0)
+            || (words_tree_root == NULL))
+    {
+        return 0;
+    }
+    if (words_tree_root->node_type != INIT_NODE)
+    {
+        return 0;
+    }
+
+    for (i = 0; i < word_length; i++)
+    {
+        if (word_phonemes[i] <= 0)
+        {
+            is_ok = 0;
+            break;
+        }
+        n = words_tree_root->number_of_next_nodes;
+        next_i = n - 1;
+        next_node = words_tree_root->next_nodes + next_i;
+        while (next_i >= 0)
+        {
+            if (next_node->node_type != PHONEME_NODE)
+            {
+                next_i--;
+                next_node--;
+            }
+            else
+            {
+                if (next_node->node_data == word_phonemes[i])
+                {
+                    break;
+                }
+                next_i--;
+                next_node--;
+            }
+        }
+        if (next_i < 0)
+        {
+            words_tree_root->next_nodes = realloc(
+                        words_tree_root->next_nodes,
+                        (n+1) * sizeof(TWordsTreeNode));
+            next_node = words_tree_root->next_nodes + n;
+            words_tree_root->number_of_next_nodes++;
+            next_node->node_data = word_phonemes[i];
+            next_node->node_type = PHONEME_NODE;
+            next_node->number_of_next_nodes = 0;
+            next_node->next_nodes = NULL;
+        }
+        words_tree_root = next_node;
+    }
+    if (!is_ok)
+    {
+        return 0;
+    }
+
+    n = words_tree_root->number_of_next_nodes;
+    next_i = n - 1;
+    next_node = words_tree_root->next_nodes + next_i;
+    while (next_i >= 0)
+    {
+        if (next_node->node_type == WORD_NODE)
+        {
+            break;
+        }
+        next_i--;
+        next_node--;
+    }
+    if (next_i >= 0)
+    {
+        if (next_node->node_data != word_index)
+        {
+            return 0;
+        }
+        return 1;
+    }
+
+    words_tree_root->next_nodes = realloc(
+                words_tree_root->next_nodes, (n+1) * sizeof(TWordsTreeNode));
+    next_node = words_tree_root->next_nodes + n;
+    words_tree_root->number_of_next_nodes++;
+    next_node->node_data = word_index;
+    next_node->node_type = WORD_NODE;
+    next_node->number_of_next_nodes = 0;
+    next_node->next_nodes = NULL;
+    return 1;
+}
+
+void free_words_tree_node(PWordsTreeNode deleted_node)
+{
+    PWordsTreeNode next_node = NULL;
+    int i;
+
+    if (deleted_node == NULL)
+    {
+        return;
+    }
+
+    if ((deleted_node->number_of_next_nodes > 0) && (deleted_node->next_nodes != NULL))
+    {
+        for (i = 0; i < deleted_node->number_of_next_nodes; i++)
+        {
+            next_node = deleted_node->next_nodes + i;
+            free_words_tree_node(next_node);
+        }
+        free(deleted_node->next_nodes);
+        deleted_node->next_nodes = NULL;
+    }
+}
+
+int load_phonemes_MLF(char *mlf_name, char **phonemes_vocabulary,
+                      int phonemes_number, TMLFFilePart **mlf_data)
+{
+    int buffer_size = 0, n_files = 0, n_transcription = 0;
+    int reading_state = HEADER_EXPECTATION_STATE;
+    int is_ok = 1;
+    char buffer[BUFFER_SIZE];
+    FILE *mlf_file = NULL;
+    TMLFFilePart *cur_mlf_part = NULL;
+    TTranscriptionNode new_node;
+    PTranscriptionNode last_node_ptr = NULL;
+
+    if ((mlf_data == NULL) || (mlf_name == NULL)
+            || (phonemes_vocabulary == NULL) || (phonemes_number <= 0))
+    {
+        return 0;
+    }
+
+    *mlf_data = NULL;
+    new_node.start_time = 0;
+    new_node.end_time = 0;
+    new_node.probability = 1.0;
+    new_node.score = -FLT_MAX;
+    new_node.node_data = -1;
+
+    mlf_file = fopen(mlf_name, "r");
+    if (mlf_file == NULL)
+    {
+        return 0;
+    }
+    while (!feof(mlf_file))
+    {
+        buffer_size = read_string(mlf_file, buffer);
+        if (buffer_size <= 0)
+        {
+            continue;
+        }
+        switch (reading_state)
+        {
+        case FILENAME_READING_STATE:
+            buffer_size = prepare_filename(buffer);
+            if (buffer_size <= 0)
+            {
+                is_ok = 0;
+                break;
+            }
+            n_files++;
+            *mlf_data = realloc(*mlf_data, n_files * sizeof(TMLFFilePart));
+            cur_mlf_part = *mlf_data + n_files - 1;
+            cur_mlf_part->name = malloc((buffer_size+1) * sizeof(char));
+            memset(cur_mlf_part->name, 0, buffer_size+1);
+            strcpy(cur_mlf_part->name, buffer);
+            cur_mlf_part->transcription = NULL;
+            cur_mlf_part->transcription_size = 0;
+            last_node_ptr = NULL;
+            n_transcription = 0;
+            reading_state = EVENT_READING_STATE;
+            break;
+        case EVENT_READING_STATE:
+            if (strcmp(buffer, ".") == 0)
+            {
+                if (n_transcription <= 0)
+                {
+                    is_ok = 0;
+                }
+                else
+                {
+                    reading_state = FILENAME_READING_STATE;
+                }
+            }
+            else
+            {
+                if (!string_to_transcription_node(buffer, phonemes_vocabulary,
+                                                  phonemes_number, &new_node))
+                {
+                    is_ok = 0;
+                }
+                else
+                {
+                    if (last_node_ptr != NULL)
+                    {
+                        if (last_node_ptr->end_time > new_node.start_time)
+                        {
+                            is_ok = 0;
+                        }
+                    }
+                }
+                if (is_ok)
+                {
+                    n_transcription++;
+                    cur_mlf_part->transcription_size++;
+                    cur_mlf_part->transcription = realloc(
+                                cur_mlf_part->transcription,
+                                n_transcription * sizeof(TTranscriptionNode));
+                    cur_mlf_part->transcription[n_transcription-1] = new_node;
+                    last_node_ptr = cur_mlf_part->transcription
+                            + n_transcription - 1;
+                }
+            }
+            break;
+        default:
+            if (strcmp(buffer, MLF_HEADER) != 0)
+            {
+                is_ok = 0;
+            }
+            else
+            {
+                reading_state = FILENAME_READING_STATE;
+            }
+        }
+        if (!is_ok)
+        {
+            break;
+        }
+    }
+    fclose(mlf_file);
+    if (is_ok)
+    {
+        if (reading_state != FILENAME_READING_STATE)
+        {
+            is_ok = 0;
+        }
+    }
+
+    if (!is_ok)
+    {
+        free_MLF(mlf_data, n_files);
+        n_files = 0;
+    }
+    return n_files;
+}
+
+/* This function parses the line of words MLF file. This line contains the
+ * name of word only, or start and end times of word before its name and the
+ * optional score (log10-probability) after it like in HTK. Index of the word
+ * in vocabulary is -1 if this word isn't found. As result, this function
+ * returns the transcription node of the word (without times and with zero
+ * score if they aren't given). */
+static TTranscriptionNode parse_word_of_MLF(char *str, char **words_vocabulary,
+                                            int words_number)
+{
+    TTranscriptionNode node;
+    char word_name[BUFFER_SIZE];
+    float score;
+    int n = 0, n_score = 0;
+
+    node.start_time = 0;
+    node.end_time = 0;
+    set_score_of_word(&node, 0.0);
+    if ((sscanf(str, "%lu %lu %s%n", &(node.start_time), &(node.end_time),
+                word_name, &n) == 3) && (node.end_time > node.start_time))
+    {
+        if (sscanf(str + n, "%f%n", &score, &n_score) == 1)
+        {
+            set_score_of_word(&node, score);
+            n += n_score;
+        }
+        while ((str[n] == ' ') || (str[n] == '\t'))
+        {
+            n++;
+        }
+        if (str[n] == 0)
+        {
+            node.node_data = find_in_unsorted_vocabulary(
+                        words_vocabulary, words_number, word_name);
+            return node;
+        }
+    }
+
+    node.start_time = 0;
+    node.end_time = 0;
+    set_score_of_word(&node, 0.0);
+    node.node_data = find_in_unsorted_vocabulary(words_vocabulary,
+                                                 words_number, str);
+    return node;
+}
+
+int load_words_MLF(char *mlf_name, char **words_vocabulary, int words_number,
+                   TMLFFilePart **mlf_data)
+{
+    int buffer_size = 0, n_files = 0, n_transcription = 0;
+    int reading_state = HEADER_EXPECTATION_STATE;
+    int is_ok = 1;
+    char buffer[BUFFER_SIZE];
+    FILE *mlf_file = NULL;
+    TMLFFilePart *cur_mlf_part = NULL;
+    TTranscriptionNode new_node;
+
+    if ((mlf_data == NULL) || (mlf_name == NULL) || (words_vocabulary == NULL)
+            || (words_number <= 0))
+    {
+        return 0;
+    }
+
+    *mlf_data = NULL;
+    new_node.start_time = 0;
+    new_node.end_time = 0;
+    set_score_of_word(&new_node, 0.0);
+    new_node.node_data = -1;
+
+    mlf_file = fopen(mlf_name, "r");
+    if (mlf_file == NULL)
+    {
+        return 0;
+    }
+    while (!feof(mlf_file))
+    {
+        buffer_size = read_string(mlf_file, buffer);
+        if (buffer_size <= 0)
+        {
+            continue;
+        }
+        switch (reading_state)
+        {
+        case FILENAME_READING_STATE:
+            buffer_size = prepare_filename(buffer);
+            if (buffer_size <= 0)
+            {
+                is_ok = 0;
+                break;
+            }
+            n_files++;
+            *mlf_data = realloc(*mlf_data, n_files * sizeof(TMLFFilePart));
+            cur_mlf_part = *mlf_data + n_files - 1;
+            cur_mlf_part->name = malloc((buffer_size+1) * sizeof(char));
+            memset(cur_mlf_part->name, 0, buffer_size+1);
+            strcpy(cur_mlf_part->name, buffer);
+            cur_mlf_part->transcription = NULL;
+            cur_mlf_part->transcription_size = 0;
+            n_transcription = 0;
+            reading_state = EVENT_READING_STATE;
+            break;
+        case EVENT_READING_STATE:
+            if (strcmp(buffer, ".") == 0)
+            {
+                if (n_transcription <= 0)
+                {
+                    is_ok = 0;
+                }
+                else
+                {
+                    reading_state = FILENAME_READING_STATE;
+                }
+            }
+            else
+            {
+                new_node = parse_word_of_MLF(buffer, words_vocabulary,
+                                             words_number);
+                if (new_node.node_data >= 0)
+                {
+                    n_transcription++;
+                    cur_mlf_part->transcription_size++;
+                    cur_mlf_part->transcription = realloc(
+                                cur_mlf_part->transcription,
+                                n_transcription * sizeof(TTranscriptionNode));
+                    cur_mlf_part->transcription[n_transcription-1] = new_node;
+                }
+                /*if (new_node.node_data < 0)
+                {
+                    is_ok = 0;
+                }
+                else
+                {
+                    n_transcription++;
+                    cur_mlf_part->transcription_size++;
+                    cur_mlf_part->transcription = realloc(
+                                cur_mlf_part->transcription,
+                                n_transcription * sizeof(TTranscriptionNode));
+                    cur_mlf_part->transcription[n_transcription-1] = new_node;
+                }*/
+                /*new_node.node_data = find_in_vocabulary(
+                            words_vocabulary, words_number, buffer, &is_equal);
+                if (!is_equal)
+                {
+                    is_ok = 0;
+                }
+                else
+                {
+                    n_transcription++;
+                    cur_mlf_part->transcription_size++;
+                    cur_mlf_part->transcription = realloc(
+                                cur_mlf_part->transcription,
+                                n_transcription * sizeof(TTranscriptionNode));
+                    cur_mlf_part->transcription[n_transcription-1] = new_node;
+                }*/
+            }
+            break;
+        default:
+            if (strcmp(buffer, MLF_HEADER) != 0)
+            {
+                is_ok = 0;
+                break;
+            }
+            reading_state = FILENAME_READING_STATE;
+            break;
+        }
+        if (!is_ok)
+        {
+            break;
+        }
+    }
+    fclose(mlf_file);
+    if (is_ok)
+    {
+        if (reading_state != FILENAME_READING_STATE)
+        {
+            is_ok = 0;
+        }
+    }
+
+    if (!is_ok)
+    {
+        free_MLF(mlf_data, n_files);
+        n_files = 0;
+    }
+    return n_files;
+}
+
+/* This function writes the line of words MLF file for the given word. Start
+ * and end times of the word are written before its name and its score
+ * (log10-probability) is written after it like in HTK, if this word has
+ * nonzero duration. Otherwise only the name of word is written. As result,
+ * this function returns 1 in case of success, or 0 in case of error. */
+static int write_word_of_MLF(FILE *mlf_file, char *word_name,
+                             TTranscriptionNode node)
+{
+    if (node.end_time <= node.start_time)
+    {
+        return (fprintf(mlf_file, "%s\n", word_name) > 0);
+    }
+    if (node.score <= (-FLT_MAX + FLT_EPSILON))
+    {
+        return (fprintf(mlf_file, "%lu %lu %s\n", node.start_time,
+                        node.end_time, word_name) > 0);
+    }
+    return (fprintf(mlf_file, "%lu %lu %s %.4f\n", node.start_time,
+                    node.end_time, word_name, node.score) > 0);
+}
+
+int save_words_MLF(char *mlf_name, char **words_vocabulary, int words_number,
+                   TMLFFilePart *mlf_data, int files_number)
+{
+    int i, j, ret = files_number;
+    FILE *mlf_file = NULL;
+    PTranscriptionNode node_ptr;
+    char *word_name;
+
+    if ((mlf_name == NULL) || (words_vocabulary == NULL) || (words_number <= 0)
+            || (mlf_data == NULL) || (files_number <= 0))
+    {
+        return 0;
+    }
+
+    mlf_file = fopen(mlf_name, "w");
+    if (mlf_file == NULL)
+    {
+        return 0;
+    }
+
+    if (fprintf(mlf_file, "%s\n", MLF_HEADER) <= 0)
+    {
+        ret = 0;
+    }
+    else
+    {
+        for (i = 0; i < files_number; i++)
+        {
+            if ((mlf_data->name == NULL) || (mlf_data->transcription == NULL)
+                    || (mlf_data->transcription_size <= 0))
+            {
+                ret = 0;
+                break;
+            }
+            if (fprintf(mlf_file, "\"%s\"\n", mlf_data->name) <= 0)
+            {
+                ret = 0;
+                break;
+            }
+            node_ptr = mlf_data->transcription;
+            for (j = 0; j < mlf_data->transcription_size; j++)
+            {
+                if ((node_ptr->node_data < 0)
+                        || (node_ptr->node_data >= words_number))
+                {
+                    ret = 0;
+                    break;
+                }
+                word_name = words_vocabulary[node_ptr->node_data];
+                if (word_name == NULL)
+                {
+                    ret = 0;
+                    break;
+                }
+                if (!write_word_of_MLF(mlf_file, word_name, *node_ptr))
+                {
+                    ret = 0;
+                    break;
+                }
+                node_ptr++;
+            }
+            if (!ret)
+            {
+                break;
+            }
+            if (fprintf(mlf_file, "%c\n", '.') <= 0)
+            {
+                ret = 0;
+                break;
+            }
+            mlf_data++;
+        }
+    }
+    fclose(mlf_file);
+
+    return ret;
+}
+
+int save_word_lattice(char *file_name, TWordLattice lattice,
+                      char **words_vocabulary, int words_number)
+{
+    int i, ret = 1;
+    FILE *lattice_file = NULL;
+    TLatticeNode *node;
+    TLatticeLink *link;
+    char *word_name;
+
+    if ((file_name == NULL) || (words_vocabulary == NULL)
+            || (words_number <= 0) || (lattice.nodes == NULL)
+            || (lattice.nodes_number < 2) || (lattice.links == NULL)
+            || (lattice.links_number <= 0))
+    {
+        return 0;
+    }
+
+    lattice_file = fopen(file_name, "w");
+    if (lattice_file == NULL)
+    {
+        return 0;
+    }
+
+    if (fprintf(lattice_file, "VERSION=1.0\n") <= 0)
+    {
+        ret = 0;
+    }
+    else if ((lattice.name != NULL)
+             && (fprintf(lattice_file, "UTTERANCE=%s\n", lattice.name) <= 0))
+    {
+        ret = 0;
+    }
+    else if (fprintf(lattice_file, "base=10.0\nN=%d L=%d\n",
+                     lattice.nodes_number, lattice.links_number) <= 0)
+    {
+        ret = 0;
+    }
+    for (i = 0; ret && (i < lattice.nodes_number); i++)
+    {
+        node = lattice.nodes + i;
+        if (node->word_index < 0)
+        {
+            word_name = "!NULL";
+        }
+        else if (node->word_index < words_number)
+        {
+            word_name = words_vocabulary[node->word_index];
+        }
+        else
+        {
+            word_name = NULL;
+        }
+        if (word_name == NULL)
+        {
+            ret = 0;
+            break;
+        }
+        if (fprintf(lattice_file, "I=%d t=%.2f W=%s\n", i,
+                    node->end_time / 1.0e7, word_name) <= 0)
+        {
+            ret = 0;
+            break;
+        }
+    }
+    for (i = 0; ret && (i < lattice.links_number); i++)
+    {
+        link = lattice.links + i;
+        if ((link->start_node < 0) || (link->start_node >= lattice.nodes_number)
+                || (link->end_node < 0)
+                || (link->end_node >= lattice.nodes_number))
+        {
+            ret = 0;
+            break;
+        }
+        if (fprintf(lattice_file, "J=%d S=%d E=%d a=%.4f l=%.4f\n", i,
+                    link->start_node, link->end_node, link->acoustic_score,
+                    link->language_score) <= 0)
+        {
+            ret = 0;
+            break;
+        }
+    }
+    fclose(lattice_file);
+
+    return ret;
+}
+
+int save_nbest_MLF(char *mlf_name, char **words_vocabulary, int words_number,
+                   TNBestList *nbest_lists, int lists_number)
+{
+    int i, j, k, ret = lists_number;
+    FILE *mlf_file = NULL;
+    TWordsHypothesis *hypothesis;
+    char *word_name;
+
+    if ((mlf_name == NULL) || (words_vocabulary == NULL) || (words_number <= 0)
+            || (nbest_lists == NULL) || (lists_number <= 0))
+    {
+        return 0;
+    }
+
+    mlf_file = fopen(mlf_name, "w");
+    if (mlf_file == NULL)
+    {
+        return 0;
+    }
+
+    if (fprintf(mlf_file, "%s\n", MLF_HEADER) <= 0)
+    {
+        ret = 0;
+    }
+    for (i = 0; ret && (i < lists_number); i++)
+    {
+        if ((nbest_lists[i].name == NULL)
+                || (nbest_lists[i].hypotheses == NULL)
+                || (nbest_lists[i].hypotheses_number <= 0))
+        {
+            ret = 0;
+            break;
+        }
+        if (fprintf(mlf_file, "\"%s\"\n", nbest_lists[i].name) <= 0)
+        {
+            ret = 0;
+            break;
+        }
+        for (j = 0; ret && (j < nbest_lists[i].hypotheses_number); j++)
+        {
+            hypothesis = nbest_lists[i].hypotheses + j;
+            if ((j > 0) && (fprintf(mlf_file, "///\n") <= 0))
+            {
+                ret = 0;
+                break;
+            }
+            for (k = 0; k < hypothesis->words_number; k++)
+            {
+                if ((hypothesis->words[k].node_data < 0)
+                        || (hypothesis->words[k].node_data >= words_number))
+                {
+                    ret = 0;
+                    break;
+                }
+                word_name = words_vocabulary[hypothesis->words[k].node_data];
+                if (word_name == NULL)
+                {
+                    ret = 0;
+                    break;
+                }
+                if (!write_word_of_MLF(mlf_file, word_name,
+                                       hypothesis->words[k]))
+                {
+                    ret = 0;
+                    break;
+                }
+            }
+        }
+        if (ret && (fprintf(mlf_file, "%c\n", '.') <= 0))
+        {
+            ret = 0;
+        }
+    }
+    fclose(mlf_file);
+
+    return ret;
+}
+
+int load_phonemes_vocabulary(char *file_name, char ***phonemes_vocabulary)
+{
+    int i, buffer_size = 0, vocabulary_size = 0;
+    char buffer[BUFFER_SIZE];
+    char **temp_vocabulary;
+    FILE *vocabulary_file = NULL;
+
+    if (phonemes_vocabulary == NULL)
+    {
+        return 0;
+    }
+    *phonemes_vocabulary = NULL;
+
+    vocabulary_file = fopen(file_name, "r");
+    if (vocabulary_file == NULL)
+    {
+        return 0;
+    }
+    while (!feof(vocabulary_file))
+    {
+        buffer_size = read_string(vocabulary_file, buffer);
+        if (buffer_size <= 0)
+        {
+            continue;
+        }
+        i = find_in_unsorted_vocabulary(*phonemes_vocabulary, vocabulary_size,
+                                        buffer);
+        if (i < 0)
+        {
+            *phonemes_vocabulary = realloc(*phonemes_vocabulary,
+                                           (vocabulary_size+1)*sizeof(char*));
+            temp_vocabulary = *phonemes_vocabulary;
+            i = vocabulary_size;
+            temp_vocabulary[i] = malloc((buffer_size+1) * sizeof(char));
+            memset(temp_vocabulary[i], 0, (buffer_size+1) * sizeof(char));
+            strcpy(temp_vocabulary[i], buffer);
+            vocabulary_size++;
+        }
+    }
+    fclose(vocabulary_file);
+
+    return vocabulary_size;
+}
+
+int calculate_confusion_penalties_matrix(
+        char *confusion_matrix_name, int phonemes_number,
+        float confusion_penalties_matrix[])
+{
+    FILE *matrix_file = NULL;
+    int *confusion_matrix = NULL;
+    char buffer[BUFFER_SIZE];
+    char *value_str;
+    int i, j, index, buffer_size, value = 0, is_ok = 1;
+    float sum_value = 0.0;
+
+    if ((confusion_matrix_name == NULL) || (phonemes_number <= 0)
+            || (confusion_penalties_matrix == NULL))
+    {
+        return 0;
+    }
+
+    matrix_file = fopen(confusion_matrix_name, "r");
+    if (matrix_file == NULL)
+    {
+        return 0;
+    }
+    i = 0;
+    confusion_matrix = malloc((phonemes_number+1) * (phonemes_number+1)
+                              * sizeof(int));
+    memset(confusion_matrix, 0, (phonemes_number+1) * (phonemes_number+1)
+           * sizeof(int));
+    while (!feof(matrix_file))
+    {
+        buffer_size = read_string(matrix_file, buffer);
+        if (buffer_size <= 0)
+        {
+            continue;
+        }
+        if (i > phonemes_number)
+        {
+            is_ok = 0;
+            break;
+        }
+        j = 0;
+        value_str = strtok(buffer, " \t");
+        if (value_str == NULL)
+        {
+            is_ok = 0;
+            break;
+        }
+        if (sscanf(value_str, "%d", &value) != 1)
+        {
+            is_ok = 0;
+            break;
+        }
+        if (value < 0)
+        {
+            is_ok = 0;
+            break;
+        }
+        confusion_matrix[i*(phonemes_number+1)+j] = value;
+        j++;
+        value_str = strtok(NULL, " \t");
+        while (value_str != NULL)
+        {
+            if (j > phonemes_number)
+            {
+                is_ok = 0;
+                break;
+            }
+            if (sscanf(value_str, "%d", &value) != 1)
+            {
+                is_ok = 0;
+                break;
+            }
+            if (value < 0)
+            {
+                is_ok = 0;
+                break;
+            }
+            confusion_matrix[i*(phonemes_number+1)+j] = value;
+            j++;
+            value_str = strtok(NULL, " \t");
+        }
+        if (is_ok)
+        {
+            if (j != (phonemes_number+1))
+            {
+                is_ok = 0;
+            }
+        }
+        if (!is_ok)
+        {
+            break;
+        }
+        i++;
+    }
+    if (is_ok)
+    {
+        if (i != (phonemes_number+1))
+        {
+            is_ok = 0;
+        }
+    }
+    fclose(matrix_file);
+    if (!is_ok)
+    {
+        free(confusion_matrix);
+        return 0;
+    }
+    for (i = 0; i < phonemes_number; i++)
+    {
+        sum_value = 0;
+        for (j = 0; j < phonemes_number; j++)
+        {
+            sum_value += confusion_matrix[i*(phonemes_number+1)+j];
+        }
+        if (sum_value > 0)
+        {
+            for (j = 0; j < phonemes_number; j++)
+            {
+                confusion_penalties_matrix[i*phonemes_number+j]
+                        = confusion_matrix[i*(phonemes_number+1)+j]/sum_value;
+            }
+        }
+        else
+        {
+            is_ok = 0;
+            break;
+        }
+    }
+    free(confusion_matrix);
+    if (!is_ok)
+    {
+        return 0;
+    }
+    for (i = 0; i < phonemes_number; i++)
+    {
+        for (j = 0; j < phonemes_number; j++)
+        {
+            index = i * phonemes_number + j;
+            if (confusion_penalties_matrix[index] > 0.0)
+            {
+                confusion_penalties_matrix[index]
+                        = log10(confusion_penalties_matrix[index]);
+            }
+            else
+            {
+                confusion_penalties_matrix[index] = -FLT_MAX;
+            }
+        }
+    }
+    return 1;
+}
+
+int load_words_vocabulary(char *file_name, char ***words_vocabulary)
+{
+    int i, n, buffer_size = 0, vocabulary_size = 0;
+    int is_ok = 1;
+    char buffer[BUFFER_SIZE];
+    char *word_name = NULL, *word_transcription = NULL;
+    char **temp_vocabulary;
+    FILE *vocabulary_file = NULL;
+
+    if (words_vocabulary == NULL)
+    {
+        return 0;
+    }
+    *words_vocabulary = NULL;
+
+    vocabulary_file = fopen(file_name, "r");
+    if (vocabulary_file == NULL)
+    {
+        return 0;
+    }
+    while (!feof(vocabulary_file))
+    {
+        buffer_size = read_string(vocabulary_file, buffer);
+        if (buffer_size <= 0)
+        {
+            continue;
+        }
+        if (!select_word_and_transcription(buffer, &word_name,
+                                           &word_transcription))
+        {
+            is_ok = 0;
+            break;
+        }
+        if (find_in_unsorted_vocabulary(*words_vocabulary, vocabulary_size,
+                                        word_name) < 0)
+        {
+            *words_vocabulary = realloc(*words_vocabulary,
+                                        (vocabulary_size+1) * sizeof(char*));
+            temp_vocabulary = *words_vocabulary;
+            i = vocabulary_size;
+            n = strlen(word_name);
+            temp_vocabulary[i] = malloc((n+1) * sizeof(char));
+            memset(temp_vocabulary[i], 0, (n+1) * sizeof(char));
+            strcpy(temp_vocabulary[i], word_name);
+            vocabulary_size++;
+        }
+    }
+    fclose(vocabulary_file);
+    if (!is_ok)
+    {
+        free_string_array(words_vocabulary, vocabulary_size);
+        vocabulary_size = 0;
+    }
+
+    return vocabulary_size;
+}
+
+int load_language_model(char *file_name,  int words_number,
+                        TLanguageModel *language_model)
+{
+    int i, j, n = 0, is_ok = 1;
+    FILE *h_file = NULL;
+
+    if (language_model == NULL)
+    {
+        return 0;
+    }
+    language_model->unigrams_number = 0;
+    language_model->unigrams_probabilities = NULL;
+    language_model->bigrams = NULL;
+
+    h_file = fopen(file_name, "rb");
+    if (h_file == NULL)
+    {
+        return 0;
+    }
+
+    if (fread(&n, sizeof(int), 1, h_file) != 1)
+    {
+        fclose(h_file);
+        return 0;
+    }
+    if (n != words_number)
+    {
+        fclose(h_file);
+        return 0;
+    }
+    language_model->unigrams_probabilities = malloc(n * sizeof(float));
+    language_model->unigrams_number = n;
+    language_model->bigrams = malloc(n * sizeof(TWordBigram));
+    for (i = 0; i < n; i++)
+    {
+        language_model->bigrams[i].begins_number = 0;
+        language_model->bigrams[i].begins = NULL;
+    }
+    if (fread(language_model->unigrams_probabilities, sizeof(float), n, h_file)
+            != n)
+    {
+        free_language_model(language_model);
+        fclose(h_file);
+        return 0;
+    }
+    for (i = 0; i < n; i++)
+    {
+        if ((language_model->unigrams_probabilities[i] < 0.0)
+                || (language_model->unigrams_probabilities[i] > 1.0))
+        {
+            is_ok = 0;
+            break;
+        }
+    }
+    if (!is_ok)
+    {
+        free_language_model(language_model);
+        fclose(h_file);
+        return 0;
+    }
+
+    for (i = 0; i < language_model->unigrams_number; i++)
+    {
+        if (fread(&n, sizeof(int), 1, h_file) != 1)
+        {
+            fclose(h_file);
+            return 0;
+        }
+        if (n < 0)
+        {
+            is_ok = 0;
+            break;
+        }
+        if (n > 0)
+        {
+            language_model->bigrams[i].begins_number = n;
+            language_model->bigrams[i].begins
+                    = malloc(n * sizeof(TWordBigramBegin));
+            if (fread(language_model->bigrams[i].begins,
+                      sizeof(TWordBigramBegin), n, h_file) != n)
+            {
+                is_ok = 0;
+                break;
+            }
+            for (j = 0; j < n; j++)
+            {
+                if ((language_model->bigrams[i].begins[j].word_i < 0)
+                        || (language_model->bigrams[i].begins[j].word_i
+                            >= language_model->unigrams_number))
+                {
+                    is_ok = 0;
+                    break;
+                }
+                if ((language_model->bigrams[i].begins[j].probability < 0.0)
+                        ||(language_model->bigrams[i].begins[j].probability
+                           > 1.0))
+                {
+                    is_ok = 0;
+                    break;
+                }
+            }
+            if (!is_ok)
+            {
+                break;
+            }
+            qsort(language_model->bigrams[i].begins,
+                  language_model->bigrams[i].begins_number,
+                  sizeof(TWordBigramBegin), compare_begins_of_bigrams);
+        }
+    }
+    if (!is_ok)
+    {
+        free_language_model(language_model);
+        return 0;
+    }
+    return 1;
+}
+
+int save_language_model(char *file_name, TLanguageModel language_model)
+{
+    int i, n, is_ok = 1;
+    FILE *h_file = NULL;
+
+    if ((file_name == NULL) || (language_model.unigrams_number <= 0)
+            || (language_model.bigrams == NULL)
+            || (language_model.unigrams_probabilities == NULL))
+    {
+        return 0;
+    }
+
+    h_file = fopen(file_name, "wb");
+    if (h_file == NULL)
+    {
+        return 0;
+    }
+
+    n = language_model.unigrams_number;
+    if (fwrite(&n, sizeof(int), 1, h_file) != 1)
+    {
+        fclose(h_file);
+        return 0;
+    }
+    if (fwrite(language_model.unigrams_probabilities, sizeof(float), n, h_file)
+            != n)
+    {
+        fclose(h_file);
+        return 0;
+    }
+
+    for (i = 0; i < language_model.unigrams_number; i++)
+    {
+        n = language_model.bigrams[i].begins_number;
+        if (fwrite(&n, sizeof(int), 1, h_file) != 1)
+        {
+            is_ok = 0;
+            break;
+        }
+        if (n > 0)
+        {
+            if (fwrite(language_model.bigrams[i].begins,
+                       sizeof(TWordBigramBegin), n, h_file) != n)
+            {
+                is_ok = 0;
+                break;
+            }
+        }
+    }
+
+    fclose(h_file);
+    return is_ok;
+}
+
+int calculate_language_model(TMLFFilePart *words_mlf_data, int files_number,
+                             int words_number, float eps,
+                             TLanguageModel *language_model)
+{
+    int i, j, word_i, bigram_i, is_ok = 1, total_words_count = 0;
+    int first_i, second_i, nwords, nbigrams;
+    int *words_frequencies = NULL;
+
+    if ((words_mlf_data == NULL) || (files_number <= 0) || (words_number <= 0)
+            || (eps < 0.0) || (eps >= 1.0) || (language_model == NULL))
+    {
+        return 0;
+    }
+
+    language_model->unigrams_number = words_number;
+    language_model->unigrams_probabilities = malloc(words_number
+                                                    * sizeof(float));
+    words_frequencies = malloc(words_number * sizeof(int));
+    memset(words_frequencies, 0, words_number * sizeof(int));
+    language_model->bigrams = malloc(words_number * sizeof(TWordBigram));
+
+    for (i = 0; i < words_number; i++)
+    {
+        language_model->unigrams_probabilities[i] = 0.0;
+        language_model->bigrams[i].begins_number = 0;
+        language_model->bigrams[i].begins = NULL;
+    }
+
+    for (i = 0; i < files_number; i++)
+    {
+        for (j = 0; j < words_mlf_data[i].transcription_size; j++)
+        {
+            word_i = words_mlf_data[i].transcription[j].node_data;
+            if ((word_i >= words_number) || (word_i < 0))
+            {
+                is_ok = 0;
+                break;
+            }
+            words_frequencies[word_i]++;
+            total_words_count++;
+        }
+    }
+    if (!is_ok)
+    {
+        free_language_model(language_model);
+        free(words_frequencies);
+        return 0;
+    }
+    for (i = 0; i < words_number; i++)
+    {
+        if (words_frequencies[i] < 1)
+        {
+            words_frequencies[i] = 1;
+            total_words_count++;
+        }
+    }
+    for (i = 0; i < words_number; i++)
+    {
+        language_model->unigrams_probabilities[i]
+                = (float)words_frequencies[i] / (float)total_words_count;
+    }
+    if (!is_ok)
+    {
+        free_language_model(language_model);
+        free(words_frequencies);
+        return 0;
+    }
+
+    for (i = 0; i < files_number; i++)
+    {
+        for (j = 1; j < words_mlf_data[i].transcription_size; j++)
+        {
+            first_i = words_mlf_data[i].transcription[j-1].node_data;
+            second_i = words_mlf_data[i].transcription[j].node_data;
+            bigram_i = 0;
+            nwords = language_model->bigrams[second_i].begins_number;
+            while (bigram_i < nwords)
+            {
+                if (language_model->bigrams[second_i].begins[bigram_i].word_i
+                        == first_i)
+                {
+                    break;
+                }
+                bigram_i++;
+            }
+            if (bigram_i < nwords)
+            {
+                language_model->bigrams[second_i].begins[
+                        bigram_i].probability += 1.0;
+            }
+            else
+            {
+                language_model->bigrams[second_i].begins_number++;
+                if (nwords > 0)
+                {
+                    language_model->bigrams[second_i].begins = realloc(
+                                language_model->bigrams[second_i].begins,
+                                sizeof(TWordBigramBegin) * (nwords + 1));
+                }
+                else
+                {
+                    language_model->bigrams[second_i].begins = malloc(
+                                sizeof(TWordBigramBegin) * (nwords + 1));
+                }
+                language_model->bigrams[second_i].begins[nwords].word_i
+                        = first_i;
+                language_model->bigrams[second_i].begins[nwords].probability
+                        = 1.0;
+            }
+        }
+    }
+
+    nbigrams = 0;
+    for (i = 0; i < language_model->unigrams_number; i++)
+    {
+        j = 0;
+        while (j < language_model->bigrams[i].begins_number)
+        {
+            first_i = language_model->bigrams[i].begins[j].word_i;
+            language_model->bigrams[i].begins[j].probability
+                    /= (float)words_frequencies[first_i];
+            if (language_model->bigrams[i].begins[j].probability >= eps)
+            {
+                j++;
+            }
+            else
+            {
+                nwords = language_model->bigrams[i].begins_number;
+                memmove(language_model->bigrams[i].begins+j,
+                        language_model->bigrams[i].begins+j+1,
+                        sizeof(TWordBigramBegin) * (nwords - j - 1));
+                language_model->bigrams[i].begins_number--;
+            }
+        }
+        nwords = language_model->bigrams[i].begins_number;
+        if (nwords > 1)
+        {
+            qsort(language_model->bigrams[i].begins, nwords,
+                  sizeof(TWordBigramBegin), compare_begins_of_bigrams);
+        }
+        nbigrams += nwords;
+    }
+
+    free(words_frequencies);
+    if (nbigrams <= 0)
+    {
+        free_language_model(language_model);
+        return 0;
+    }
+
+    return 1;
+}
+
+PWordsTreeNode create_words_vocabulary_tree(
+        char *file_name, char **phonemes_vocabulary, int phonemes_number,
+        char **words_vocabulary, int words_number)
+{
+    PWordsTreeNode root = NULL;
+    int buffer_size = 0;
+    int word_index, phonemes_sequence_size = 0;
+    int is_ok = 1;
+    char buffer[BUFFER_SIZE];
+    int phonemes_sequence[BUFFER_SIZE];
+    char *word_name = NULL, *word_transcription = NULL;
+    FILE *vocabulary_file = NULL;
+
+    if ((file_name==NULL) || (words_vocabulary == NULL) || (words_number <= 0)
+            || (phonemes_vocabulary == NULL) || (phonemes_number <= 0))
+    {
+        return NULL;
+    }
+
+    vocabulary_file = fopen(file_name, "r");
+    if (vocabulary_file == NULL)
+    {
+        return NULL;
+    }
+    root = malloc(sizeof(TWordsTreeNode));
+    root->node_data = -1;
+    root->node_type = INIT_NODE;
+    root->next_nodes = NULL;
+    root->number_of_next_nodes = 0;
+    while (!feof(vocabulary_file))
+    {
+        buffer_size = read_string(vocabulary_file, buffer);
+        if (buffer_size <= 0)
+        {
+            continue;
+        }
+        if (!select_word_and_transcription(buffer, &word_name,
+                                           &word_transcription))
+        {
+            is_ok = 0;
+            break;
+        }
+        word_index = find_in_unsorted_vocabulary(
+                    words_vocabulary, words_number, word_name);
+        if (word_index < 0)
+        {
+            is_ok = 0;
+            break;
+        }
+        phonemes_sequence_size = parse_transcription_str(
+                    word_transcription, phonemes_vocabulary, phonemes_number,
+                    phonemes_sequence);
+        if (phonemes_sequence_size <= 0)
+        {
+            is_ok = 0;
+            break;
+        }
+        if (!add_word_to_words_tree(word_index, phonemes_sequence,
+                                    phonemes_sequence_size, root))
+        {
+            is_ok = 0;
+            break;
+        }
+    }
+    fclose(vocabulary_file);
+    if (is_ok)
+    {
+        if (root->number_of_next_nodes <= 0)
+        {
+            free_words_tree(&root);
+        }
+    }
+    else
+    {
+        free_words_tree(&root);
+    }
+
+    return root;
+}
+
+int word_exists_in_words_tree(int word_index, PWordsTreeNode words_tree_root)
+{
+    int i, res = 0;
+    PWordsTreeNode cur;
+    if ((word_index < 0) || (words_tree_root == NULL))
+    {
+        return 0;
+    }
+    cur = words_tree_root->next_nodes;
+    for (i = 0; i < words_tree_root->number_of_next_nodes; i++)
+    {
+        if (cur->node_type == WORD_NODE)
+        {
+            if (cur->node_data == word_index)
+            {
+                res = 1;
+                break;
+            }
+        }
+        else if (cur->node_type == PHONEME_NODE)
+        {
+            if (word_exists_in_words_tree(word_index, cur))
+            {
+                res = 1;
+                break;
+            }
+        }
+        cur++;
+    }
+    return res;
+}
+
+int create_linear_words_lexicon(
+        char *file_name, char **phonemes_vocabulary, int phonemes_number,
+        char **words_vocabulary, int words_number,
+        TLinearWordsLexicon **linear_words_lexicon)
+{
+    int words_lexicon_size = 0;
+    int buffer_size = 0;
+    int word_index, phonemes_sequence_size = 0, n;
+    int is_ok = 1;
+    char buffer[BUFFER_SIZE];
+    int phonemes_sequence[BUFFER_SIZE];
+    char *word_name = NULL, *word_transcription = NULL;
+    FILE *vocabulary_file = NULL;
+    TLinearWordsLexicon *tmp_array;
+
+    if ((file_name==NULL) || (words_vocabulary == NULL) || (words_number <= 0)
+            || (phonemes_vocabulary == NULL) || (phonemes_number <= 0)
+            || (linear_words_lexicon == NULL))
+    {
+        return 0;
+    }
+
+    vocabulary_file = fopen(file_name, "r");
+    if (vocabulary_file == NULL)
+    {
+        return 0;
+    }
+    while (!feof(vocabulary_file))
+    {
+        buffer_size = read_string(vocabulary_file, buffer);
+        if (buffer_size <= 0)
+        {
+            continue;
+        }
+        if (!select_word_and_transcription(buffer, &word_name,
+                                           &word_transcription))
+        {
+            is_ok = 0;
+            break;
+        }
+        word_index = find_in_unsorted_vocabulary(
+                    words_vocabulary, words_number, word_name);
+        if (word_index < 0)
+        {
+            is_ok = 0;
+            break;
+        }
+        phonemes_sequence_size = parse_transcription_str(
+                    word_transcription, phonemes_vocabulary, phonemes_number,
+                    phonemes_sequence);
+        if (phonemes_sequence_size <= 0)
+        {
+            is_ok = 0;
+            break;
+        }
+        words_lexicon_size++;
+        *linear_words_lexicon = realloc(
+                    *linear_words_lexicon,
+                    words_lexicon_size * sizeof(TLinearWordsLexicon));
+        tmp_array = *linear_words_lexicon;
+        tmp_array[words_lexicon_size-1].word_index = word_index;
+        n = phonemes_sequence_size + 1;
+        tmp_array[words_lexicon_size-1].phonemes_number = n;
+        tmp_array[words_lexicon_size-1].phonemes_indexes
+                = malloc(sizeof(int) * n);
+        memmove(tmp_array[words_lexicon_size-1].phonemes_indexes,
+                phonemes_sequence, phonemes_sequence_size * sizeof(int));
+        tmp_array[words_lexicon_size-1].phonemes_indexes[n-1] = 0;
+    }
+    fclose(vocabulary_file);
+    if (!is_ok)
+    {
+        free_linear_words_lexicon(linear_words_lexicon, words_lexicon_size);
+        words_lexicon_size = 0;
+    }
+    qsort(*linear_words_lexicon,words_lexicon_size,sizeof(TLinearWordsLexicon),
+          compare_items_of_words_lexicon);
+
+    return words_lexicon_size;
+}
+
+void free_MLF(TMLFFilePart **mlf_data, int number_of_MLF_parts)
+{
+    int i;
+    TMLFFilePart *cur_MLF_part;
+
+    if ((mlf_data == NULL) || (number_of_MLF_parts <= 0))
+    {
+        return;
+    }
+    if (*mlf_data == NULL)
+    {
+        return;
+    }
+
+    cur_MLF_part = *mlf_data;
+    for (i = 0; i < number_of_MLF_parts; i++)
+    {
+        if (cur_MLF_part->name != NULL)
+        {
+            free(cur_MLF_part->name);
+            cur_MLF_part->name = NULL;
+        }
+        if (cur_MLF_part->transcription != NULL)
+        {
+            free(cur_MLF_part->transcription);
+            cur_MLF_part->transcription = NULL;
+        }
+        cur_MLF_part->transcription_size = 0;
+        cur_MLF_part++;
+    }
+    free(*mlf_data);
+    *mlf_data = NULL;
+}
+
+void free_word_lattices(TWordLattice **lattices, int number_of_lattices)
+{
+    int i;
+    TWordLattice *cur_lattice;
+
+    if ((lattices == NULL) || (number_of_lattices <= 0))
+    {
+        return;
+    }
+    if (*lattices == NULL)
+    {
+        return;
+    }
+
+    cur_lattice = *lattices;
+    for (i = 0; i < number_of_lattices; i++)
+    {
+        if (cur_lattice->name != NULL)
+        {
+            free(cur_lattice->name);
+            cur_lattice->name = NULL;
+        }
+        if (cur_lattice->nodes != NULL)
+        {
+            free(cur_lattice->nodes);
+            cur_lattice->nodes = NULL;
+        }
+        if (cur_lattice->links != NULL)
+        {
+            free(cur_lattice->links);
+            cur_lattice->links = NULL;
+        }
+        cur_lattice->nodes_number = 0;
+        cur_lattice->links_number = 0;
+        cur_lattice++;
+    }
+    free(*lattices);
+    *lattices = NULL;
+}
+
+void free_nbest_lists(TNBestList **nbest_lists, int number_of_lists)
+{
+    int i, j;
+    TNBestList *cur_list;
+
+    if ((nbest_lists == NULL) || (number_of_lists <= 0))
+    {
+        return;
+    }
+    if (*nbest_lists == NULL)
+    {
+        return;
+    }
+
+    cur_list = *nbest_lists;
+    for (i = 0; i < number_of_lists; i++)
+    {
+        if (cur_list->name != NULL)
+        {
+            free(cur_list->name);
+            cur_list->name = NULL;
+        }
+        if (cur_list->hypotheses != NULL)
+        {
+            for (j = 0; j < cur_list->hypotheses_number; j++)
+            {
+                if (cur_list->hypotheses[j].words != NULL)
+                {
+                    free(cur_list->hypotheses[j].words);
+                }
+            }
+            free(cur_list->hypotheses);
+            cur_list->hypotheses = NULL;
+        }
+        cur_list->hypotheses_number = 0;
+        cur_list++;
+    }
+    free(*nbest_lists);
+    *nbest_lists = NULL;
+}
+
+void free_words_tree(PWordsTreeNode* root_node)
+{
+    PWordsTreeNode deleted_node = *root_node, next_node = NULL;
+    int i;
+
+    if (root_node == NULL)
+    {
+        return;
+    }
+    if (deleted_node == NULL)
+    {
+        return;
+    }
+
+    if ((deleted_node->number_of_next_nodes > 0) && (deleted_node->next_nodes != NULL))
+    {
+        for (i = 0; i < deleted_node->number_of_next_nodes; i++)
+        {
+            next_node = deleted_node->next_nodes + i;
+            free_words_tree_node(next_node);
+        }
+        free(deleted_node->next_nodes);
+        deleted_node->next_nodes = NULL;
+    }
+    free(deleted_node);
+    *root_node = NULL;
+}
+
+void free_linear_words_lexicon(TLinearWordsLexicon **words_lexicon,
+                               int lexicon_size)
+{
+    int i;
+    TLinearWordsLexicon *tmp;
+
+    if ((*words_lexicon == NULL) || (lexicon_size <= 0))
+    {
+        return;
+    }
+    tmp = *words_lexicon;
+    if (tmp == NULL)
+    {
+        return;
+    }
+
+    for (i = 0; i < lexicon_size; i++)
+    {
+        if (tmp[i].phonemes_indexes != NULL)
+        {
+            free(tmp[i].phonemes_indexes);
+        }
+    }
+    free(tmp);
+    *words_lexicon = NULL;
+}
+
+void free_string_array(char ***string_array, int array_size)
+{
+    char **tmp;
+    register int i;
+
+    if ((string_array == NULL) || (array_size <= 0))
+    {
+        return;
+    }
+    if (*string_array == NULL)
+    {
+        return;
+    }
+    tmp = *string_array;
+
+    for (i = 0; i < array_size; i++)
+    {
+        if (tmp[i] != NULL)
+        {
+            free(tmp[i]);
+            tmp[i] = NULL;
+        }
+    }
+    free(tmp);
+    *string_array = NULL;
+}
+
+void free_language_model(TLanguageModel *language_model)
+{
+    int i;
+    if (language_model == NULL)
+    {
+        return;
+    }
+    if (language_model->unigrams_probabilities != NULL)
+    {
+        free(language_model->unigrams_probabilities);
+        language_model->unigrams_probabilities = NULL;
+    }
+    if (language_model->bigrams != NULL)
+    {
+        for (i = 0; i < language_model->unigrams_number; i++)
+        {
+            if (language_model->bigrams[i].begins != NULL)
+            {
+                free(language_model->bigrams[i].begins);
+                language_model->bigrams[i].begins = NULL;
+            }
+        }
+        free(language_model->bigrams);
+        language_model->bigrams = NULL;
+    }
+    language_model->unigrams_number = 0;
+}
+
+float get_bigram_probability(TLanguageModel language_model, int start_word_ind,
+                             int end_word_ind)
+{
+    int first, last, middle, cmp_res;
+    TWordBigram *item = NULL;
+
+    if ((language_model.unigrams_probabilities == NULL)
+            || (language_model.unigrams_number <= 0)
+            || (language_model.bigrams == NULL))
+    {
+        return 0.0;
+    }
+    if ((start_word_ind < 0)
+            || (start_word_ind >= language_model.unigrams_number))
+    {
+        return 0.0;
+    }
+    if ((end_word_ind < 0) || (end_word_ind >= language_model.unigrams_number))
+    {
+        return 0.0;
+    }
+
+    item = language_model.bigrams + end_word_ind;
+
+    if (item->begins_number <= 0)
+    {
+        return 0.0;
+    }
+
+    first = 0; last = item->begins_number;
+
+    cmp_res = item->begins[0].word_i - start_word_ind;
+    if (cmp_res > 0)
+    {
+        return 0.0;
+    }
+    if (cmp_res == 0)
+    {
+        return item->begins[0].probability;
+    }
+
+    cmp_res = item->begins[last-1].word_i - start_word_ind;
+    if (cmp_res < 0)
+    {
+        return 0.0;
+    }
+    if (cmp_res == 0)
+    {
+        return item->begins[last-1].probability;
+    }
+
+    while (first < last)
+    {
+        middle = first + (last - first) / 2;
+
+        cmp_res = start_word_ind - item->begins[middle].word_i;
+
+        if (cmp_res <= 0)
+        {
+            last = middle;
+            if (cmp_res == 0)
+            {
+                break;
+            }
+        }
+        else
+        {
+            first = middle + 1;
+        }
+    }
+
+    cmp_res = item->begins[last].word_i - start_word_ind;
+    if (cmp_res == 0)
+    {
+        return item->begins[last].probability;
+    }
+    return 0.0;
+}
+
+int compile_language_model(TLanguageModel language_model, float lambda,
+                           TCompiledLanguageModel *compiled_model)
+{
+    int i, j, k, bigrams_number = 0;
+    float probability;
+
+    if ((language_model.unigrams_number <= 0)
+            || (language_model.unigrams_probabilities == NULL)
+            || (language_model.bigrams == NULL) || (compiled_model == NULL)
+            || (lambda < 0.0) || (lambda > 1.0))
+    {
+        return 0;
+    }
+    for (i = 0; i < language_model.unigrams_number; i++)
+    {
+        if (language_model.bigrams[i].begins_number < 0)
+        {
+            return 0;
+        }
+        if ((language_model.bigrams[i].begins_number > 0)
+                && (language_model.bigrams[i].begins == NULL))
+        {
+            return 0;
+        }
+        bigrams_number += language_model.bigrams[i].begins_number;
+    }
+
+    compiled_model->unigrams_number = language_model.unigrams_number;
+    compiled_model->lambda = lambda;
+    compiled_model->backoff_scores = malloc(language_model.unigrams_number
+                                            * sizeof(float));
+    compiled_model->bigrams_offsets = malloc((language_model.unigrams_number+1)
+                                             * sizeof(int));
+    compiled_model->bigrams_begins = malloc((bigrams_number + 1)
+                                            * sizeof(int));
+    compiled_model->bigrams_scores = malloc((bigrams_number + 1)
+                                            * sizeof(float));
+
+    k = 0;
+    for (i = 0; i < language_model.unigrams_number; i++)
+    {
+        probability = interpolate_bigram_probability(language_model, lambda,
+                                                     0.0, i);
+        if (probability > 0.0)
+        {
+            compiled_model->backoff_scores[i] = log10(probability);
+        }
+        else
+        {
+            compiled_model->backoff_scores[i] = -FLT_MAX;
+        }
+        compiled_model->bigrams_offsets[i] = k;
+        for (j = 0; j < language_model.bigrams[i].begins_number; j++)
+        {
+            probability = interpolate_bigram_probability(
+                        language_model, lambda,
+                        language_model.bigrams[i].begins[j].probability, i);
+            compiled_model->bigrams_begins[k]
+                    = language_model.bigrams[i].begins[j].word_i;
+            if (probability > 0.0)
+            {
+                compiled_model->bigrams_scores[k] = log10(probability);
+            }
+            else
+            {
+                compiled_model->bigrams_scores[k] = -FLT_MAX;
+            }
+            k++;
+        }
+    }
+    compiled_model->bigrams_offsets[language_model.unigrams_number] = k;
+
+    /* The forward index of bigrams is built by the counting sort of bigrams
+     * by their started words. Bigrams of each started word are ordered by
+     * increase of their last words, because the source bigrams are ordered by
+     * last words. */
+    compiled_model->successors_offsets = malloc(
+                (language_model.unigrams_number + 1) * sizeof(int));
+    compiled_model->successors_ends = malloc((bigrams_number + 1)
+                                             * sizeof(int));
+    compiled_model->successors_scores = malloc((bigrams_number + 1)
+                                               * sizeof(float));
+    for (i = 0; i <= language_model.unigrams_number; i++)
+    {
+        compiled_model->successors_offsets[i] = 0;
+    }
+    for (k = 0; k < bigrams_number; k++)
+    {
+        j = compiled_model->bigrams_begins[k];
+        if ((j >= 0) && (j < language_model.unigrams_number))
+        {
+            compiled_model->successors_offsets[j + 1]++;
+        }
+    }
+    for (i = 0; i < language_model.unigrams_number; i++)
+    {
+        compiled_model->successors_offsets[i + 1]
+                += compiled_model->successors_offsets[i];
+    }
+    for (i = 0; i < language_model.unigrams_number; i++)
+    {
+        for (k = compiled_model->bigrams_offsets[i];
+             k < compiled_model->bigrams_offsets[i + 1]; k++)
+        {
+            j = compiled_model->bigrams_begins[k];
+            if ((j < 0) || (j >= language_model.unigrams_number))
+            {
+                continue;
+            }
+            j = compiled_model->successors_offsets[j]++;
+            compiled_model->successors_ends[j] = i;
+            compiled_model->successors_scores[j]
+                    = compiled_model->bigrams_scores[k];
         }
     }
+    for (i = language_model.unigrams_number; i > 0; i--)
+    {
+        compiled_model->successors_offsets[i]
+                = compiled_model->successors_offsets[i - 1];
+    }
+    compiled_model->successors_offsets[0] = 0;
 
-    if (!is_ok)
+    return 1;
+}
+
+void free_compiled_language_model(TCompiledLanguageModel *compiled_model)
+{
+    if (compiled_model == NULL)
     {
-        free_MLF(mlf_data, n_files);
-        n_files = 0;
+        return;
     }
-    return n_files;
+    if (compiled_model->backoff_scores != NULL)
+    {
+        free(compiled_model->backoff_scores);
+        compiled_model->backoff_scores = NULL;
+    }
+    if (compiled_model->bigrams_offsets != NULL)
+    {
+        free(compiled_model->bigrams_offsets);
+        compiled_model->bigrams_offsets = NULL;
+    }
+    if (compiled_model->bigrams_begins != NULL)
+    {
+        free(compiled_model->bigrams_begins);
+        compiled_model->bigrams_begins = NULL;
+    }
+    if (compiled_model->bigrams_scores != NULL)
+    {
+        free(compiled_model->bigrams_scores);
+        compiled_model->bigrams_scores = NULL;
+    }
+    if (compiled_model->successors_offsets != NULL)
+    {
+        free(compiled_model->successors_offsets);
+        compiled_model->successors_offsets = NULL;
+    }
+    if (compiled_model->successors_ends != NULL)
+    {
+        free(compiled_model->successors_ends);
+        compiled_model->successors_ends = NULL;
+    }
+    if (compiled_model->successors_scores != NULL)
+    {
+        free(compiled_model->successors_scores);
+        compiled_model->successors_scores = NULL;
+    }
+    compiled_model->unigrams_number = 0;
 }
 
-int save_words_MLF(char *mlf_name, char **words_vocabulary, int words_number,
-                   TMLFFilePart *mlf_data, int files_number)
+/* This function allocates memory for the recognition workspace. The Viterbi
+ * matrix of workspace is created on basis of the linear words lexicon (if
+ * words_tree_root is NULL) or on basis of the words tree. Buffers for phonemes
+ * sequences and for the traceback array are allocated at recognition (see
+ * enlarge_recognition_workspace() and reserve_traceback_item()). As result,
+ * this function returns 1 in case of success, or 0 in case of error. */
+static int create_recognition_workspace(
+        TRecognitionWorkspace *workspace, TLinearWordsLexicon words_lexicon[],
+        int words_lexicon_size, PWordsTreeNode words_tree_root,
+        TDecoderParameters pruning)
 {
-    int i, j, ret = files_number;
-    FILE *mlf_file = NULL;
-    PTranscriptionNode node_ptr;
-    char *word_name;
+    workspace->traceback.items = NULL;
+    workspace->traceback.first_time = 0;
+    workspace->traceback.capacity = 0;
+    workspace->traceback.marks = NULL;
+    workspace->traceback.committed_cost = 0.0;
+    workspace->records_word_ends = 0;
+    workspace->word_ends.items = NULL;
+    workspace->word_ends.items_number = 0;
+    workspace->word_ends.items_capacity = 0;
+    workspace->word_ends.times_offsets = NULL;
+    workspace->word_ends.costs_offsets = NULL;
+    workspace->word_ends.times_number = 0;
+    workspace->word_ends.times_capacity = 0;
+    workspace->word_ends.selected_costs = NULL;
+    workspace->word_ends.selected_capacity = 0;
+    workspace->word_ends.required_words = NULL;
+    workspace->word_ends.required_capacity = 0;
+    workspace->phonemes_sequence = NULL;
+    workspace->phonemes_weights = NULL;
+    workspace->phonemes_repeats = NULL;
+    workspace->frames_start_times = NULL;
+    workspace->frames_end_times = NULL;
+    workspace->capacity = 0;
+    workspace->words_sequence = NULL;
+    workspace->committed_words = NULL;
+    workspace->committed_words_number = 0;
+    workspace->committed_words_capacity = 0;
+    workspace->linear_data.states_memory = NULL;
+    workspace->linear_data.words_sizes = NULL;
+    workspace->linear_data.times_number = 0;
+    workspace->linear_data.words_number = 0;
+    if (words_tree_root != NULL)
+    {
+        workspace->use_words_tree = 1;
+        return create_words_tree_matrix(&(workspace->tree_data),
+                                        words_tree_root, pruning);
+    }
+    workspace->use_words_tree = 0;
+    create_viterbi_matrix(&(workspace->linear_data), words_lexicon_size,
+                          words_lexicon, pruning);
+    return (workspace->linear_data.states_memory != NULL);
+}
 
-    if ((mlf_name == NULL) || (words_vocabulary == NULL) || (words_number <= 0)
-            || (mlf_data == NULL) || (files_number <= 0))
+/* This function frees all memory which was allocated for the recognition
+ * workspace. */
+static void delete_recognition_workspace(TRecognitionWorkspace *workspace)
+{
+    if (workspace->use_words_tree)
     {
-        return 0;
+        delete_words_tree_matrix(&(workspace->tree_data));
+    }
+    else
+    {
+        delete_viterbi_matrix(&(workspace->linear_data));
+    }
+    if (workspace->traceback.items != NULL)
+    {
+        free(workspace->traceback.items);
+        workspace->traceback.items = NULL;
+    }
+    if (workspace->traceback.marks != NULL)
+    {
+        free(workspace->traceback.marks);
+        workspace->traceback.marks = NULL;
+    }
+    workspace->traceback.capacity = 0;
+    if (workspace->word_ends.items != NULL)
+    {
+        free(workspace->word_ends.items);
+        workspace->word_ends.items = NULL;
+    }
+    if (workspace->word_ends.times_offsets != NULL)
+    {
+        free(workspace->word_ends.times_offsets);
+        workspace->word_ends.times_offsets = NULL;
+    }
+    if (workspace->word_ends.costs_offsets != NULL)
+    {
+        free(workspace->word_ends.costs_offsets);
+        workspace->word_ends.costs_offsets = NULL;
+    }
+    if (workspace->word_ends.selected_costs != NULL)
+    {
+        free(workspace->word_ends.selected_costs);
+        workspace->word_ends.selected_costs = NULL;
+    }
+    if (workspace->word_ends.required_words != NULL)
+    {
+        free(workspace->word_ends.required_words);
+        workspace->word_ends.required_words = NULL;
+    }
+    workspace->word_ends.items_capacity = 0;
+    workspace->word_ends.times_capacity = 0;
+    workspace->word_ends.selected_capacity = 0;
+    workspace->word_ends.required_capacity = 0;
+    if (workspace->phonemes_sequence != NULL)
+    {
+        free(workspace->phonemes_sequence);
+        workspace->phonemes_sequence = NULL;
+    }
+    if (workspace->phonemes_weights != NULL)
+    {
+        free(workspace->phonemes_weights);
+        workspace->phonemes_weights = NULL;
+    }
+    if (workspace->phonemes_repeats != NULL)
+    {
+        free(workspace->phonemes_repeats);
+        workspace->phonemes_repeats = NULL;
+    }
+    if (workspace->frames_start_times != NULL)
+    {
+        free(workspace->frames_start_times);
+        workspace->frames_start_times = NULL;
+    }
+    if (workspace->frames_end_times != NULL)
+    {
+        free(workspace->frames_end_times);
+        workspace->frames_end_times = NULL;
+    }
+    workspace->capacity = 0;
+    if (workspace->words_sequence != NULL)
+    {
+        free(workspace->words_sequence);
+        workspace->words_sequence = NULL;
+    }
+    if (workspace->committed_words != NULL)
+    {
+        free(workspace->committed_words);
+        workspace->committed_words = NULL;
     }
+    workspace->committed_words_number = 0;
+    workspace->committed_words_capacity = 0;
+}
 
-    mlf_file = fopen(mlf_name, "w");
-    if (mlf_file == NULL)
+/* This function enlarges buffers of phonemes sequence of the recognition
+ * workspace so that the phonemes sequence with the given length can be
+ * kept. */
+static void enlarge_recognition_workspace(TRecognitionWorkspace *workspace,
+                                          int capacity)
+{
+    if (capacity <= workspace->capacity)
     {
-        return 0;
+        return;
     }
+    workspace->capacity = capacity;
+    workspace->phonemes_sequence = realloc(
+                workspace->phonemes_sequence,
+                workspace->capacity * sizeof(int));
+    workspace->phonemes_weights = realloc(
+                workspace->phonemes_weights,
+                workspace->capacity * sizeof(float));
+    workspace->phonemes_repeats = realloc(
+                workspace->phonemes_repeats,
+                workspace->capacity * sizeof(int));
+    workspace->frames_start_times = realloc(
+                workspace->frames_start_times,
+                workspace->capacity * sizeof(long unsigned));
+    workspace->frames_end_times = realloc(
+                workspace->frames_end_times,
+                workspace->capacity * sizeof(long unsigned));
+}
 
-    if (fprintf(mlf_file, "%s\n", MLF_HEADER) <= 0)
+/* This function returns number of time points which are calculated by the
+ * Viterbi matrix of the recognition workspace for the current phonemes
+ * sequence. */
+static int get_number_of_recognized_frames(TRecognitionWorkspace *workspace)
+{
+    return workspace->use_words_tree ? workspace->tree_data.times_number
+                                     : workspace->linear_data.times_number;
+}
+
+/* This function prepares the recognition workspace for recognition of new
+ * phonemes sequence. Word ends of this sequence are recorded if the
+ * records_word_ends is 1. */
+static void reset_recognition_workspace(TRecognitionWorkspace *workspace,
+                                        int records_word_ends)
+{
+    if (workspace->use_words_tree)
     {
-        ret = 0;
+        workspace->tree_data.times_number = 0;
     }
     else
     {
-        for (i = 0; i < files_number; i++)
+        workspace->linear_data.times_number = 0;
+    }
+    workspace->traceback.first_time = 0;
+    workspace->traceback.committed_cost = 0.0;
+    workspace->committed_words_number = 0;
+    workspace->records_word_ends = records_word_ends;
+    workspace->word_ends.items_number = 0;
+    workspace->word_ends.times_number = 0;
+}
+
+/* This function finds the latest item of the traceback array which is common
+ * for words histories of all unpruned hypotheses of the workspace, i.e. for all
+ * words sequences which can be found by the traceback array at this time or
+ * later. Any unpruned hypothesis of the linear words lexicon which has the
+ * backtrack pointer b will be continued by the item of the time b-1 (see
+ * finish_viterbi_matrix()), and the item of the previous time can be used by
+ * the next time point also. Any unpruned hypothesis of the words tree which
+ * has the backtrack pointer b is continued by the item of the time b. Each
+ * item refers to the earlier item, therefore the common item is found by one
+ * pass over the traceback array from the last item to the first one, and
+ * distinct items which are referred by hypotheses or by later items are marked
+ * at this pass. As result, this function returns time of the common item, or
+ * -1 if words histories of hypotheses don't have any common item.
+ */
+static int find_common_traceback_item(TRecognitionWorkspace *workspace)
+{
+    TTraceback traceback = workspace->traceback;
+    int times_number = get_number_of_recognized_frames(workspace);
+    int j, w, s, first, last, item_time, marks_number = 0, res = -1;
+    float *costs, dead_cost;
+    int *btps;
+
+    if ((times_number - traceback.first_time) < 2)
+    {
+        return -1;
+    }
+    memset(traceback.marks, 0, (times_number - traceback.first_time)
+           * sizeof(unsigned char));
+    if (workspace->use_words_tree)
+    {
+        costs = workspace->tree_data.costs[(times_number - 1) % 2];
+        btps = workspace->tree_data.btps[(times_number - 1) % 2];
+        dead_cost = workspace->tree_data.dead_cost;
+        for (s = 0; s < workspace->tree_data.states_number; s++)
         {
-            if ((mlf_data->name == NULL) || (mlf_data->transcription == NULL)
-                    || (mlf_data->transcription_size <= 0))
+            if ((costs[s] + workspace->tree_data.lookahead_scores[s])
+                    <= dead_cost)
             {
-                ret = 0;
-                break;
+                continue;
             }
-            if (fprintf(mlf_file, "\"%s\"\n", mlf_data->name) <= 0)
+            if (btps[s] < traceback.first_time)
             {
-                ret = 0;
-                break;
+                return -1;
             }
-            node_ptr = mlf_data->transcription;
-            for (j = 0; j < mlf_data->transcription_size; j++)
+            if (!traceback.marks[btps[s] - traceback.first_time])
             {
-                if ((node_ptr->node_data < 0)
-                        || (node_ptr->node_data >= words_number))
+                traceback.marks[btps[s] - traceback.first_time] = 1;
+                marks_number++;
+            }
+        }
+    }
+    else
+    {
+        costs = workspace->linear_data.costs[(times_number - 1) % 2];
+        btps = workspace->linear_data.btps[(times_number - 1) % 2];
+        dead_cost = workspace->linear_data.dead_cost;
+        traceback.marks[times_number - 2 - traceback.first_time] = 1;
+        marks_number++;
+        for (j = 0; j < workspace->linear_data.active_words_number; j++)
+        {
+            w = workspace->linear_data.active_words[j];
+            first = workspace->linear_data.states_offsets[w];
+            last = workspace->linear_data.last_states[w];
+            for (s = first; s <= last;
+                 s += workspace->linear_data.states_strides[w])
+            {
+                if (costs[s] <= dead_cost)
                 {
-                    ret = 0;
-                    break;
+                    continue;
                 }
-                word_name = words_vocabulary[node_ptr->node_data];
-                if (word_name == NULL)
+                if ((btps[s] - 1) < traceback.first_time)
                 {
-                    ret = 0;
-                    break;
+                    return -1;
                 }
-                if (fprintf(mlf_file, "%s\n", word_name) <= 0)
+                if (!traceback.marks[btps[s] - 1 - traceback.first_time])
                 {
-                    ret = 0;
-                    break;
+                    traceback.marks[btps[s] - 1 - traceback.first_time] = 1;
+                    marks_number++;
                 }
-                node_ptr++;
-            }
-            if (!ret)
-            {
-                break;
-            }
-            if (fprintf(mlf_file, "%c\n", '.') <= 0)
-            {
-                ret = 0;
-                break;
             }
-            mlf_data++;
         }
     }
-    fclose(mlf_file);
 
-    return ret;
+    for (item_time = times_number - 1; item_time >= traceback.first_time;
+         item_time--)
+    {
+        j = item_time - traceback.first_time;
+        if (!traceback.marks[j])
+        {
+            continue;
+        }
+        if (marks_number == 1)
+        {
+            res = item_time;
+            break;
+        }
+        marks_number--;
+        /* time of the item which is referred by the marked item */
+        s = traceback.items[j].start_time - 1;
+        if (s < traceback.first_time)
+        {
+            break;
+        }
+        if (!traceback.marks[s - traceback.first_time])
+        {
+            traceback.marks[s - traceback.first_time] = 1;
+            marks_number++;
+        }
+    }
+
+    return res;
 }
 
-int load_phonemes_vocabulary(char *file_name, char ***phonemes_vocabulary)
+/* This function commits words of the best words sequence which can't be
+ * changed by the next phonemes: all words histories of unpruned hypotheses pass
+ * through the common item of the traceback array (see
+ * find_common_traceback_item()), so words which are found by the traceback
+ * array before the common item are appended to the committed words sequence,
+ * and items before the common item are removed. The common item itself is
+ * kept, because its word is used by the language model of the words tree. As
+ * result, this function returns number of removed items.
+ */
+static int commit_stable_words(TRecognitionWorkspace *workspace)
 {
-    int i, buffer_size = 0, vocabulary_size = 0;
-    char buffer[BUFFER_SIZE];
-    char **temp_vocabulary;
-    FILE *vocabulary_file = NULL;
+    TTraceback *traceback = &(workspace->traceback);
+    int times_number = get_number_of_recognized_frames(workspace);
+    int i, n, common_item_time, new_first_time;
 
-    if (phonemes_vocabulary == NULL)
+    common_item_time = find_common_traceback_item(workspace);
+    if (common_item_time < 0)
     {
         return 0;
     }
-    *phonemes_vocabulary = NULL;
-
-    vocabulary_file = fopen(file_name, "r");
-    if (vocabulary_file == NULL)
+    new_first_time = traceback->items[common_item_time
+                                      - traceback->first_time].start_time;
+    if (new_first_time <= traceback->first_time)
     {
         return 0;
     }
-    while (!feof(vocabulary_file))
+
+    n = get_words_sequence_by_traceback(*traceback, new_first_time - 1,
+                                        workspace->words_sequence);
+    if ((workspace->committed_words_number + n)
+            > workspace->committed_words_capacity)
     {
-        buffer_size = read_string(vocabulary_file, buffer);
-        if (buffer_size <= 0)
-        {
-            continue;
-        }
-        i = find_in_unsorted_vocabulary(*phonemes_vocabulary, vocabulary_size,
-                                        buffer);
-        if (i < 0)
-        {
-            *phonemes_vocabulary = realloc(*phonemes_vocabulary,
-                                           (vocabulary_size+1)*sizeof(char*));
-            temp_vocabulary = *phonemes_vocabulary;
-            i = vocabulary_size;
-            temp_vocabulary[i] = malloc((buffer_size+1) * sizeof(char));
-            memset(temp_vocabulary[i], 0, (buffer_size+1) * sizeof(char));
-            strcpy(temp_vocabulary[i], buffer);
-            vocabulary_size++;
-        }
+        workspace->committed_words_capacity
+                = 2 * (workspace->committed_words_number + n);
+        workspace->committed_words = realloc(
+                    workspace->committed_words,
+                    workspace->committed_words_capacity
+                    * sizeof(TTranscriptionNode));
+    }
+    for (i = 0; i < n; i++)
+    {
+        workspace->committed_words[workspace->committed_words_number++]
+                = workspace->words_sequence[i];
     }
-    fclose(vocabulary_file);
 
-    return vocabulary_size;
+    if (n > 0)
+    {
+        /* scores of next words are calculated from the end of the last
+           committed word */
+        traceback->committed_cost = traceback->items[
+                new_first_time - 1 - traceback->first_time].cost;
+    }
+
+    n = new_first_time - traceback->first_time;
+    memmove(traceback->items, traceback->items + n,
+            (times_number - new_first_time) * sizeof(TTracebackArrayItem));
+    traceback->first_time = new_first_time;
+
+    return n;
 }
 
-int calculate_confusion_penalties_matrix(
-        char *confusion_matrix_name, int phonemes_number,
-        float confusion_penalties_matrix[])
+/* This function guarantees that the traceback array of the workspace can keep
+ * the item of the next time point. If the traceback array is full, then stable
+ * words are committed at first (see commit_stable_words()), and the traceback
+ * array is enlarged only if more than half of it is still used after that.
+ */
+static void reserve_traceback_item(TRecognitionWorkspace *workspace)
 {
-    FILE *matrix_file = NULL;
-    int *confusion_matrix = NULL;
-    char buffer[BUFFER_SIZE];
-    char *value_str;
-    int i, j, index, buffer_size, value = 0, is_ok = 1;
-    float sum_value = 0.0;
+    TTraceback *traceback = &(workspace->traceback);
+    int items_number = get_number_of_recognized_frames(workspace) + 1
+            - traceback->first_time;
 
-    if ((confusion_matrix_name == NULL) || (phonemes_number <= 0)
-            || (confusion_penalties_matrix == NULL))
+    if (items_number <= traceback->capacity)
     {
-        return 0;
+        return;
     }
-
-    matrix_file = fopen(confusion_matrix_name, "r");
-    if (matrix_file == NULL)
+    items_number -= commit_stable_words(workspace);
+    if ((2 * items_number) <= traceback->capacity)
     {
-        return 0;
+        return;
     }
-    i = 0;
-    confusion_matrix = malloc((phonemes_number+1) * (phonemes_number+1)
-                              * sizeof(int));
-    memset(confusion_matrix, 0, (phonemes_number+1) * (phonemes_number+1)
-           * sizeof(int));
-    while (!feof(matrix_file))
+    traceback->capacity *= 2;
+    if (traceback->capacity < MIN_TRACEBACK_CAPACITY)
     {
-        buffer_size = read_string(matrix_file, buffer);
-        if (buffer_size <= 0)
-        {
-            continue;
-        }
-        if (i > phonemes_number)
-        {
-            is_ok = 0;
-            break;
-        }
-        j = 0;
-        value_str = strtok(buffer, " \t");
-        if (value_str == NULL)
-        {
-            is_ok = 0;
-            break;
-        }
-        if (sscanf(value_str, "%d", &value) != 1)
-        {
-            is_ok = 0;
-            break;
-        }
-        if (value < 0)
-        {
-            is_ok = 0;
-            break;
-        }
-        confusion_matrix[i*(phonemes_number+1)+j] = value;
-        j++;
-        value_str = strtok(NULL, " \t");
-        while (value_str != NULL)
-        {
-            if (j > phonemes_number)
-            {
-                is_ok = 0;
-                break;
-            }
-            if (sscanf(value_str, "%d", &value) != 1)
+        traceback->capacity = MIN_TRACEBACK_CAPACITY;
+    }
+    traceback->items = realloc(traceback->items, traceback->capacity
+                               * sizeof(TTracebackArrayItem));
+    traceback->marks = realloc(traceback->marks, traceback->capacity
+                               * sizeof(unsigned char));
+    /* each word takes one time point at least */
+    workspace->words_sequence = realloc(
+                workspace->words_sequence,
+                traceback->capacity * sizeof(TTranscriptionNode));
+}
+
+/* This function recognizes the next phoneme (the inp_phoneme_i with the
+ * phoneme_weight, which lasts the given number of frames called repeats) of
+ * the phonemes sequence by means of the given workspace. The next_phonemes
+ * are input phonemes of following time points which are known (see
+ * update_viterbi_matrix()), and their number is next_phonemes_number. Bounds
+ * of this time point (in 100ns units) are written into the traceback array.
+ * Recognition of new sequence is started if nothing is recognized yet
+ * (times_number of the Viterbi matrix is zero).
+ *
+ * This function is called by all threads of the team which recognizes the
+ * phonemes sequence (see recognize_phonemes_sequence()). Time points of the
+ * Viterbi matrix are calculated by all threads together, and other work is
+ * done by one thread. As result, this function returns 1 in case of success,
+ * or 0 if all hypotheses became impossible (the same value in all threads).
+ */
+static int recognize_next_phoneme(
+        TRecognitionWorkspace *workspace, int inp_phoneme_i,
+        float phoneme_weight, int repeats, int next_phonemes[],
+        int next_phonemes_number, long unsigned frame_start_time,
+        long unsigned frame_end_time,
+        int phonemes_vocabulary_size, float confusion_penalties[],
+        TDecoderParameters pruning, TCompiledLanguageModel language_model)
+{
+    TWordEndsTable *word_ends = workspace->records_word_ends
+            ? &(workspace->word_ends) : NULL;
+    TTracebackArrayItem *item;
+    int is_started = workspace->use_words_tree
+            ? (workspace->tree_data.times_number > 0)
+            : (workspace->linear_data.times_number > 0);
+    int result = 1;
+
+    /* the traceback array is enlarged by one thread, so the matrix isn't
+       changed until all threads check whether it is started */
+    #pragma omp single
+    {
+        reserve_traceback_item(workspace);
+        item = workspace->traceback.items
+                + (get_number_of_recognized_frames(workspace)
+                   - workspace->traceback.first_time);
+        item->frame_start_time = frame_start_time;
+        item->frame_end_time = frame_end_time;
+        item->cost = 0.0;
+    }
+    if (workspace->use_words_tree)
+    {
+        #pragma omp single copyprivate(result)
+        {
+            if (!is_started)
             {
-                is_ok = 0;
-                break;
+                start_words_tree_matrix(
+                            &(workspace->tree_data), inp_phoneme_i,
+                            phoneme_weight, repeats, phonemes_vocabulary_size,
+                            confusion_penalties);
             }
-            if (value < 0)
+            else
             {
-                is_ok = 0;
-                break;
+                result = update_words_tree_matrix(
+                            &(workspace->tree_data), workspace->traceback,
+                            word_ends, inp_phoneme_i, phoneme_weight, repeats,
+                            phonemes_vocabulary_size, confusion_penalties,
+                            pruning, language_model);
             }
-            confusion_matrix[i*(phonemes_number+1)+j] = value;
-            j++;
-            value_str = strtok(NULL, " \t");
         }
-        if (is_ok)
+        return result;
+    }
+    if (!is_started)
+    {
+        #pragma omp single
         {
-            if (j != (phonemes_number+1))
-            {
-                is_ok = 0;
-            }
+            start_viterbi_matrix(&(workspace->linear_data), inp_phoneme_i,
+                                 phoneme_weight, repeats,
+                                 phonemes_vocabulary_size,
+                                 confusion_penalties);
+            /* the cost of the first time point is written if some word can
+               be ended at this time */
+            finish_viterbi_matrix(workspace->linear_data,
+                                  workspace->traceback);
         }
-        if (!is_ok)
+        return 1;
+    }
+    return update_viterbi_matrix(
+                &(workspace->linear_data), workspace->traceback, word_ends,
+                inp_phoneme_i, phoneme_weight, repeats, next_phonemes,
+                next_phonemes_number, phonemes_vocabulary_size,
+                confusion_penalties, pruning, language_model);
+}
+
+/* This function finds the best words sequence for all phonemes which are
+ * recognized by the workspace at this moment, and it creates transcription of
+ * this words sequence (memory for the transcription is allocated if the words
+ * sequence isn't empty). The committed words sequence is placed in the
+ * beginning of transcription. Recognition of the current phonemes sequence can
+ * be continued after that. As result, this function returns length of the
+ * words sequence, or -1 in case of error (if there isn't any alive word end).
+ */
+static int create_words_transcription_by_workspace(
+        TRecognitionWorkspace *workspace, TTranscriptionNode **transcription)
+{
+    int times_number, words_sequence_length;
+    int n = workspace->committed_words_number;
+
+    *transcription = NULL;
+    times_number = get_number_of_recognized_frames(workspace);
+    if (workspace->use_words_tree)
+    {
+        /* the best word end is written at each time point except the first
+           one */
+        if (times_number < 2)
         {
-            break;
+            return -1;
         }
-        i++;
     }
-    if (is_ok)
+    else if (!finish_viterbi_matrix(workspace->linear_data,
+                                    workspace->traceback))
     {
-        if (i != (phonemes_number+1))
+        return -1;
+    }
+    words_sequence_length = get_words_sequence_by_traceback(
+                workspace->traceback, times_number - 1,
+                workspace->words_sequence);
+    if ((n + words_sequence_length) > 0)
+    {
+        *transcription = malloc((n + words_sequence_length)
+                                * sizeof(TTranscriptionNode));
+        if (*transcription == NULL)
         {
-            is_ok = 0;
+            return -1;
+        }
+        if (n > 0)
+        {
+            memcpy(*transcription, workspace->committed_words,
+                   n * sizeof(TTranscriptionNode));
+        }
+        if (words_sequence_length > 0)
+        {
+            memcpy(*transcription + n, workspace->words_sequence,
+                   words_sequence_length * sizeof(TTranscriptionNode));
         }
     }
-    fclose(matrix_file);
-    if (!is_ok)
+
+    return n + words_sequence_length;
+}
+
+/* This function adds the link into the word lattice. Memory of links is
+ * enlarged if necessary (the links_capacity is its current size). */
+static void add_link_to_word_lattice(TWordLattice *lattice, int *links_capacity,
+                                     int start_node, int end_node,
+                                     float acoustic_score, float language_score)
+{
+    TLatticeLink *link;
+
+    if (lattice->links_number >= *links_capacity)
+    {
+        *links_capacity = (*links_capacity > 0) ? (2 * (*links_capacity))
+                                                : MIN_WORD_ENDS_CAPACITY;
+        lattice->links = realloc(lattice->links,
+                                 (*links_capacity) * sizeof(TLatticeLink));
+    }
+    link = lattice->links + lattice->links_number;
+    link->start_node = start_node;
+    link->end_node = end_node;
+    link->acoustic_score = acoustic_score;
+    link->language_score = language_score;
+    lattice->links_number++;
+}
+
+/* This function creates the word lattice which consists of the start node and
+ * the end node only. Such lattice corresponds to the phonemes sequence without
+ * any word. */
+static void create_empty_word_lattice(TWordLattice *lattice)
+{
+    int links_capacity = 0;
+
+    lattice->nodes_number = 2;
+    lattice->nodes = malloc(2 * sizeof(TLatticeNode));
+    lattice->nodes[0].word_index = -1;
+    lattice->nodes[0].end_time = 0;
+    lattice->nodes[1].word_index = -1;
+    lattice->nodes[1].end_time = 0;
+    lattice->links_number = 0;
+    lattice->links = NULL;
+    add_link_to_word_lattice(lattice, &links_capacity, 0, 1, 0.0, 0.0);
+}
+
+/* This function creates the word lattice by word ends which are recorded by
+ * the workspace for the last recognized phonemes sequence (see
+ * decoder_generate_lattices()).
+ *
+ * At first, the best cost of transition into the word of each word end from
+ * word ends of the time before this word is found by one pass from the first
+ * time to the last one (word ends without any transition are unreachable from
+ * the start node). Transitions into words of the words tree are made from the
+ * best word end of each time point only. Then word ends from which the end
+ * node can be reached are marked by one pass from the last time to the first
+ * one, and these word ends become nodes of the lattice. As result, this
+ * function returns 1 in case of success, or 0 if the end node can't be
+ * reached from the start node.
+ */
+static int create_word_lattice_by_workspace(
+        TRecognitionWorkspace *workspace,
+        TCompiledLanguageModel language_model, TWordLattice *lattice)
+{
+    TWordEndsTable table = workspace->word_ends;
+    TWordEndItem *items = table.items, *item;
+    int times_number = table.times_number;
+    int t, b, i, j, j_best, nodes_number, links_capacity = 0;
+    float *entry_costs = NULL, cost, score;
+    int *nodes_indexes = NULL;
+    unsigned char *used_times = NULL;
+
+    lattice->nodes = NULL;
+    lattice->nodes_number = 0;
+    lattice->links = NULL;
+    lattice->links_number = 0;
+    if ((times_number <= 0) || (table.times_offsets[times_number-1]
+                                >= table.times_offsets[times_number]))
     {
-        free(confusion_matrix);
         return 0;
     }
-    for (i = 0; i < phonemes_number; i++)
+    entry_costs = malloc(table.items_number * sizeof(float));
+    nodes_indexes = malloc(table.items_number * sizeof(int));
+    used_times = malloc(times_number * sizeof(unsigned char));
+
+    for (i = 0; i < table.items_number; i++)
     {
-        sum_value = 0;
-        for (j = 0; j < phonemes_number; j++)
+        item = items + i;
+        b = item->predecessor_time;
+        if (b < 0)
         {
-            sum_value += confusion_matrix[i*(phonemes_number+1)+j];
+            entry_costs[i] = 0.0;
+            continue;
         }
-        if (sum_value > 0)
+        entry_costs[i] = -FLT_MAX;
+        j_best = -1;
+        for (j = table.times_offsets[b]; j < table.times_offsets[b+1]; j++)
         {
-            for (j = 0; j < phonemes_number; j++)
+            if ((j_best < 0) || (items[j].cost > items[j_best].cost))
             {
-                confusion_penalties_matrix[i*phonemes_number+j]
-                        = confusion_matrix[i*(phonemes_number+1)+j]/sum_value;
+                j_best = j;
+            }
+            if (workspace->use_words_tree
+                    || (entry_costs[j] <= (-FLT_MAX + FLT_EPSILON)))
+            {
+                continue;
+            }
+            score = get_bigram_score(language_model, items[j].word,
+                                     item->word);
+            if (score <= MIN_TRANSITION_SCORE)
+            {
+                continue;
+            }
+            if ((items[j].cost + score) > entry_costs[i])
+            {
+                entry_costs[i] = items[j].cost + score;
             }
         }
-        else
+        if (workspace->use_words_tree && (j_best >= 0)
+                && (entry_costs[j_best] > (-FLT_MAX + FLT_EPSILON)))
         {
-            is_ok = 0;
-            break;
+            score = get_bigram_score(language_model, items[j_best].word,
+                                     item->word);
+            if (score > MIN_TRANSITION_SCORE)
+            {
+                entry_costs[i] = items[j_best].cost + score;
+            }
         }
     }
-    free(confusion_matrix);
-    if (!is_ok)
+
+    memset(used_times, 0, times_number * sizeof(unsigned char));
+    used_times[times_number-1] = 1;
+    nodes_number = 0;
+    for (t = times_number - 1; t >= 0; t--)
     {
-        return 0;
+        for (i = table.times_offsets[t]; i < table.times_offsets[t+1]; i++)
+        {
+            nodes_indexes[i] = -1;
+            if (!used_times[t]
+                    || (entry_costs[i] <= (-FLT_MAX + FLT_EPSILON)))
+            {
+                continue;
+            }
+            nodes_indexes[i] = nodes_number++;
+            if (items[i].predecessor_time >= 0)
+            {
+                used_times[items[i].predecessor_time] = 1;
+            }
+        }
     }
-    for (i = 0; i < phonemes_number; i++)
+
+    if (nodes_number == 0)
     {
-        for (j = 0; j < phonemes_number; j++)
+        free(entry_costs);
+        free(nodes_indexes);
+        free(used_times);
+        return 0;
+    }
+    /* nodes were numbered from the last time, so their numbers are reversed */
+    lattice->nodes_number = nodes_number + 2;
+    lattice->nodes = malloc(lattice->nodes_number * sizeof(TLatticeNode));
+    lattice->nodes[0].word_index = -1;
+    lattice->nodes[0].end_time = workspace->frames_start_times[0];
+    lattice->nodes[nodes_number+1].word_index = -1;
+    lattice->nodes[nodes_number+1].end_time
+            = workspace->frames_end_times[times_number-1];
+    for (t = 0; t < times_number; t++)
+    {
+        for (i = table.times_offsets[t]; i < table.times_offsets[t+1]; i++)
         {
-            index = i * phonemes_number + j;
-            if (confusion_penalties_matrix[index] > 0.0)
+            if (nodes_indexes[i] < 0)
             {
-                confusion_penalties_matrix[index]
-                        = log10(confusion_penalties_matrix[index]);
+                continue;
+            }
+            nodes_indexes[i] = nodes_number - nodes_indexes[i];
+            lattice->nodes[nodes_indexes[i]].word_index = items[i].word;
+            lattice->nodes[nodes_indexes[i]].end_time
+                    = workspace->frames_end_times[t];
+            item = items + i;
+            b = item->predecessor_time;
+            /* costs of different times have different offsets */
+            cost = (float)(item->cost + table.costs_offsets[t]
+                           - entry_costs[i]
+                           - ((b >= 0) ? table.costs_offsets[b] : 0.0));
+            if (b < 0)
+            {
+                add_link_to_word_lattice(lattice, &links_capacity, 0,
+                                         nodes_indexes[i], cost, 0.0);
             }
             else
             {
-                confusion_penalties_matrix[index] = -FLT_MAX;
+                for (j = table.times_offsets[b]; j < table.times_offsets[b+1];
+                     j++)
+                {
+                    if (nodes_indexes[j] < 0)
+                    {
+                        continue;
+                    }
+                    score = get_bigram_score(language_model, items[j].word,
+                                             item->word);
+                    if (score <= MIN_TRANSITION_SCORE)
+                    {
+                        continue;
+                    }
+                    add_link_to_word_lattice(lattice, &links_capacity,
+                                             nodes_indexes[j],
+                                             nodes_indexes[i], cost, score);
+                }
+            }
+            if (t == (times_number - 1))
+            {
+                add_link_to_word_lattice(lattice, &links_capacity,
+                                         nodes_indexes[i], nodes_number + 1,
+                                         0.0, 0.0);
             }
         }
     }
+
+    free(entry_costs);
+    free(nodes_indexes);
+    free(used_times);
+
     return 1;
 }
 
-int load_words_vocabulary(char *file_name, char ***words_vocabulary)
+/* This function inserts the path into the priority queue of the A* search
+ * (the queue capacity is enlarged if necessary). */
+static void push_nbest_queue(TNBestQueueItem **queue, int *queue_size,
+                             int *queue_capacity, int path, float priority)
 {
-    int i, n, buffer_size = 0, vocabulary_size = 0;
-    int is_ok = 1;
-    char buffer[BUFFER_SIZE];
-    char *word_name = NULL, *word_transcription = NULL;
-    char **temp_vocabulary;
-    FILE *vocabulary_file = NULL;
+    int i, parent;
+    TNBestQueueItem new_item;
 
-    if (words_vocabulary == NULL)
+    if (*queue_size >= *queue_capacity)
     {
-        return 0;
+        *queue_capacity = (*queue_capacity > 0) ? (2 * (*queue_capacity))
+                                                : MIN_NBEST_PATHS_CAPACITY;
+        *queue = realloc(*queue, (*queue_capacity) * sizeof(TNBestQueueItem));
     }
-    *words_vocabulary = NULL;
+    new_item.priority = priority;
+    new_item.path = path;
+    i = (*queue_size)++;
+    while (i > 0)
+    {
+        parent = (i - 1) / 2;
+        if ((*queue)[parent].priority >= priority)
+        {
+            break;
+        }
+        (*queue)[i] = (*queue)[parent];
+        i = parent;
+    }
+    (*queue)[i] = new_item;
+}
 
-    vocabulary_file = fopen(file_name, "r");
-    if (vocabulary_file == NULL)
+/* This function removes the path with the greatest priority from the priority
+ * queue of the A* search, and it returns index of this path. */
+static int pop_nbest_queue(TNBestQueueItem *queue, int *queue_size)
+{
+    int i, child, res = queue[0].path;
+    TNBestQueueItem last_item = queue[--(*queue_size)];
+
+    i = 0;
+    while ((2 * i + 1) < *queue_size)
+    {
+        child = 2 * i + 1;
+        if (((child + 1) < *queue_size)
+                && (queue[child+1].priority > queue[child].priority))
+        {
+            child++;
+        }
+        if (last_item.priority >= queue[child].priority)
+        {
+            break;
+        }
+        queue[i] = queue[child];
+        i = child;
+    }
+    queue[i] = last_item;
+
+    return res;
+}
+
+/* This function checks whether two paths of the A* search have the same words
+ * sequence. The start node and the end node aren't words, so they are
+ * skipped. */
+static int nbest_paths_are_same(TNBestPath paths[], TWordLattice *lattice,
+                                int first_path, int second_path)
+{
+    int first_word, second_word;
+
+    if ((paths[first_path].words_number != paths[second_path].words_number)
+            || (paths[first_path].hash != paths[second_path].hash))
     {
         return 0;
     }
-    while (!feof(vocabulary_file))
+    while ((first_path >= 0) && (second_path >= 0))
     {
-        buffer_size = read_string(vocabulary_file, buffer);
-        if (buffer_size <= 0)
+        first_word = lattice->nodes[paths[first_path].node].word_index;
+        second_word = lattice->nodes[paths[second_path].node].word_index;
+        if (first_word < 0)
         {
+            first_path = paths[first_path].previous;
             continue;
         }
-        if (!select_word_and_transcription(buffer, &word_name,
-                                           &word_transcription))
+        if (second_word < 0)
         {
-            is_ok = 0;
-            break;
+            second_path = paths[second_path].previous;
+            continue;
         }
-        if (find_in_unsorted_vocabulary(*words_vocabulary, vocabulary_size,
-                                        word_name) < 0)
+        if (first_word != second_word)
         {
-            *words_vocabulary = realloc(*words_vocabulary,
-                                        (vocabulary_size+1) * sizeof(char*));
-            temp_vocabulary = *words_vocabulary;
-            i = vocabulary_size;
-            n = strlen(word_name);
-            temp_vocabulary[i] = malloc((n+1) * sizeof(char));
-            memset(temp_vocabulary[i], 0, (n+1) * sizeof(char));
-            strcpy(temp_vocabulary[i], word_name);
-            vocabulary_size++;
+            return 0;
         }
-    }
-    fclose(vocabulary_file);
-    if (!is_ok)
-    {
-        free_string_array(words_vocabulary, vocabulary_size);
-        vocabulary_size = 0;
+        first_path = paths[first_path].previous;
+        second_path = paths[second_path].previous;
     }
 
-    return vocabulary_size;
+    return 1;
 }
 
-int load_language_model(char *file_name,  int words_number,
-                        TLanguageModel *language_model)
+/* This function finds no more than nbest_size best paths of the word lattice
+ * with different words sequences by the A* search, and it writes these words
+ * sequences into the N-best list.
+ *
+ * The heuristic of the A* search is the exact score of the best path from the
+ * node to the end node, so paths come to the end node in order of descending
+ * of their scores. Nodes are sorted by time, so this heuristic is found by one
+ * pass from the last node to the first one. If some node is reached by the
+ * path with the same words sequence as one of paths which have been expanded
+ * from this node, then continuations of this path are the same as
+ * continuations of the expanded path, but they are worse. Such path is
+ * dropped, and also no more than nbest_size paths are expanded from each node.
+ * Therefore the search time is limited by the number of links multiplied by
+ * the nbest_size. */
+static void find_nbest_in_word_lattice(TWordLattice *lattice, int nbest_size,
+                                       TNBestList *nbest_list)
 {
-    int i, j, n = 0, is_ok = 1;
-    FILE *h_file = NULL;
+    int i, j, k, n, end_node = lattice->nodes_number - 1;
+    int paths_number = 0, paths_capacity = 0, queue_size = 0;
+    int queue_capacity = 0, words_number, is_new;
+    int *links_offsets = NULL, *links_indexes = NULL;
+    int *expanded_paths = NULL, *expanded_numbers = NULL;
+    float *best_scores = NULL, score;
+    TNBestPath *paths = NULL, *path;
+    TNBestQueueItem *queue = NULL;
+    TLatticeLink *link;
+    TWordsHypothesis *hypothesis;
+    TTranscriptionNode *word;
 
-    if (language_model == NULL)
+    nbest_list->hypotheses = malloc(nbest_size * sizeof(TWordsHypothesis));
+    nbest_list->hypotheses_number = 0;
+
+    /* outgoing links of each node are grouped together */
+    links_offsets = malloc((lattice->nodes_number + 1) * sizeof(int));
+    links_indexes = malloc(lattice->links_number * sizeof(int));
+    memset(links_offsets, 0, (lattice->nodes_number + 1) * sizeof(int));
+    for (i = 0; i < lattice->links_number; i++)
     {
-        return 0;
+        links_offsets[lattice->links[i].start_node + 1]++;
     }
-    language_model->unigrams_number = 0;
-    language_model->unigrams_probabilities = NULL;
-    language_model->bigrams = NULL;
-
-    h_file = fopen(file_name, "rb");
-    if (h_file == NULL)
+    for (i = 0; i < lattice->nodes_number; i++)
     {
-        return 0;
+        links_offsets[i+1] += links_offsets[i];
     }
-
-    if (fread(&n, sizeof(int), 1, h_file) != 1)
+    expanded_numbers = malloc(lattice->nodes_number * sizeof(int));
+    memcpy(expanded_numbers, links_offsets,
+           lattice->nodes_number * sizeof(int));
+    for (i = 0; i < lattice->links_number; i++)
     {
-        fclose(h_file);
-        return 0;
+        links_indexes[expanded_numbers[lattice->links[i].start_node]++] = i;
     }
-    if (n != words_number)
+
+    best_scores = malloc(lattice->nodes_number * sizeof(float));
+    for (i = end_node; i >= 0; i--)
     {
-        fclose(h_file);
-        return 0;
+        best_scores[i] = (i == end_node) ? 0.0 : -FLT_MAX;
+        for (j = links_offsets[i]; j < links_offsets[i+1]; j++)
+        {
+            link = lattice->links + links_indexes[j];
+            if (best_scores[link->end_node] <= (-FLT_MAX + FLT_EPSILON))
+            {
+                continue;
+            }
+            score = best_scores[link->end_node] + link->acoustic_score
+                    + link->language_score;
+            if (score > best_scores[i])
+            {
+                best_scores[i] = score;
+            }
+        }
     }
-    language_model->unigrams_probabilities = malloc(n * sizeof(float));
-    language_model->unigrams_number = n;
-    language_model->bigrams = malloc(n * sizeof(TWordBigram));
-    for (i = 0; i < n; i++)
+
+    memset(expanded_numbers, 0, lattice->nodes_number * sizeof(int));
+    expanded_paths = malloc(lattice->nodes_number * nbest_size * sizeof(int));
+    if (best_scores[0] > (-FLT_MAX + FLT_EPSILON))
     {
-        language_model->bigrams[i].begins_number = 0;
-        language_model->bigrams[i].begins = NULL;
+        paths_capacity = MIN_NBEST_PATHS_CAPACITY;
+        paths = malloc(paths_capacity * sizeof(TNBestPath));
+        paths[0].node = 0;
+        paths[0].previous = -1;
+        paths[0].words_number = 0;
+        paths[0].hash = 0;
+        paths[0].score = 0.0;
+        paths_number = 1;
+        push_nbest_queue(&queue, &queue_size, &queue_capacity, 0,
+                         best_scores[0]);
     }
-    if (fread(language_model->unigrams_probabilities, sizeof(float), n, h_file)
-            != n)
+    while ((queue_size > 0) && (nbest_list->hypotheses_number < nbest_size))
     {
-        free_language_model(language_model);
-        fclose(h_file);
-        return 0;
+        i = pop_nbest_queue(queue, &queue_size);
+        n = paths[i].node;
+        if (expanded_numbers[n] >= nbest_size)
+        {
+            continue;
+        }
+        is_new = 1;
+        for (k = 0; k < expanded_numbers[n]; k++)
+        {
+            if (nbest_paths_are_same(paths, lattice, i,
+                                     expanded_paths[n * nbest_size + k]))
+            {
+                is_new = 0;
+                break;
+            }
+        }
+        if (!is_new)
+        {
+            continue;
+        }
+        expanded_paths[n * nbest_size + expanded_numbers[n]] = i;
+        expanded_numbers[n]++;
+
+        if (n == end_node)
+        {
+            hypothesis = nbest_list->hypotheses
+                    + nbest_list->hypotheses_number;
+            nbest_list->hypotheses_number++;
+            hypothesis->score = paths[i].score;
+            hypothesis->words_number = paths[i].words_number;
+            hypothesis->words = NULL;
+            if (hypothesis->words_number > 0)
+            {
+                hypothesis->words = malloc(hypothesis->words_number
+                                           * sizeof(TTranscriptionNode));
+            }
+            words_number = hypothesis->words_number;
+            for (j = i; paths[j].previous >= 0; j = paths[j].previous)
+            {
+                k = lattice->nodes[paths[j].node].word_index;
+                if (k < 0)
+                {
+                    continue;
+                }
+                /* the word begins at the end of its predecessor */
+                words_number--;
+                word = hypothesis->words + words_number;
+                word->node_data = k;
+                word->start_time = lattice->nodes[
+                        paths[paths[j].previous].node].end_time;
+                word->end_time = lattice->nodes[paths[j].node].end_time;
+                set_score_of_word(word, paths[j].score
+                                  - paths[paths[j].previous].score);
+            }
+            continue;
+        }
+
+        for (j = links_offsets[n]; j < links_offsets[n+1]; j++)
+        {
+            link = lattice->links + links_indexes[j];
+            if (best_scores[link->end_node] <= (-FLT_MAX + FLT_EPSILON))
+            {
+                continue;
+            }
+            if (paths_number >= paths_capacity)
+            {
+                paths_capacity *= 2;
+                paths = realloc(paths, paths_capacity * sizeof(TNBestPath));
+            }
+            path = paths + paths_number;
+            path->node = link->end_node;
+            path->previous = i;
+            path->score = paths[i].score + link->acoustic_score
+                    + link->language_score;
+            k = lattice->nodes[link->end_node].word_index;
+            if (k >= 0)
+            {
+                path->words_number = paths[i].words_number + 1;
+                path->hash = paths[i].hash * 31 + (unsigned int)(k + 1);
+            }
+            else
+            {
+                path->words_number = paths[i].words_number;
+                path->hash = paths[i].hash;
+            }
+            push_nbest_queue(&queue, &queue_size, &queue_capacity,
+                             paths_number,
+                             path->score + best_scores[link->end_node]);
+            paths_number++;
+        }
+    }
+
+    free(links_offsets);
+    free(links_indexes);
+    free(expanded_numbers);
+    free(expanded_paths);
+    free(best_scores);
+    if (paths != NULL)
+    {
+        free(paths);
     }
-    for (i = 0; i < n; i++)
+    if (queue != NULL)
     {
-        if ((language_model->unigrams_probabilities[i] < 0.0)
-                || (language_model->unigrams_probabilities[i] > 1.0))
-        {
-            is_ok = 0;
-            break;
-        }
+        free(queue);
     }
-    if (!is_ok)
+}
+
+/* This function returns the number of threads of the team which recognizes
+ * phonemes by means of the given workspace (see recognize_next_phoneme()).
+ * Time points of the words tree are calculated by one thread. */
+static int get_threads_number_of_workspace(TRecognitionWorkspace *workspace)
+{
+    return workspace->use_words_tree ? 1
+                                     : workspace->linear_data.threads_number;
+}
+
+/* This function recognizes the phonemes sequence of one part of the source MLF
+ * file by means of the given workspace, and it writes the recognized words
+ * sequence into the corresponding part of the result MLF file. Also the word
+ * lattice of this phonemes sequence is created if the lattice isn't NULL.
+ * Buffers of the workspace are enlarged if necessary. All phonemes of the
+ * sequence are recognized by one team of threads, which is created once for
+ * the whole sequence (if this function is called in the parallel region, then
+ * the team consists of the calling thread only). As result, this function
+ * returns 1 in case of success, or 0 in case of error. */
+static int recognize_phonemes_sequence(
+        TRecognitionWorkspace *workspace, TMLFFilePart *source_part,
+        TMLFFilePart *result_part, TWordLattice *lattice,
+        int phonemes_vocabulary_size, float confusion_penalties_matrix[],
+        TDecoderParameters pruning, TCompiledLanguageModel language_model)
+{
+    int t, next_phonemes_number, phonemes_sequence_length;
+    int words_sequence_length, recognized_phonemes_number = 0;
+    int max_next_phonemes_number = (pruning.fast_match_depth > 1)
+            ? pruning.fast_match_depth : 1;
+
+    phonemes_sequence_length = create_phonemes_sequence_by_transcription(
+                source_part->transcription, source_part->transcription_size,
+                pruning, NULL, NULL, NULL, NULL, NULL);
+    if (phonemes_sequence_length < 0)
     {
-        free_language_model(language_model);
-        fclose(h_file);
         return 0;
     }
-
-    for (i = 0; i < language_model->unigrams_number; i++)
+    if (phonemes_sequence_length == 0)
     {
-        if (fread(&n, sizeof(int), 1, h_file) != 1)
-        {
-            fclose(h_file);
-            return 0;
-        }
-        if (n < 0)
+        if (lattice != NULL)
         {
-            is_ok = 0;
-            break;
+            create_empty_word_lattice(lattice);
         }
-        if (n > 0)
+        return 1;
+    }
+    enlarge_recognition_workspace(workspace, phonemes_sequence_length);
+    phonemes_sequence_length = create_phonemes_sequence_by_transcription(
+                source_part->transcription, source_part->transcription_size,
+                pruning, workspace->phonemes_sequence,
+                workspace->phonemes_weights, workspace->phonemes_repeats,
+                workspace->frames_start_times, workspace->frames_end_times);
+
+    reset_recognition_workspace(workspace, lattice != NULL);
+    #pragma omp parallel num_threads(get_threads_number_of_workspace(workspace))\
+                         if(!omp_in_parallel()) private(t, \
+                                                        next_phonemes_number)
+    {
+        for (t = 0; t < phonemes_sequence_length; t++)
         {
-            language_model->bigrams[i].begins_number = n;
-            language_model->bigrams[i].begins
-                    = malloc(n * sizeof(TWordBigramBegin));
-            if (fread(language_model->bigrams[i].begins,
-                      sizeof(TWordBigramBegin), n, h_file) != n)
+            /* following phonemes are known until the first segment */
+            next_phonemes_number = 0;
+            while ((next_phonemes_number < max_next_phonemes_number)
+                   && ((t + next_phonemes_number + 1)
+                       < phonemes_sequence_length)
+                   && (workspace->phonemes_repeats[
+                           t + next_phonemes_number + 1] == 1))
             {
-                is_ok = 0;
-                break;
-            }
-            for (j = 0; j < n; j++)
-            {
-                if ((language_model->bigrams[i].begins[j].word_i < 0)
-                        || (language_model->bigrams[i].begins[j].word_i
-                            >= language_model->unigrams_number))
-                {
-                    is_ok = 0;
-                    break;
-                }
-                if ((language_model->bigrams[i].begins[j].probability < 0.0)
-                        ||(language_model->bigrams[i].begins[j].probability
-                           > 1.0))
-                {
-                    is_ok = 0;
-                    break;
-                }
+                next_phonemes_number++;
             }
-            if (!is_ok)
+            if (!recognize_next_phoneme(
+                        workspace, workspace->phonemes_sequence[t],
+                        workspace->phonemes_weights[t],
+                        workspace->phonemes_repeats[t],
+                        workspace->phonemes_sequence + t + 1,
+                        next_phonemes_number,
+                        workspace->frames_start_times[t],
+                        workspace->frames_end_times[t],
+                        phonemes_vocabulary_size, confusion_penalties_matrix,
+                        pruning, language_model))
             {
                 break;
             }
-            qsort(language_model->bigrams[i].begins,
-                  language_model->bigrams[i].begins_number,
-                  sizeof(TWordBigramBegin), compare_begins_of_bigrams);
         }
+        #pragma omp master
+        recognized_phonemes_number = t;
     }
-    if (!is_ok)
+    if (recognized_phonemes_number < phonemes_sequence_length)
+    {
+        return 0;
+    }
+    words_sequence_length = create_words_transcription_by_workspace(
+                workspace, &(result_part->transcription));
+    if (words_sequence_length < 0)
     {
-        free_language_model(language_model);
         return 0;
     }
+    result_part->transcription_size = words_sequence_length;
+    if (lattice != NULL)
+    {
+        return create_word_lattice_by_workspace(workspace, language_model,
+                                                lattice);
+    }
+
     return 1;
 }
 
-int save_language_model(char *file_name, TLanguageModel language_model)
+/* This function replaces the confusion penalties matrix and scores of the
+ * language model of the decoder by their copies which are rounded for the
+ * fixed-point mode (see quantize_score()). Offsets and begins of bigrams
+ * aren't changed, so they are shared with the source language model. If the
+ * fixed-point mode isn't used, then models remain as is.
+ */
+static void quantize_models_of_decoder(PDecoder decoder)
 {
-    int i, n, is_ok = 1;
-    FILE *h_file = NULL;
+    int fixed_point_bits = decoder->parameters.fixed_point_bits;
+    int phonemes_vocabulary_size = decoder->models.phonemes_vocabulary_size;
+    TCompiledLanguageModel *language_model = &(decoder->models.language_model);
+    int i, n;
 
-    if ((file_name == NULL) || (language_model.unigrams_number <= 0)
-            || (language_model.bigrams == NULL)
-            || (language_model.unigrams_probabilities == NULL))
+    decoder->quantized_penalties = NULL;
+    decoder->quantized_backoff_scores = NULL;
+    decoder->quantized_bigrams_scores = NULL;
+    decoder->quantized_successors_scores = NULL;
+    if (fixed_point_bits <= 0)
     {
-        return 0;
+        return;
     }
 
-    h_file = fopen(file_name, "wb");
-    if (h_file == NULL)
+    n = phonemes_vocabulary_size * phonemes_vocabulary_size;
+    decoder->quantized_penalties = malloc(n * sizeof(float));
+    for (i = 0; i < n; i++)
     {
-        return 0;
+        decoder->quantized_penalties[i] = quantize_score(
+                    decoder->models.confusion_penalties_matrix[i],
+                    fixed_point_bits);
     }
+    decoder->models.confusion_penalties_matrix = decoder->quantized_penalties;
 
-    n = language_model.unigrams_number;
-    if (fwrite(&n, sizeof(int), 1, h_file) != 1)
-    {
-        fclose(h_file);
-        return 0;
-    }
-    if (fwrite(language_model.unigrams_probabilities, sizeof(float), n, h_file)
-            != n)
+    n = language_model->unigrams_number;
+    decoder->quantized_backoff_scores = malloc(n * sizeof(float));
+    for (i = 0; i < n; i++)
     {
-        fclose(h_file);
-        return 0;
+        decoder->quantized_backoff_scores[i] = quantize_score(
+                    language_model->backoff_scores[i], fixed_point_bits);
     }
+    language_model->backoff_scores = decoder->quantized_backoff_scores;
 
-    for (i = 0; i < language_model.unigrams_number; i++)
+    n = language_model->bigrams_offsets[language_model->unigrams_number];
+    if (n > 0)
     {
-        n = language_model.bigrams[i].begins_number;
-        if (fwrite(&n, sizeof(int), 1, h_file) != 1)
+        decoder->quantized_bigrams_scores = malloc(n * sizeof(float));
+        for (i = 0; i < n; i++)
         {
-            is_ok = 0;
-            break;
+            decoder->quantized_bigrams_scores[i] = quantize_score(
+                        language_model->bigrams_scores[i], fixed_point_bits);
         }
-        if (n > 0)
+        language_model->bigrams_scores = decoder->quantized_bigrams_scores;
+    }
+
+    n = language_model->successors_offsets[language_model->unigrams_number];
+    if (n > 0)
+    {
+        decoder->quantized_successors_scores = malloc(n * sizeof(float));
+        for (i = 0; i < n; i++)
         {
-            if (fwrite(language_model.bigrams[i].begins,
-                       sizeof(TWordBigramBegin), n, h_file) != n)
-            {
-                is_ok = 0;
-                break;
-            }
+            decoder->quantized_successors_scores[i] = quantize_score(
+                        language_model->successors_scores[i],
+                        fixed_point_bits);
         }
+        language_model->successors_scores
+                = decoder->quantized_successors_scores;
     }
-
-    fclose(h_file);
-    return is_ok;
 }
 
-int calculate_language_model(TMLFFilePart *words_mlf_data, int files_number,
-                             int words_number, float eps,
-                             TLanguageModel *language_model)
+/* This function creates the emission table of the decoder, i.e. penalties of
+ * confusions of phonemes of all states of the Viterbi matrix (or of the words
+ * tree) with each input phoneme. The row of the input phoneme is indexed by
+ * the state number in the same layout as costs of states, so each time step
+ * reads penalties contiguously instead of gathering them from the confusion
+ * penalties matrix by phonemes of states. Phoneme weights aren't included
+ * into the table, therefore results are the same as without it. Layout of
+ * states is identical in all workspaces, so one table is shared by them. The
+ * table isn't created if its size (number of penalties) exceeds the
+ * max_emission_table_size of decoder parameters, and then penalties are
+ * gathered at each time step as before.
+ */
+static void create_emission_table(PDecoder decoder)
 {
-    int i, j, word_i, bigram_i, is_ok = 1, total_words_count = 0;
-    int first_i, second_i, nwords, nbigrams;
-    int *words_frequencies = NULL;
+    TRecognitionWorkspace *workspace = decoder->workspaces;
+    int phonemes_vocabulary_size = decoder->models.phonemes_vocabulary_size;
+    float *confusion_penalties = decoder->models.confusion_penalties_matrix;
+    int states_number, row_size, inp_phoneme_i, trg_phoneme_i, i, s;
+    float *row;
 
-    if ((words_mlf_data == NULL) || (files_number <= 0) || (words_number <= 0)
-            || (eps < 0.0) || (eps >= 1.0) || (language_model == NULL))
+    decoder->emission_table = NULL;
+    if ((decoder->workspaces_number <= 0)
+            || (decoder->parameters.max_emission_table_size <= 0))
     {
-        return 0;
+        return;
     }
-
-    language_model->unigrams_number = words_number;
-    language_model->unigrams_probabilities = malloc(words_number
-                                                    * sizeof(float));
-    words_frequencies = malloc(words_number * sizeof(int));
-    memset(words_frequencies, 0, words_number * sizeof(int));
-    language_model->bigrams = malloc(words_number * sizeof(TWordBigram));
-
-    for (i = 0; i < words_number; i++)
+    states_number = workspace->use_words_tree
+            ? workspace->tree_data.states_number
+            : workspace->linear_data.states_number;
+    row_size = MEMORY_ALIGNMENT / sizeof(float);
+    row_size = ((states_number + row_size - 1) / row_size) * row_size;
+    if ((double)row_size * phonemes_vocabulary_size
+            > decoder->parameters.max_emission_table_size)
     {
-        language_model->unigrams_probabilities[i] = 0.0;
-        language_model->bigrams[i].begins_number = 0;
-        language_model->bigrams[i].begins = NULL;
+        return;
     }
-
-    for (i = 0; i < files_number; i++)
+    decoder->emission_table = malloc_aligned_memory(
+                row_size * phonemes_vocabulary_size * sizeof(float));
+    for (inp_phoneme_i = 0; inp_phoneme_i < phonemes_vocabulary_size;
+         inp_phoneme_i++)
     {
-        for (j = 0; j < words_mlf_data[i].transcription_size; j++)
+        row = decoder->emission_table + inp_phoneme_i * row_size;
+        for (s = 0; s < row_size; s++)
         {
-            word_i = words_mlf_data[i].transcription[j].node_data;
-            if ((word_i >= words_number) || (word_i < 0))
+            if (s >= states_number)
             {
-                is_ok = 0;
-                break;
+                trg_phoneme_i = -1;
             }
-            words_frequencies[word_i]++;
-            total_words_count++;
+            else if (!workspace->use_words_tree)
+            {
+                trg_phoneme_i = workspace->linear_data.states_phonemes[s];
+            }
+            else if (s < workspace->tree_data.nodes_number)
+            {
+                trg_phoneme_i = workspace->tree_data.nodes_phonemes[s];
+            }
+            else
+            {
+                trg_phoneme_i = 0;
+            }
+            row[s] = (trg_phoneme_i >= 0)
+                    ? confusion_penalties[trg_phoneme_i
+                                          * phonemes_vocabulary_size
+                                          + inp_phoneme_i]
+                    : -FLT_MAX;
         }
     }
-    if (!is_ok)
-    {
-        free_language_model(language_model);
-        free(words_frequencies);
-        return 0;
-    }
-    for (i = 0; i < words_number; i++)
+    for (i = 0; i < decoder->workspaces_number; i++)
     {
-        if (words_frequencies[i] < 1)
-        {
-            words_frequencies[i] = 1;
-            total_words_count++;
-        }
+        workspace = decoder->workspaces + i;
+        workspace->linear_data.emission_table = decoder->emission_table;
+        workspace->linear_data.emission_row_size = row_size;
+        workspace->tree_data.emission_table = decoder->emission_table;
+        workspace->tree_data.emission_row_size = row_size;
     }
-    for (i = 0; i < words_number; i++)
+}
+
+/* This function creates scores of the language model lookahead for states of
+ * the words tree of the decoder. The score of the pause state of each leaf is
+ * the score of its word without context, i.e. its backoff score (or the best
+ * score of bigrams which end in this word if the backoff score is impossible),
+ * and the score of each phoneme node is the maximum of scores of all words
+ * which are reachable from this node. The best bigram score isn't used as the
+ * score of word, because it is applicable after one predecessor only, and it
+ * is too optimistic for pruning in other contexts. Nodes are numbered in
+ * breadth-first order, so scores are propagated from children to parents in
+ * the reverse order of nodes. Impossible words don't restrict the lookahead,
+ * and their scores are zero (as well as scores of nodes which lead to such
+ * words only). If the lookahead isn't used, then all scores are zero, so
+ * pruning costs are equal to costs of hypotheses. Scores are taken from the
+ * language model of the decoder, which is quantized in the fixed-point mode,
+ * therefore pruning costs are exact in this mode too.
+ */
+static void create_lookahead_scores(PDecoder decoder)
+{
+    TRecognitionWorkspace *workspace = decoder->workspaces;
+    TCompiledLanguageModel language_model = decoder->models.language_model;
+    TWordsTreeMatrix data;
+    float *scores;
+    float score;
+    int i, l, n, s, w, parent;
+
+    decoder->lookahead_scores = NULL;
+    if ((decoder->workspaces_number <= 0) || !workspace->use_words_tree)
     {
-        language_model->unigrams_probabilities[i]
-                = (float)words_frequencies[i] / (float)total_words_count;
+        return;
     }
-    if (!is_ok)
+    data = workspace->tree_data;
+    scores = malloc(data.states_number * sizeof(float));
+    for (s = 0; s < data.states_number; s++)
     {
-        free_language_model(language_model);
-        free(words_frequencies);
-        return 0;
+        scores[s] = decoder->parameters.use_lm_lookahead ? -FLT_MAX : 0.0;
     }
-
-    for (i = 0; i < files_number; i++)
+    if (decoder->parameters.use_lm_lookahead)
     {
-        for (j = 1; j < words_mlf_data[i].transcription_size; j++)
+        for (l = 0; l < data.leaves_number; l++)
         {
-            first_i = words_mlf_data[i].transcription[j-1].node_data;
-            second_i = words_mlf_data[i].transcription[j].node_data;
-            bigram_i = 0;
-            nwords = language_model->bigrams[second_i].begins_number;
-            while (bigram_i < nwords)
+            w = data.leaves_words[l];
+            score = language_model.backoff_scores[w];
+            if (score <= MIN_TRANSITION_SCORE)
             {
-                if (language_model->bigrams[second_i].begins[bigram_i].word_i
-                        == first_i)
+                score = -FLT_MAX;
+                for (i = language_model.bigrams_offsets[w];
+                     i < language_model.bigrams_offsets[w+1]; i++)
                 {
-                    break;
+                    if ((language_model.bigrams_scores[i]
+                         > MIN_TRANSITION_SCORE)
+                            && (language_model.bigrams_scores[i] > score))
+                    {
+                        score = language_model.bigrams_scores[i];
+                    }
                 }
-                bigram_i++;
             }
-            if (bigram_i < nwords)
+            s = data.nodes_number + l;
+            if (score <= (-FLT_MAX + FLT_EPSILON))
             {
-                language_model->bigrams[second_i].begins[
-                        bigram_i].probability += 1.0;
+                scores[s] = 0.0;
+                continue;
             }
-            else
+            scores[s] = score;
+            n = data.leaves_nodes[l];
+            if (score > scores[n])
             {
-                language_model->bigrams[second_i].begins_number++;
-                if (nwords > 0)
-                {
-                    language_model->bigrams[second_i].begins = realloc(
-                                language_model->bigrams[second_i].begins,
-                                sizeof(TWordBigramBegin) * (nwords + 1));
-                }
-                else
-                {
-                    language_model->bigrams[second_i].begins = malloc(
-                                sizeof(TWordBigramBegin) * (nwords + 1));
-                }
-                language_model->bigrams[second_i].begins[nwords].word_i
-                        = first_i;
-                language_model->bigrams[second_i].begins[nwords].probability
-                        = 1.0;
+                scores[n] = score;
+            }
+        }
+        for (n = data.nodes_number - 1; n >= 0; n--)
+        {
+            parent = data.nodes_parents[n];
+            if ((parent >= 0) && (scores[n] > scores[parent]))
+            {
+                scores[parent] = scores[n];
+            }
+        }
+        for (n = 0; n < data.nodes_number; n++)
+        {
+            if (scores[n] <= (-FLT_MAX + FLT_EPSILON))
+            {
+                scores[n] = 0.0;
             }
         }
     }
+    decoder->lookahead_scores = scores;
+    for (i = 0; i < decoder->workspaces_number; i++)
+    {
+        decoder->workspaces[i].tree_data.lookahead_scores = scores;
+    }
+}
 
-    nbigrams = 0;
-    for (i = 0; i < language_model->unigrams_number; i++)
+/* This function creates lists of words which can be continued by each input
+ * phoneme, i.e. words whose entry at some time point can give an alive
+ * hypothesis at the next time point with this input phoneme. The entry into
+ * the word is written into its first state, and at the next time point it
+ * becomes either the first state (then the penalty of confusion of the first
+ * phoneme with the input phoneme must be possible) or the second one (if the
+ * word has three states at least, because the last state is calculated from
+ * the current time point). Also words of one state are always included,
+ * because their entries are word ends of the same time point. The list isn't
+ * created for the input phoneme if it contains a half of all words or more,
+ * and then transitions into all words are calculated. Lists are shared by all
+ * workspaces of the decoder. The words tree doesn't use these lists.
+ */
+static void create_lists_of_entering_words(PDecoder decoder)
+{
+    TRecognitionWorkspace *workspace = decoder->workspaces;
+    TViterbiMatrix *data;
+    int phonemes_vocabulary_size = decoder->models.phonemes_vocabulary_size;
+    float *confusion_penalties = decoder->models.confusion_penalties_matrix;
+    int inp_phoneme_i, trg_phoneme_i, i, w, s, n, capacity;
+
+    decoder->entering_words_offsets = NULL;
+    decoder->entering_words_numbers = NULL;
+    decoder->entering_words = NULL;
+    if ((decoder->workspaces_number <= 0) || workspace->use_words_tree)
     {
-        j = 0;
-        while (j < language_model->bigrams[i].begins_number)
+        return;
+    }
+    data = &(workspace->linear_data);
+
+    decoder->entering_words_offsets = malloc(phonemes_vocabulary_size
+                                             * sizeof(int));
+    decoder->entering_words_numbers = malloc(phonemes_vocabulary_size
+                                             * sizeof(int));
+    capacity = 0;
+    n = 0;
+    for (inp_phoneme_i = 0; inp_phoneme_i < phonemes_vocabulary_size;
+         inp_phoneme_i++)
+    {
+        decoder->entering_words_offsets[inp_phoneme_i] = n;
+        decoder->entering_words_numbers[inp_phoneme_i] = 0;
+        for (w = 0; w < data->words_number; w++)
         {
-            first_i = language_model->bigrams[i].begins[j].word_i;
-            language_model->bigrams[i].begins[j].probability
-                    /= (float)words_frequencies[first_i];
-            if (language_model->bigrams[i].begins[j].probability >= eps)
+            s = data->states_offsets[w] + data->states_strides[w];
+            trg_phoneme_i = data->states_phonemes[s];
+            if ((data->words_sizes[w] > 1)
+                    && (confusion_penalties[trg_phoneme_i
+                                            * phonemes_vocabulary_size
+                                            + inp_phoneme_i]
+                        <= (-FLT_MAX + FLT_EPSILON)))
             {
-                j++;
+                if (data->words_sizes[w] < 3)
+                {
+                    continue;
+                }
+                trg_phoneme_i = data->states_phonemes[
+                        s + data->states_strides[w]];
+                if (confusion_penalties[trg_phoneme_i
+                                        * phonemes_vocabulary_size
+                                        + inp_phoneme_i]
+                        <= (-FLT_MAX + FLT_EPSILON))
+                {
+                    continue;
+                }
             }
-            else
+            if (2 * (decoder->entering_words_numbers[inp_phoneme_i] + 1)
+                    >= data->words_number)
             {
-                nwords = language_model->bigrams[i].begins_number;
-                memmove(language_model->bigrams[i].begins+j,
-                        language_model->bigrams[i].begins+j+1,
-                        sizeof(TWordBigramBegin) * (nwords - j - 1));
-                language_model->bigrams[i].begins_number--;
+                decoder->entering_words_numbers[inp_phoneme_i] = -1;
+                break;
+            }
+            if (n >= capacity)
+            {
+                capacity = (capacity > 0) ? (2 * capacity) : data->words_number;
+                decoder->entering_words = realloc(decoder->entering_words,
+                                                  capacity * sizeof(int));
             }
+            decoder->entering_words[n++] = w;
+            decoder->entering_words_numbers[inp_phoneme_i]++;
         }
-        nwords = language_model->bigrams[i].begins_number;
-        if (nwords > 1)
+        if (decoder->entering_words_numbers[inp_phoneme_i] < 0)
         {
-            qsort(language_model->bigrams[i].begins, nwords,
-                  sizeof(TWordBigramBegin), compare_begins_of_bigrams);
+            n = decoder->entering_words_offsets[inp_phoneme_i];
         }
-        nbigrams += nwords;
     }
 
-    free(words_frequencies);
-    if (nbigrams <= 0)
+    for (i = 0; i < decoder->workspaces_number; i++)
     {
-        free_language_model(language_model);
-        return 0;
+        data = &(decoder->workspaces[i].linear_data);
+        data->entering_words_offsets = decoder->entering_words_offsets;
+        data->entering_words_numbers = decoder->entering_words_numbers;
+        data->entering_words = decoder->entering_words;
     }
-
-    return 1;
 }
 
-PWordsTreeNode create_words_vocabulary_tree(
-        char *file_name, char **phonemes_vocabulary, int phonemes_number,
-        char **words_vocabulary, int words_number)
+/* This function creates prefixes of words of the linear words lexicon for the
+ * fast match (see select_words_by_fast_match()). The prefix of word is its
+ * first fast_match_depth+1 states (or all states of shorter word), because
+ * the word which is entered at some time point can pass so many states over
+ * the next fast_match_depth time points. Words are sorted by their prefixes,
+ * and words with equal prefixes share one prefix, so each prefix is scored
+ * once for all these words, and the prefix of each word is given by its
+ * number. Prefixes aren't created if the fast match isn't
+ * used. They are shared by all workspaces of the decoder, and buffers of the
+ * fast match are allocated in each workspace.
+ */
+static void create_prefixes_of_words(PDecoder decoder)
 {
-    PWordsTreeNode root = NULL;
-    int buffer_size = 0;
-    int word_index, phonemes_sequence_size = 0;
-    int is_ok = 1;
-    char buffer[BUFFER_SIZE];
-    int phonemes_sequence[BUFFER_SIZE];
-    char *word_name = NULL, *word_transcription = NULL;
-    FILE *vocabulary_file = NULL;
+    TRecognitionWorkspace *workspace = decoder->workspaces;
+    TViterbiMatrix *data;
+    int depth = decoder->parameters.fast_match_depth;
+    int row_size = depth + 1, n = 0, i, w, k;
+    TWordPrefix *prefixes;
 
-    if ((file_name==NULL) || (words_vocabulary == NULL) || (words_number <= 0)
-            || (phonemes_vocabulary == NULL) || (phonemes_number <= 0))
+    if ((decoder->workspaces_number <= 0) || workspace->use_words_tree
+            || (depth <= 0) || (decoder->parameters.fast_match_size <= 0))
     {
-        return NULL;
+        return;
     }
+    data = &(workspace->linear_data);
 
-    vocabulary_file = fopen(file_name, "r");
-    if (vocabulary_file == NULL)
-    {
-        return NULL;
-    }
-    root = malloc(sizeof(TWordsTreeNode));
-    root->node_data = -1;
-    root->node_type = INIT_NODE;
-    root->next_nodes = NULL;
-    root->number_of_next_nodes = 0;
-    while (!feof(vocabulary_file))
+    prefixes = malloc(data->words_number * sizeof(TWordPrefix));
+    for (w = 0; w < data->words_number; w++)
     {
-        buffer_size = read_string(vocabulary_file, buffer);
-        if (buffer_size <= 0)
-        {
-            continue;
-        }
-        if (!select_word_and_transcription(buffer, &word_name,
-                                           &word_transcription))
-        {
-            is_ok = 0;
-            break;
-        }
-        word_index = find_in_unsorted_vocabulary(
-                    words_vocabulary, words_number, word_name);
-        if (word_index < 0)
-        {
-            is_ok = 0;
-            break;
-        }
-        phonemes_sequence_size = parse_transcription_str(
-                    word_transcription, phonemes_vocabulary, phonemes_number,
-                    phonemes_sequence);
-        if (phonemes_sequence_size <= 0)
-        {
-            is_ok = 0;
-            break;
-        }
-        if (!add_word_to_words_tree(word_index, phonemes_sequence,
-                                    phonemes_sequence_size, root))
+        prefixes[w].length = (data->words_sizes[w] < row_size)
+                ? data->words_sizes[w] : row_size;
+        prefixes[w].is_whole_word = (data->words_sizes[w] <= row_size);
+        for (k = 0; k <= MAX_FAST_MATCH_DEPTH; k++)
         {
-            is_ok = 0;
-            break;
+            prefixes[w].phonemes[k] = (k < prefixes[w].length)
+                    ? data->states_phonemes[data->states_offsets[w]
+                                            + (k + 1) * data->states_strides[w]]
+                    : -1;
         }
+        prefixes[w].word = w;
     }
-    fclose(vocabulary_file);
-    if (is_ok)
+    qsort(prefixes, data->words_number, sizeof(TWordPrefix),
+          compare_prefixes_of_words);
+
+    decoder->words_prefixes = malloc(data->words_number * sizeof(int));
+    decoder->prefixes_lengths = malloc(data->words_number * sizeof(int));
+    decoder->prefixes_ends = malloc(data->words_number
+                                    * sizeof(unsigned char));
+    decoder->prefixes_phonemes = malloc(data->words_number * row_size
+                                        * sizeof(int));
+    for (w = 0; w < data->words_number; w++)
     {
-        if (root->number_of_next_nodes <= 0)
+        if ((w == 0) || (compare_prefixes_of_words(prefixes + w - 1,
+                                                   prefixes + w) != 0))
         {
-            free_words_tree(&root);
+            decoder->prefixes_lengths[n] = prefixes[w].length;
+            decoder->prefixes_ends[n] = prefixes[w].is_whole_word;
+            memcpy(decoder->prefixes_phonemes + n * row_size,
+                   prefixes[w].phonemes, row_size * sizeof(int));
+            n++;
         }
+        decoder->words_prefixes[prefixes[w].word] = n - 1;
     }
-    else
+    free(prefixes);
+
+    for (i = 0; i < decoder->workspaces_number; i++)
     {
-        free_words_tree(&root);
+        data = &(decoder->workspaces[i].linear_data);
+        data->fast_match_depth = depth;
+        data->fast_match_size = decoder->parameters.fast_match_size;
+        data->prefixes_number = n;
+        data->words_prefixes = decoder->words_prefixes;
+        data->prefixes_lengths = decoder->prefixes_lengths;
+        data->prefixes_ends = decoder->prefixes_ends;
+        data->prefixes_phonemes = decoder->prefixes_phonemes;
+        data->prefixes_scores = malloc(n * sizeof(float));
+        data->fast_match_costs = malloc(data->words_number * sizeof(float));
+        data->fast_match_words = malloc(data->words_number * sizeof(int));
     }
+}
 
-    return root;
+TDecoderParameters decoder_get_default_parameters(void)
+{
+    TDecoderParameters parameters;
+
+    parameters.pruning_coeff = 0.0;
+    parameters.histogram_size = DEFAULT_HISTOGRAM_SIZE;
+    parameters.beam_width = 0.0;
+    parameters.max_active_hypotheses = 0;
+    parameters.word_end_beam = 0.0;
+    parameters.lattice_beam = 0.0;
+    parameters.lattice_size = DEFAULT_LATTICE_SIZE;
+    parameters.threads_number = 1;
+    parameters.frame_duration = DEFAULT_FRAME_DURATION;
+    parameters.max_repeats_of_phoneme = DEFAULT_MAX_REPEATS_OF_PHONEME;
+    parameters.use_segments = 0;
+    parameters.max_emission_table_size = DEFAULT_MAX_EMISSION_TABLE_SIZE;
+    parameters.fixed_point_bits = 0;
+    parameters.use_lm_lookahead = 0;
+    parameters.fast_match_depth = DEFAULT_FAST_MATCH_DEPTH;
+    parameters.fast_match_size = 0;
+
+    return parameters;
 }
 
-int word_exists_in_words_tree(int word_index, PWordsTreeNode words_tree_root)
+PDecoder decoder_create(TDecoderModels models, TDecoderParameters parameters)
 {
-    int i, res = 0;
-    PWordsTreeNode cur;
-    if ((word_index < 0) || (words_tree_root == NULL))
+    int i;
+    PDecoder decoder = NULL;
+
+    if ((models.phonemes_vocabulary_size <= 0)
+            || (models.confusion_penalties_matrix == NULL)
+            || (models.language_model.unigrams_number <= 0)
+            || (models.language_model.backoff_scores == NULL)
+            || (models.language_model.bigrams_offsets == NULL)
+            || (parameters.pruning_coeff < 0.0)
+            || (parameters.pruning_coeff > 1.0)
+            || (parameters.histogram_size < 2)
+            || (parameters.beam_width < 0.0)
+            || (parameters.max_active_hypotheses < 0)
+            || (parameters.word_end_beam < 0.0)
+            || (parameters.lattice_beam < 0.0)
+            || (parameters.lattice_size < 0)
+            || (parameters.threads_number <= 0)
+            || (parameters.frame_duration <= 0.0)
+            || (parameters.max_repeats_of_phoneme < 1)
+            || ((parameters.use_segments != 0)
+                && (parameters.use_segments != 1))
+            || (parameters.max_emission_table_size < 0)
+            || (parameters.fixed_point_bits < 0)
+            || (parameters.fixed_point_bits > MAX_FIXED_POINT_BITS)
+            || ((parameters.use_lm_lookahead != 0)
+                && (parameters.use_lm_lookahead != 1))
+            || (parameters.fast_match_depth < 0)
+            || (parameters.fast_match_depth > MAX_FAST_MATCH_DEPTH)
+            || (parameters.fast_match_size < 0))
     {
-        return 0;
+        return NULL;
     }
-    cur = words_tree_root->next_nodes;
-    for (i = 0; i < words_tree_root->number_of_next_nodes; i++)
+    if (models.words_tree_root != NULL)
     {
-        if (cur->node_type == WORD_NODE)
+        if (models.words_tree_root->node_type != INIT_NODE)
         {
-            if (cur->node_data == word_index)
-            {
-                res = 1;
-                break;
-            }
+            return NULL;
         }
-        else if (cur->node_type == PHONEME_NODE)
+        models.words_lexicon = NULL;
+        models.words_lexicon_size = 0;
+    }
+    else if ((models.words_lexicon == NULL) || (models.words_lexicon_size <= 0))
+    {
+        return NULL;
+    }
+
+    decoder = malloc(sizeof(TDecoder));
+    decoder->models = models;
+    decoder->parameters = parameters;
+    decoder->stream_state = STREAM_IS_CLOSED;
+    decoder->pauses_weights = NULL;
+    decoder->pauses_repeats = NULL;
+    decoder->pauses_start_times = NULL;
+    decoder->pauses_end_times = NULL;
+    decoder->pauses_number = 0;
+    decoder->pauses_capacity = 0;
+    decoder->emission_table = NULL;
+    decoder->lookahead_scores = NULL;
+    decoder->entering_words_offsets = NULL;
+    decoder->entering_words_numbers = NULL;
+    decoder->entering_words = NULL;
+    decoder->words_prefixes = NULL;
+    decoder->prefixes_lengths = NULL;
+    decoder->prefixes_ends = NULL;
+    decoder->prefixes_phonemes = NULL;
+    quantize_models_of_decoder(decoder);
+    decoder->workspaces_number = 0;
+    decoder->workspaces = malloc(parameters.threads_number
+                                 * sizeof(TRecognitionWorkspace));
+    for (i = 0; i < parameters.threads_number; i++)
+    {
+        if (!create_recognition_workspace(
+                    decoder->workspaces + i, models.words_lexicon,
+                    models.words_lexicon_size, models.words_tree_root,
+                    parameters))
         {
-            if (word_exists_in_words_tree(word_index, cur))
-            {
-                res = 1;
-                break;
-            }
+            delete_recognition_workspace(decoder->workspaces + i);
+            decoder_destroy(&decoder);
+            return NULL;
         }
-        cur++;
+        decoder->workspaces_number++;
     }
-    return res;
+    create_emission_table(decoder);
+    create_lookahead_scores(decoder);
+    create_lists_of_entering_words(decoder);
+    create_prefixes_of_words(decoder);
+
+    return decoder;
 }
 
-int create_linear_words_lexicon(
-        char *file_name, char **phonemes_vocabulary, int phonemes_number,
-        char **words_vocabulary, int words_number,
-        TLinearWordsLexicon **linear_words_lexicon)
+/* This function recognizes all phonemes sequences of the source MLF file by
+ * means of the decoder, and it creates word lattices of these sequences if the
+ * lattices isn't NULL. If the decoder has several workspaces, then different
+ * phonemes sequences are recognized in parallel, and each thread uses own
+ * workspace. Otherwise phonemes sequences are recognized one after another
+ * (parallelism of calculations within one time point is used in this case).
+ * Results of both modes are identical. */
+static int decode_phonemes_MLF(
+        PDecoder decoder, TMLFFilePart *source_phonemes_MLF,
+        int number_of_MLF_files, TMLFFilePart **result_words_MLF,
+        TWordLattice **lattices)
 {
-    int words_lexicon_size = 0;
-    int buffer_size = 0;
-    int word_index, phonemes_sequence_size = 0, n;
-    int is_ok = 1;
-    char buffer[BUFFER_SIZE];
-    int phonemes_sequence[BUFFER_SIZE];
-    char *word_name = NULL, *word_transcription = NULL;
-    FILE *vocabulary_file = NULL;
-    TLinearWordsLexicon *tmp_array;
+    int i, n, errors_number = 0;
+    TMLFFilePart *cur_src, *cur_result;
 
-    if ((file_name==NULL) || (words_vocabulary == NULL) || (words_number <= 0)
-            || (phonemes_vocabulary == NULL) || (phonemes_number <= 0)
-            || (linear_words_lexicon == NULL))
+    if (decoder->stream_state != STREAM_IS_CLOSED)
     {
         return 0;
     }
 
-    vocabulary_file = fopen(file_name, "r");
-    if (vocabulary_file == NULL)
+    *result_words_MLF = malloc(sizeof(TMLFFilePart) * number_of_MLF_files);
+    if (lattices != NULL)
     {
-        return 0;
+        *lattices = malloc(sizeof(TWordLattice) * number_of_MLF_files);
     }
-    while (!feof(vocabulary_file))
+    cur_src = source_phonemes_MLF;
+    cur_result = *result_words_MLF;
+    for (i = 0; i < number_of_MLF_files; i++)
     {
-        buffer_size = read_string(vocabulary_file, buffer);
-        if (buffer_size <= 0)
-        {
-            continue;
-        }
-        if (!select_word_and_transcription(buffer, &word_name,
-                                           &word_transcription))
+        cur_result->transcription_size = 0;
+        cur_result->transcription = NULL;
+        n = strlen(cur_src->name);
+        cur_result->name = malloc((n+5)*sizeof(char));
+        memset(cur_result->name, 0, (n+5)*sizeof(char));
+        strcpy(cur_result->name, cur_src->name);
+        set_new_file_extension(cur_result->name, "rec");
+        if (lattices != NULL)
         {
-            is_ok = 0;
-            break;
+            (*lattices)[i].name = malloc((n+5)*sizeof(char));
+            memset((*lattices)[i].name, 0, (n+5)*sizeof(char));
+            strcpy((*lattices)[i].name, cur_src->name);
+            set_new_file_extension((*lattices)[i].name, "lat");
+            (*lattices)[i].nodes = NULL;
+            (*lattices)[i].nodes_number = 0;
+            (*lattices)[i].links = NULL;
+            (*lattices)[i].links_number = 0;
         }
-        word_index = find_in_unsorted_vocabulary(
-                    words_vocabulary, words_number, word_name);
-        if (word_index < 0)
+        cur_result++;
+        cur_src++;
+    }
+
+    if ((decoder->workspaces_number > 1) && (number_of_MLF_files > 1))
+    {
+        #pragma omp parallel for num_threads(decoder->workspaces_number) \
+                                 schedule(dynamic)
+        for (i = 0; i < number_of_MLF_files; i++)
         {
-            is_ok = 0;
-            break;
+            if (!recognize_phonemes_sequence(
+                        decoder->workspaces + omp_get_thread_num(),
+                        source_phonemes_MLF + i, (*result_words_MLF) + i,
+                        (lattices != NULL) ? ((*lattices) + i) : NULL,
+                        decoder->models.phonemes_vocabulary_size,
+                        decoder->models.confusion_penalties_matrix,
+                        decoder->parameters, decoder->models.language_model))
+            {
+                #pragma omp atomic
+                errors_number++;
+            }
         }
-        phonemes_sequence_size = parse_transcription_str(
-                    word_transcription, phonemes_vocabulary, phonemes_number,
-                    phonemes_sequence);
-        if (phonemes_sequence_size <= 0)
+    }
+    else
+    {
+        for (i = 0; i < number_of_MLF_files; i++)
         {
-            is_ok = 0;
-            break;
+            if (!recognize_phonemes_sequence(
+                        decoder->workspaces, source_phonemes_MLF + i,
+                        (*result_words_MLF) + i,
+                        (lattices != NULL) ? ((*lattices) + i) : NULL,
+                        decoder->models.phonemes_vocabulary_size,
+                        decoder->models.confusion_penalties_matrix,
+                        decoder->parameters, decoder->models.language_model))
+            {
+                errors_number++;
+                break;
+            }
         }
-        words_lexicon_size++;
-        *linear_words_lexicon = realloc(
-                    *linear_words_lexicon,
-                    words_lexicon_size * sizeof(TLinearWordsLexicon));
-        tmp_array = *linear_words_lexicon;
-        tmp_array[words_lexicon_size-1].word_index = word_index;
-        n = phonemes_sequence_size + 1;
-        tmp_array[words_lexicon_size-1].phonemes_number = n;
-        tmp_array[words_lexicon_size-1].phonemes_indexes
-                = malloc(sizeof(int) * n);
-        memmove(tmp_array[words_lexicon_size-1].phonemes_indexes,
-                phonemes_sequence, phonemes_sequence_size * sizeof(int));
-        tmp_array[words_lexicon_size-1].phonemes_indexes[n-1] = 0;
     }
-    fclose(vocabulary_file);
-    if (!is_ok)
+    if (errors_number > 0)
     {
-        free_linear_words_lexicon(linear_words_lexicon, words_lexicon_size);
-        words_lexicon_size = 0;
+        free_MLF(result_words_MLF, number_of_MLF_files);
+        if (lattices != NULL)
+        {
+            free_word_lattices(lattices, number_of_MLF_files);
+        }
+        return 0;
     }
-    qsort(*linear_words_lexicon,words_lexicon_size,sizeof(TLinearWordsLexicon),
-          compare_items_of_words_lexicon);
 
-    return words_lexicon_size;
+    return 1;
 }
 
-void free_MLF(TMLFFilePart **mlf_data, int number_of_MLF_parts)
+int decoder_decode(PDecoder decoder, TMLFFilePart *source_phonemes_MLF,
+                   int number_of_MLF_files, TMLFFilePart **result_words_MLF)
 {
-    int i;
-    TMLFFilePart *cur_MLF_part;
-
-    if ((mlf_data == NULL) || (number_of_MLF_parts <= 0))
-    {
-        return;
-    }
-    if (*mlf_data == NULL)
+    if ((decoder == NULL) || (source_phonemes_MLF == NULL)
+            || (number_of_MLF_files <= 0) || (result_words_MLF == NULL))
     {
-        return;
+        return 0;
     }
 
-    cur_MLF_part = *mlf_data;
-    for (i = 0; i < number_of_MLF_parts; i++)
-    {
-        if (cur_MLF_part->name != NULL)
-        {
-            free(cur_MLF_part->name);
-            cur_MLF_part->name = NULL;
-        }
-        if (cur_MLF_part->transcription != NULL)
-        {
-            free(cur_MLF_part->transcription);
-            cur_MLF_part->transcription = NULL;
-        }
-        cur_MLF_part->transcription_size = 0;
-        cur_MLF_part++;
-    }
-    free(*mlf_data);
-    *mlf_data = NULL;
+    return decode_phonemes_MLF(decoder, source_phonemes_MLF,
+                               number_of_MLF_files, result_words_MLF, NULL);
 }
 
-void free_words_tree(PWordsTreeNode* root_node)
+int decoder_generate_lattices(
+        PDecoder decoder, TMLFFilePart *source_phonemes_MLF,
+        int number_of_MLF_files, TMLFFilePart **result_words_MLF,
+        TWordLattice **lattices)
 {
-    PWordsTreeNode deleted_node = *root_node, next_node = NULL;
-    int i;
-
-    if (root_node == NULL)
+    if ((decoder == NULL) || (source_phonemes_MLF == NULL)
+            || (number_of_MLF_files <= 0) || (result_words_MLF == NULL)
+            || (lattices == NULL))
     {
-        return;
-    }
-    if (deleted_node == NULL)
-    {
-        return;
+        return 0;
     }
 
-    if ((deleted_node->number_of_next_nodes > 0) && (deleted_node->next_nodes != NULL))
-    {
-        for (i = 0; i < deleted_node->number_of_next_nodes; i++)
-        {
-            next_node = deleted_node->next_nodes + i;
-            free_words_tree_node(next_node);
-        }
-        free(deleted_node->next_nodes);
-        deleted_node->next_nodes = NULL;
-    }
-    free(deleted_node);
-    *root_node = NULL;
+    return decode_phonemes_MLF(decoder, source_phonemes_MLF,
+                               number_of_MLF_files, result_words_MLF,
+                               lattices);
 }
 
-void free_linear_words_lexicon(TLinearWordsLexicon **words_lexicon,
-                               int lexicon_size)
+int decoder_generate_nbest(
+        PDecoder decoder, TMLFFilePart *source_phonemes_MLF,
+        int number_of_MLF_files, int nbest_size, TNBestList **nbest_lists)
 {
     int i;
-    TLinearWordsLexicon *tmp;
+    TMLFFilePart *result_words_MLF = NULL;
+    TWordLattice *lattices = NULL;
+
+    if ((decoder == NULL) || (source_phonemes_MLF == NULL)
+            || (number_of_MLF_files <= 0) || (nbest_size <= 0)
+            || (nbest_lists == NULL))
+    {
+        return 0;
+    }
 
-    if ((*words_lexicon == NULL) || (lexicon_size <= 0))
+    if (!decode_phonemes_MLF(decoder, source_phonemes_MLF,
+                             number_of_MLF_files, &result_words_MLF,
+                             &lattices))
     {
-        return;
+        return 0;
     }
-    tmp = *words_lexicon;
-    if (tmp == NULL)
+    *nbest_lists = malloc(number_of_MLF_files * sizeof(TNBestList));
+    #pragma omp parallel for num_threads(decoder->workspaces_number) \
+                             schedule(dynamic)
+    for (i = 0; i < number_of_MLF_files; i++)
     {
-        return;
+        (*nbest_lists)[i].name = result_words_MLF[i].name;
+        result_words_MLF[i].name = NULL;
+        find_nbest_in_word_lattice(lattices + i, nbest_size,
+                                   (*nbest_lists) + i);
     }
+    free_MLF(&result_words_MLF, number_of_MLF_files);
+    free_word_lattices(&lattices, number_of_MLF_files);
 
-    for (i = 0; i < lexicon_size; i++)
+    return 1;
+}
+
+/* This function recognizes the next time point of the phonemes stream by the
+ * first workspace of the decoder. This time point lasts the given number of
+ * frames (repeats), and its bounds are given in 100ns units. The team of
+ * threads is created for this time point only, because the next phoneme of
+ * the stream isn't known yet. As result, this function returns 1 in case of
+ * success, or 0 if recognition of the current utterance is failed. */
+static int recognize_stream_phoneme(PDecoder decoder, int inp_phoneme_i,
+                                    float phoneme_weight, int repeats,
+                                    long unsigned frame_start_time,
+                                    long unsigned frame_end_time)
+{
+    TRecognitionWorkspace *workspace = decoder->workspaces;
+
+    if (decoder->stream_state == STREAM_IS_CLOSED)
     {
-        if (tmp[i].phonemes_indexes != NULL)
+        reset_recognition_workspace(workspace, 0);
+        decoder->stream_state = STREAM_IS_OPENED;
+    }
+    #pragma omp parallel num_threads(get_threads_number_of_workspace(workspace))\
+                         if(!omp_in_parallel())
+    {
+        if (!recognize_next_phoneme(
+                    workspace, inp_phoneme_i, phoneme_weight, repeats, NULL,
+                    0, frame_start_time, frame_end_time,
+                    decoder->models.phonemes_vocabulary_size,
+                    decoder->models.confusion_penalties_matrix,
+                    decoder->parameters, decoder->models.language_model))
         {
-            free(tmp[i].phonemes_indexes);
+            #pragma omp master
+            decoder->stream_state = STREAM_IS_BROKEN;
         }
     }
-    free(tmp);
-    *words_lexicon = NULL;
+    if (decoder->stream_state == STREAM_IS_BROKEN)
+    {
+        return 0;
+    }
+
+    return 1;
 }
 
-void free_string_array(char ***string_array, int array_size)
+int decoder_push(PDecoder decoder, TTranscriptionNode phonemes[],
+                 int phonemes_number)
 {
-    char **tmp;
-    register int i;
+    int i, j, number_of_frames, repeats;
+    float phoneme_weight;
+    long unsigned frame_start_time, frame_end_time;
 
-    if ((string_array == NULL) || (array_size <= 0))
+    if ((decoder == NULL) || (phonemes == NULL) || (phonemes_number <= 0))
     {
-        return;
+        return 0;
     }
-    if (*string_array == NULL)
+    if (decoder->stream_state == STREAM_IS_BROKEN)
     {
-        return;
+        return 0;
     }
-    tmp = *string_array;
 
-    for (i = 0; i < array_size; i++)
+    for (i = 0; i < phonemes_number; i++)
     {
-        if (tmp[i] != NULL)
+        if ((phonemes[i].probability <= 0.0) || (phonemes[i].node_data < 0)
+                || (phonemes[i].node_data
+                    >= decoder->models.phonemes_vocabulary_size))
         {
-            free(tmp[i]);
-            tmp[i] = NULL;
+            decoder->stream_state = STREAM_IS_BROKEN;
+            return 0;
+        }
+        number_of_frames = calculate_number_of_time_points(
+                    phonemes[i], decoder->parameters, &repeats);
+        phoneme_weight = quantize_score(log10(phonemes[i].probability),
+                                        decoder->parameters.fixed_point_bits);
+        if (phonemes[i].node_data == 0)
+        {
+            /* pauses in the beginning of utterance are skipped, and other
+               pauses wait for the next phoneme */
+            if (decoder->stream_state == STREAM_IS_CLOSED)
+            {
+                continue;
+            }
+            if ((decoder->pauses_number + number_of_frames)
+                    > decoder->pauses_capacity)
+            {
+                decoder->pauses_capacity = 2 * (decoder->pauses_number
+                                                + number_of_frames);
+                decoder->pauses_weights = realloc(
+                            decoder->pauses_weights,
+                            decoder->pauses_capacity * sizeof(float));
+                decoder->pauses_repeats = realloc(
+                            decoder->pauses_repeats,
+                            decoder->pauses_capacity * sizeof(int));
+                decoder->pauses_start_times = realloc(
+                            decoder->pauses_start_times,
+                            decoder->pauses_capacity * sizeof(long unsigned));
+                decoder->pauses_end_times = realloc(
+                            decoder->pauses_end_times,
+                            decoder->pauses_capacity * sizeof(long unsigned));
+            }
+            for (j = 0; j < number_of_frames; j++)
+            {
+                calculate_bounds_of_frame(
+                            phonemes[i], number_of_frames, j,
+                            decoder->pauses_start_times
+                            + decoder->pauses_number,
+                            decoder->pauses_end_times
+                            + decoder->pauses_number);
+                decoder->pauses_repeats[decoder->pauses_number] = repeats;
+                decoder->pauses_weights[decoder->pauses_number++]
+                        = phoneme_weight;
+            }
+            continue;
+        }
+        for (j = 0; j < decoder->pauses_number; j++)
+        {
+            if (!recognize_stream_phoneme(decoder, 0,
+                                          decoder->pauses_weights[j],
+                                          decoder->pauses_repeats[j],
+                                          decoder->pauses_start_times[j],
+                                          decoder->pauses_end_times[j]))
+            {
+                return 0;
+            }
+        }
+        decoder->pauses_number = 0;
+        for (j = 0; j < number_of_frames; j++)
+        {
+            calculate_bounds_of_frame(phonemes[i], number_of_frames, j,
+                                      &frame_start_time, &frame_end_time);
+            if (!recognize_stream_phoneme(decoder, phonemes[i].node_data,
+                                          phoneme_weight, repeats,
+                                          frame_start_time, frame_end_time))
+            {
+                return 0;
+            }
         }
     }
-    free(tmp);
-    *string_array = NULL;
+
+    return 1;
 }
 
-void free_language_model(TLanguageModel *language_model)
+int decoder_get_partial_result(PDecoder decoder, TTranscriptionNode **words,
+                               int *words_number)
 {
-    int i;
-    if (language_model == NULL)
+    if ((decoder == NULL) || (words == NULL) || (words_number == NULL))
     {
-        return;
+        return 0;
     }
-    if (language_model->unigrams_probabilities != NULL)
+    *words = NULL;
+    *words_number = 0;
+    if (decoder->stream_state == STREAM_IS_BROKEN)
     {
-        free(language_model->unigrams_probabilities);
-        language_model->unigrams_probabilities = NULL;
+        return 0;
     }
-    if (language_model->bigrams != NULL)
+    if (decoder->stream_state == STREAM_IS_OPENED)
     {
-        for (i = 0; i < language_model->unigrams_number; i++)
+        /* the words sequence is empty if any word can't be ended yet */
+        *words_number = create_words_transcription_by_workspace(
+                    decoder->workspaces, words);
+        if (*words_number < 0)
         {
-            if (language_model->bigrams[i].begins != NULL)
-            {
-                free(language_model->bigrams[i].begins);
-                language_model->bigrams[i].begins = NULL;
-            }
+            *words_number = 0;
         }
-        free(language_model->bigrams);
-        language_model->bigrams = NULL;
     }
-    language_model->unigrams_number = 0;
+
+    return 1;
 }
 
-float get_bigram_probability(TLanguageModel language_model, int start_word_ind,
-                             int end_word_ind)
+int decoder_get_stable_words(PDecoder decoder, TTranscriptionNode **words,
+                             int *words_number)
 {
-    int first, last, middle, cmp_res;
-    TWordBigram *item = NULL;
+    TRecognitionWorkspace *workspace;
 
-    if ((language_model.unigrams_probabilities == NULL)
-            || (language_model.unigrams_number <= 0)
-            || (language_model.bigrams == NULL))
+    if ((decoder == NULL) || (words == NULL) || (words_number == NULL))
     {
-        return 0.0;
+        return 0;
     }
-    if ((start_word_ind < 0)
-            || (start_word_ind >= language_model.unigrams_number))
+    *words = NULL;
+    *words_number = 0;
+    if (decoder->stream_state == STREAM_IS_BROKEN)
     {
-        return 0.0;
+        return 0;
     }
-    if ((end_word_ind < 0) || (end_word_ind >= language_model.unigrams_number))
+    if (decoder->stream_state == STREAM_IS_CLOSED)
     {
-        return 0.0;
+        return 1;
     }
 
-    item = language_model.bigrams + end_word_ind;
-
-    if (item->begins_number <= 0)
+    workspace = decoder->workspaces;
+    commit_stable_words(workspace);
+    if (workspace->committed_words_number > 0)
     {
-        return 0.0;
+        *words_number = workspace->committed_words_number;
+        *words = malloc(workspace->committed_words_number
+                        * sizeof(TTranscriptionNode));
+        memcpy(*words, workspace->committed_words,
+               workspace->committed_words_number * sizeof(TTranscriptionNode));
+        /* the taken words aren't returned by other functions */
+        workspace->committed_words_number = 0;
     }
 
-    first = 0; last = item->begins_number;
+    return 1;
+}
 
-    cmp_res = item->begins[0].word_i - start_word_ind;
-    if (cmp_res > 0)
+int decoder_finalize(PDecoder decoder, TTranscriptionNode **words,
+                     int *words_number)
+{
+    int res = 1;
+
+    if ((decoder == NULL) || (words == NULL) || (words_number == NULL))
     {
-        return 0.0;
+        return 0;
     }
-    if (cmp_res == 0)
+    *words = NULL;
+    *words_number = 0;
+    if (decoder->stream_state == STREAM_IS_BROKEN)
     {
-        return item->begins[0].probability;
+        res = 0;
+    }
+    else if (decoder->stream_state == STREAM_IS_OPENED)
+    {
+        *words_number = create_words_transcription_by_workspace(
+                    decoder->workspaces, words);
+        if (*words_number < 0)
+        {
+            *words_number = 0;
+            res = 0;
+        }
     }
+    decoder->stream_state = STREAM_IS_CLOSED;
+    decoder->pauses_number = 0;
 
-    cmp_res = item->begins[last-1].word_i - start_word_ind;
-    if (cmp_res < 0)
+    return res;
+}
+
+int decoder_get_lookahead_score(PDecoder decoder, int phonemes[],
+                                int phonemes_number, float *score)
+{
+    TWordsTreeMatrix data;
+    int i, n, node = -1;
+
+    if ((decoder == NULL) || (phonemes == NULL) || (phonemes_number <= 0)
+            || (score == NULL))
     {
-        return 0.0;
+        return 0;
     }
-    if (cmp_res == 0)
+    if (!decoder->parameters.use_lm_lookahead
+            || (decoder->lookahead_scores == NULL))
     {
-        return item->begins[last-1].probability;
+        return 0;
     }
 
-    while (first < last)
+    data = decoder->workspaces[0].tree_data;
+    for (i = 0; i < phonemes_number; i++)
     {
-        middle = first + (last - first) / 2;
-
-        cmp_res = start_word_ind - item->begins[middle].word_i;
-
-        if (cmp_res <= 0)
+        /* next nodes of each node have successive numbers after it */
+        for (n = node + 1; n < data.nodes_number; n++)
         {
-            last = middle;
-            if (cmp_res == 0)
+            if ((data.nodes_parents[n] == node)
+                    && (data.nodes_phonemes[n] == phonemes[i]))
             {
                 break;
             }
         }
-        else
+        if (n >= data.nodes_number)
         {
-            first = middle + 1;
+            return 0;
         }
+        node = n;
     }
+    *score = decoder->lookahead_scores[node];
 
-    cmp_res = item->begins[last].word_i - start_word_ind;
-    if (cmp_res == 0)
+    return 1;
+}
+
+void decoder_destroy(PDecoder *decoder)
+{
+    int i;
+
+    if (decoder == NULL)
     {
-        return item->begins[last].probability;
+        return;
     }
-    return 0.0;
+    if (*decoder == NULL)
+    {
+        return;
+    }
+    for (i = 0; i < (*decoder)->workspaces_number; i++)
+    {
+        delete_recognition_workspace((*decoder)->workspaces + i);
+    }
+    free((*decoder)->workspaces);
+    if ((*decoder)->pauses_weights != NULL)
+    {
+        free((*decoder)->pauses_weights);
+        free((*decoder)->pauses_repeats);
+        free((*decoder)->pauses_start_times);
+        free((*decoder)->pauses_end_times);
+    }
+    if ((*decoder)->emission_table != NULL)
+    {
+        free_aligned_memory((*decoder)->emission_table);
+    }
+    free((*decoder)->quantized_penalties);
+    free((*decoder)->quantized_backoff_scores);
+    free((*decoder)->quantized_bigrams_scores);
+    free((*decoder)->quantized_successors_scores);
+    free((*decoder)->lookahead_scores);
+    free((*decoder)->entering_words_offsets);
+    free((*decoder)->entering_words_numbers);
+    free((*decoder)->entering_words);
+    free((*decoder)->words_prefixes);
+    free((*decoder)->prefixes_lengths);
+    free((*decoder)->prefixes_ends);
+    free((*decoder)->prefixes_phonemes);
+    free(*decoder);
+    *decoder = NULL;
 }
 
-int recognize_words(
+/* This function recognizes all phonemes sequences of the source MLF file by
+ * means of the temporary decoder. Number of threads is limited by number of
+ * phonemes sequences, so that unused workspaces aren't created. */
+static int recognize_words_by_decoder(
         TMLFFilePart *source_phonemes_MLF, int number_of_MLF_files,
-        int phonemes_vocabulary_size, float confusion_penalties_matrix[],
-        TLinearWordsLexicon words_lexicon[], int words_lexicon_size,
-        float pruning_coeff, TLanguageModel language_model, float lambda,
+        TDecoderModels models, TDecoderParameters parameters,
         TMLFFilePart **result_words_MLF)
 {
-    int is_ok = 1;
-    int i, j, n;
-    int phonemes_sequence_length, phonemes_sequence_capacity;
-    int words_sequence_length, max_words_sequence_length = 0;
-    int *words_sequence = NULL;
-    TMLFFilePart *cur_src, *cur_result;
-    TViterbiMatrix data;
-    TTracebackArray traceback_array = NULL;
-    int *src_phonemes_sequence = NULL;
-    float *src_phonemes_weights = NULL;
+    PDecoder decoder = NULL;
+    int res;
 
     if ((source_phonemes_MLF == NULL) || (number_of_MLF_files <= 0)
-            || (phonemes_vocabulary_size <= 0)
-            || (confusion_penalties_matrix == NULL)
-            || (words_lexicon_size <= 0) || (words_lexicon == NULL)
-            || (pruning_coeff < 0.0) || (pruning_coeff > 1.0)
-            || (language_model.unigrams_number <= 0)
-            || (language_model.unigrams_probabilities == NULL)
-            || (language_model.bigrams == NULL) || (result_words_MLF == NULL)
-            || (lambda < 0.0) || (lambda > 1.0))
+            || (result_words_MLF == NULL))
     {
         return 0;
     }
-
-    *result_words_MLF = malloc(sizeof(TMLFFilePart) * number_of_MLF_files);
-    cur_src = source_phonemes_MLF;
-    cur_result = *result_words_MLF;
-    for (i = 0; i < number_of_MLF_files; i++)
-    {
-        cur_result->transcription_size = 0;
-        cur_result->transcription = NULL;
-        n = strlen(cur_src->name);
-        cur_result->name = malloc((n+5)*sizeof(char));
-        memset(cur_result->name, 0, (n+5)*sizeof(char));
-        strcpy(cur_result->name, cur_src->name);
-        set_new_file_extension(cur_result->name, "rec");
-        cur_result++;
-        cur_src++;
-    }
-
-    data.cells = NULL;
-    data.words_sizes = NULL;
-    data.times_number = 0;
-    data.words_number = 0;
-    create_viterbi_matrix(&data, words_lexicon_size, words_lexicon);
-
-    cur_src = source_phonemes_MLF;
-    cur_result = *result_words_MLF;
-    max_words_sequence_length = cur_src->transcription_size;
-    words_sequence = malloc(max_words_sequence_length * sizeof(int));
-    phonemes_sequence_capacity = create_phonemes_sequence_by_transcription(
-                cur_src->transcription, cur_src->transcription_size,
-                NULL, NULL);
-    if (phonemes_sequence_capacity > 0)
-    {
-        if (phonemes_sequence_capacity > 1)
-        {
-            traceback_array = malloc(phonemes_sequence_capacity
-                                     * sizeof(TTracebackArrayItem));
-        }
-        src_phonemes_sequence = malloc(
-                    phonemes_sequence_capacity * sizeof(int));
-        src_phonemes_weights = malloc(
-                    phonemes_sequence_capacity * sizeof(float));
-        phonemes_sequence_capacity = create_phonemes_sequence_by_transcription(
-                    cur_src->transcription, cur_src->transcription_size,
-                    src_phonemes_sequence, src_phonemes_weights);
-
-        data.times_number = phonemes_sequence_capacity;
-        initialize_values_of_viterbi_matrix(data);
-        if (!calculate_viterbi_matrix(
-                    data, traceback_array,
-                    src_phonemes_sequence, src_phonemes_weights,
-                    phonemes_vocabulary_size, confusion_penalties_matrix,
-                    words_lexicon, pruning_coeff, language_model, lambda))
-        {
-            is_ok = 0;
-        }
-        else
-        {
-            words_sequence_length = get_words_sequence_by_traceback_array(
-                        traceback_array, phonemes_sequence_capacity,
-                        words_sequence);
-            if (words_sequence_length > 0)
-            {
-                cur_result->transcription_size = words_sequence_length;
-                cur_result->transcription = malloc(words_sequence_length
-                                                   * sizeof(TTranscriptionNode));
-                for (j = 0; j < words_sequence_length; j++)
-                {
-                    cur_result->transcription[j].node_data = words_sequence[j];
-                    cur_result->transcription[j].start_time = 0;
-                    cur_result->transcription[j].end_time = 0;
-                    cur_result->transcription[j].probability = 1.0;
-                }
-            }
-        }
-    }
-    else if (phonemes_sequence_capacity < 0)
+    if (parameters.threads_number > number_of_MLF_files)
     {
-        is_ok = 0;
+        parameters.threads_number = number_of_MLF_files;
     }
-    cur_src++;
-    cur_result++;
-    if (!is_ok)
+    decoder = decoder_create(models, parameters);
+    if (decoder == NULL)
     {
-        if (traceback_array != NULL)
-        {
-            free(traceback_array);
-            traceback_array = NULL;
-        }
-        delete_viterbi_matrix(&data);
-        free(words_sequence);
-        free(src_phonemes_sequence);
-        free(src_phonemes_weights);
-        free_MLF(result_words_MLF, number_of_MLF_files);
         return 0;
     }
+    res = decoder_decode(decoder, source_phonemes_MLF, number_of_MLF_files,
+                         result_words_MLF);
+    decoder_destroy(&decoder);
 
-    for (i = 1; i < number_of_MLF_files; i++)
-    {
-        if (cur_src->transcription_size > max_words_sequence_length)
-        {
-            max_words_sequence_length = cur_src->transcription_size;
-            words_sequence = realloc(words_sequence, max_words_sequence_length
-                                     * sizeof(int));
-        }
-        phonemes_sequence_length = create_phonemes_sequence_by_transcription(
-                    cur_src->transcription, cur_src->transcription_size,
-                    NULL, NULL);
-        if (phonemes_sequence_length > phonemes_sequence_capacity)
-        {
-            phonemes_sequence_capacity = phonemes_sequence_length;
-            if (phonemes_sequence_capacity > 1)
-            {
-                if (traceback_array == NULL)
-                {
-                    traceback_array = malloc(phonemes_sequence_capacity
-                                             * sizeof(TTracebackArrayItem));
-                }
-                else
-                {
-                    traceback_array = realloc(traceback_array,
-                                              phonemes_sequence_capacity
-                                              * sizeof(TTracebackArrayItem));
-                }
-            }
-            src_phonemes_sequence = realloc(
-                        src_phonemes_sequence, phonemes_sequence_capacity
-                        * sizeof(int));
-            src_phonemes_weights = realloc(
-                        src_phonemes_weights, phonemes_sequence_capacity
-                        * sizeof(float));
-        }
-        if (phonemes_sequence_length > 0)
-        {
-            phonemes_sequence_length=create_phonemes_sequence_by_transcription(
-                        cur_src->transcription, cur_src->transcription_size,
-                        src_phonemes_sequence, src_phonemes_weights);
-            data.times_number = phonemes_sequence_length;
-            initialize_values_of_viterbi_matrix(data);
-            if (!calculate_viterbi_matrix(
-                        data, traceback_array,
-                        src_phonemes_sequence, src_phonemes_weights,
-                        phonemes_vocabulary_size, confusion_penalties_matrix,
-                        words_lexicon, pruning_coeff, language_model, lambda))
-            {
-                is_ok = 0;
-                break;
-            }
-            words_sequence_length = get_words_sequence_by_traceback_array(
-                        traceback_array, phonemes_sequence_length,
-                        words_sequence);
-            if (words_sequence_length > 0)
-            {
-                cur_result->transcription_size = words_sequence_length;
-                cur_result->transcription = malloc(words_sequence_length
-                                                   * sizeof(TTranscriptionNode));
-                for (j = 0; j < words_sequence_length; j++)
-                {
-                    cur_result->transcription[j].node_data = words_sequence[j];
-                    cur_result->transcription[j].start_time = 0;
-                    cur_result->transcription[j].end_time = 0;
-                    cur_result->transcription[j].probability = 1.0;
-                }
-            }
-        }
-        else if (phonemes_sequence_length < 0)
-        {
-            is_ok = 0;
-            break;
-        }
-        cur_src++;
-        cur_result++;
-    }
-    if (traceback_array != NULL)
+    return res;
+}
+
+int recognize_words(
+        TMLFFilePart *source_phonemes_MLF, int number_of_MLF_files,
+        int phonemes_vocabulary_size, float confusion_penalties_matrix[],
+        TLinearWordsLexicon words_lexicon[], int words_lexicon_size,
+        float pruning_coeff, int histogram_size, float beam_width,
+        int max_active_hypotheses, float word_end_beam,
+        TCompiledLanguageModel language_model, int threads_number,
+        TMLFFilePart **result_words_MLF)
+{
+    TDecoderModels models;
+    TDecoderParameters parameters;
+
+    if ((words_lexicon == NULL) || (words_lexicon_size <= 0))
     {
-        free(traceback_array);
-        traceback_array = NULL;
+        return 0;
     }
-    delete_viterbi_matrix(&data);
-    free(words_sequence);
-    free(src_phonemes_sequence);
-    free(src_phonemes_weights);
-    if (!is_ok)
+    models.phonemes_vocabulary_size = phonemes_vocabulary_size;
+    models.confusion_penalties_matrix = confusion_penalties_matrix;
+    models.words_lexicon = words_lexicon;
+    models.words_lexicon_size = words_lexicon_size;
+    models.words_tree_root = NULL;
+    models.language_model = language_model;
+    parameters = decoder_get_default_parameters();
+    parameters.pruning_coeff = pruning_coeff;
+    parameters.histogram_size = histogram_size;
+    parameters.beam_width = beam_width;
+    parameters.max_active_hypotheses = max_active_hypotheses;
+    parameters.word_end_beam = word_end_beam;
+    parameters.threads_number = threads_number;
+
+    return recognize_words_by_decoder(source_phonemes_MLF,
+                                      number_of_MLF_files, models, parameters,
+                                      result_words_MLF);
+}
+
+int recognize_words_by_words_tree(
+        TMLFFilePart *source_phonemes_MLF, int number_of_MLF_files,
+        int phonemes_vocabulary_size, float confusion_penalties_matrix[],
+        PWordsTreeNode words_tree_root, float pruning_coeff,
+        int histogram_size, float beam_width, int max_active_hypotheses,
+        float word_end_beam, TCompiledLanguageModel language_model,
+        int threads_number, TMLFFilePart **result_words_MLF)
+{
+    TDecoderModels models;
+    TDecoderParameters parameters;
+
+    if (words_tree_root == NULL)
     {
-        free_MLF(result_words_MLF, number_of_MLF_files);
+        return 0;
     }
-
-    return is_ok;
+    models.phonemes_vocabulary_size = phonemes_vocabulary_size;
+    models.confusion_penalties_matrix = confusion_penalties_matrix;
+    models.words_lexicon = NULL;
+    models.words_lexicon_size = 0;
+    models.words_tree_root = words_tree_root;
+    models.language_model = language_model;
+    parameters = decoder_get_default_parameters();
+    parameters.pruning_coeff = pruning_coeff;
+    parameters.histogram_size = histogram_size;
+    parameters.beam_width = beam_width;
+    parameters.max_active_hypotheses = max_active_hypotheses;
+    parameters.word_end_beam = word_end_beam;
+    parameters.threads_number = threads_number;
+
+    return recognize_words_by_decoder(source_phonemes_MLF,
+                                      number_of_MLF_files, models, parameters,
+                                      result_words_MLF);
 }
 
 float estimate_error_rate(
@@ -39,6 +39,59 @@
  */
 #define MLF_HEADER "#!MLF!#"
 
+/*! \def DEFAULT_HISTOGRAM_SIZE
+ * \brief This macro defines default number of bins of the histogram which is
+ * used for acoustic pruning in the Viterbi beam search algorithm.
+ */
+#define DEFAULT_HISTOGRAM_SIZE 20
+
+/*! \def DEFAULT_LATTICE_SIZE
+ * \brief This macro defines default maximal number of word ends which are
+ * recorded into the word lattice at each time point.
+ */
+#define DEFAULT_LATTICE_SIZE 16
+
+/*! \def DEFAULT_FRAME_DURATION
+ * \brief This macro defines default duration of one time point (frame) of the
+ * recognized phonemes sequence in 100ns units, i.e. 10 ms.
+ */
+#define DEFAULT_FRAME_DURATION 100000.0
+
+/*! \def DEFAULT_MAX_REPEATS_OF_PHONEME
+ * \brief This macro defines default maximal number of time points (frames)
+ * which are taken by one phoneme of the recognized phonemes sequence.
+ */
+#define DEFAULT_MAX_REPEATS_OF_PHONEME 2
+
+/*! \def DEFAULT_MAX_EMISSION_TABLE_SIZE
+ * \brief This macro defines default maximal number of items of the table of
+ * emission penalties (see TDecoderParameters), i.e. 64 MB of memory.
+ */
+#define DEFAULT_MAX_EMISSION_TABLE_SIZE 16777216
+
+/*! \def MAX_FIXED_POINT_BITS
+ * \brief This macro defines maximal number of binary fraction digits of scores
+ * in the fixed-point mode of the decoder (see TDecoderParameters). Costs of
+ * alive hypotheses of one frame stay within 2^(23-MAX_FIXED_POINT_BITS), i.e.
+ * 2048, of the best one in this mode, which is much wider than any useful
+ * beam.
+ */
+#define MAX_FIXED_POINT_BITS 12
+
+/*! \def MAX_FAST_MATCH_DEPTH
+ * \brief This macro defines maximal number of next input phonemes which are
+ * matched with beginnings of words by the fast match (see
+ * TDecoderParameters).
+ */
+#define MAX_FAST_MATCH_DEPTH 8
+
+/*! \def DEFAULT_FAST_MATCH_DEPTH
+ * \brief This macro defines default number of next input phonemes which are
+ * matched with beginnings of words by the fast match (see
+ * TDecoderParameters).
+ */
+#define DEFAULT_FAST_MATCH_DEPTH 2
+
 /*! \enum TMLFParsingState
  * \brief There are states of the MLF file reading.
  */
@@ -100,13 +153,19 @@ typedef struct _TLinearWordsLexicon {
  * - name of acoustic event;
  * - start time of this acoustic event;
  * - stop time of this acoustic event;
- * - event probability.
+ * - event probability;
+ * - event score (for words only).
  */
 typedef struct _TTranscriptionNode {
     int node_data;           /**< Data of node: index of word or phoneme. */
     long unsigned start_time;/**< Start time in 100ns units. */
     long unsigned end_time;  /**< End time in 100ns units. */
-    float probability;       /**< Probability of this acoustic event. */
+    float probability;       /**< Probability of this acoustic event. For
+                                  words it is calculated by the score, so it
+                                  can be zero because of underflow. */
+    float score;             /**< Score (log10-probability) of word. It is
+                                  not used for phonemes, and it is -FLT_MAX
+                                  if the score is unknown. */
 } TTranscriptionNode;
 
 /*! \typedef PTranscriptionNode
@@ -130,6 +189,67 @@ typedef struct {
                                           events. */
 } TMLFFilePart;
 
+/*! \struct TLatticeNode
+ * \brief Structure for representation of one node of the word lattice. Each
+ * node except the start node and the end node is some word end hypothesis.
+ */
+typedef struct _TLatticeNode {
+    int word_index;         /**< Index of word in vocabulary, or -1 for the
+                                 start node and the end node. */
+    long unsigned end_time; /**< End time of word in 100ns units. Time of the
+                                 start node is the start time of the first
+                                 phoneme, and time of the end node is the end
+                                 time of the last phoneme. */
+} TLatticeNode;
+
+/*! \struct TLatticeLink
+ * \brief Structure for representation of one link of the word lattice, i.e.
+ * transition between two word ends.
+ */
+typedef struct _TLatticeLink {
+    int start_node;       /**< Number of the predecessor node. */
+    int end_node;         /**< Number of the successor node. */
+    float acoustic_score; /**< Log10-probability of phonemes of the word of
+                               the successor node. */
+    float language_score; /**< Log10-probability of the words bigram (see
+                               TCompiledLanguageModel). */
+} TLatticeLink;
+
+/*! \struct TWordLattice
+ * \brief Structure for representation of the word lattice of one phonemes
+ * sequence. The first node is the start node, the last node is the end node,
+ * and other nodes are sorted by their end times.
+ */
+typedef struct _TWordLattice {
+    char *name;          /**< Name of the lattice file. */
+    TLatticeNode *nodes; /**< Nodes of the lattice. */
+    int nodes_number;    /**< Number of nodes. */
+    TLatticeLink *links; /**< Links of the lattice. */
+    int links_number;    /**< Number of links. */
+} TWordLattice;
+
+/*! \struct TWordsHypothesis
+ * \brief Structure for representation of one hypothesis of the N-best list,
+ * i.e. one recognized words sequence with its total score.
+ */
+typedef struct _TWordsHypothesis {
+    PTranscriptionNode words;/**< Recognized words sequence. */
+    int words_number;        /**< Length of recognized words sequence. */
+    float score;             /**< Total log10-score of the words sequence
+                                  (sum of acoustic and language scores). */
+} TWordsHypothesis;
+
+/*! \struct TNBestList
+ * \brief Structure for representation of the N-best list of one phonemes
+ * sequence. Hypotheses are different words sequences, and they are sorted by
+ * descending of their scores.
+ */
+typedef struct _TNBestList {
+    char *name;                  /**< Name of the label file. */
+    TWordsHypothesis *hypotheses;/**< Hypotheses of the N-best list. */
+    int hypotheses_number;       /**< Number of hypotheses. */
+} TNBestList;
+
 /*! \struct TWordBigramBegin
  * \brief Structure for representation of begin of some words bigram.
  */
@@ -162,6 +282,171 @@ typedef struct _TLanguageModel {
                                        ended in the corresponding word). */
 } TLanguageModel;
 
+/*! \struct TCompiledLanguageModel
+ * \brief Structure for representation of the language model which is prepared
+ * for the words recognition. All scores of this model are decimal logarithms
+ * of probabilities which are interpolated with the given smoothing coefficient
+ * (impossible events have -FLT_MAX score). Scores of probabilities which
+ * aren't greater than FLT_EPSILON are kept too, but the decoder uses them
+ * only for transitions from the first entry of the linear words lexicon.
+ */
+typedef struct _TCompiledLanguageModel {
+    int unigrams_number;   /**< Number of unigrams. */
+    float lambda;          /**< The coefficient of language model smoothing
+                                which was used for compilation. */
+    float *backoff_scores; /**< Scores of words without explicit bigrams,
+                                i.e. log10((1 - lambda) * P(w)). */
+    int *bigrams_offsets;  /**< Offsets of bigrams which are ended in each
+                                word (length of this array is greater than
+                                number of unigrams by one). */
+    int *bigrams_begins;   /**< Vocabulary's indexes of bigrams' first words
+                                (they are ordered by increase within each
+                                ended word). */
+    float *bigrams_scores; /**< Scores of bigrams, i.e.
+                                log10(lambda * P(v,w) + (1 - lambda) * P(w)). */
+    int *successors_offsets; /**< Offsets of bigrams which are started in
+                                  each word (the forward index of bigrams,
+                                  length of this array is greater than
+                                  number of unigrams by one). */
+    int *successors_ends;    /**< Vocabulary's indexes of bigrams' last words
+                                  (they are ordered by increase within each
+                                  started word). */
+    float *successors_scores;/**< Scores of these bigrams (the same as
+                                  bigrams_scores). */
+} TCompiledLanguageModel;
+
+/*! \struct TDecoderModels
+ * \brief Structure for representation of all models which are used by the
+ * decoder (see decoder_create()). The decoder doesn't copy these models,
+ * therefore they must exist until the decoder is destroyed.
+ */
+typedef struct _TDecoderModels {
+    int phonemes_vocabulary_size;       /**< Size of phonemes vocabulary. */
+    float *confusion_penalties_matrix;  /**< Quadratic matrix of penalties for
+                                             mixing up phonemes (see
+                                             recognize_words()). */
+    TLinearWordsLexicon *words_lexicon; /**< The linear words lexicon (it is
+                                             used if the words tree isn't
+                                             specified). */
+    int words_lexicon_size;             /**< Size of the linear words
+                                             lexicon. */
+    PWordsTreeNode words_tree_root;     /**< Root of the words tree, or NULL if
+                                             the linear words lexicon is
+                                             used. */
+    TCompiledLanguageModel language_model;/**< The compiled language
+                                               model. */
+} TDecoderModels;
+
+/*! \struct TDecoderParameters
+ * \brief Structure for representation of parameters of the decoder (see
+ * decoder_create()). Each kind of pruning is disabled if the corresponding
+ * parameter is equal to zero.
+ */
+typedef struct _TDecoderParameters {
+    float pruning_coeff;      /**< Part of all hypotheses which are pruned by
+                                   the histogram pruning (from 0 to 1). */
+    int histogram_size;       /**< Number of bins of the histogram (it must be
+                                   greater than 1). */
+    float beam_width;         /**< Width of beam for all hypotheses. */
+    int max_active_hypotheses;/**< Maximal number of unpruned hypotheses. */
+    float word_end_beam;      /**< Width of beam for word ends. */
+    float lattice_beam;       /**< Width of beam for word ends which are
+                                   recorded into word lattices (see
+                                   decoder_generate_lattices()). */
+    int lattice_size;         /**< Maximal number of word ends which are
+                                   recorded into word lattice at each time
+                                   point. */
+    int threads_number;       /**< Number of threads which recognize different
+                                   phonemes sequences in parallel. If only
+                                   one phonemes sequence is recognized at a
+                                   time (e.g. by decoder_push()), then its
+                                   time points are calculated by the team of
+                                   OpenMP threads instead. */
+    float frame_duration;     /**< Duration of one time point (frame) in 100ns
+                                   units (see DEFAULT_FRAME_DURATION). Each
+                                   phoneme takes its duration divided by this
+                                   value time points (one at least). */
+    int max_repeats_of_phoneme; /**< Maximal number of time points of one
+                                     phoneme (see
+                                     DEFAULT_MAX_REPEATS_OF_PHONEME). */
+    int use_segments;         /**< 0 if each phoneme is expanded into its time
+                                   points, which are recognized one after
+                                   another, or 1 if each phoneme is recognized
+                                   as one segment, whose number of time points
+                                   is taken into account by the duration model
+                                   of states. Segments require fewer steps of
+                                   recognition, but words can be ended only on
+                                   bounds of phonemes in this case. */
+    int max_emission_table_size; /**< Maximal number of items of the table of
+                                      emission penalties (see
+                                      DEFAULT_MAX_EMISSION_TABLE_SIZE). This
+                                      table keeps penalties of all states of
+                                      the lexicon for each input phoneme, so
+                                      its size is number of phonemes
+                                      multiplied by number of states. If the
+                                      table is larger, then it isn't created,
+                                      and penalties are taken from the
+                                      confusion penalties matrix at each time
+                                      point. Zero disables the table. */
+    int fixed_point_bits;     /**< Number of binary fraction digits of scores
+                                   in the fixed-point mode (from 0 to
+                                   MAX_FIXED_POINT_BITS). If it isn't zero,
+                                   then penalties of confusion, weights of
+                                   phonemes and scores of the language model
+                                   are rounded to multiples of
+                                   2^(-fixed_point_bits). The best cost of
+                                   each frame is subtracted from costs of all
+                                   hypotheses, and hypotheses which are worse
+                                   than the best one by 2^(23-fixed_point_bits)
+                                   or more are pruned. So absolute values of
+                                   costs are less than 2^(24-fixed_point_bits)
+                                   at any length of the phonemes sequence, all
+                                   sums of scores are exact, and they don't
+                                   depend on order of additions and on the
+                                   compiler. Zero means the usual
+                                   floating-point scores. */
+    int use_lm_lookahead;     /**< 1 if hypotheses in phoneme nodes of the
+                                   words tree are scored by the language model
+                                   lookahead, i.e. by the best score of the
+                                   language model (without context) among
+                                   words which are reachable from the node, or
+                                   0 if they are scored acoustically only
+                                   until the word end. The lookahead makes
+                                   pruning of the words tree more precise, but
+                                   it isn't included into costs, so results
+                                   without pruning are the same. It isn't
+                                   used for the linear words lexicon. */
+    int fast_match_depth;     /**< Number of next input phonemes (from 0 to
+                                   MAX_FAST_MATCH_DEPTH) which are matched
+                                   with beginnings of words of the linear
+                                   words lexicon by the fast match before
+                                   transitions between words. */
+    int fast_match_size;      /**< Number of words with the best scores of
+                                   the fast match which are entered at each
+                                   time point (words with scores equal to
+                                   the score of the last of them are entered
+                                   too). Other words aren't entered, so their
+                                   states aren't calculated. Zero (or zero
+                                   fast_match_depth) disables the fast
+                                   match. The fast match isn't used for the
+                                   words tree, for segments which last
+                                   several time points and for generation of
+                                   word lattices. */
+} TDecoderParameters;
+
+/*! \struct TDecoder
+ * \brief Opaque structure of the decoder, which keeps the models and all
+ * memory buffers of recognition between calls of decoder_decode() (or state
+ * of the phonemes stream between calls of decoder_push()).
+ */
+typedef struct _TDecoder TDecoder;
+
+/*! \typedef PDecoder
+ * \brief Pointer to TDecoder data.
+ * \sa TDecoder
+ */
+typedef TDecoder* PDecoder;
+
 /*! \fn int load_phonemes_MLF(
  *         char *mlf_name, char **phonemes_vocabulary, int phonemes_number,
  *         TMLFFilePart **mlf_data);
@@ -202,8 +487,9 @@ int load_phonemes_MLF(char *mlf_name, char **phonemes_vocabulary,
  *         TMLFFilePart **mlf_data);
  *
  * \brief This function loads MLF file describing words transcriptions of some
- * speech signals. This MLF file must contain only labels of acoustical events
- * (i.e. names of words).
+ * speech signals. Each line of transcription contains the label of acoustical
+ * event (i.e. name of word), and it can also contain start and end times of
+ * word before its name and the score (log10-probability) after it like in HTK.
  *
  * \details It is basic function of this library. This function uses such
  * additional functions of library as find_in_vocabulary(), prepare_filename(),
@@ -234,9 +520,11 @@ int load_words_MLF(char *mlf_name, char **words_vocabulary, int words_number,
  *         TMLFFilePart *mlf_data, int files_number)
  *
  * \brief This function saves the MLF data (names and transcriptions of all
- * label files) into the given MLF file. Only labels of acoustical labels (i.e.
- * names of words) without their start and end times will be written into this
- * MLF file.
+ * label files) into the given MLF file. Each line of transcription contains
+ * start and end times of word in 100ns units, name of word and its score
+ * (log10-probability) like in HTK. If the word has zero duration, then only
+ * name of word is written. If the score of word is -FLT_MAX (unknown), then
+ * it isn't written.
  *
  * \details It is basic function of this library. This function doesn't use any
  * additional function of this library.
@@ -262,6 +550,70 @@ int load_words_MLF(char *mlf_name, char **words_vocabulary, int words_number,
 int save_words_MLF(char *mlf_name, char **words_vocabulary, int words_number,
                    TMLFFilePart *mlf_data, int files_number);
 
+/*! \fn int save_word_lattice(char *file_name, TWordLattice lattice,
+ *                           char **words_vocabulary, int words_number)
+ *
+ * \brief This function saves the word lattice into the text file in HTK
+ * Standard Lattice Format (SLF).
+ *
+ * \details It is basic function of this library. This function doesn't use any
+ * additional function of this library. Words are placed on nodes, and scores
+ * of links are written as log10-probabilities (the "base=10" field of the
+ * lattice header). Times of nodes are ends of their words in seconds (they are
+ * calculated by times of phonemes).
+ *
+ * \param file_name The name of lattice file into which the word lattice must
+ * be written.
+ *
+ * \param lattice The word lattice which is created by the
+ * decoder_generate_lattices() function.
+ *
+ * \param words_vocabulary The string array which represents words vocabulary.
+ *
+ * \param words_number The size of words vocabulary.
+ *
+ * \return If the saving has been completed successfully, then this function
+ * returns 1. In case of error this function returns zero.
+ *
+ * \sa decoder_generate_lattices().
+ */
+int save_word_lattice(char *file_name, TWordLattice lattice,
+                      char **words_vocabulary, int words_number);
+
+/*! \fn int save_nbest_MLF(char *mlf_name, char **words_vocabulary,
+ *                        int words_number, TNBestList *nbest_lists,
+ *                        int lists_number)
+ *
+ * \brief This function saves N-best lists of words sequences into the MLF
+ * file.
+ *
+ * \details It is basic function of this library. This function doesn't use any
+ * additional function of this library. Hypotheses of one labels file are
+ * separated by the "///" line like in HTK. Each line of hypothesis contains one
+ * word with its start and end times and its score as in the save_words_MLF()
+ * function.
+ *
+ * \param mlf_name The name of MLF file into which N-best lists must be
+ * written.
+ *
+ * \param words_vocabulary The string array which represents words vocabulary.
+ *
+ * \param words_number The size of words vocabulary.
+ *
+ * \param nbest_lists The array of N-best lists which is created by the
+ * decoder_generate_nbest() function.
+ *
+ * \param lists_number The size of array of N-best lists.
+ *
+ * \return If the saving has been completed successfully, then this function
+ * will return number of labels files of which the saved MLF file consists. In
+ * case of error this function will return zero.
+ *
+ * \sa decoder_generate_nbest().
+ */
+int save_nbest_MLF(char *mlf_name, char **words_vocabulary, int words_number,
+                   TNBestList *nbest_lists, int lists_number);
+
 /*! \fn int load_phonemes_vocabulary(char *file_name,
  *         char ***phonemes_vocabulary)
  *
@@ -551,6 +903,29 @@ int create_linear_words_lexicon(
  */
 void free_MLF(TMLFFilePart **mlf_data, int number_of_MLF_parts);
 
+/*! \fn void free_word_lattices(TWordLattice **lattices,
+ *                             int number_of_lattices)
+ *
+ * \brief Free memory which was allocated for the array of word lattices.
+ *
+ * \param lattices Pointer to array of word lattices. This array will be freed
+ * and zeroized.
+ *
+ * \param number_of_lattices Size of the array of word lattices.
+ */
+void free_word_lattices(TWordLattice **lattices, int number_of_lattices);
+
+/*! \fn void free_nbest_lists(TNBestList **nbest_lists, int number_of_lists)
+ *
+ * \brief Free memory which was allocated for the array of N-best lists.
+ *
+ * \param nbest_lists Pointer to array of N-best lists. This array will be
+ * freed and zeroized.
+ *
+ * \param number_of_lists Size of the array of N-best lists.
+ */
+void free_nbest_lists(TNBestList **nbest_lists, int number_of_lists);
+
 /*! \fn void free_words_tree(PWordsTreeNode* root_node)
  *
  * \brief Free memory which was allocated for the given words tree.
@@ -629,11 +1004,62 @@ void free_language_model(TLanguageModel *language_model);
 float get_bigram_probability(TLanguageModel language_model, int start_word_ind,
                              int end_word_ind);
 
+/*! \fn int compile_language_model(
+ *         TLanguageModel language_model, float lambda,
+ *         TCompiledLanguageModel *compiled_model)
+ *
+ * \brief This function compiles the given language model for the words
+ * recognition, i.e. it calculates decimal logarithms of all bigrams
+ * probabilities, which are interpolated with unigrams probabilities by the
+ * deleted interpolation smoothing algorithm, and decimal logarithms of
+ * unigrams probabilities for words without explicit bigrams.
+ *
+ * \details It is basic function of this library. This function doesn't use any
+ * additional function of this library. Source language model isn't changed,
+ * therefore it can be saved or trained after compilation. Only zero
+ * probabilities get the -FLT_MAX score. Scores are calculated in double
+ * precision and stored as float values, i.e. each score is rounded once.
+ *
+ * \param language_model The language model which is compiled. The bigrams
+ * array must be ordered by increase of vocabulary's indexes.
+ *
+ * \param lambda The coefficient of language model smoothing which is used in
+ * the deleted interpolation smoothing algorithm. Value of this coefficient
+ * must be more or equal 0, and less or equal 1.
+ *
+ * \param compiled_model Pointer to the TCompiledLanguageModel structure into
+ * which the compilation result is written. Memory for arrays of this structure
+ * will be allocated automatically in this function.
+ *
+ * \return If the compilation completes successfully, then this function
+ * returns 1. In other cases this function returns 0.
+ *
+ * \sa free_compiled_language_model().
+ */
+int compile_language_model(TLanguageModel language_model, float lambda,
+                           TCompiledLanguageModel *compiled_model);
+
+/*! \fn void free_compiled_language_model(
+ *         TCompiledLanguageModel *compiled_model)
+ *
+ * \brief This function frees memory which was allocated for the given compiled
+ * language model.
+ *
+ * \details It is basic function of this library. This function doesn't use any
+ * additional function of this library.
+ *
+ * \param compiled_model Pointer to the TCompiledLanguageModel structure which
+ * represents the deletable compiled language model.
+ */
+void free_compiled_language_model(TCompiledLanguageModel *compiled_model);
+
 /*! \fn int recognize_words(
  *         TMLFFilePart *source_phonemes_MLF, int number_of_MLF_files,
  *         int phonemes_vocabulary_size, float confusion_weights_matrix[],
  *         TLinearWordsLexicon words_lexicon[], int words_lexicon_size,
- *         TLanguageModel language_model, float lambda,
+ *         float pruning_coeff, int histogram_size, float beam_width,
+ *         int max_active_hypotheses, float word_end_beam,
+ *         TCompiledLanguageModel language_model, int threads_number,
  *         TMLFFilePart **result_words_MLF)
  *
  * \brief This function recognizes all words which are represented in source
@@ -672,11 +1098,37 @@ float get_bigram_probability(TLanguageModel language_model, int start_word_ind,
  * the Viterbi beam search algorithm. Value of this coefficient must be more or
  * equal 0, and less or equal 1.
  *
- * \param language_model The language model which is used for recognition.
- *
- * \param lambda The coefficient of language model smoothing which is used in
- * the deleted interpolation smoothing algorithm. Value of this coefficient
- * must be more or equal 0, and less or equal 1.
+ * \param histogram_size The number of bins of the histogram which is used for
+ * acoustic pruning (see DEFAULT_HISTOGRAM_SIZE). The more bins, the more
+ * precisely the number of pruned hypotheses corresponds to the pruning_coeff.
+ * This number must be greater than 1.
+ *
+ * \param beam_width The width of beam which is used for acoustic pruning:
+ * hypotheses with costs (i.e. log10-probabilities) less than the best cost of
+ * the current time point minus this width are pruned. Value of this width must
+ * be more or equal 0, and 0 means that the beam pruning isn't used.
+ *
+ * \param max_active_hypotheses The maximal number of hypotheses which are kept
+ * at each time point after pruning (hypotheses with the best costs are kept).
+ * Value of this number must be more or equal 0, and 0 means that number of
+ * hypotheses isn't limited.
+ *
+ * \param word_end_beam The width of beam for word ends: word ends with costs
+ * less than the best word end cost of the current time point minus this width
+ * don't make transitions into next words. Usually this width is less than the
+ * beam_width. Value of this width must be more or equal 0, and 0 means that
+ * the word end beam isn't used.
+ *
+ * \param language_model The language model which is used for recognition. It
+ * must be compiled by the compile_language_model() function.
+ *
+ * \param threads_number The number of threads which recognize different parts
+ * of the source MLF file in parallel. Each thread has own copy of all data
+ * which are changed in the recognition process. If this number is equal to 1,
+ * then parts of the source MLF file are recognized one after another, and
+ * each of them is recognized by one team of OpenMP threads which calculate
+ * all stages of each time point together. Recognition results don't depend on
+ * this number and on the number of OpenMP threads.
  *
  * \param result_words_MLF It is pointer to array of parts of the words MLF
  * file. Each part of the words MLF file involves name of the some label file
@@ -687,7 +1139,9 @@ float get_bigram_probability(TLanguageModel language_model, int start_word_ind,
  * corresponding part of source MLF file. Memory for the array of parts of the
  * words MLF file will be allocated automatically in this function. Numbers of
  * labels files of which the result MLF file and source MLF file consist are
- * equal.
+ * equal. Start and end times of each recognized word are start time of its
+ * first phoneme and end time of its last phoneme, and its score is the
+ * increase of the path cost (i.e. of its log10-probability) over this word.
  *
  * \return If the recognition process completes successfully, then this
  * function returns 1. In other cases this function returns 0.
@@ -696,9 +1150,431 @@ int recognize_words(
         TMLFFilePart *source_phonemes_MLF, int number_of_MLF_files,
         int phonemes_vocabulary_size, float confusion_penalties_matrix[],
         TLinearWordsLexicon words_lexicon[], int words_lexicon_size,
-        float pruning_coeff, TLanguageModel language_model, float lambda,
+        float pruning_coeff, int histogram_size, float beam_width,
+        int max_active_hypotheses, float word_end_beam,
+        TCompiledLanguageModel language_model, int threads_number,
         TMLFFilePart **result_words_MLF);
 
+/*! \fn int recognize_words_by_words_tree(
+ *         TMLFFilePart *source_phonemes_MLF, int number_of_MLF_files,
+ *         int phonemes_vocabulary_size, float confusion_penalties_matrix[],
+ *         PWordsTreeNode words_tree_root, float pruning_coeff,
+ *         int histogram_size, float beam_width, int max_active_hypotheses,
+ *         float word_end_beam, TCompiledLanguageModel language_model,
+ *         int threads_number, TMLFFilePart **result_words_MLF)
+ *
+ * \brief This function recognizes all words which are represented in source
+ * sequences of phonemes like the recognize_words() function, but the
+ * recognition process is based on the words tree instead of the linear words
+ * lexicon.
+ *
+ * \details It is basic function of this library. This function doesn't use any
+ * additional function of this library. Words with common beginning of phonetic
+ * transcription share nodes of the words tree, therefore these nodes are
+ * scored once for all such words. The bigram probability is applied at the end
+ * of each word, when this word is known.
+ *
+ * \param source_phonemes_MLF The array of parts of the source MLF file (see
+ * recognize_words()).
+ *
+ * \param files_number The size of TMLFFilePart array, i.e. number of labels
+ * files of which the source MLF file consists.
+ *
+ * \param phonemes_vocabulary_size The size of phonemes vocabulary.
+ *
+ * \param confusion_penalties_matrix It is quadratic matrix of phonemes_number on
+ * phonemes_number in size (see recognize_words()).
+ *
+ * \param words_tree_root The root of words tree which is created by the
+ * create_words_vocabulary_tree() function.
+ *
+ * \param pruning_coeff The coefficient of acoustic pruning which is used in
+ * the Viterbi beam search algorithm. Value of this coefficient must be more or
+ * equal 0, and less or equal 1.
+ *
+ * \param histogram_size The number of bins of the histogram which is used for
+ * acoustic pruning (see recognize_words()).
+ *
+ * \param beam_width The width of beam which is used for acoustic pruning (see
+ * recognize_words()).
+ *
+ * \param max_active_hypotheses The maximal number of hypotheses which are kept
+ * at each time point after pruning (see recognize_words()).
+ *
+ * \param word_end_beam The width of beam for word ends (see
+ * recognize_words()).
+ *
+ * \param language_model The language model which is used for recognition. It
+ * must be compiled by the compile_language_model() function.
+ *
+ * \param threads_number The number of threads which recognize different parts
+ * of the source MLF file in parallel (see recognize_words()).
+ *
+ * \param result_words_MLF It is pointer to array of parts of the words MLF
+ * file (see recognize_words()).
+ *
+ * \return If the recognition process completes successfully, then this
+ * function returns 1. In other cases this function returns 0.
+ *
+ * \sa recognize_words(), create_words_vocabulary_tree().
+ */
+int recognize_words_by_words_tree(
+        TMLFFilePart *source_phonemes_MLF, int number_of_MLF_files,
+        int phonemes_vocabulary_size, float confusion_penalties_matrix[],
+        PWordsTreeNode words_tree_root, float pruning_coeff,
+        int histogram_size, float beam_width, int max_active_hypotheses,
+        float word_end_beam, TCompiledLanguageModel language_model,
+        int threads_number, TMLFFilePart **result_words_MLF);
+
+/*! \fn TDecoderParameters decoder_get_default_parameters(void)
+ *
+ * \brief This function returns the default parameters of the decoder, so
+ * that the caller can change only parameters which it needs before calling
+ * decoder_create().
+ *
+ * \details All kinds of pruning are disabled (the histogram_size is
+ * DEFAULT_HISTOGRAM_SIZE), the lattice_size is DEFAULT_LATTICE_SIZE, one
+ * thread is used, the duration model of phonemes is defined by
+ * DEFAULT_FRAME_DURATION and DEFAULT_MAX_REPEATS_OF_PHONEME without segments,
+ * the max_emission_table_size is DEFAULT_MAX_EMISSION_TABLE_SIZE, scores are
+ * floating-point, the language model lookahead isn't used, and the fast match
+ * is disabled (the fast_match_depth is DEFAULT_FAST_MATCH_DEPTH, but the
+ * fast_match_size is zero).
+ *
+ * \return The default parameters of the decoder.
+ *
+ * \sa decoder_create().
+ */
+TDecoderParameters decoder_get_default_parameters(void);
+
+/*! \fn PDecoder decoder_create(TDecoderModels models,
+ *                             TDecoderParameters parameters)
+ *
+ * \brief This function creates the decoder, which recognizes words in
+ * phonemes sequences like the recognize_words() function (or like the
+ * recognize_words_by_words_tree() function, if the words tree is specified).
+ *
+ * \details The decoder compiles the words lexicon (or the words tree) once,
+ * and it keeps memory buffers of recognition for each thread. These buffers
+ * are enlarged up to the longest phonemes sequence which was recognized, and
+ * they are reused by all next calls of decoder_decode(). Therefore the decoder
+ * is suitable for recognition of many small requests.
+ *
+ * \param models All models which are used for recognition. They aren't copied,
+ * so they must exist until the decoder is destroyed.
+ *
+ * \param parameters Parameters of pruning and number of threads (see
+ * recognize_words()), and parameters of the duration model of phonemes (the
+ * frame_duration must be greater than zero, the max_repeats_of_phoneme must be
+ * greater than or equal to 1, and the use_segments must be 0 or 1). The
+ * max_emission_table_size must not be negative, the use_lm_lookahead must be
+ * 0 or 1, the fast_match_depth must be from 0 to MAX_FAST_MATCH_DEPTH, and the
+ * fast_match_size must not be negative.
+ *
+ * \return Pointer to the created decoder, or NULL in case of error.
+ *
+ * \sa decoder_decode(), decoder_push(), decoder_destroy().
+ */
+PDecoder decoder_create(TDecoderModels models, TDecoderParameters parameters);
+
+/*! \fn int decoder_decode(
+ *         PDecoder decoder, TMLFFilePart *source_phonemes_MLF,
+ *         int number_of_MLF_files, TMLFFilePart **result_words_MLF)
+ *
+ * \brief This function recognizes all words which are represented in source
+ * sequences of phonemes by means of the decoder.
+ *
+ * \details Results of this function are identical to results of the
+ * recognize_words() function with the same models and parameters (if each
+ * phoneme is expanded into time points with the default duration, see
+ * TDecoderParameters). This function fails if some utterance of the phonemes
+ * stream is being recognized by the decoder (see decoder_push()).
+ *
+ * \param decoder The decoder which is created by the decoder_create()
+ * function.
+ *
+ * \param source_phonemes_MLF The array of parts of the source MLF file (see
+ * recognize_words()). It can contain one phonemes sequence only.
+ *
+ * \param number_of_MLF_files The size of TMLFFilePart array.
+ *
+ * \param result_words_MLF It is pointer to array of parts of the words MLF
+ * file (see recognize_words()). Memory for this array will be allocated
+ * automatically in this function, and it must be freed by the free_MLF()
+ * function.
+ *
+ * \return If the recognition process completes successfully, then this
+ * function returns 1. In other cases this function returns 0.
+ *
+ * \sa decoder_create(), decoder_destroy().
+ */
+int decoder_decode(PDecoder decoder, TMLFFilePart *source_phonemes_MLF,
+                   int number_of_MLF_files, TMLFFilePart **result_words_MLF);
+
+/*! \fn int decoder_generate_lattices(
+ *         PDecoder decoder, TMLFFilePart *source_phonemes_MLF,
+ *         int number_of_MLF_files, TMLFFilePart **result_words_MLF,
+ *         TWordLattice **lattices)
+ *
+ * \brief This function recognizes all words which are represented in source
+ * sequences of phonemes like the decoder_decode() function, and it creates
+ * the word lattice of each phonemes sequence, so that recognition results can
+ * be rescored without repetition of the search.
+ *
+ * \details Alive word ends of each time point are recorded at recognition,
+ * except word ends with costs less than the best word end cost of this time
+ * point minus the lattice_beam, and only the lattice_size best word ends are
+ * kept (see TDecoderParameters). Also best predecessors of the lattice_size
+ * best words entered after this time point are kept, so that the best path of
+ * the lattice isn't lost. Each node of the lattice is a recorded word
+ * end which is reachable from the start node and from which the end node is
+ * reachable. Each word end is linked with all word ends of the time point
+ * before its word. The acoustic score of link is the cost of the successor
+ * word end minus the best cost of transition into its word, and the language
+ * score is the bigram score. If the words tree is used, then transitions into
+ * words are made from the best word end of each time point only, so acoustic
+ * scores of links from other word ends are approximate.
+ *
+ * \param decoder The decoder which is created by the decoder_create()
+ * function.
+ *
+ * \param source_phonemes_MLF The array of parts of the source MLF file (see
+ * recognize_words()).
+ *
+ * \param number_of_MLF_files The size of TMLFFilePart array.
+ *
+ * \param result_words_MLF It is pointer to array of parts of the words MLF
+ * file (see decoder_decode()).
+ *
+ * \param lattices It is pointer to array of word lattices. The lattice name
+ * is the label file name with the "lat" extension. Memory for this array will
+ * be allocated automatically in this function, and it must be freed by the
+ * free_word_lattices() function.
+ *
+ * \return If the recognition process completes successfully, then this
+ * function returns 1. In other cases this function returns 0. In particular,
+ * the lattice can't be created if its end node is unreachable from its start
+ * node. It is possible if the language model has no unigram backoff (i.e.
+ * the lambda of compile_language_model() is 1.0) and the lattice_size is too
+ * small.
+ *
+ * \sa decoder_decode(), save_word_lattice().
+ */
+int decoder_generate_lattices(
+        PDecoder decoder, TMLFFilePart *source_phonemes_MLF,
+        int number_of_MLF_files, TMLFFilePart **result_words_MLF,
+        TWordLattice **lattices);
+
+/*! \fn int decoder_generate_nbest(
+ *         PDecoder decoder, TMLFFilePart *source_phonemes_MLF,
+ *         int number_of_MLF_files, int nbest_size, TNBestList **nbest_lists)
+ *
+ * \brief This function recognizes all words which are represented in source
+ * sequences of phonemes by means of the decoder, and it finds the N-best list
+ * of different words sequences for each phonemes sequence.
+ *
+ * \details The word lattice of each phonemes sequence is created like in the
+ * decoder_generate_lattices() function, so size of the N-best list depends on
+ * the lattice_beam and the lattice_size parameters of the decoder. Best paths
+ * of this lattice are found by the A* search, in which the heuristic is the
+ * exact score of the best path from the node to the end node. Paths with the
+ * same words sequence which come into the same node are merged, so each found
+ * path is a new words sequence. The first hypothesis is the best path of the
+ * lattice, and it can differ from result of the decoder_decode() function,
+ * because traceback of the decoder keeps the only best word end for each time.
+ * Start and end times of words in hypotheses are taken from nodes of the
+ * lattice, and score of each word is the difference between scores of its
+ * path and of the previous path.
+ *
+ * \param decoder The decoder which is created by the decoder_create()
+ * function.
+ *
+ * \param source_phonemes_MLF The array of parts of the source MLF file (see
+ * recognize_words()).
+ *
+ * \param number_of_MLF_files The size of TMLFFilePart array.
+ *
+ * \param nbest_size The maximal number of hypotheses of each N-best list.
+ *
+ * \param nbest_lists It is pointer to array of N-best lists. Name of each
+ * list is the label file name with the "rec" extension. Memory for this array
+ * will be allocated automatically in this function, and it must be freed by
+ * the free_nbest_lists() function.
+ *
+ * \return If the recognition process completes successfully, then this
+ * function returns 1. In other cases this function returns 0.
+ *
+ * \sa decoder_generate_lattices(), save_nbest_MLF().
+ */
+int decoder_generate_nbest(
+        PDecoder decoder, TMLFFilePart *source_phonemes_MLF,
+        int number_of_MLF_files, int nbest_size, TNBestList **nbest_lists);
+
+/*! \fn int decoder_push(PDecoder decoder, TTranscriptionNode phonemes[],
+ *                      int phonemes_number)
+ *
+ * \brief This function recognizes the next part of the phonemes stream by
+ * means of the decoder, i.e. it continues recognition of the current
+ * utterance, which is started by the first call of this function after
+ * creation of the decoder or after the decoder_finalize() function.
+ *
+ * \details Phonemes are recognized as soon as they are pushed, so time of
+ * this function depends on number of pushed phonemes only. Pauses (phonemes
+ * with zero index) in the beginning and in the end of utterance are skipped
+ * like in the recognize_words() function, therefore pauses are kept by the
+ * decoder until the next phoneme is pushed. The first workspace of the
+ * decoder is used for recognition of the stream, so the decoder_decode()
+ * function can't be called until the current utterance is finalized.
+ *
+ * \param decoder The decoder which is created by the decoder_create()
+ * function.
+ *
+ * \param phonemes The array of phonemes with their time bounds and
+ * probabilities (like transcription of part of the source MLF file).
+ *
+ * \param phonemes_number The size of the phonemes array.
+ *
+ * \return If the phonemes are recognized successfully, then this function
+ * returns 1. In other cases this function returns 0, and recognition of the
+ * current utterance is failed (all next phonemes of this utterance will be
+ * rejected until the decoder_finalize() function is called).
+ *
+ * \sa decoder_get_partial_result(), decoder_finalize().
+ */
+int decoder_push(PDecoder decoder, TTranscriptionNode phonemes[],
+                 int phonemes_number);
+
+/*! \fn int decoder_get_partial_result(
+ *         PDecoder decoder, TTranscriptionNode **words, int *words_number)
+ *
+ * \brief This function finds the best words sequence for all phonemes of the
+ * current utterance which are pushed by this moment.
+ *
+ * \details Recognition of the current utterance isn't changed, so more
+ * phonemes can be pushed after that, and the best words sequence may be
+ * changed by them. Words which are taken by the decoder_get_stable_words()
+ * function aren't included into the result.
+ *
+ * \param decoder The decoder which is created by the decoder_create()
+ * function.
+ *
+ * \param words It is pointer to array of recognized words (node_data of each
+ * node is index of word in the words vocabulary). Memory for this array will
+ * be allocated automatically in this function if the words sequence isn't
+ * empty (otherwise NULL is written), and it must be freed by the free()
+ * function.
+ *
+ * \param words_number It is pointer to length of the words sequence.
+ *
+ * \return If the current utterance is recognized successfully by this moment,
+ * then this function returns 1. In other cases this function returns 0.
+ *
+ * \sa decoder_push(), decoder_finalize().
+ */
+int decoder_get_partial_result(PDecoder decoder, TTranscriptionNode **words,
+                               int *words_number);
+
+/*! \fn int decoder_get_stable_words(
+ *         PDecoder decoder, TTranscriptionNode **words, int *words_number)
+ *
+ * \brief This function takes the beginning of the best words sequence of the
+ * current utterance which can't be changed by next phonemes.
+ *
+ * \details Words histories of all unpruned hypotheses of the decoder pass
+ * through these words, so they are committed, and memory of the traceback
+ * which precedes them is released (the decoder commits stable words
+ * automatically when its traceback memory is exhausted). Taken words are
+ * excluded from results of decoder_get_partial_result(), decoder_finalize()
+ * and next calls of this function, so memory of the decoder doesn't depend on
+ * duration of the utterance if stable words are taken regularly.
+ *
+ * \param decoder The decoder which is created by the decoder_create()
+ * function.
+ *
+ * \param words It is pointer to array of stable words (see
+ * decoder_get_partial_result()). It must be freed by the free() function.
+ *
+ * \param words_number It is pointer to number of stable words (it may be
+ * zero if the best words sequence isn't stable yet).
+ *
+ * \return If the current utterance is recognized successfully by this moment,
+ * then this function returns 1. In other cases this function returns 0.
+ *
+ * \sa decoder_push(), decoder_get_partial_result(), decoder_finalize().
+ */
+int decoder_get_stable_words(PDecoder decoder, TTranscriptionNode **words,
+                             int *words_number);
+
+/*! \fn int decoder_finalize(
+ *         PDecoder decoder, TTranscriptionNode **words, int *words_number)
+ *
+ * \brief This function completes recognition of the current utterance, and
+ * it finds the best words sequence for this utterance.
+ *
+ * \details Results of this function are identical to results of the
+ * decoder_decode() function for the same phonemes sequence, except words which
+ * are taken by the decoder_get_stable_words() function already. Pauses in the
+ * end of utterance are skipped. After that the next call of the decoder_push()
+ * function starts recognition of new utterance.
+ *
+ * \param decoder The decoder which is created by the decoder_create()
+ * function.
+ *
+ * \param words It is pointer to array of recognized words (see
+ * decoder_get_partial_result()). It must be freed by the free() function.
+ *
+ * \param words_number It is pointer to length of the words sequence.
+ *
+ * \return If the utterance is recognized successfully, then this function
+ * returns 1. In other cases this function returns 0.
+ *
+ * \sa decoder_push(), decoder_get_partial_result().
+ */
+int decoder_finalize(PDecoder decoder, TTranscriptionNode **words,
+                     int *words_number);
+
+/*! \fn int decoder_get_lookahead_score(
+ *         PDecoder decoder, int phonemes[], int phonemes_number, float *score)
+ *
+ * \brief This function finds the score of the language model lookahead of the
+ * phoneme node of the words tree which is reached from the root node by the
+ * given phonemes.
+ *
+ * \details This score is the best score of the language model (without
+ * context) of all words which are reachable from this node (see the
+ * use_lm_lookahead field of TDecoderParameters). Scores of the language model
+ * are rounded in the fixed-point mode.
+ *
+ * \param decoder The decoder which is created by the decoder_create()
+ * function with the words tree and the language model lookahead.
+ *
+ * \param phonemes The array of indexes of phonemes (first phonemes of some
+ * words of the words tree).
+ *
+ * \param phonemes_number The size of the phonemes array.
+ *
+ * \param score It is pointer to the found score.
+ *
+ * \return If the phoneme node is found, then this function returns 1. In other
+ * cases (for example, the decoder doesn't use the words tree or the language
+ * model lookahead) this function returns 0.
+ *
+ * \sa decoder_create().
+ */
+int decoder_get_lookahead_score(PDecoder decoder, int phonemes[],
+                                int phonemes_number, float *score);
+
+/*! \fn void decoder_destroy(PDecoder *decoder)
+ *
+ * \brief This function frees all memory which was allocated for the decoder.
+ * Models of the decoder aren't freed.
+ *
+ * \param decoder Pointer to the decoder (it will be set to NULL).
+ *
+ * \sa decoder_create().
+ */
+void decoder_destroy(PDecoder *decoder);
+
 /*! \fn float estimate_error_rate(
  *         TMLFFilePart recognized_MLF[], TMLFFilePart correct_MLF[],
  *         int files_number, int *insertions,int *deletions,int *substitutions)
@@ -113,10 +113,57 @@ static int get_parameters_of_recognition(
         int argc,char *argv[], char **source_file_name,char **result_file_name,
         char **phonemes_vocabulary, char **confusion_matrix_name,
         char **words_vocabulary, float *pruning_coeff,
-        char **language_model_name, float *lambda)
+        char **language_model_name, float *lambda, int *use_words_tree,
+        int *threads_number, int *histogram_size, float *beam_width,
+        int *max_active_hypotheses, float *word_end_beam,
+        char **lattices_directory, float *lattice_beam, int *lattice_size,
+        int *nbest_size, float *frame_duration, int *max_repeats_of_phoneme,
+        int *use_segments, int *max_emission_table_size,
+        int *fixed_point_bits, int *use_lm_lookahead, int *fast_match_depth,
+        int *fast_match_size, int *estimate_drift, char **correct_file_name)
 {
     int i, n = 0, is_ok = 0;
 
+    *use_words_tree = 0;
+    for (i = 0; i < argc; i++)
+    {
+        if (strcmp(argv[i], "-tree") == 0)
+        {
+            *use_words_tree = 1;
+            break;
+        }
+    }
+
+    *use_segments = 0;
+    for (i = 0; i < argc; i++)
+    {
+        if (strcmp(argv[i], "-segments") == 0)
+        {
+            *use_segments = 1;
+            break;
+        }
+    }
+
+    *use_lm_lookahead = 0;
+    for (i = 0; i < argc; i++)
+    {
+        if (strcmp(argv[i], "-lookahead") == 0)
+        {
+            *use_lm_lookahead = 1;
+            break;
+        }
+    }
+
+    *estimate_drift = 0;
+    for (i = 0; i < argc; i++)
+    {
+        if (strcmp(argv[i], "-fpdrift") == 0)
+        {
+            *estimate_drift = 1;
+            break;
+        }
+    }
+
     for (i = 0; i < (argc-1); i++)
     {
         if (strcmp(argv[i], "-src") == 0)
@@ -258,7 +305,293 @@ static int get_parameters_of_recognition(
         return 0;
     }
 
-    return ((n * 2) == (argc-2));
+    *threads_number = 1;
+    for (i = 0; i < (argc-1); i++)
+    {
+        if (strcmp(argv[i], "-threads") == 0)
+        {
+            if (sscanf(argv[i+1], "%d", threads_number) != 1)
+            {
+                return 0;
+            }
+            if (*threads_number <= 0)
+            {
+                return 0;
+            }
+            n++;
+            break;
+        }
+    }
+
+    *histogram_size = DEFAULT_HISTOGRAM_SIZE;
+    for (i = 0; i < (argc-1); i++)
+    {
+        if (strcmp(argv[i], "-hist") == 0)
+        {
+            if (sscanf(argv[i+1], "%d", histogram_size) != 1)
+            {
+                return 0;
+            }
+            if (*histogram_size < 2)
+            {
+                return 0;
+            }
+            n++;
+            break;
+        }
+    }
+
+    *beam_width = 0.0;
+    for (i = 0; i < (argc-1); i++)
+    {
+        if (strcmp(argv[i], "-beam") == 0)
+        {
+            if (sscanf(argv[i+1], "%f", beam_width) != 1)
+            {
+                return 0;
+            }
+            if (*beam_width < 0.0)
+            {
+                return 0;
+            }
+            n++;
+            break;
+        }
+    }
+
+    *max_active_hypotheses = 0;
+    for (i = 0; i < (argc-1); i++)
+    {
+        if (strcmp(argv[i], "-maxactive") == 0)
+        {
+            if (sscanf(argv[i+1], "%d", max_active_hypotheses) != 1)
+            {
+                return 0;
+            }
+            if (*max_active_hypotheses < 0)
+            {
+                return 0;
+            }
+            n++;
+            break;
+        }
+    }
+
+    *word_end_beam = 0.0;
+    for (i = 0; i < (argc-1); i++)
+    {
+        if (strcmp(argv[i], "-wordbeam") == 0)
+        {
+            if (sscanf(argv[i+1], "%f", word_end_beam) != 1)
+            {
+                return 0;
+            }
+            if (*word_end_beam < 0.0)
+            {
+                return 0;
+            }
+            n++;
+            break;
+        }
+    }
+
+    *lattices_directory = NULL;
+    for (i = 0; i < (argc-1); i++)
+    {
+        if (strcmp(argv[i], "-lat") == 0)
+        {
+            *lattices_directory = argv[i+1];
+            n++;
+            break;
+        }
+    }
+
+    *lattice_beam = 0.0;
+    for (i = 0; i < (argc-1); i++)
+    {
+        if (strcmp(argv[i], "-latbeam") == 0)
+        {
+            if (sscanf(argv[i+1], "%f", lattice_beam) != 1)
+            {
+                return 0;
+            }
+            if (*lattice_beam < 0.0)
+            {
+                return 0;
+            }
+            n++;
+            break;
+        }
+    }
+
+    *lattice_size = DEFAULT_LATTICE_SIZE;
+    for (i = 0; i < (argc-1); i++)
+    {
+        if (strcmp(argv[i], "-latsize") == 0)
+        {
+            if (sscanf(argv[i+1], "%d", lattice_size) != 1)
+            {
+                return 0;
+            }
+            if (*lattice_size < 0)
+            {
+                return 0;
+            }
+            n++;
+            break;
+        }
+    }
+
+    *nbest_size = 0;
+    for (i = 0; i < (argc-1); i++)
+    {
+        if (strcmp(argv[i], "-nbest") == 0)
+        {
+            if (sscanf(argv[i+1], "%d", nbest_size) != 1)
+            {
+                return 0;
+            }
+            if ((*nbest_size <= 0) || (*lattices_directory != NULL))
+            {
+                return 0;
+            }
+            n++;
+            break;
+        }
+    }
+
+    *frame_duration = DEFAULT_FRAME_DURATION;
+    for (i = 0; i < (argc-1); i++)
+    {
+        if (strcmp(argv[i], "-framedur") == 0)
+        {
+            if (sscanf(argv[i+1], "%f", frame_duration) != 1)
+            {
+                return 0;
+            }
+            if (*frame_duration <= 0.0)
+            {
+                return 0;
+            }
+            n++;
+            break;
+        }
+    }
+
+    *max_repeats_of_phoneme = DEFAULT_MAX_REPEATS_OF_PHONEME;
+    for (i = 0; i < (argc-1); i++)
+    {
+        if (strcmp(argv[i], "-maxrepeats") == 0)
+        {
+            if (sscanf(argv[i+1], "%d", max_repeats_of_phoneme) != 1)
+            {
+                return 0;
+            }
+            if (*max_repeats_of_phoneme < 1)
+            {
+                return 0;
+            }
+            n++;
+            break;
+        }
+    }
+
+    *max_emission_table_size = DEFAULT_MAX_EMISSION_TABLE_SIZE;
+    for (i = 0; i < (argc-1); i++)
+    {
+        if (strcmp(argv[i], "-maxemissions") == 0)
+        {
+            if (sscanf(argv[i+1], "%d", max_emission_table_size) != 1)
+            {
+                return 0;
+            }
+            if (*max_emission_table_size < 0)
+            {
+                return 0;
+            }
+            n++;
+            break;
+        }
+    }
+
+    *fixed_point_bits = 0;
+    for (i = 0; i < (argc-1); i++)
+    {
+        if (strcmp(argv[i], "-fixedpoint") == 0)
+        {
+            if (sscanf(argv[i+1], "%d", fixed_point_bits) != 1)
+            {
+                return 0;
+            }
+            if ((*fixed_point_bits < 1)
+                    || (*fixed_point_bits > MAX_FIXED_POINT_BITS))
+            {
+                return 0;
+            }
+            n++;
+            break;
+        }
+    }
+
+    *fast_match_depth = DEFAULT_FAST_MATCH_DEPTH;
+    for (i = 0; i < (argc-1); i++)
+    {
+        if (strcmp(argv[i], "-fastdepth") == 0)
+        {
+            if (sscanf(argv[i+1], "%d", fast_match_depth) != 1)
+            {
+                return 0;
+            }
+            if ((*fast_match_depth < 1)
+                    || (*fast_match_depth > MAX_FAST_MATCH_DEPTH))
+            {
+                return 0;
+            }
+            n++;
+            break;
+        }
+    }
+
+    *fast_match_size = 0;
+    for (i = 0; i < (argc-1); i++)
+    {
+        if (strcmp(argv[i], "-fastsize") == 0)
+        {
+            if (sscanf(argv[i+1], "%d", fast_match_size) != 1)
+            {
+                return 0;
+            }
+            if (*fast_match_size < 1)
+            {
+                return 0;
+            }
+            n++;
+            break;
+        }
+    }
+
+    *correct_file_name = NULL;
+    for (i = 0; i < (argc-1); i++)
+    {
+        if (strcmp(argv[i], "-corr") == 0)
+        {
+            if (!(*estimate_drift))
+            {
+                return 0;
+            }
+            *correct_file_name = argv[i+1];
+            n++;
+            break;
+        }
+    }
+    if (*estimate_drift && ((*lattices_directory != NULL)
+                            || (*nbest_size > 0)))
+    {
+        return 0;
+    }
+
+    return ((n * 2 + *use_words_tree + *use_segments + *use_lm_lookahead
+             + *estimate_drift) == (argc-2));
 }
 
 static int get_parameters_of_estimating(
@@ -373,6 +706,119 @@ int train_language_model_by_mlf_file(int argc, char *argv[])
     return 1;
 }
 
+/* This function saves each word lattice into the separate SLF file of the
+ * given directory. Name of the file is the base name of the lattice. */
+static int save_word_lattices(char *lattices_directory, TWordLattice *lattices,
+                              int number_of_lattices, char **words_vocabulary,
+                              int words_number)
+{
+    int i, j, n, ret = 1;
+    char *base_name, *file_name;
+
+    for (i = 0; i < number_of_lattices; i++)
+    {
+        base_name = lattices[i].name;
+        for (j = strlen(lattices[i].name) - 1; j >= 0; j--)
+        {
+            if ((lattices[i].name[j] == '/') || (lattices[i].name[j] == '\\'))
+            {
+                base_name = lattices[i].name + j + 1;
+                break;
+            }
+        }
+        n = strlen(lattices_directory) + strlen(base_name) + 2;
+        file_name = malloc(n * sizeof(char));
+        sprintf(file_name, "%s/%s", lattices_directory, base_name);
+        ret = save_word_lattice(file_name, lattices[i], words_vocabulary,
+                                words_number);
+        free(file_name);
+        if (!ret)
+        {
+            break;
+        }
+    }
+
+    return ret;
+}
+
+/* This function decodes the source data in the fixed-point mode with the
+ * given number of bits (other parameters are the same as for the float
+ * results) and prints the WER drift of these results against the float
+ * results through estimate_error_rate(). Utterances with empty float results
+ * can't be references of estimate_error_rate(), so they are skipped. If the
+ * correct data are given, then WER of the fixed-point results against them
+ * and its difference from WER of the float results (the float_WER) are
+ * printed too.
+ */
+static int print_drift_of_fixed_point_mode(
+        TDecoderModels models, TDecoderParameters parameters,
+        int fixed_point_bits, TMLFFilePart *src_data, TMLFFilePart *res_data,
+        TMLFFilePart *correct_data, int files_in_MLF, float float_WER)
+{
+    TMLFFilePart *fixed_res_data = NULL;
+    TMLFFilePart *selected_res_data = NULL, *selected_float_data = NULL;
+    PDecoder decoder = NULL;
+    int i, n = 0, insertions = 0, deletions = 0, substitutions = 0;
+    float drift = 0.0, fixed_WER;
+
+    parameters.fixed_point_bits = fixed_point_bits;
+    decoder = decoder_create(models, parameters);
+    if ((decoder == NULL)
+            || !decoder_decode(decoder, src_data, files_in_MLF,
+                               &fixed_res_data))
+    {
+        decoder_destroy(&decoder);
+        return 0;
+    }
+    decoder_destroy(&decoder);
+
+    selected_res_data = malloc(files_in_MLF * sizeof(TMLFFilePart));
+    selected_float_data = malloc(files_in_MLF * sizeof(TMLFFilePart));
+    for (i = 0; i < files_in_MLF; i++)
+    {
+        if (res_data[i].transcription_size > 0)
+        {
+            selected_res_data[n] = fixed_res_data[i];
+            selected_float_data[n] = res_data[i];
+            n++;
+        }
+    }
+    if (n > 0)
+    {
+        drift = estimate_error_rate(selected_res_data, selected_float_data, n,
+                                    &insertions, &deletions, &substitutions);
+    }
+    free(selected_res_data);
+    free(selected_float_data);
+    if (drift < 0.0)
+    {
+        free_MLF(&fixed_res_data, files_in_MLF);
+        return 0;
+    }
+    printf("%d bits: WER drift against the float results is %.2f%% (%d "\
+           "insertions, %d deletions, %d substitutions, %d of %d "\
+           "utterances).\n", fixed_point_bits, drift, insertions, deletions,
+           substitutions, n, files_in_MLF);
+
+    if (correct_data != NULL)
+    {
+        fixed_WER = estimate_error_rate(fixed_res_data, correct_data,
+                                        files_in_MLF, &insertions, &deletions,
+                                        &substitutions);
+        if (fixed_WER < 0.0)
+        {
+            free_MLF(&fixed_res_data, files_in_MLF);
+            return 0;
+        }
+        printf("%d bits: WER is %.2f%%, its difference from WER of the "\
+               "float results is %+.2f%%.\n", fixed_point_bits, fixed_WER,
+               fixed_WER - float_WER);
+    }
+    free_MLF(&fixed_res_data, files_in_MLF);
+
+    return 1;
+}
+
 int recognize_speech_by_mlf_file(int argc, char *argv[])
 {
     char *source_file_name = NULL;
@@ -381,14 +827,38 @@ int recognize_speech_by_mlf_file(int argc, char *argv[])
     char *confusion_matrix_name = NULL;
     char *words_vocabulary_name = NULL;
     char *language_model_name = NULL;
+    char *lattices_directory = NULL;
 
     TMLFFilePart *src_data = NULL, *res_data = NULL;
     int files_in_MLF = 0;
     char **phonemes_vocabulary, **words_vocabulary;
-    int phonemes_number, words_number, words_lexicon_size;
+    int phonemes_number, words_number, words_lexicon_size = 0;
     TLinearWordsLexicon *words_lexicon = NULL;
+    PWordsTreeNode words_tree = NULL;
+    int use_words_tree = 0, threads_number = 1;
+    int histogram_size = DEFAULT_HISTOGRAM_SIZE, max_active_hypotheses = 0;
     TLanguageModel language_model;
+    TCompiledLanguageModel compiled_language_model;
     float lambda = 1.0, pruning_coeff = 0.0;
+    float beam_width = 0.0, word_end_beam = 0.0, lattice_beam = 0.0;
+    int lattice_size = DEFAULT_LATTICE_SIZE, nbest_size = 0;
+    float frame_duration = DEFAULT_FRAME_DURATION;
+    int max_repeats_of_phoneme = DEFAULT_MAX_REPEATS_OF_PHONEME;
+    int use_segments = 0;
+    int max_emission_table_size = DEFAULT_MAX_EMISSION_TABLE_SIZE;
+    int fixed_point_bits = 0;
+    int use_lm_lookahead = 0;
+    int fast_match_depth = DEFAULT_FAST_MATCH_DEPTH, fast_match_size = 0;
+    int estimate_drift = 0, drift_bits = 0, first_bits, last_bits;
+    char *correct_file_name = NULL;
+    TMLFFilePart *correct_data = NULL;
+    int correct_files = 0, insertions = 0, deletions = 0, substitutions = 0;
+    float float_WER = 0.0;
+    TDecoderModels models;
+    TDecoderParameters parameters;
+    PDecoder decoder = NULL;
+    TWordLattice *lattices = NULL;
+    TNBestList *nbest_lists = NULL;
     float *confusion_penalties_matrix = NULL;
     int recogn_res;
     double start_time, end_time;
@@ -397,11 +867,25 @@ int recognize_speech_by_mlf_file(int argc, char *argv[])
                 argc, argv, &source_file_name, &result_file_name,
                 &phonemes_vocabulary_name, &confusion_matrix_name,
                 &words_vocabulary_name, &pruning_coeff, &language_model_name,
-                &lambda))
+                &lambda, &use_words_tree, &threads_number, &histogram_size,
+                &beam_width, &max_active_hypotheses, &word_end_beam,
+                &lattices_directory, &lattice_beam, &lattice_size,
+                &nbest_size, &frame_duration, &max_repeats_of_phoneme,
+                &use_segments, &max_emission_table_size, &fixed_point_bits,
+                &use_lm_lookahead, &fast_match_depth, &fast_match_size,
+                &estimate_drift, &correct_file_name))
     {
         fprintf(stderr, "Parameters of command prompt are incorrect.\n");
         return 0;
     }
+    if (estimate_drift)
+    {
+        /* the saved results are the float ones, and they are the reference
+           for the fixed-point mode (with the given number of bits, or with
+           every possible number if it isn't given) */
+        drift_bits = fixed_point_bits;
+        fixed_point_bits = 0;
+    }
     phonemes_number = load_phonemes_vocabulary(phonemes_vocabulary_name,
                                                &phonemes_vocabulary);
     if (phonemes_number <= 0)
@@ -431,10 +915,21 @@ int recognize_speech_by_mlf_file(int argc, char *argv[])
                 "incorrect, or it cannot be loaded from the given file).\n");
         return 0;
     }
-    words_lexicon_size = create_linear_words_lexicon(
-                words_vocabulary_name, phonemes_vocabulary, phonemes_number,
-                words_vocabulary, words_number, &words_lexicon);
-    if (words_lexicon_size <= 0)
+    if (use_words_tree)
+    {
+        words_tree = create_words_vocabulary_tree(
+                    words_vocabulary_name, phonemes_vocabulary,
+                    phonemes_number, words_vocabulary, words_number);
+    }
+    else
+    {
+        words_lexicon_size = create_linear_words_lexicon(
+                    words_vocabulary_name, phonemes_vocabulary,
+                    phonemes_number, words_vocabulary, words_number,
+                    &words_lexicon);
+    }
+    if ((use_words_tree && (words_tree == NULL))
+            || (!use_words_tree && (words_lexicon_size <= 0)))
     {
         free_string_array(&phonemes_vocabulary, phonemes_number);
         free_string_array(&words_vocabulary, words_number);
@@ -450,10 +945,24 @@ int recognize_speech_by_mlf_file(int argc, char *argv[])
         free_string_array(&words_vocabulary, words_number);
         free(confusion_penalties_matrix);
         free_linear_words_lexicon(&words_lexicon, words_lexicon_size);
+        free_words_tree(&words_tree);
         fprintf(stderr, "The language model cannot be loaded from the given "\
                 "file.\n");
         return 0;
     }
+    if (!compile_language_model(language_model, lambda,
+                                &compiled_language_model))
+    {
+        free_string_array(&phonemes_vocabulary, phonemes_number);
+        free_string_array(&words_vocabulary, words_number);
+        free(confusion_penalties_matrix);
+        free_linear_words_lexicon(&words_lexicon, words_lexicon_size);
+        free_words_tree(&words_tree);
+        free_language_model(&language_model);
+        fprintf(stderr, "The language model cannot be compiled.\n");
+        return 0;
+    }
+    free_language_model(&language_model);
 
     files_in_MLF = load_phonemes_MLF(
                 source_file_name, phonemes_vocabulary, phonemes_number,
@@ -464,17 +973,84 @@ int recognize_speech_by_mlf_file(int argc, char *argv[])
         free_string_array(&words_vocabulary, words_number);
         free(confusion_penalties_matrix);
         free_linear_words_lexicon(&words_lexicon, words_number);
-        free_language_model(&language_model);
+        free_words_tree(&words_tree);
+        free_compiled_language_model(&compiled_language_model);
         fprintf(stderr, "The source data (phonemes transcriptions in the MLF "\
                 "file) cannot be loaded from the given file.\n");
         return 0;
     }
 
     start_time = omp_get_wtime();
-    recogn_res = recognize_words(
-                src_data, files_in_MLF, phonemes_number,
-                confusion_penalties_matrix, words_lexicon, words_lexicon_size,
-                pruning_coeff, language_model, lambda, &res_data);
+    if ((lattices_directory != NULL) || (nbest_size > 0) || use_segments
+            || (frame_duration != DEFAULT_FRAME_DURATION)
+            || (max_repeats_of_phoneme != DEFAULT_MAX_REPEATS_OF_PHONEME)
+            || (max_emission_table_size != DEFAULT_MAX_EMISSION_TABLE_SIZE)
+            || (fixed_point_bits > 0) || use_lm_lookahead
+            || (fast_match_size > 0) || estimate_drift)
+    {
+        models.phonemes_vocabulary_size = phonemes_number;
+        models.confusion_penalties_matrix = confusion_penalties_matrix;
+        models.words_lexicon = words_lexicon;
+        models.words_lexicon_size = words_lexicon_size;
+        models.words_tree_root = words_tree;
+        models.language_model = compiled_language_model;
+        parameters = decoder_get_default_parameters();
+        parameters.pruning_coeff = pruning_coeff;
+        parameters.histogram_size = histogram_size;
+        parameters.beam_width = beam_width;
+        parameters.max_active_hypotheses = max_active_hypotheses;
+        parameters.word_end_beam = word_end_beam;
+        parameters.lattice_beam = lattice_beam;
+        parameters.lattice_size = lattice_size;
+        parameters.threads_number = threads_number;
+        parameters.frame_duration = frame_duration;
+        parameters.max_repeats_of_phoneme = max_repeats_of_phoneme;
+        parameters.use_segments = use_segments;
+        parameters.max_emission_table_size = max_emission_table_size;
+        parameters.fixed_point_bits = fixed_point_bits;
+        parameters.use_lm_lookahead = use_lm_lookahead;
+        parameters.fast_match_depth = fast_match_depth;
+        parameters.fast_match_size = fast_match_size;
+        decoder = decoder_create(models, parameters);
+        if (nbest_size > 0)
+        {
+            recogn_res = (decoder != NULL)
+                    && decoder_generate_nbest(decoder, src_data, files_in_MLF,
+                                              nbest_size, &nbest_lists);
+        }
+        else if (lattices_directory == NULL)
+        {
+            recogn_res = (decoder != NULL)
+                    && decoder_decode(decoder, src_data, files_in_MLF,
+                                      &res_data);
+        }
+        else
+        {
+            recogn_res = (decoder != NULL)
+                    && decoder_generate_lattices(decoder, src_data,
+                                                 files_in_MLF, &res_data,
+                                                 &lattices);
+        }
+        decoder_destroy(&decoder);
+    }
+    else if (use_words_tree)
+    {
+        recogn_res = recognize_words_by_words_tree(
+                    src_data, files_in_MLF, phonemes_number,
+                    confusion_penalties_matrix, words_tree, pruning_coeff,
+                    histogram_size, beam_width, max_active_hypotheses,
+                    word_end_beam, compiled_language_model, threads_number,
+                    &res_data);
+    }
+    else
+    {
+        recogn_res = recognize_words(
+                    src_data, files_in_MLF, phonemes_number,
+                    confusion_penalties_matrix, words_lexicon,
+                    words_lexicon_size, pruning_coeff, histogram_size,
+                    beam_width, max_active_hypotheses, word_end_beam,
+                    compiled_language_model, threads_number, &res_data);
+    }
     end_time = omp_get_wtime();
     if (!recogn_res)
     {
@@ -482,38 +1058,136 @@ int recognize_speech_by_mlf_file(int argc, char *argv[])
         free_string_array(&words_vocabulary, words_number);
         free(confusion_penalties_matrix);
         free_linear_words_lexicon(&words_lexicon, words_number);
-        free_language_model(&language_model);
+        free_words_tree(&words_tree);
+        free_compiled_language_model(&compiled_language_model);
         free_MLF(&src_data, files_in_MLF);
         fprintf(stderr, "The input data cannot be recognized (probably, this "\
                 "data are not valid, or recognition parameters are "\
                 "incorrect).\n");
         return 0;
     }
-    if (!save_words_MLF(result_file_name, words_vocabulary, words_number,
-                        res_data, files_in_MLF))
+    if ((nbest_lists != NULL)
+            && !save_nbest_MLF(result_file_name, words_vocabulary,
+                               words_number, nbest_lists, files_in_MLF))
     {
         free_string_array(&phonemes_vocabulary, phonemes_number);
         free_string_array(&words_vocabulary, words_number);
         free(confusion_penalties_matrix);
         free_linear_words_lexicon(&words_lexicon, words_number);
-        free_language_model(&language_model);
+        free_words_tree(&words_tree);
+        free_compiled_language_model(&compiled_language_model);
+        free_MLF(&src_data, files_in_MLF);
+        free_nbest_lists(&nbest_lists, files_in_MLF);
+        fprintf(stderr, "The N-best lists cannot be saved into the given "\
+                "file.\n");
+        return 0;
+    }
+    if ((nbest_lists == NULL)
+            && !save_words_MLF(result_file_name, words_vocabulary,
+                               words_number, res_data, files_in_MLF))
+    {
+        free_string_array(&phonemes_vocabulary, phonemes_number);
+        free_string_array(&words_vocabulary, words_number);
+        free(confusion_penalties_matrix);
+        free_linear_words_lexicon(&words_lexicon, words_number);
+        free_words_tree(&words_tree);
+        free_compiled_language_model(&compiled_language_model);
         free_MLF(&src_data, files_in_MLF);
         free_MLF(&res_data, files_in_MLF);
+        free_word_lattices(&lattices, files_in_MLF);
         fprintf(stderr, "The recognition results cannot be saved into the "\
                 "given file.\n");
         return 0;
     }
+    if ((lattices != NULL)
+            && !save_word_lattices(lattices_directory, lattices, files_in_MLF,
+                                   words_vocabulary, words_number))
+    {
+        free_string_array(&phonemes_vocabulary, phonemes_number);
+        free_string_array(&words_vocabulary, words_number);
+        free(confusion_penalties_matrix);
+        free_linear_words_lexicon(&words_lexicon, words_number);
+        free_words_tree(&words_tree);
+        free_compiled_language_model(&compiled_language_model);
+        free_MLF(&src_data, files_in_MLF);
+        free_MLF(&res_data, files_in_MLF);
+        free_word_lattices(&lattices, files_in_MLF);
+        fprintf(stderr, "The word lattices cannot be saved into the given "\
+                "directory.\n");
+        return 0;
+    }
+
+    printf("Duration of recognition process is %.3f secs.\n",
+           end_time - start_time);
+
+    if (estimate_drift && (correct_file_name != NULL))
+    {
+        correct_files = load_words_MLF(correct_file_name, words_vocabulary,
+                                       words_number, &correct_data);
+        float_WER = -1.0;
+        if (correct_files == files_in_MLF)
+        {
+            float_WER = estimate_error_rate(res_data, correct_data,
+                                            files_in_MLF, &insertions,
+                                            &deletions, &substitutions);
+        }
+        if (float_WER < 0.0)
+        {
+            free_string_array(&phonemes_vocabulary, phonemes_number);
+            free_string_array(&words_vocabulary, words_number);
+            free(confusion_penalties_matrix);
+            free_linear_words_lexicon(&words_lexicon, words_number);
+            free_words_tree(&words_tree);
+            free_compiled_language_model(&compiled_language_model);
+            free_MLF(&src_data, files_in_MLF);
+            free_MLF(&res_data, files_in_MLF);
+            free_MLF(&correct_data, correct_files);
+            fprintf(stderr, "The MLF file with sequences of correct words "\
+                    "cannot be loaded, or it doesn't correspond to the "\
+                    "source data.\n");
+            return 0;
+        }
+        printf("WER of the float results is %.2f%%.\n", float_WER);
+    }
+    if (estimate_drift)
+    {
+        first_bits = (drift_bits > 0) ? drift_bits : 1;
+        last_bits = (drift_bits > 0) ? drift_bits : MAX_FIXED_POINT_BITS;
+        for (fixed_point_bits = first_bits; fixed_point_bits <= last_bits;
+             fixed_point_bits++)
+        {
+            if (!print_drift_of_fixed_point_mode(
+                        models, parameters, fixed_point_bits, src_data,
+                        res_data, correct_data, files_in_MLF, float_WER))
+            {
+                free_string_array(&phonemes_vocabulary, phonemes_number);
+                free_string_array(&words_vocabulary, words_number);
+                free(confusion_penalties_matrix);
+                free_linear_words_lexicon(&words_lexicon, words_number);
+                free_words_tree(&words_tree);
+                free_compiled_language_model(&compiled_language_model);
+                free_MLF(&src_data, files_in_MLF);
+                free_MLF(&res_data, files_in_MLF);
+                free_MLF(&correct_data, correct_files);
+                fprintf(stderr, "The input data cannot be recognized in the "\
+                        "fixed-point mode with %d bits.\n",
+                        fixed_point_bits);
+                return 0;
+            }
+        }
+    }
 
     free_string_array(&phonemes_vocabulary, phonemes_number);
     free_string_array(&words_vocabulary, words_number);
     free(confusion_penalties_matrix);
     free_linear_words_lexicon(&words_lexicon, words_number);
-    free_language_model(&language_model);
+    free_words_tree(&words_tree);
+    free_compiled_language_model(&compiled_language_model);
     free_MLF(&src_data, files_in_MLF);
     free_MLF(&res_data, files_in_MLF);
-
-    printf("Duration of recognition process is %.3f secs.\n",
-           end_time - start_time);
+    free_MLF(&correct_data, correct_files);
+    free_word_lattices(&lattices, files_in_MLF);
+    free_nbest_lists(&nbest_lists, files_in_MLF);
 
     return 1;
 }
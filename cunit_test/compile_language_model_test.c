@@ -0,0 +1,244 @@
+#include <float.h>
+#include <math.h>
+#include <stdlib.h>
+#include <CUnit/Basic.h>
+#include <CUnit/CUnit.h>
+
+#include "../bond005_lvcsr_lib.h"
+#include "compile_language_model_test.h"
+
+static TLanguageModel language_model;
+static float lambda_1 = 0.7;
+static float lambda_2 = 1.0;
+static float incorrect_lambda_1 = -1.0;
+static float incorrect_lambda_2 = 1.5;
+
+static void create_language_model_for_testing()
+{
+    language_model.unigrams_number = 4;
+    language_model.unigrams_probabilities = malloc(4 * sizeof(float));
+    language_model.bigrams = malloc(4 * sizeof(TWordBigram));
+
+    language_model.bigrams[0].begins_number = 2;
+    language_model.bigrams[0].begins = malloc(2 * sizeof(TWordBigramBegin));
+    language_model.bigrams[0].begins[0].word_i = 1;
+    language_model.bigrams[0].begins[0].probability = 0.13;
+    language_model.bigrams[0].begins[1].word_i = 3;
+    language_model.bigrams[0].begins[1].probability = 0.2;
+
+    language_model.bigrams[1].begins_number = 0;
+    language_model.bigrams[1].begins = NULL;
+
+    language_model.bigrams[2].begins_number = 2;
+    language_model.bigrams[2].begins = malloc(2 * sizeof(TWordBigramBegin));
+    language_model.bigrams[2].begins[0].word_i = 0;
+    language_model.bigrams[2].begins[0].probability = 0.23;
+    language_model.bigrams[2].begins[1].word_i = 3;
+    language_model.bigrams[2].begins[1].probability = 0.25;
+
+    language_model.bigrams[3].begins_number = 2;
+    language_model.bigrams[3].begins = malloc(2 * sizeof(TWordBigramBegin));
+    language_model.bigrams[3].begins[0].word_i = 0;
+    language_model.bigrams[3].begins[0].probability = 0.11;
+    language_model.bigrams[3].begins[1].word_i = 2;
+    language_model.bigrams[3].begins[1].probability = 0.08;
+
+    language_model.unigrams_probabilities[0] = 0.2;
+    language_model.unigrams_probabilities[1] = 0.3;
+    language_model.unigrams_probabilities[2] = 0.15;
+    language_model.unigrams_probabilities[3] = 0.35;
+}
+
+static int check_compiled_language_model(TCompiledLanguageModel compiled_model,
+                                         float lambda)
+{
+    int i, j, k, m, n;
+    float probability, score;
+
+    if (compiled_model.unigrams_number != language_model.unigrams_number)
+    {
+        return 0;
+    }
+    if (fabs(compiled_model.lambda - lambda) > FLT_EPSILON)
+    {
+        return 0;
+    }
+    for (i = 0; i < language_model.unigrams_number; i++)
+    {
+        probability = (1.0 - lambda)
+                * language_model.unigrams_probabilities[i];
+        score = (probability > 0.0) ? log10(probability) : -FLT_MAX;
+        if (fabs(compiled_model.backoff_scores[i] - score) > 1e-5)
+        {
+            return 0;
+        }
+        if ((compiled_model.bigrams_offsets[i+1]
+             - compiled_model.bigrams_offsets[i])
+                != language_model.bigrams[i].begins_number)
+        {
+            return 0;
+        }
+        k = compiled_model.bigrams_offsets[i];
+        for (j = 0; j < language_model.bigrams[i].begins_number; j++)
+        {
+            if (compiled_model.bigrams_begins[k+j]
+                    != language_model.bigrams[i].begins[j].word_i)
+            {
+                return 0;
+            }
+            probability = lambda
+                    * language_model.bigrams[i].begins[j].probability
+                    + (1.0 - lambda) * language_model.unigrams_probabilities[i];
+            score = log10(probability);
+            if (fabs(compiled_model.bigrams_scores[k+j] - score) > 1e-5)
+            {
+                return 0;
+            }
+        }
+    }
+    if (compiled_model.successors_offsets[0] != 0)
+    {
+        return 0;
+    }
+    for (i = 0; i < language_model.unigrams_number; i++)
+    {
+        n = 0;
+        for (j = 0; j < language_model.unigrams_number; j++)
+        {
+            for (k = compiled_model.bigrams_offsets[j];
+                 k < compiled_model.bigrams_offsets[j+1]; k++)
+            {
+                if (compiled_model.bigrams_begins[k] != i)
+                {
+                    continue;
+                }
+                m = compiled_model.successors_offsets[i] + n;
+                if (m >= compiled_model.successors_offsets[i+1])
+                {
+                    return 0;
+                }
+                if (compiled_model.successors_ends[m] != j)
+                {
+                    return 0;
+                }
+                if (compiled_model.successors_scores[m]
+                        != compiled_model.bigrams_scores[k])
+                {
+                    return 0;
+                }
+                n++;
+            }
+        }
+        if ((compiled_model.successors_offsets[i] + n)
+                != compiled_model.successors_offsets[i+1])
+        {
+            return 0;
+        }
+    }
+
+    return 1;
+}
+
+int prepare_for_testing_of_compile_language_model()
+{
+    CU_pSuite pSuite = NULL;
+
+    pSuite = CU_add_suite("Test suite for compile_language_model()",
+                          init_suite_compile_language_model,
+                          clean_suite_compile_language_model);
+    if (NULL == pSuite)
+    {
+        CU_cleanup_registry();
+        return 0;
+    }
+
+    if ((NULL == CU_add_test(pSuite, "Valid partition 1",
+                             compile_language_model_valid_test_1))
+            || (NULL == CU_add_test(pSuite, "Valid partition 2",
+                                    compile_language_model_valid_test_2))
+            || (NULL == CU_add_test(pSuite, "Invalid partitions",
+                                    compile_language_model_invalid_test_1)))
+    {
+        CU_cleanup_registry();
+        return 0;
+    }
+
+    return 1;
+}
+
+int init_suite_compile_language_model()
+{
+    create_language_model_for_testing();
+    return 0;
+}
+
+int clean_suite_compile_language_model()
+{
+    free_language_model(&language_model);
+    return 0;
+}
+
+void compile_language_model_valid_test_1()
+{
+    TCompiledLanguageModel compiled_model;
+    int is_ok = 0, is_equal = 0;
+
+    is_ok = compile_language_model(language_model, lambda_1, &compiled_model);
+    if (is_ok)
+    {
+        is_equal = check_compiled_language_model(compiled_model, lambda_1);
+        free_compiled_language_model(&compiled_model);
+    }
+
+    CU_ASSERT_TRUE_FATAL(is_ok);
+    CU_ASSERT_TRUE_FATAL(is_equal);
+}
+
+void compile_language_model_valid_test_2()
+{
+    TCompiledLanguageModel compiled_model;
+    int is_ok = 0, is_equal = 0;
+
+    is_ok = compile_language_model(language_model, lambda_2, &compiled_model);
+    if (is_ok)
+    {
+        is_equal = check_compiled_language_model(compiled_model, lambda_2);
+        free_compiled_language_model(&compiled_model);
+    }
+
+    CU_ASSERT_TRUE_FATAL(is_ok);
+    CU_ASSERT_TRUE_FATAL(is_equal);
+}
+
+void compile_language_model_invalid_test_1()
+{
+    TCompiledLanguageModel compiled_model;
+    TLanguageModel incorrect_model;
+    int is_ok = 1;
+
+    incorrect_model = language_model;
+    incorrect_model.bigrams = NULL;
+    is_ok = compile_language_model(incorrect_model, lambda_1, &compiled_model);
+    CU_ASSERT_FALSE_FATAL(is_ok);
+
+    incorrect_model = language_model;
+    incorrect_model.unigrams_probabilities = NULL;
+    is_ok = compile_language_model(incorrect_model, lambda_1, &compiled_model);
+    CU_ASSERT_FALSE_FATAL(is_ok);
+
+    incorrect_model = language_model;
+    incorrect_model.unigrams_number = 0;
+    is_ok = compile_language_model(incorrect_model, lambda_1, &compiled_model);
+    CU_ASSERT_FALSE_FATAL(is_ok);
+
+    is_ok = compile_language_model(language_model, incorrect_lambda_1,
+                                   &compiled_model);
+    CU_ASSERT_FALSE_FATAL(is_ok);
+
+    is_ok = compile_language_model(language_model, incorrect_lambda_2,
+                                   &compiled_model);
+    CU_ASSERT_FALSE_FATAL(is_ok);
+
+    is_ok = compile_language_model(language_model, lambda_1, NULL);
+    CU_ASSERT_FALSE_FATAL(is_ok);
+}
@@ -0,0 +1,11 @@
+#ifndef COMPILE_LANGUAGE_MODEL_TEST_H
+#define COMPILE_LANGUAGE_MODEL_TEST_H
+
+int prepare_for_testing_of_compile_language_model();
+int init_suite_compile_language_model();
+int clean_suite_compile_language_model();
+void compile_language_model_valid_test_1();
+void compile_language_model_valid_test_2();
+void compile_language_model_invalid_test_1();
+
+#endif // COMPILE_LANGUAGE_MODEL_TEST_H
@@ -16,15 +16,29 @@ SOURCES += main.c \
     load_phonemes_MLF_test.c \
     load_words_MLF_test.c \
     save_words_MLF_test.c \
+    save_word_lattice_test.c \
+    save_nbest_MLF_test.c \
     load_phonemes_vocabulary_test.c \
     load_words_vocabulary_test.c \
     create_words_vocabulary_tree_test.c \
     load_language_model_test.c \
     save_language_model_test.c \
     get_bigram_probability_test.c \
+    compile_language_model_test.c \
     calculate_language_model_test.c \
     create_linear_words_lexicon_test.c \
     recognize_words_test.c \
+    recognize_words_by_words_tree_test.c \
+    decoder_create_test.c \
+    decoder_decode_test.c \
+    decoder_generate_lattices_test.c \
+    decoder_generate_nbest_test.c \
+    decoder_push_test.c \
+    decoder_get_partial_result_test.c \
+    decoder_get_stable_words_test.c \
+    decoder_finalize_test.c \
+    decoder_get_lookahead_score_test.c \
+    decoder_get_default_parameters_test.c \
     calculate_confusion_penalties_matrix_test.c
 
 HEADERS += \
@@ -40,18 +54,32 @@ HEADERS += \
     load_phonemes_MLF_test.h \
     load_words_MLF_test.h \
     save_words_MLF_test.h \
+    save_word_lattice_test.h \
+    save_nbest_MLF_test.h \
     load_phonemes_vocabulary_test.h \
     load_words_vocabulary_test.h \
     create_words_vocabulary_tree_test.h \
     load_language_model_test.h \
     save_language_model_test.h \
     get_bigram_probability_test.h \
+    compile_language_model_test.h \
     calculate_language_model_test.h \
     create_linear_words_lexicon_test.h \
     recognize_words_test.h \
+    recognize_words_by_words_tree_test.h \
+    decoder_create_test.h \
+    decoder_decode_test.h \
+    decoder_generate_lattices_test.h \
+    decoder_generate_nbest_test.h \
+    decoder_push_test.h \
+    decoder_get_partial_result_test.h \
+    decoder_get_stable_words_test.h \
+    decoder_finalize_test.h \
+    decoder_get_lookahead_score_test.h \
+    decoder_get_default_parameters_test.h \
     calculate_confusion_penalties_matrix_test.h
 
 win32:QMAKE_CFLAGS_RELEASE += /fp:fast /Ox /arch:SSE2 /openmp
-unix:QMAKE_CFLAGS_RELEASE += -O3 -march=native -mfpmath=sse -msse2 -funroll-loops -ffast-math -fopenmp
+unix:QMAKE_CFLAGS_RELEASE += -O3 -mfpmath=sse -msse2 -funroll-loops -ffast-math -fopenmp
 unix:QMAKE_CFLAGS_DEBUG += -fopenmp
 unix:QMAKE_LIBS += -lgomp -lpthread -lcunit
@@ -0,0 +1,287 @@
+#include <float.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <CUnit/Basic.h>
+#include <CUnit/CUnit.h>
+
+#include "../bond005_lvcsr_lib.h"
+#include "decoder_create_test.h"
+
+#define PHONEMES_VOCABULARY_SIZE 4
+#define WORDS_VOCABULARY_SIZE 3
+
+static float confusion_penalties[] = {
+    0.95, 0.02, 0.02, 0.01,
+    0.03, 0.80, 0.05, 0.12,
+    0.05, 0.12, 0.75, 0.08,
+    0.04, 0.04, 0.11, 0.81
+};
+static TLinearWordsLexicon *words_lexicon = NULL;
+static TCompiledLanguageModel language_model;
+static float lambda = 1.0;
+static int word_0[] = {1, 2};
+static int word_1[] = {3, 2};
+static int word_2[] = {2, 3, 1};
+static PWordsTreeNode words_tree = NULL;
+static TDecoderModels models;
+static TDecoderParameters parameters;
+
+int prepare_for_testing_of_decoder_create()
+{
+    CU_pSuite pSuite = NULL;
+
+    pSuite = CU_add_suite("Test suite for decoder_create()",
+                          init_suite_decoder_create,
+                          clean_suite_decoder_create);
+    if (NULL == pSuite)
+    {
+        CU_cleanup_registry();
+        return 0;
+    }
+
+    if ((NULL == CU_add_test(pSuite, "Valid partition 1",
+                             decoder_create_valid_test_1))
+            || (NULL == CU_add_test(pSuite, "Valid partition 2",
+                                    decoder_create_valid_test_2))
+            || (NULL == CU_add_test(pSuite, "Invalid partitions",
+                                    decoder_create_invalid_test_1)))
+    {
+        CU_cleanup_registry();
+        return 0;
+    }
+
+    return 1;
+}
+
+int init_suite_decoder_create()
+{
+    int i;
+    TLanguageModel source_model;
+
+    for (i = 0; i < (PHONEMES_VOCABULARY_SIZE * PHONEMES_VOCABULARY_SIZE); i++)
+    {
+        if (confusion_penalties[i] > 0.0)
+        {
+            confusion_penalties[i] = log10(confusion_penalties[i]);
+        }
+        else
+        {
+            confusion_penalties[i] = -FLT_MAX;
+        }
+    }
+
+    words_tree = malloc(sizeof(TWordsTreeNode));
+    words_tree->node_data = -1;
+    words_tree->node_type = INIT_NODE;
+    words_tree->number_of_next_nodes = 0;
+    words_tree->next_nodes = NULL;
+    add_word_to_words_tree(0, word_0, 2, words_tree);
+    add_word_to_words_tree(1, word_1, 2, words_tree);
+    add_word_to_words_tree(2, word_2, 3, words_tree);
+
+    words_lexicon = malloc(WORDS_VOCABULARY_SIZE*sizeof(TLinearWordsLexicon));
+    words_lexicon[0].word_index = 0;
+    words_lexicon[0].phonemes_number = 2 + 1;
+    words_lexicon[0].phonemes_indexes = malloc((2 + 1) * sizeof(int));
+    words_lexicon[0].phonemes_indexes[0] = 1;
+    words_lexicon[0].phonemes_indexes[1] = 2;
+    words_lexicon[0].phonemes_indexes[2] = 0;
+    words_lexicon[1].word_index = 1;
+    words_lexicon[1].phonemes_number = 2 + 1;
+    words_lexicon[1].phonemes_indexes = malloc((2 + 1) * sizeof(int));
+    words_lexicon[1].phonemes_indexes[0] = 3;
+    words_lexicon[1].phonemes_indexes[1] = 2;
+    words_lexicon[1].phonemes_indexes[2] = 0;
+    words_lexicon[2].word_index = 2;
+    words_lexicon[2].phonemes_number = 3 + 1;
+    words_lexicon[2].phonemes_indexes = malloc((3 + 1) * sizeof(int));
+    words_lexicon[2].phonemes_indexes[0] = 2;
+    words_lexicon[2].phonemes_indexes[1] = 3;
+    words_lexicon[2].phonemes_indexes[2] = 1;
+    words_lexicon[2].phonemes_indexes[3] = 0;
+
+    source_model.unigrams_number = 3;
+    source_model.unigrams_probabilities = malloc(3*sizeof(float));
+    source_model.unigrams_probabilities[0] = 0.4;
+    source_model.unigrams_probabilities[1] = 0.25;
+    source_model.unigrams_probabilities[2] = 0.35;
+    source_model.bigrams = malloc(3*sizeof(TWordBigram));
+    source_model.bigrams[0].begins_number = 2;
+    source_model.bigrams[0].begins = malloc(2*sizeof(TWordBigramBegin));
+    //1->0
+    source_model.bigrams[0].begins[0].word_i = 1;
+    source_model.bigrams[0].begins[0].probability = 0.5;
+    //2->0
+    source_model.bigrams[0].begins[1].word_i = 2;
+    source_model.bigrams[0].begins[1].probability = 0.1;
+    source_model.bigrams[1].begins_number = 2;
+    source_model.bigrams[1].begins = malloc(2*sizeof(TWordBigramBegin));
+    //0->1
+    source_model.bigrams[1].begins[0].word_i = 0;
+    source_model.bigrams[1].begins[0].probability = 0.2;
+    //2->1
+    source_model.bigrams[1].begins[1].word_i = 2;
+    source_model.bigrams[1].begins[1].probability = 0.9;
+    source_model.bigrams[2].begins_number = 2;
+    source_model.bigrams[2].begins = malloc(2*sizeof(TWordBigramBegin));
+    //0->2
+    source_model.bigrams[2].begins[0].word_i = 0;
+    source_model.bigrams[2].begins[0].probability = 0.8;
+    //1->2
+    source_model.bigrams[2].begins[1].word_i = 1;
+    source_model.bigrams[2].begins[1].probability = 0.5;
+    compile_language_model(source_model, lambda, &language_model);
+    free_language_model(&source_model);
+
+    models.phonemes_vocabulary_size = PHONEMES_VOCABULARY_SIZE;
+    models.confusion_penalties_matrix = confusion_penalties;
+    models.words_lexicon = words_lexicon;
+    models.words_lexicon_size = WORDS_VOCABULARY_SIZE;
+    models.words_tree_root = NULL;
+    models.language_model = language_model;
+    parameters = decoder_get_default_parameters();
+
+    return 0;
+}
+
+int clean_suite_decoder_create()
+{
+    free_compiled_language_model(&language_model);
+    free_linear_words_lexicon(&words_lexicon, WORDS_VOCABULARY_SIZE);
+    free_words_tree(&words_tree);
+    return 0;
+}
+
+void decoder_create_valid_test_1()
+{
+    PDecoder decoder = decoder_create(models, parameters);
+
+    CU_ASSERT_PTR_NOT_NULL_FATAL(decoder);
+    decoder_destroy(&decoder);
+    CU_ASSERT_PTR_NULL_FATAL(decoder);
+}
+
+void decoder_create_valid_test_2()
+{
+    TDecoderModels tree_models = models;
+    TDecoderParameters parallel_parameters = parameters;
+    PDecoder decoder = NULL;
+
+    tree_models.words_lexicon = NULL;
+    tree_models.words_lexicon_size = 0;
+    tree_models.words_tree_root = words_tree;
+    parallel_parameters.threads_number = 2;
+    decoder = decoder_create(tree_models, parallel_parameters);
+
+    CU_ASSERT_PTR_NOT_NULL_FATAL(decoder);
+    decoder_destroy(&decoder);
+    CU_ASSERT_PTR_NULL_FATAL(decoder);
+}
+
+void decoder_create_invalid_test_1()
+{
+    TDecoderModels incorrect_models;
+    TDecoderParameters incorrect_parameters;
+    PDecoder decoder = NULL;
+
+    incorrect_parameters = parameters;
+    incorrect_parameters.pruning_coeff = -0.5;
+    decoder = decoder_create(models, incorrect_parameters);
+    CU_ASSERT_PTR_NULL_FATAL(decoder);
+
+    incorrect_parameters = parameters;
+    incorrect_parameters.histogram_size = 1;
+    decoder = decoder_create(models, incorrect_parameters);
+    CU_ASSERT_PTR_NULL_FATAL(decoder);
+
+    incorrect_parameters = parameters;
+    incorrect_parameters.beam_width = -1.0;
+    decoder = decoder_create(models, incorrect_parameters);
+    CU_ASSERT_PTR_NULL_FATAL(decoder);
+
+    incorrect_parameters = parameters;
+    incorrect_parameters.max_active_hypotheses = -1;
+    decoder = decoder_create(models, incorrect_parameters);
+    CU_ASSERT_PTR_NULL_FATAL(decoder);
+
+    incorrect_parameters = parameters;
+    incorrect_parameters.word_end_beam = -1.0;
+    decoder = decoder_create(models, incorrect_parameters);
+    CU_ASSERT_PTR_NULL_FATAL(decoder);
+
+    incorrect_parameters = parameters;
+    incorrect_parameters.lattice_beam = -1.0;
+    decoder = decoder_create(models, incorrect_parameters);
+    CU_ASSERT_PTR_NULL_FATAL(decoder);
+
+    incorrect_parameters = parameters;
+    incorrect_parameters.lattice_size = -1;
+    decoder = decoder_create(models, incorrect_parameters);
+    CU_ASSERT_PTR_NULL_FATAL(decoder);
+
+    incorrect_parameters = parameters;
+    incorrect_parameters.threads_number = 0;
+    decoder = decoder_create(models, incorrect_parameters);
+    CU_ASSERT_PTR_NULL_FATAL(decoder);
+
+    incorrect_parameters = parameters;
+    incorrect_parameters.frame_duration = 0.0;
+    decoder = decoder_create(models, incorrect_parameters);
+    CU_ASSERT_PTR_NULL_FATAL(decoder);
+
+    incorrect_parameters = parameters;
+    incorrect_parameters.max_repeats_of_phoneme = 0;
+    decoder = decoder_create(models, incorrect_parameters);
+    CU_ASSERT_PTR_NULL_FATAL(decoder);
+
+    incorrect_parameters = parameters;
+    incorrect_parameters.use_segments = 2;
+    decoder = decoder_create(models, incorrect_parameters);
+    CU_ASSERT_PTR_NULL_FATAL(decoder);
+
+    incorrect_parameters = parameters;
+    incorrect_parameters.max_emission_table_size = -1;
+    decoder = decoder_create(models, incorrect_parameters);
+    CU_ASSERT_PTR_NULL_FATAL(decoder);
+
+    incorrect_parameters = parameters;
+    incorrect_parameters.fixed_point_bits = -1;
+    decoder = decoder_create(models, incorrect_parameters);
+    CU_ASSERT_PTR_NULL_FATAL(decoder);
+
+    incorrect_parameters = parameters;
+    incorrect_parameters.fixed_point_bits = MAX_FIXED_POINT_BITS + 1;
+    decoder = decoder_create(models, incorrect_parameters);
+    CU_ASSERT_PTR_NULL_FATAL(decoder);
+
+    incorrect_parameters = parameters;
+    incorrect_parameters.use_lm_lookahead = 2;
+    decoder = decoder_create(models, incorrect_parameters);
+    CU_ASSERT_PTR_NULL_FATAL(decoder);
+
+    incorrect_parameters = parameters;
+    incorrect_parameters.fast_match_depth = MAX_FAST_MATCH_DEPTH + 1;
+    decoder = decoder_create(models, incorrect_parameters);
+    CU_ASSERT_PTR_NULL_FATAL(decoder);
+
+    incorrect_parameters = parameters;
+    incorrect_parameters.fast_match_size = -1;
+    decoder = decoder_create(models, incorrect_parameters);
+    CU_ASSERT_PTR_NULL_FATAL(decoder);
+
+    incorrect_models = models;
+    incorrect_models.confusion_penalties_matrix = NULL;
+    decoder = decoder_create(incorrect_models, parameters);
+    CU_ASSERT_PTR_NULL_FATAL(decoder);
+
+    incorrect_models = models;
+    incorrect_models.words_lexicon = NULL;
+    decoder = decoder_create(incorrect_models, parameters);
+    CU_ASSERT_PTR_NULL_FATAL(decoder);
+
+    incorrect_models = models;
+    incorrect_models.language_model.backoff_scores = NULL;
+    decoder = decoder_create(incorrect_models, parameters);
+    CU_ASSERT_PTR_NULL_FATAL(decoder);
+}
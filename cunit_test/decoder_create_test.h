@@ -0,0 +1,11 @@
+#ifndef DECODER_CREATE_TEST_H
+#define DECODER_CREATE_TEST_H
+
+int prepare_for_testing_of_decoder_create();
+int init_suite_decoder_create();
+int clean_suite_decoder_create();
+void decoder_create_valid_test_1();
+void decoder_create_valid_test_2();
+void decoder_create_invalid_test_1();
+
+#endif // DECODER_CREATE_TEST_H
@@ -0,0 +1,966 @@
+#include <float.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <CUnit/Basic.h>
+#include <CUnit/CUnit.h>
+
+#include "../bond005_lvcsr_lib.h"
+#include "decoder_decode_test.h"
+
+#define FILES_NUMBER 1
+#define INP_MLF_PART_NAME "test_record.lab"
+#define REC_MLF_PART_NAME "test_record.rec"
+#define PHONEMES_VOCABULARY_SIZE 4
+#define WORDS_VOCABULARY_SIZE 3
+#define SCORE_EPSILON 1e-5
+#define LONG_SOURCE_REPEATS 4000
+
+static float confusion_penalties[] = {
+    0.95, 0.02, 0.02, 0.01,
+    0.03, 0.80, 0.05, 0.12,
+    0.05, 0.12, 0.75, 0.08,
+    0.04, 0.04, 0.11, 0.81
+};
+static int word_0[] = {1, 2};
+static int word_1[] = {3, 2};
+static int word_2[] = {2, 3, 1};
+static TLinearWordsLexicon *words_lexicon = NULL;
+static PWordsTreeNode words_tree = NULL;
+static TCompiledLanguageModel language_model;
+static float lambda = 1.0;
+static TMLFFilePart *src_mlf_1 = NULL, *src_mlf_2 = NULL;
+static TMLFFilePart *target_res_mlf = NULL, *segments_res_mlf = NULL;
+static TDecoderModels models;
+static TDecoderParameters parameters;
+
+static int compare_two_MLF(TMLFFilePart *mlf1, int mlf1_size,
+                           TMLFFilePart *mlf2, int mlf2_size)
+{
+    int i, j, res = 1;
+
+    if (mlf1_size != mlf2_size)
+    {
+        return 0;
+    }
+    if (mlf1_size < 0)
+    {
+        return 0;
+    }
+    if (mlf1_size == 0)
+    {
+        return 1;
+    }
+    if ((mlf1 == NULL) || (mlf2 == NULL))
+    {
+        return 0;
+    }
+
+    for (i = 0; i < mlf1_size; i++)
+    {
+        if ((mlf1[i].name == NULL) || (mlf2[i].name == NULL))
+        {
+            res = 0;
+            break;
+        }
+        if (strcmp(mlf1[i].name, mlf2[i].name) != 0)
+        {
+            res = 0;
+            break;
+        }
+        if (mlf1[i].transcription_size != mlf2[i].transcription_size)
+        {
+            res = 0;
+            break;
+        }
+        if (mlf1[i].transcription_size < 0)
+        {
+            res = 0;
+            break;
+        }
+        if (mlf1[i].transcription_size > 0)
+        {
+            for (j = 0; j < mlf1[i].transcription_size; j++)
+            {
+                if (mlf1[i].transcription[j].start_time
+                        != mlf2[i].transcription[j].start_time)
+                {
+                    res = 0;
+                    break;
+                }
+                if (mlf1[i].transcription[j].end_time
+                        != mlf2[i].transcription[j].end_time)
+                {
+                    res = 0;
+                    break;
+                }
+                if (mlf1[i].transcription[j].node_data
+                        != mlf2[i].transcription[j].node_data)
+                {
+                    res = 0;
+                    break;
+                }
+                if (fabs(mlf1[i].transcription[j].score
+                         - mlf2[i].transcription[j].score) > SCORE_EPSILON)
+                {
+                    res = 0;
+                    break;
+                }
+            }
+            if (!res)
+            {
+                break;
+            }
+        }
+    }
+
+    return res;
+}
+
+static TMLFFilePart *create_long_source(TMLFFilePart *src, int repeats)
+{
+    TMLFFilePart *res = NULL;
+    int i, j, n = src[0].transcription_size;
+    long unsigned duration = src[0].transcription[n-1].end_time;
+
+    res = malloc(sizeof(TMLFFilePart));
+    if (res == NULL)
+    {
+        return NULL;
+    }
+    res[0].name = malloc((strlen(src[0].name) + 1) * sizeof(char));
+    res[0].transcription_size = n * repeats;
+    res[0].transcription = malloc(n * repeats * sizeof(TTranscriptionNode));
+    if ((res[0].name == NULL) || (res[0].transcription == NULL))
+    {
+        free(res[0].name);
+        free(res[0].transcription);
+        free(res);
+        return NULL;
+    }
+    strcpy(res[0].name, src[0].name);
+    for (i = 0; i < repeats; i++)
+    {
+        for (j = 0; j < n; j++)
+        {
+            res[0].transcription[i * n + j] = src[0].transcription[j];
+            res[0].transcription[i * n + j].start_time += i * duration;
+            res[0].transcription[i * n + j].end_time += i * duration;
+        }
+    }
+
+    return res;
+}
+
+int prepare_for_testing_of_decoder_decode()
+{
+    CU_pSuite pSuite = NULL;
+
+    pSuite = CU_add_suite("Test suite for decoder_decode()",
+                          init_suite_decoder_decode,
+                          clean_suite_decoder_decode);
+    if (NULL == pSuite)
+    {
+        CU_cleanup_registry();
+        return 0;
+    }
+
+    if ((NULL == CU_add_test(pSuite, "Valid partition 1",
+                             decoder_decode_valid_test_1))
+            || (NULL == CU_add_test(pSuite, "Valid partition 2",
+                                    decoder_decode_valid_test_2))
+            || (NULL == CU_add_test(pSuite, "Valid partition 3",
+                                    decoder_decode_valid_test_3))
+            || (NULL == CU_add_test(pSuite, "Valid partition 4",
+                                    decoder_decode_valid_test_4))
+            || (NULL == CU_add_test(pSuite, "Valid partition 5",
+                                    decoder_decode_valid_test_5))
+            || (NULL == CU_add_test(pSuite, "Valid partition 6",
+                                    decoder_decode_valid_test_6))
+            || (NULL == CU_add_test(pSuite, "Valid partition 7",
+                                    decoder_decode_valid_test_7))
+            || (NULL == CU_add_test(pSuite, "Invalid partitions",
+                                    decoder_decode_invalid_test_1)))
+    {
+        CU_cleanup_registry();
+        return 0;
+    }
+
+    return 1;
+}
+
+int init_suite_decoder_decode()
+{
+    int i, n;
+    TLanguageModel source_model;
+
+    for (i = 0; i < (PHONEMES_VOCABULARY_SIZE * PHONEMES_VOCABULARY_SIZE); i++)
+    {
+        if (confusion_penalties[i] > 0.0)
+        {
+            confusion_penalties[i] = log10(confusion_penalties[i]);
+        }
+        else
+        {
+            confusion_penalties[i] = -FLT_MAX;
+        }
+    }
+
+    words_tree = malloc(sizeof(TWordsTreeNode));
+    words_tree->node_data = -1;
+    words_tree->node_type = INIT_NODE;
+    words_tree->number_of_next_nodes = 0;
+    words_tree->next_nodes = NULL;
+    add_word_to_words_tree(0, word_0, 2, words_tree);
+    add_word_to_words_tree(1, word_1, 2, words_tree);
+    add_word_to_words_tree(2, word_2, 3, words_tree);
+
+    words_lexicon = malloc(WORDS_VOCABULARY_SIZE*sizeof(TLinearWordsLexicon));
+    words_lexicon[0].word_index = 0;
+    words_lexicon[0].phonemes_number = 2 + 1;
+    words_lexicon[0].phonemes_indexes = malloc((2 + 1) * sizeof(int));
+    words_lexicon[0].phonemes_indexes[0] = 1;
+    words_lexicon[0].phonemes_indexes[1] = 2;
+    words_lexicon[0].phonemes_indexes[2] = 0;
+    words_lexicon[1].word_index = 1;
+    words_lexicon[1].phonemes_number = 2 + 1;
+    words_lexicon[1].phonemes_indexes = malloc((2 + 1) * sizeof(int));
+    words_lexicon[1].phonemes_indexes[0] = 3;
+    words_lexicon[1].phonemes_indexes[1] = 2;
+    words_lexicon[1].phonemes_indexes[2] = 0;
+    words_lexicon[2].word_index = 2;
+    words_lexicon[2].phonemes_number = 3 + 1;
+    words_lexicon[2].phonemes_indexes = malloc((3 + 1) * sizeof(int));
+    words_lexicon[2].phonemes_indexes[0] = 2;
+    words_lexicon[2].phonemes_indexes[1] = 3;
+    words_lexicon[2].phonemes_indexes[2] = 1;
+    words_lexicon[2].phonemes_indexes[3] = 0;
+
+    source_model.unigrams_number = 3;
+    source_model.unigrams_probabilities = malloc(3*sizeof(float));
+    source_model.unigrams_probabilities[0] = 0.4;
+    source_model.unigrams_probabilities[1] = 0.25;
+    source_model.unigrams_probabilities[2] = 0.35;
+    source_model.bigrams = malloc(3*sizeof(TWordBigram));
+    source_model.bigrams[0].begins_number = 2;
+    source_model.bigrams[0].begins = malloc(2*sizeof(TWordBigramBegin));
+    //1->0
+    source_model.bigrams[0].begins[0].word_i = 1;
+    source_model.bigrams[0].begins[0].probability = 0.5;
+    //2->0
+    source_model.bigrams[0].begins[1].word_i = 2;
+    source_model.bigrams[0].begins[1].probability = 0.1;
+    source_model.bigrams[1].begins_number = 2;
+    source_model.bigrams[1].begins = malloc(2*sizeof(TWordBigramBegin));
+    //0->1
+    source_model.bigrams[1].begins[0].word_i = 0;
+    source_model.bigrams[1].begins[0].probability = 0.2;
+    //2->1
+    source_model.bigrams[1].begins[1].word_i = 2;
+    source_model.bigrams[1].begins[1].probability = 0.9;
+    source_model.bigrams[2].begins_number = 2;
+    source_model.bigrams[2].begins = malloc(2*sizeof(TWordBigramBegin));
+    //0->2
+    source_model.bigrams[2].begins[0].word_i = 0;
+    source_model.bigrams[2].begins[0].probability = 0.8;
+    //1->2
+    source_model.bigrams[2].begins[1].word_i = 1;
+    source_model.bigrams[2].begins[1].probability = 0.5;
+    compile_language_model(source_model, lambda, &language_model);
+    free_language_model(&source_model);
+
+    models.phonemes_vocabulary_size = PHONEMES_VOCABULARY_SIZE;
+    models.confusion_penalties_matrix = confusion_penalties;
+    models.words_lexicon = words_lexicon;
+    models.words_lexicon_size = WORDS_VOCABULARY_SIZE;
+    models.words_tree_root = NULL;
+    models.language_model = language_model;
+    parameters = decoder_get_default_parameters();
+
+    n = strlen(INP_MLF_PART_NAME);
+    src_mlf_1 = malloc(sizeof(TMLFFilePart));
+    src_mlf_1[0].name = malloc((n+1) * sizeof(char));
+    memset(src_mlf_1[0].name, 0, (n+1) * sizeof(char));
+    strcpy(src_mlf_1[0].name, INP_MLF_PART_NAME);
+    src_mlf_1[0].transcription_size = 7;
+    src_mlf_1[0].transcription = malloc(7*sizeof(TTranscriptionNode));
+    src_mlf_1[0].transcription[0].start_time = 0;
+    src_mlf_1[0].transcription[0].end_time = 100000000;
+    src_mlf_1[0].transcription[0].node_data = 0;
+    src_mlf_1[0].transcription[0].probability = 0.9;
+    src_mlf_1[0].transcription[1].start_time = 100000000;
+    src_mlf_1[0].transcription[1].end_time = 150000000;
+    src_mlf_1[0].transcription[1].node_data = 1;
+    src_mlf_1[0].transcription[1].probability = 0.8;
+    src_mlf_1[0].transcription[2].start_time = 150000000;
+    src_mlf_1[0].transcription[2].end_time = 160000000;
+    src_mlf_1[0].transcription[2].node_data = 3;
+    src_mlf_1[0].transcription[2].probability = 0.6;
+    src_mlf_1[0].transcription[3].start_time = 160000000;
+    src_mlf_1[0].transcription[3].end_time = 190000000;
+    src_mlf_1[0].transcription[3].node_data = 2;
+    src_mlf_1[0].transcription[3].probability = 0.75;
+    src_mlf_1[0].transcription[4].start_time = 190000000;
+    src_mlf_1[0].transcription[4].end_time = 240000000;
+    src_mlf_1[0].transcription[4].node_data = 3;
+    src_mlf_1[0].transcription[4].probability = 0.9;
+    src_mlf_1[0].transcription[5].start_time = 240000000;
+    src_mlf_1[0].transcription[5].end_time = 260000000;
+    src_mlf_1[0].transcription[5].node_data = 1;
+    src_mlf_1[0].transcription[5].probability = 0.7;
+    src_mlf_1[0].transcription[6].start_time = 260000000;
+    src_mlf_1[0].transcription[6].end_time = 300000000;
+    src_mlf_1[0].transcription[6].node_data = 0;
+    src_mlf_1[0].transcription[6].probability = 0.9;
+
+    n = strlen(INP_MLF_PART_NAME);
+    src_mlf_2 = malloc(sizeof(TMLFFilePart));
+    src_mlf_2[0].name = malloc((n+1) * sizeof(char));
+    memset(src_mlf_2[0].name, 0, (n+1) * sizeof(char));
+    strcpy(src_mlf_2[0].name, INP_MLF_PART_NAME);
+    src_mlf_2[0].transcription_size = 9;
+    src_mlf_2[0].transcription = malloc(9*sizeof(TTranscriptionNode));
+    src_mlf_2[0].transcription[0].start_time = 0;
+    src_mlf_2[0].transcription[0].end_time = 100000000;
+    src_mlf_2[0].transcription[0].node_data = 0;
+    src_mlf_2[0].transcription[0].probability = 0.9;
+    src_mlf_2[0].transcription[1].start_time = 100000000;
+    src_mlf_2[0].transcription[1].end_time = 150000000;
+    src_mlf_2[0].transcription[1].node_data = 1;
+    src_mlf_2[0].transcription[1].probability = 0.8;
+    src_mlf_2[0].transcription[2].start_time = 150000000;
+    src_mlf_2[0].transcription[2].end_time = 160000000;
+    src_mlf_2[0].transcription[2].node_data = 3;
+    src_mlf_2[0].transcription[2].probability = 0.6;
+    src_mlf_2[0].transcription[3].start_time = 160000000;
+    src_mlf_2[0].transcription[3].end_time = 190000000;
+    src_mlf_2[0].transcription[3].node_data = 2;
+    src_mlf_2[0].transcription[3].probability = 0.75;
+    src_mlf_2[0].transcription[4].start_time = 190000000;
+    src_mlf_2[0].transcription[4].end_time = 280000000;
+    src_mlf_2[0].transcription[4].node_data = 0;
+    src_mlf_2[0].transcription[4].probability = 0.97;
+    src_mlf_2[0].transcription[5].start_time = 280000000;
+    src_mlf_2[0].transcription[5].end_time = 300000000;
+    src_mlf_2[0].transcription[5].node_data = 2;
+    src_mlf_2[0].transcription[5].probability = 0.83;
+    src_mlf_2[0].transcription[6].start_time = 300000000;
+    src_mlf_2[0].transcription[6].end_time = 350000000;
+    src_mlf_2[0].transcription[6].node_data = 3;
+    src_mlf_2[0].transcription[6].probability = 0.9;
+    src_mlf_2[0].transcription[7].start_time = 350000000;
+    src_mlf_2[0].transcription[7].end_time = 370000000;
+    src_mlf_2[0].transcription[7].node_data = 1;
+    src_mlf_2[0].transcription[7].probability = 0.7;
+    src_mlf_2[0].transcription[8].start_time = 370000000;
+    src_mlf_2[0].transcription[8].end_time = 410000000;
+    src_mlf_2[0].transcription[8].node_data = 0;
+    src_mlf_2[0].transcription[8].probability = 0.9;
+
+    n = strlen(REC_MLF_PART_NAME);
+    target_res_mlf = malloc(2*sizeof(TMLFFilePart));
+    target_res_mlf[0].name = malloc((n+1) * sizeof(char));
+    memset(target_res_mlf[0].name, 0, (n+1) * sizeof(char));
+    strcpy(target_res_mlf[0].name, REC_MLF_PART_NAME);
+    target_res_mlf[0].transcription_size = 2;
+    target_res_mlf[0].transcription = malloc(2*sizeof(TTranscriptionNode));
+    target_res_mlf[0].transcription[0].start_time = 100000000;
+    target_res_mlf[0].transcription[0].end_time = 155000000;
+    target_res_mlf[0].transcription[0].node_data = 0;
+    target_res_mlf[0].transcription[0].score = -1.70639872;
+    target_res_mlf[0].transcription[1].start_time = 155000000;
+    target_res_mlf[0].transcription[1].end_time = 260000000;
+    target_res_mlf[0].transcription[1].node_data = 2;
+    target_res_mlf[0].transcription[1].score = -2.34140992;
+    target_res_mlf[1].name = malloc((n+1) * sizeof(char));
+    memset(target_res_mlf[1].name, 0, (n+1) * sizeof(char));
+    strcpy(target_res_mlf[1].name, REC_MLF_PART_NAME);
+    target_res_mlf[1].transcription_size = 2;
+    target_res_mlf[1].transcription = malloc(2*sizeof(TTranscriptionNode));
+    target_res_mlf[1].transcription[0].start_time = 100000000;
+    target_res_mlf[1].transcription[0].end_time = 190000000;
+    target_res_mlf[1].transcription[0].node_data = 0;
+    target_res_mlf[1].transcription[0].score = -3.03700137;
+    target_res_mlf[1].transcription[1].start_time = 190000000;
+    target_res_mlf[1].transcription[1].end_time = 370000000;
+    target_res_mlf[1].transcription[1].node_data = 2;
+    target_res_mlf[1].transcription[1].score = -1.49353767;
+
+    segments_res_mlf = malloc(2*sizeof(TMLFFilePart));
+    segments_res_mlf[0].name = malloc((n+1) * sizeof(char));
+    memset(segments_res_mlf[0].name, 0, (n+1) * sizeof(char));
+    strcpy(segments_res_mlf[0].name, REC_MLF_PART_NAME);
+    segments_res_mlf[0].transcription_size = 2;
+    segments_res_mlf[0].transcription = malloc(2*sizeof(TTranscriptionNode));
+    segments_res_mlf[0].transcription[0].start_time = 100000000;
+    segments_res_mlf[0].transcription[0].end_time = 190000000;
+    segments_res_mlf[0].transcription[0].node_data = 0;
+    segments_res_mlf[0].transcription[0].score = -3.17272998;
+    segments_res_mlf[0].transcription[1].start_time = 190000000;
+    segments_res_mlf[0].transcription[1].end_time = 260000000;
+    segments_res_mlf[0].transcription[1].node_data = 2;
+    segments_res_mlf[0].transcription[1].score = -0.87507915;
+    segments_res_mlf[1].name = malloc((n+1) * sizeof(char));
+    memset(segments_res_mlf[1].name, 0, (n+1) * sizeof(char));
+    strcpy(segments_res_mlf[1].name, REC_MLF_PART_NAME);
+    segments_res_mlf[1].transcription_size = 2;
+    segments_res_mlf[1].transcription = malloc(2*sizeof(TTranscriptionNode));
+    segments_res_mlf[1].transcription[0].start_time = 100000000;
+    segments_res_mlf[1].transcription[0].end_time = 280000000;
+    segments_res_mlf[1].transcription[0].node_data = 0;
+    segments_res_mlf[1].transcription[0].score = -3.24373936;
+    segments_res_mlf[1].transcription[1].start_time = 280000000;
+    segments_res_mlf[1].transcription[1].end_time = 370000000;
+    segments_res_mlf[1].transcription[1].node_data = 2;
+    segments_res_mlf[1].transcription[1].score = -1.28680015;
+
+    return 0;
+}
+
+int clean_suite_decoder_decode()
+{
+    free_compiled_language_model(&language_model);
+    free_linear_words_lexicon(&words_lexicon, WORDS_VOCABULARY_SIZE);
+    free_words_tree(&words_tree);
+    free_MLF(&src_mlf_1, FILES_NUMBER);
+    free_MLF(&src_mlf_2, FILES_NUMBER);
+    free_MLF(&target_res_mlf, 2);
+    free_MLF(&segments_res_mlf, 2);
+    return 0;
+}
+
+void decoder_decode_valid_test_1()
+{
+    TMLFFilePart *recognition_res = NULL;
+    PDecoder decoder = NULL;
+    int is_ok = 0, is_equal_1 = 0, is_equal_2 = 0, is_equal_3 = 0;
+
+    decoder = decoder_create(models, parameters);
+    CU_ASSERT_PTR_NOT_NULL_FATAL(decoder);
+
+    /* buffers of the decoder are enlarged for the second sequence and they
+       are reused for the third one */
+    is_ok = decoder_decode(decoder, src_mlf_1, FILES_NUMBER, &recognition_res);
+    if (is_ok)
+    {
+        is_equal_1 = compare_two_MLF(recognition_res, FILES_NUMBER,
+                                     target_res_mlf, FILES_NUMBER);
+        free_MLF(&recognition_res, FILES_NUMBER);
+        is_ok = decoder_decode(decoder, src_mlf_2, FILES_NUMBER,
+                               &recognition_res);
+    }
+    if (is_ok)
+    {
+        is_equal_2 = compare_two_MLF(recognition_res, FILES_NUMBER,
+                                     target_res_mlf + 1, FILES_NUMBER);
+        free_MLF(&recognition_res, FILES_NUMBER);
+        is_ok = decoder_decode(decoder, src_mlf_1, FILES_NUMBER,
+                               &recognition_res);
+    }
+    if (is_ok)
+    {
+        is_equal_3 = compare_two_MLF(recognition_res, FILES_NUMBER,
+                                     target_res_mlf, FILES_NUMBER);
+        free_MLF(&recognition_res, FILES_NUMBER);
+    }
+    decoder_destroy(&decoder);
+
+    CU_ASSERT_TRUE_FATAL(is_ok);
+    CU_ASSERT_TRUE_FATAL(is_equal_1);
+    CU_ASSERT_TRUE_FATAL(is_equal_2);
+    CU_ASSERT_TRUE_FATAL(is_equal_3);
+    CU_ASSERT_PTR_NULL_FATAL(decoder);
+}
+
+void decoder_decode_valid_test_2()
+{
+    TMLFFilePart src_mlf[2];
+    TMLFFilePart *recognition_res = NULL;
+    TDecoderParameters parallel_parameters = parameters;
+    PDecoder decoder = NULL;
+    int is_ok = 0, is_equal_1 = 0, is_equal_2 = 0;
+
+    parallel_parameters.threads_number = 2;
+    decoder = decoder_create(models, parallel_parameters);
+    CU_ASSERT_PTR_NOT_NULL_FATAL(decoder);
+
+    src_mlf[0] = src_mlf_2[0];
+    src_mlf[1] = src_mlf_1[0];
+    is_ok = decoder_decode(decoder, src_mlf, 2, &recognition_res);
+    if (is_ok)
+    {
+        is_equal_1 = compare_two_MLF(recognition_res, FILES_NUMBER,
+                                     target_res_mlf + 1, FILES_NUMBER);
+        is_equal_2 = compare_two_MLF(recognition_res + 1, FILES_NUMBER,
+                                     target_res_mlf, FILES_NUMBER);
+        free_MLF(&recognition_res, 2);
+    }
+    decoder_destroy(&decoder);
+
+    CU_ASSERT_TRUE_FATAL(is_ok);
+    CU_ASSERT_TRUE_FATAL(is_equal_1);
+    CU_ASSERT_TRUE_FATAL(is_equal_2);
+}
+
+void decoder_decode_valid_test_3()
+{
+    TMLFFilePart *recognition_res = NULL;
+    TDecoderModels tree_models = models;
+    TDecoderParameters segments_parameters = parameters;
+    PDecoder decoder = NULL;
+    int is_ok = 0, is_equal_1 = 0, is_equal_2 = 0;
+
+    /* each phoneme is the single time point, so word bounds are bounds of
+       phonemes only */
+    tree_models.words_lexicon = NULL;
+    tree_models.words_lexicon_size = 0;
+    tree_models.words_tree_root = words_tree;
+    segments_parameters.use_segments = 1;
+    decoder = decoder_create(tree_models, segments_parameters);
+    CU_ASSERT_PTR_NOT_NULL_FATAL(decoder);
+
+    is_ok = decoder_decode(decoder, src_mlf_1, FILES_NUMBER, &recognition_res);
+    if (is_ok)
+    {
+        is_equal_1 = compare_two_MLF(recognition_res, FILES_NUMBER,
+                                     segments_res_mlf, FILES_NUMBER);
+        free_MLF(&recognition_res, FILES_NUMBER);
+        is_ok = decoder_decode(decoder, src_mlf_2, FILES_NUMBER,
+                               &recognition_res);
+    }
+    if (is_ok)
+    {
+        is_equal_2 = compare_two_MLF(recognition_res, FILES_NUMBER,
+                                     segments_res_mlf + 1, FILES_NUMBER);
+        free_MLF(&recognition_res, FILES_NUMBER);
+    }
+    decoder_destroy(&decoder);
+
+    CU_ASSERT_TRUE_FATAL(is_ok);
+    CU_ASSERT_TRUE_FATAL(is_equal_1);
+    CU_ASSERT_TRUE_FATAL(is_equal_2);
+}
+
+void decoder_decode_valid_test_4()
+{
+    TMLFFilePart *recognition_res = NULL;
+    TDecoderModels tree_models = models;
+    TDecoderParameters gathering_parameters = parameters;
+    PDecoder decoder = NULL;
+    int is_ok = 0, is_equal_1 = 0, is_equal_2 = 0;
+
+    /* the emission table is disabled, so penalties of states are gathered
+       from the confusion penalties matrix at each time point */
+    gathering_parameters.max_emission_table_size = 0;
+    decoder = decoder_create(models, gathering_parameters);
+    CU_ASSERT_PTR_NOT_NULL_FATAL(decoder);
+
+    is_ok = decoder_decode(decoder, src_mlf_1, FILES_NUMBER, &recognition_res);
+    if (is_ok)
+    {
+        is_equal_1 = compare_two_MLF(recognition_res, FILES_NUMBER,
+                                     target_res_mlf, FILES_NUMBER);
+        free_MLF(&recognition_res, FILES_NUMBER);
+    }
+    decoder_destroy(&decoder);
+
+    tree_models.words_lexicon = NULL;
+    tree_models.words_lexicon_size = 0;
+    tree_models.words_tree_root = words_tree;
+    gathering_parameters.use_segments = 1;
+    decoder = decoder_create(tree_models, gathering_parameters);
+    CU_ASSERT_PTR_NOT_NULL_FATAL(decoder);
+
+    if (is_ok)
+    {
+        is_ok = decoder_decode(decoder, src_mlf_2, FILES_NUMBER,
+                               &recognition_res);
+    }
+    if (is_ok)
+    {
+        is_equal_2 = compare_two_MLF(recognition_res, FILES_NUMBER,
+                                     segments_res_mlf + 1, FILES_NUMBER);
+        free_MLF(&recognition_res, FILES_NUMBER);
+    }
+    decoder_destroy(&decoder);
+
+    CU_ASSERT_TRUE_FATAL(is_ok);
+    CU_ASSERT_TRUE_FATAL(is_equal_1);
+    CU_ASSERT_TRUE_FATAL(is_equal_2);
+}
+
+void decoder_decode_valid_test_5()
+{
+    TMLFFilePart *long_mlf = NULL;
+    TMLFFilePart *float_res[3] = {NULL, NULL, NULL};
+    TMLFFilePart *fixed_res[3] = {NULL, NULL, NULL};
+    TMLFFilePart *sources[3];
+    TDecoderParameters fixed_point_parameters = parameters;
+    PDecoder float_decoder = NULL, fixed_decoder = NULL;
+    int i, j, k, is_ok = 1, is_periodic = 0;
+    int insertions = 0, deletions = 0, substitutions = 0;
+    float error_rates[3] = {-1.0, -1.0, -1.0};
+
+    /* total costs of the long sequence exceed 2^(24-fixed_point_bits), and
+       scores of its words are calculated exactly only if costs are
+       normalized in each frame: then words of the last repeat of the source
+       sequence have the same scores as words of the second one */
+    long_mlf = create_long_source(src_mlf_2, LONG_SOURCE_REPEATS);
+    CU_ASSERT_PTR_NOT_NULL_FATAL(long_mlf);
+    sources[0] = src_mlf_1;
+    sources[1] = src_mlf_2;
+    sources[2] = long_mlf;
+
+    /* scores are rounded in the fixed-point mode, so results of this mode
+       are compared with results of the floating-point mode by words only */
+    fixed_point_parameters.fixed_point_bits = 10;
+    float_decoder = decoder_create(models, parameters);
+    fixed_decoder = decoder_create(models, fixed_point_parameters);
+    CU_ASSERT_PTR_NOT_NULL_FATAL(float_decoder);
+    CU_ASSERT_PTR_NOT_NULL_FATAL(fixed_decoder);
+
+    for (i = 0; (i < 3) && is_ok; i++)
+    {
+        is_ok = decoder_decode(float_decoder, sources[i], FILES_NUMBER,
+                               &float_res[i]);
+        if (is_ok)
+        {
+            is_ok = decoder_decode(fixed_decoder, sources[i], FILES_NUMBER,
+                                   &fixed_res[i]);
+        }
+        if (is_ok)
+        {
+            error_rates[i] = estimate_error_rate(
+                        fixed_res[i], float_res[i], FILES_NUMBER,
+                        &insertions, &deletions, &substitutions);
+        }
+    }
+    if (is_ok && (fixed_res[2][0].transcription_size
+                  == (LONG_SOURCE_REPEATS * 3 - 1)))
+    {
+        is_periodic = 1;
+        k = (LONG_SOURCE_REPEATS - 3) * 3;
+        for (j = 3; j < 6; j++)
+        {
+            if ((fixed_res[2][0].transcription[j].node_data
+                 != fixed_res[2][0].transcription[j + k].node_data)
+                    || (fabs(fixed_res[2][0].transcription[j].score
+                             - fixed_res[2][0].transcription[j + k].score)
+                        > FLT_EPSILON))
+            {
+                is_periodic = 0;
+                break;
+            }
+        }
+    }
+    for (i = 0; i < 3; i++)
+    {
+        free_MLF(&float_res[i], FILES_NUMBER);
+        free_MLF(&fixed_res[i], FILES_NUMBER);
+    }
+    free_MLF(&long_mlf, FILES_NUMBER);
+    decoder_destroy(&float_decoder);
+    decoder_destroy(&fixed_decoder);
+
+    CU_ASSERT_TRUE_FATAL(is_ok);
+    CU_ASSERT_DOUBLE_EQUAL(error_rates[0], 0.0, FLT_EPSILON);
+    CU_ASSERT_DOUBLE_EQUAL(error_rates[1], 0.0, FLT_EPSILON);
+    CU_ASSERT_DOUBLE_EQUAL(error_rates[2], 0.0, FLT_EPSILON);
+    CU_ASSERT_TRUE_FATAL(is_periodic);
+}
+
+void decoder_decode_valid_test_6()
+{
+    TMLFFilePart *recognition_res = NULL;
+    TMLFFilePart *pruned_res_1 = NULL, *pruned_res_2 = NULL;
+    TMLFFilePart *unpruned_res_1 = NULL, *unpruned_res_2 = NULL;
+    TMLFFilePart src_mlf, target_mlf, short_src_mlf, short_target_mlf;
+    TTranscriptionNode src_phonemes[6], target_word;
+    TTranscriptionNode short_src_phonemes[4], short_target_word;
+    TDecoderModels tree_models = models;
+    TDecoderParameters lookahead_parameters = parameters;
+    TLanguageModel source_model;
+    TCompiledLanguageModel unigram_model;
+    TWordBigram bigrams[3] = {{0, NULL}, {0, NULL}, {0, NULL}};
+    float unigrams[3] = {0.25, 0.15, 0.6};
+    int phonemes[6] = {0, 1, 3, 3, 2, 0}, short_phonemes[4] = {1, 1, 0, 0};
+    PDecoder decoder = NULL;
+    int i, is_ok = 0, is_equal_1 = 0, is_equal_2 = 0;
+    int is_equal_3 = 0, is_equal_4 = 1, is_equal_5 = 0;
+
+    /* the language model lookahead changes pruning of hypotheses only, so
+       results of the words tree without pruning are the same */
+    tree_models.words_lexicon = NULL;
+    tree_models.words_lexicon_size = 0;
+    tree_models.words_tree_root = words_tree;
+    lookahead_parameters.use_segments = 1;
+    lookahead_parameters.use_lm_lookahead = 1;
+    decoder = decoder_create(tree_models, lookahead_parameters);
+    CU_ASSERT_PTR_NOT_NULL_FATAL(decoder);
+
+    is_ok = decoder_decode(decoder, src_mlf_1, FILES_NUMBER, &recognition_res);
+    if (is_ok)
+    {
+        is_equal_1 = compare_two_MLF(recognition_res, FILES_NUMBER,
+                                     segments_res_mlf, FILES_NUMBER);
+        free_MLF(&recognition_res, FILES_NUMBER);
+        is_ok = decoder_decode(decoder, src_mlf_2, FILES_NUMBER,
+                               &recognition_res);
+    }
+    if (is_ok)
+    {
+        is_equal_2 = compare_two_MLF(recognition_res, FILES_NUMBER,
+                                     segments_res_mlf + 1, FILES_NUMBER);
+        free_MLF(&recognition_res, FILES_NUMBER);
+    }
+    decoder_destroy(&decoder);
+
+    CU_ASSERT_TRUE_FATAL(is_ok);
+    CU_ASSERT_TRUE_FATAL(is_equal_1);
+    CU_ASSERT_TRUE_FATAL(is_equal_2);
+
+    /* the word 2 is recognized without pruning, because the language model
+       prefers it, but words 0 and 1 are better by phonemes of their
+       beginnings; so the word 2 is lost at pruning by the max_active
+       hypotheses without the lookahead, and it is kept with the lookahead */
+    source_model.unigrams_number = 3;
+    source_model.unigrams_probabilities = unigrams;
+    source_model.bigrams = bigrams;
+    CU_ASSERT_TRUE_FATAL(compile_language_model(source_model, 0.5,
+                                                &unigram_model));
+    tree_models.language_model = unigram_model;
+    for (i = 0; i < 6; i++)
+    {
+        src_phonemes[i].node_data = phonemes[i];
+        src_phonemes[i].start_time = i * 100000;
+        src_phonemes[i].end_time = (i + 1) * 100000;
+        src_phonemes[i].probability = 0.9;
+    }
+    src_mlf.name = INP_MLF_PART_NAME;
+    src_mlf.transcription = src_phonemes;
+    src_mlf.transcription_size = 6;
+    target_word.node_data = 2;
+    target_word.start_time = 100000;
+    target_word.end_time = 500000;
+    target_word.score = -2.58790874;
+    target_mlf.name = REC_MLF_PART_NAME;
+    target_mlf.transcription = &target_word;
+    target_mlf.transcription_size = 1;
+
+    /* lookahead scores aren't included into costs of hypotheses, so scores
+       of words without pruning are exactly the same as without lookahead
+       (not only within SCORE_EPSILON) */
+    for (i = 0; i < 4; i++)
+    {
+        short_src_phonemes[i].node_data = short_phonemes[i];
+        short_src_phonemes[i].start_time = i * 100000;
+        short_src_phonemes[i].end_time = (i + 1) * 100000;
+        short_src_phonemes[i].probability = 0.9;
+    }
+    short_src_mlf.name = INP_MLF_PART_NAME;
+    short_src_mlf.transcription = short_src_phonemes;
+    short_src_mlf.transcription_size = 4;
+    short_target_word.node_data = 0;
+    short_target_word.start_time = 0;
+    short_target_word.end_time = 300000;
+    short_target_word.score = -1.17727768;
+    short_target_mlf.name = REC_MLF_PART_NAME;
+    short_target_mlf.transcription = &short_target_word;
+    short_target_mlf.transcription_size = 1;
+    lookahead_parameters = parameters;
+    for (i = 0; i < 2; i++)
+    {
+        lookahead_parameters.use_lm_lookahead = i;
+        decoder = decoder_create(tree_models, lookahead_parameters);
+        CU_ASSERT_PTR_NOT_NULL_FATAL(decoder);
+        is_ok = decoder_decode(decoder, &short_src_mlf, FILES_NUMBER,
+                               (i == 0) ? &unpruned_res_1 : &unpruned_res_2);
+        decoder_destroy(&decoder);
+        CU_ASSERT_TRUE_FATAL(is_ok);
+    }
+    is_equal_5 = compare_two_MLF(unpruned_res_1, FILES_NUMBER,
+                                 &short_target_mlf, FILES_NUMBER)
+            && compare_two_MLF(unpruned_res_2, FILES_NUMBER,
+                               &short_target_mlf, FILES_NUMBER)
+            && (unpruned_res_1[0].transcription[0].score
+                == unpruned_res_2[0].transcription[0].score);
+    free_MLF(&unpruned_res_1, FILES_NUMBER);
+    free_MLF(&unpruned_res_2, FILES_NUMBER);
+    CU_ASSERT_TRUE_FATAL(is_equal_5);
+
+    lookahead_parameters = parameters;
+    lookahead_parameters.max_active_hypotheses = 7;
+    decoder = decoder_create(tree_models, lookahead_parameters);
+    is_ok = (decoder != NULL);
+    if (is_ok)
+    {
+        is_ok = decoder_decode(decoder, &src_mlf, FILES_NUMBER, &pruned_res_1);
+        decoder_destroy(&decoder);
+    }
+    lookahead_parameters.use_lm_lookahead = 1;
+    if (is_ok)
+    {
+        decoder = decoder_create(tree_models, lookahead_parameters);
+        is_ok = (decoder != NULL);
+    }
+    if (is_ok)
+    {
+        is_ok = decoder_decode(decoder, &src_mlf, FILES_NUMBER, &pruned_res_2);
+        decoder_destroy(&decoder);
+    }
+    if (is_ok)
+    {
+        is_equal_3 = compare_two_MLF(pruned_res_2, FILES_NUMBER,
+                                     &target_mlf, FILES_NUMBER);
+        is_equal_4 = compare_two_MLF(pruned_res_1, FILES_NUMBER,
+                                     &target_mlf, FILES_NUMBER);
+    }
+    free_MLF(&pruned_res_1, FILES_NUMBER);
+    free_MLF(&pruned_res_2, FILES_NUMBER);
+    free_compiled_language_model(&unigram_model);
+
+    CU_ASSERT_TRUE_FATAL(is_ok);
+    CU_ASSERT_TRUE_FATAL(is_equal_3);
+    CU_ASSERT_FALSE_FATAL(is_equal_4);
+}
+
+void decoder_decode_valid_test_7()
+{
+    TMLFFilePart *recognition_res = NULL;
+    TMLFFilePart *full_res = NULL, *fast_match_res = NULL;
+    TMLFFilePart src_mlf;
+    TTranscriptionNode src_phonemes[8];
+    TDecoderParameters fast_match_parameters = parameters;
+    int phonemes[8] = {0, 3, 2, 1, 2, 1, 1, 0};
+    PDecoder decoder = NULL;
+    int i, is_ok = 0, is_equal_1 = 0, is_equal_2 = 0;
+    int is_equal_3 = 0, is_equal_4 = 0, is_entered_1 = 0, is_entered_2 = 1;
+
+    /* the fast match selects all words of the lexicon, so it excludes
+       impossible words only and results are not changed */
+    fast_match_parameters.fast_match_depth = DEFAULT_FAST_MATCH_DEPTH;
+    fast_match_parameters.fast_match_size = WORDS_VOCABULARY_SIZE;
+    decoder = decoder_create(models, fast_match_parameters);
+    CU_ASSERT_PTR_NOT_NULL_FATAL(decoder);
+
+    is_ok = decoder_decode(decoder, src_mlf_1, FILES_NUMBER, &recognition_res);
+    if (is_ok)
+    {
+        is_equal_1 = compare_two_MLF(recognition_res, FILES_NUMBER,
+                                     target_res_mlf, FILES_NUMBER);
+        free_MLF(&recognition_res, FILES_NUMBER);
+        is_ok = decoder_decode(decoder, src_mlf_2, FILES_NUMBER,
+                               &recognition_res);
+    }
+    if (is_ok)
+    {
+        is_equal_2 = compare_two_MLF(recognition_res, FILES_NUMBER,
+                                     target_res_mlf + 1, FILES_NUMBER);
+        free_MLF(&recognition_res, FILES_NUMBER);
+    }
+    decoder_destroy(&decoder);
+
+    CU_ASSERT_TRUE_FATAL(is_ok);
+    CU_ASSERT_TRUE_FATAL(is_equal_1);
+    CU_ASSERT_TRUE_FATAL(is_equal_2);
+
+    /* only the best word is entered by the next input phoneme, and the best
+       paths of both sequences are kept */
+    fast_match_parameters.fast_match_depth = 1;
+    fast_match_parameters.fast_match_size = 1;
+    decoder = decoder_create(models, fast_match_parameters);
+    CU_ASSERT_PTR_NOT_NULL_FATAL(decoder);
+
+    is_ok = decoder_decode(decoder, src_mlf_1, FILES_NUMBER, &recognition_res);
+    if (is_ok)
+    {
+        is_equal_3 = compare_two_MLF(recognition_res, FILES_NUMBER,
+                                     target_res_mlf, FILES_NUMBER);
+        free_MLF(&recognition_res, FILES_NUMBER);
+        is_ok = decoder_decode(decoder, src_mlf_2, FILES_NUMBER,
+                               &recognition_res);
+    }
+    if (is_ok)
+    {
+        is_equal_4 = compare_two_MLF(recognition_res, FILES_NUMBER,
+                                     target_res_mlf + 1, FILES_NUMBER);
+        free_MLF(&recognition_res, FILES_NUMBER);
+    }
+
+    CU_ASSERT_TRUE_FATAL(is_ok);
+    CU_ASSERT_TRUE_FATAL(is_equal_3);
+    CU_ASSERT_TRUE_FATAL(is_equal_4);
+
+    /* the word 2 is recognized from the input phoneme 1 without the fast
+       match, but its first phoneme 2 is rarely confused with this phoneme,
+       so the fast match of one word enters the word 0 instead of it */
+    for (i = 0; i < 8; i++)
+    {
+        src_phonemes[i].node_data = phonemes[i];
+        src_phonemes[i].start_time = i * 100000;
+        src_phonemes[i].end_time = (i + 1) * 100000;
+        src_phonemes[i].probability = 0.9;
+    }
+    src_mlf.name = INP_MLF_PART_NAME;
+    src_mlf.transcription = src_phonemes;
+    src_mlf.transcription_size = 8;
+    is_ok = decoder_decode(decoder, &src_mlf, FILES_NUMBER, &fast_match_res);
+    decoder_destroy(&decoder);
+    if (is_ok)
+    {
+        decoder = decoder_create(models, parameters);
+        is_ok = (decoder != NULL);
+    }
+    if (is_ok)
+    {
+        is_ok = decoder_decode(decoder, &src_mlf, FILES_NUMBER, &full_res);
+        decoder_destroy(&decoder);
+    }
+    if (is_ok)
+    {
+        for (i = 0; i < full_res[0].transcription_size; i++)
+        {
+            if (full_res[0].transcription[i].node_data == 2)
+            {
+                is_entered_1 = 1;
+            }
+        }
+        is_entered_2 = (fast_match_res[0].transcription_size <= 0);
+        for (i = 0; i < fast_match_res[0].transcription_size; i++)
+        {
+            if (fast_match_res[0].transcription[i].node_data == 2)
+            {
+                is_entered_2 = 1;
+            }
+        }
+    }
+    free_MLF(&full_res, FILES_NUMBER);
+    free_MLF(&fast_match_res, FILES_NUMBER);
+
+    CU_ASSERT_TRUE_FATAL(is_ok);
+    CU_ASSERT_TRUE_FATAL(is_entered_1);
+    CU_ASSERT_FALSE_FATAL(is_entered_2);
+}
+
+void decoder_decode_invalid_test_1()
+{
+    TMLFFilePart *recognition_res = NULL;
+    PDecoder decoder = decoder_create(models, parameters);
+    int is_ok = 1;
+
+    CU_ASSERT_PTR_NOT_NULL_FATAL(decoder);
+
+    is_ok = decoder_decode(NULL, src_mlf_1, FILES_NUMBER, &recognition_res);
+    CU_ASSERT_FALSE(is_ok);
+
+    is_ok = decoder_decode(decoder, NULL, FILES_NUMBER, &recognition_res);
+    CU_ASSERT_FALSE(is_ok);
+
+    is_ok = decoder_decode(decoder, src_mlf_1, 0, &recognition_res);
+    CU_ASSERT_FALSE(is_ok);
+
+    is_ok = decoder_decode(decoder, src_mlf_1, FILES_NUMBER, NULL);
+    CU_ASSERT_FALSE(is_ok);
+
+    decoder_destroy(&decoder);
+}
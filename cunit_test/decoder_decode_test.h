@@ -0,0 +1,16 @@
+#ifndef DECODER_DECODE_TEST_H
+#define DECODER_DECODE_TEST_H
+
+int prepare_for_testing_of_decoder_decode();
+int init_suite_decoder_decode();
+int clean_suite_decoder_decode();
+void decoder_decode_valid_test_1();
+void decoder_decode_valid_test_2();
+void decoder_decode_valid_test_3();
+void decoder_decode_valid_test_4();
+void decoder_decode_valid_test_5();
+void decoder_decode_valid_test_6();
+void decoder_decode_valid_test_7();
+void decoder_decode_invalid_test_1();
+
+#endif // DECODER_DECODE_TEST_H
@@ -0,0 +1,11 @@
+#ifndef DECODER_FINALIZE_TEST_H
+#define DECODER_FINALIZE_TEST_H
+
+int prepare_for_testing_of_decoder_finalize();
+int init_suite_decoder_finalize();
+int clean_suite_decoder_finalize();
+void decoder_finalize_valid_test_1();
+void decoder_finalize_valid_test_2();
+void decoder_finalize_invalid_test_1();
+
+#endif // DECODER_FINALIZE_TEST_H
@@ -0,0 +1,621 @@
+#include <float.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <CUnit/Basic.h>
+#include <CUnit/CUnit.h>
+
+#include "../bond005_lvcsr_lib.h"
+#include "decoder_generate_lattices_test.h"
+
+#define FILES_NUMBER 1
+#define INP_MLF_PART_NAME "test_record.lab"
+#define REC_MLF_PART_NAME "test_record.rec"
+#define LAT_FILE_NAME "test_record.lat"
+#define PHONEMES_VOCABULARY_SIZE 4
+#define WORDS_VOCABULARY_SIZE 3
+#define SCORE_EPSILON 1e-5
+
+static float confusion_penalties[] = {
+    0.95, 0.02, 0.02, 0.01,
+    0.03, 0.80, 0.05, 0.12,
+    0.05, 0.12, 0.75, 0.08,
+    0.04, 0.04, 0.11, 0.81
+};
+static TLinearWordsLexicon *words_lexicon = NULL;
+static TCompiledLanguageModel language_model;
+static float lambda = 1.0;
+static TMLFFilePart *src_mlf_1 = NULL, *src_mlf_2 = NULL;
+static TMLFFilePart *target_res_mlf = NULL;
+static TDecoderModels models;
+static TDecoderParameters parameters;
+
+static int compare_two_MLF(TMLFFilePart *mlf1, int mlf1_size,
+                           TMLFFilePart *mlf2, int mlf2_size)
+{
+    int i, j, res = 1;
+
+    if (mlf1_size != mlf2_size)
+    {
+        return 0;
+    }
+    if (mlf1_size < 0)
+    {
+        return 0;
+    }
+    if (mlf1_size == 0)
+    {
+        return 1;
+    }
+    if ((mlf1 == NULL) || (mlf2 == NULL))
+    {
+        return 0;
+    }
+
+    for (i = 0; i < mlf1_size; i++)
+    {
+        if ((mlf1[i].name == NULL) || (mlf2[i].name == NULL))
+        {
+            res = 0;
+            break;
+        }
+        if (strcmp(mlf1[i].name, mlf2[i].name) != 0)
+        {
+            res = 0;
+            break;
+        }
+        if (mlf1[i].transcription_size != mlf2[i].transcription_size)
+        {
+            res = 0;
+            break;
+        }
+        if (mlf1[i].transcription_size < 0)
+        {
+            res = 0;
+            break;
+        }
+        if (mlf1[i].transcription_size > 0)
+        {
+            for (j = 0; j < mlf1[i].transcription_size; j++)
+            {
+                if (mlf1[i].transcription[j].start_time
+                        != mlf2[i].transcription[j].start_time)
+                {
+                    res = 0;
+                    break;
+                }
+                if (mlf1[i].transcription[j].end_time
+                        != mlf2[i].transcription[j].end_time)
+                {
+                    res = 0;
+                    break;
+                }
+                if (mlf1[i].transcription[j].node_data
+                        != mlf2[i].transcription[j].node_data)
+                {
+                    res = 0;
+                    break;
+                }
+                if (fabs(mlf1[i].transcription[j].score
+                         - mlf2[i].transcription[j].score) > SCORE_EPSILON)
+                {
+                    res = 0;
+                    break;
+                }
+            }
+            if (!res)
+            {
+                break;
+            }
+        }
+    }
+
+    return res;
+}
+
+/* This function finds words of the best path from the start node to the end
+ * node of the word lattice. Nodes are sorted by time, so each link goes from
+ * the node with smaller number to the node with greater number. */
+static int find_best_path_of_lattice(TWordLattice lattice, int words[])
+{
+    float *costs = malloc(lattice.nodes_number * sizeof(float));
+    int *predecessors = malloc(lattice.nodes_number * sizeof(int));
+    int i, n = 0, word, res = -1;
+    TLatticeLink *link;
+
+    for (i = 0; i < lattice.nodes_number; i++)
+    {
+        costs[i] = -FLT_MAX;
+        predecessors[i] = -1;
+    }
+    costs[0] = 0.0;
+    for (i = 0; i < lattice.links_number; i++)
+    {
+        link = lattice.links + i;
+        if (link->start_node >= link->end_node)
+        {
+            break;
+        }
+    }
+    if (i >= lattice.links_number)
+    {
+        for (i = 1; i < lattice.nodes_number; i++)
+        {
+            for (n = 0; n < lattice.links_number; n++)
+            {
+                link = lattice.links + n;
+                if ((link->end_node != i)
+                        || (costs[link->start_node] <= -FLT_MAX))
+                {
+                    continue;
+                }
+                if ((costs[link->start_node] + link->acoustic_score
+                     + link->language_score) > costs[i])
+                {
+                    costs[i] = costs[link->start_node] + link->acoustic_score
+                            + link->language_score;
+                    predecessors[i] = link->start_node;
+                }
+            }
+        }
+        n = 0;
+        i = predecessors[lattice.nodes_number-1];
+        while (i > 0)
+        {
+            words[n++] = lattice.nodes[i].word_index;
+            i = predecessors[i];
+        }
+        if (i == 0)
+        {
+            for (i = 0; i < (n / 2); i++)
+            {
+                word = words[i];
+                words[i] = words[n-i-1];
+                words[n-i-1] = word;
+            }
+            res = n;
+        }
+    }
+    free(costs);
+    free(predecessors);
+
+    return res;
+}
+
+/* This function checks the structure of the word lattice: the first and the
+ * last nodes are the start and the end of the sentence, nodes of words are
+ * sorted by time, and each time contains no more than lattice_size best word
+ * ends plus lattice_size predecessors of best entered words. */
+static int check_word_lattice(TWordLattice lattice, char *name,
+                              int lattice_size)
+{
+    int i, n;
+
+    if ((lattice.name == NULL) || (lattice.nodes == NULL)
+            || (lattice.links == NULL))
+    {
+        return 0;
+    }
+    if (strcmp(lattice.name, name) != 0)
+    {
+        return 0;
+    }
+    if ((lattice.nodes_number < 3) || (lattice.links_number < 2))
+    {
+        return 0;
+    }
+    if ((lattice.nodes[0].word_index != -1)
+            || (lattice.nodes[lattice.nodes_number-1].word_index != -1))
+    {
+        return 0;
+    }
+    n = 1;
+    for (i = 2; i < (lattice.nodes_number - 1); i++)
+    {
+        if (lattice.nodes[i].word_index < 0)
+        {
+            return 0;
+        }
+        if (lattice.nodes[i].end_time < lattice.nodes[i-1].end_time)
+        {
+            return 0;
+        }
+        if (lattice.nodes[i].end_time == lattice.nodes[i-1].end_time)
+        {
+            n++;
+            if (n > (2 * lattice_size))
+            {
+                return 0;
+            }
+        }
+        else
+        {
+            n = 1;
+        }
+    }
+    for (i = 0; i < lattice.links_number; i++)
+    {
+        if ((lattice.links[i].start_node < 0)
+                || (lattice.links[i].end_node >= lattice.nodes_number))
+        {
+            return 0;
+        }
+    }
+
+    return 1;
+}
+
+int prepare_for_testing_of_decoder_generate_lattices()
+{
+    CU_pSuite pSuite = NULL;
+
+    pSuite = CU_add_suite("Test suite for decoder_generate_lattices()",
+                          init_suite_decoder_generate_lattices,
+                          clean_suite_decoder_generate_lattices);
+    if (NULL == pSuite)
+    {
+        CU_cleanup_registry();
+        return 0;
+    }
+
+    if ((NULL == CU_add_test(pSuite, "Valid partition 1",
+                             decoder_generate_lattices_valid_test_1))
+            || (NULL == CU_add_test(pSuite, "Valid partition 2",
+                                    decoder_generate_lattices_valid_test_2))
+            || (NULL == CU_add_test(pSuite, "Invalid partitions",
+                                    decoder_generate_lattices_invalid_test_1)))
+    {
+        CU_cleanup_registry();
+        return 0;
+    }
+
+    return 1;
+}
+
+int init_suite_decoder_generate_lattices()
+{
+    int i, n;
+    TLanguageModel source_model;
+
+    for (i = 0; i < (PHONEMES_VOCABULARY_SIZE * PHONEMES_VOCABULARY_SIZE); i++)
+    {
+        if (confusion_penalties[i] > 0.0)
+        {
+            confusion_penalties[i] = log10(confusion_penalties[i]);
+        }
+        else
+        {
+            confusion_penalties[i] = -FLT_MAX;
+        }
+    }
+
+    words_lexicon = malloc(WORDS_VOCABULARY_SIZE*sizeof(TLinearWordsLexicon));
+    words_lexicon[0].word_index = 0;
+    words_lexicon[0].phonemes_number = 2 + 1;
+    words_lexicon[0].phonemes_indexes = malloc((2 + 1) * sizeof(int));
+    words_lexicon[0].phonemes_indexes[0] = 1;
+    words_lexicon[0].phonemes_indexes[1] = 2;
+    words_lexicon[0].phonemes_indexes[2] = 0;
+    words_lexicon[1].word_index = 1;
+    words_lexicon[1].phonemes_number = 2 + 1;
+    words_lexicon[1].phonemes_indexes = malloc((2 + 1) * sizeof(int));
+    words_lexicon[1].phonemes_indexes[0] = 3;
+    words_lexicon[1].phonemes_indexes[1] = 2;
+    words_lexicon[1].phonemes_indexes[2] = 0;
+    words_lexicon[2].word_index = 2;
+    words_lexicon[2].phonemes_number = 3 + 1;
+    words_lexicon[2].phonemes_indexes = malloc((3 + 1) * sizeof(int));
+    words_lexicon[2].phonemes_indexes[0] = 2;
+    words_lexicon[2].phonemes_indexes[1] = 3;
+    words_lexicon[2].phonemes_indexes[2] = 1;
+    words_lexicon[2].phonemes_indexes[3] = 0;
+
+    source_model.unigrams_number = 3;
+    source_model.unigrams_probabilities = malloc(3*sizeof(float));
+    source_model.unigrams_probabilities[0] = 0.4;
+    source_model.unigrams_probabilities[1] = 0.25;
+    source_model.unigrams_probabilities[2] = 0.35;
+    source_model.bigrams = malloc(3*sizeof(TWordBigram));
+    source_model.bigrams[0].begins_number = 2;
+    source_model.bigrams[0].begins = malloc(2*sizeof(TWordBigramBegin));
+    //1->0
+    source_model.bigrams[0].begins[0].word_i = 1;
+    source_model.bigrams[0].begins[0].probability = 0.5;
+    //2->0
+    source_model.bigrams[0].begins[1].word_i = 2;
+    source_model.bigrams[0].begins[1].probability = 0.1;
+    source_model.bigrams[1].begins_number = 2;
+    source_model.bigrams[1].begins = malloc(2*sizeof(TWordBigramBegin));
+    //0->1
+    source_model.bigrams[1].begins[0].word_i = 0;
+    source_model.bigrams[1].begins[0].probability = 0.2;
+    //2->1
+    source_model.bigrams[1].begins[1].word_i = 2;
+    source_model.bigrams[1].begins[1].probability = 0.9;
+    source_model.bigrams[2].begins_number = 2;
+    source_model.bigrams[2].begins = malloc(2*sizeof(TWordBigramBegin));
+    //0->2
+    source_model.bigrams[2].begins[0].word_i = 0;
+    source_model.bigrams[2].begins[0].probability = 0.8;
+    //1->2
+    source_model.bigrams[2].begins[1].word_i = 1;
+    source_model.bigrams[2].begins[1].probability = 0.5;
+    compile_language_model(source_model, lambda, &language_model);
+    free_language_model(&source_model);
+
+    models.phonemes_vocabulary_size = PHONEMES_VOCABULARY_SIZE;
+    models.confusion_penalties_matrix = confusion_penalties;
+    models.words_lexicon = words_lexicon;
+    models.words_lexicon_size = WORDS_VOCABULARY_SIZE;
+    models.words_tree_root = NULL;
+    models.language_model = language_model;
+    parameters = decoder_get_default_parameters();
+
+    n = strlen(INP_MLF_PART_NAME);
+    src_mlf_1 = malloc(sizeof(TMLFFilePart));
+    src_mlf_1[0].name = malloc((n+1) * sizeof(char));
+    memset(src_mlf_1[0].name, 0, (n+1) * sizeof(char));
+    strcpy(src_mlf_1[0].name, INP_MLF_PART_NAME);
+    src_mlf_1[0].transcription_size = 7;
+    src_mlf_1[0].transcription = malloc(7*sizeof(TTranscriptionNode));
+    src_mlf_1[0].transcription[0].start_time = 0;
+    src_mlf_1[0].transcription[0].end_time = 100000000;
+    src_mlf_1[0].transcription[0].node_data = 0;
+    src_mlf_1[0].transcription[0].probability = 0.9;
+    src_mlf_1[0].transcription[1].start_time = 100000000;
+    src_mlf_1[0].transcription[1].end_time = 150000000;
+    src_mlf_1[0].transcription[1].node_data = 1;
+    src_mlf_1[0].transcription[1].probability = 0.8;
+    src_mlf_1[0].transcription[2].start_time = 150000000;
+    src_mlf_1[0].transcription[2].end_time = 160000000;
+    src_mlf_1[0].transcription[2].node_data = 3;
+    src_mlf_1[0].transcription[2].probability = 0.6;
+    src_mlf_1[0].transcription[3].start_time = 160000000;
+    src_mlf_1[0].transcription[3].end_time = 190000000;
+    src_mlf_1[0].transcription[3].node_data = 2;
+    src_mlf_1[0].transcription[3].probability = 0.75;
+    src_mlf_1[0].transcription[4].start_time = 190000000;
+    src_mlf_1[0].transcription[4].end_time = 240000000;
+    src_mlf_1[0].transcription[4].node_data = 3;
+    src_mlf_1[0].transcription[4].probability = 0.9;
+    src_mlf_1[0].transcription[5].start_time = 240000000;
+    src_mlf_1[0].transcription[5].end_time = 260000000;
+    src_mlf_1[0].transcription[5].node_data = 1;
+    src_mlf_1[0].transcription[5].probability = 0.7;
+    src_mlf_1[0].transcription[6].start_time = 260000000;
+    src_mlf_1[0].transcription[6].end_time = 300000000;
+    src_mlf_1[0].transcription[6].node_data = 0;
+    src_mlf_1[0].transcription[6].probability = 0.9;
+
+    n = strlen(INP_MLF_PART_NAME);
+    src_mlf_2 = malloc(sizeof(TMLFFilePart));
+    src_mlf_2[0].name = malloc((n+1) * sizeof(char));
+    memset(src_mlf_2[0].name, 0, (n+1) * sizeof(char));
+    strcpy(src_mlf_2[0].name, INP_MLF_PART_NAME);
+    src_mlf_2[0].transcription_size = 9;
+    src_mlf_2[0].transcription = malloc(9*sizeof(TTranscriptionNode));
+    src_mlf_2[0].transcription[0].start_time = 0;
+    src_mlf_2[0].transcription[0].end_time = 100000000;
+    src_mlf_2[0].transcription[0].node_data = 0;
+    src_mlf_2[0].transcription[0].probability = 0.9;
+    src_mlf_2[0].transcription[1].start_time = 100000000;
+    src_mlf_2[0].transcription[1].end_time = 150000000;
+    src_mlf_2[0].transcription[1].node_data = 1;
+    src_mlf_2[0].transcription[1].probability = 0.8;
+    src_mlf_2[0].transcription[2].start_time = 150000000;
+    src_mlf_2[0].transcription[2].end_time = 160000000;
+    src_mlf_2[0].transcription[2].node_data = 3;
+    src_mlf_2[0].transcription[2].probability = 0.6;
+    src_mlf_2[0].transcription[3].start_time = 160000000;
+    src_mlf_2[0].transcription[3].end_time = 190000000;
+    src_mlf_2[0].transcription[3].node_data = 2;
+    src_mlf_2[0].transcription[3].probability = 0.75;
+    src_mlf_2[0].transcription[4].start_time = 190000000;
+    src_mlf_2[0].transcription[4].end_time = 280000000;
+    src_mlf_2[0].transcription[4].node_data = 0;
+    src_mlf_2[0].transcription[4].probability = 0.97;
+    src_mlf_2[0].transcription[5].start_time = 280000000;
+    src_mlf_2[0].transcription[5].end_time = 300000000;
+    src_mlf_2[0].transcription[5].node_data = 2;
+    src_mlf_2[0].transcription[5].probability = 0.83;
+    src_mlf_2[0].transcription[6].start_time = 300000000;
+    src_mlf_2[0].transcription[6].end_time = 350000000;
+    src_mlf_2[0].transcription[6].node_data = 3;
+    src_mlf_2[0].transcription[6].probability = 0.9;
+    src_mlf_2[0].transcription[7].start_time = 350000000;
+    src_mlf_2[0].transcription[7].end_time = 370000000;
+    src_mlf_2[0].transcription[7].node_data = 1;
+    src_mlf_2[0].transcription[7].probability = 0.7;
+    src_mlf_2[0].transcription[8].start_time = 370000000;
+    src_mlf_2[0].transcription[8].end_time = 410000000;
+    src_mlf_2[0].transcription[8].node_data = 0;
+    src_mlf_2[0].transcription[8].probability = 0.9;
+
+    n = strlen(REC_MLF_PART_NAME);
+    target_res_mlf = malloc(2*sizeof(TMLFFilePart));
+    target_res_mlf[0].name = malloc((n+1) * sizeof(char));
+    memset(target_res_mlf[0].name, 0, (n+1) * sizeof(char));
+    strcpy(target_res_mlf[0].name, REC_MLF_PART_NAME);
+    target_res_mlf[0].transcription_size = 2;
+    target_res_mlf[0].transcription = malloc(2*sizeof(TTranscriptionNode));
+    target_res_mlf[0].transcription[0].start_time = 100000000;
+    target_res_mlf[0].transcription[0].end_time = 155000000;
+    target_res_mlf[0].transcription[0].node_data = 0;
+    target_res_mlf[0].transcription[0].score = -1.70639872;
+    target_res_mlf[0].transcription[1].start_time = 155000000;
+    target_res_mlf[0].transcription[1].end_time = 260000000;
+    target_res_mlf[0].transcription[1].node_data = 2;
+    target_res_mlf[0].transcription[1].score = -2.34140992;
+    target_res_mlf[1].name = malloc((n+1) * sizeof(char));
+    memset(target_res_mlf[1].name, 0, (n+1) * sizeof(char));
+    strcpy(target_res_mlf[1].name, REC_MLF_PART_NAME);
+    target_res_mlf[1].transcription_size = 2;
+    target_res_mlf[1].transcription = malloc(2*sizeof(TTranscriptionNode));
+    target_res_mlf[1].transcription[0].start_time = 100000000;
+    target_res_mlf[1].transcription[0].end_time = 190000000;
+    target_res_mlf[1].transcription[0].node_data = 0;
+    target_res_mlf[1].transcription[0].score = -3.03700137;
+    target_res_mlf[1].transcription[1].start_time = 190000000;
+    target_res_mlf[1].transcription[1].end_time = 370000000;
+    target_res_mlf[1].transcription[1].node_data = 2;
+    target_res_mlf[1].transcription[1].score = -1.49353767;
+
+    return 0;
+}
+
+int clean_suite_decoder_generate_lattices()
+{
+    free_compiled_language_model(&language_model);
+    free_linear_words_lexicon(&words_lexicon, WORDS_VOCABULARY_SIZE);
+    free_MLF(&src_mlf_1, FILES_NUMBER);
+    free_MLF(&src_mlf_2, FILES_NUMBER);
+    free_MLF(&target_res_mlf, 2);
+    return 0;
+}
+
+void decoder_generate_lattices_valid_test_1()
+{
+    TMLFFilePart *recognition_res = NULL;
+    TWordLattice *lattices = NULL;
+    PDecoder decoder = NULL;
+    int best_path[WORDS_VOCABULARY_SIZE * 4];
+    int is_ok = 0, is_equal_1 = 0, is_equal_2 = 0;
+    int is_lattice_1 = 0, is_lattice_2 = 0, n1 = 0, n2 = 0;
+
+    decoder = decoder_create(models, parameters);
+    CU_ASSERT_PTR_NOT_NULL_FATAL(decoder);
+
+    /* the best path of the lattice must be the same as the recognition
+       result */
+    is_ok = decoder_generate_lattices(decoder, src_mlf_1, FILES_NUMBER,
+                                      &recognition_res, &lattices);
+    if (is_ok)
+    {
+        is_equal_1 = compare_two_MLF(recognition_res, FILES_NUMBER,
+                                     target_res_mlf, FILES_NUMBER);
+        is_lattice_1 = check_word_lattice(lattices[0], LAT_FILE_NAME,
+                                          parameters.lattice_size);
+        if (is_lattice_1)
+        {
+            n1 = find_best_path_of_lattice(lattices[0], best_path);
+            if (n1 == 2)
+            {
+                is_lattice_1 = ((best_path[0] == 0) && (best_path[1] == 2));
+            }
+        }
+        free_MLF(&recognition_res, FILES_NUMBER);
+        free_word_lattices(&lattices, FILES_NUMBER);
+        is_ok = decoder_generate_lattices(decoder, src_mlf_2, FILES_NUMBER,
+                                          &recognition_res, &lattices);
+    }
+    if (is_ok)
+    {
+        is_equal_2 = compare_two_MLF(recognition_res, FILES_NUMBER,
+                                     target_res_mlf + 1, FILES_NUMBER);
+        is_lattice_2 = check_word_lattice(lattices[0], LAT_FILE_NAME,
+                                          parameters.lattice_size);
+        if (is_lattice_2)
+        {
+            n2 = find_best_path_of_lattice(lattices[0], best_path);
+            if (n2 == 2)
+            {
+                is_lattice_2 = ((best_path[0] == 0) && (best_path[1] == 2));
+            }
+        }
+        free_MLF(&recognition_res, FILES_NUMBER);
+        free_word_lattices(&lattices, FILES_NUMBER);
+    }
+    decoder_destroy(&decoder);
+
+    CU_ASSERT_TRUE_FATAL(is_ok);
+    CU_ASSERT_TRUE_FATAL(is_equal_1);
+    CU_ASSERT_TRUE_FATAL(is_equal_2);
+    CU_ASSERT_EQUAL_FATAL(n1, 2);
+    CU_ASSERT_EQUAL_FATAL(n2, 2);
+    CU_ASSERT_TRUE_FATAL(is_lattice_1);
+    CU_ASSERT_TRUE_FATAL(is_lattice_2);
+    CU_ASSERT_PTR_NULL_FATAL(lattices);
+}
+
+void decoder_generate_lattices_valid_test_2()
+{
+    TMLFFilePart src_mlf[2];
+    TMLFFilePart *recognition_res = NULL;
+    TWordLattice *lattices = NULL;
+    TDecoderParameters parallel_parameters = parameters;
+    PDecoder decoder = NULL;
+    int best_path[WORDS_VOCABULARY_SIZE * 4];
+    int is_ok = 0, is_equal_1 = 0, is_equal_2 = 0;
+    int is_lattice_1 = 0, is_lattice_2 = 0;
+
+    /* only the best word end of each time is kept in lattices */
+    parallel_parameters.threads_number = 2;
+    parallel_parameters.lattice_size = 1;
+    decoder = decoder_create(models, parallel_parameters);
+    CU_ASSERT_PTR_NOT_NULL_FATAL(decoder);
+
+    src_mlf[0] = src_mlf_2[0];
+    src_mlf[1] = src_mlf_1[0];
+    is_ok = decoder_generate_lattices(decoder, src_mlf, 2, &recognition_res,
+                                      &lattices);
+    if (is_ok)
+    {
+        is_equal_1 = compare_two_MLF(recognition_res, FILES_NUMBER,
+                                     target_res_mlf + 1, FILES_NUMBER);
+        is_equal_2 = compare_two_MLF(recognition_res + 1, FILES_NUMBER,
+                                     target_res_mlf, FILES_NUMBER);
+        is_lattice_1 = check_word_lattice(lattices[0], LAT_FILE_NAME, 1);
+        if (is_lattice_1)
+        {
+            is_lattice_1 = (find_best_path_of_lattice(lattices[0],
+                                                      best_path) > 0);
+        }
+        is_lattice_2 = check_word_lattice(lattices[1], LAT_FILE_NAME, 1);
+        if (is_lattice_2)
+        {
+            is_lattice_2 = (find_best_path_of_lattice(lattices[1],
+                                                      best_path) > 0);
+        }
+        free_MLF(&recognition_res, 2);
+        free_word_lattices(&lattices, 2);
+    }
+    decoder_destroy(&decoder);
+
+    CU_ASSERT_TRUE_FATAL(is_ok);
+    CU_ASSERT_TRUE_FATAL(is_equal_1);
+    CU_ASSERT_TRUE_FATAL(is_equal_2);
+    CU_ASSERT_TRUE_FATAL(is_lattice_1);
+    CU_ASSERT_TRUE_FATAL(is_lattice_2);
+}
+
+void decoder_generate_lattices_invalid_test_1()
+{
+    TMLFFilePart *recognition_res = NULL;
+    TWordLattice *lattices = NULL;
+    PDecoder decoder = decoder_create(models, parameters);
+    int is_ok = 1;
+
+    CU_ASSERT_PTR_NOT_NULL_FATAL(decoder);
+
+    is_ok = decoder_generate_lattices(NULL, src_mlf_1, FILES_NUMBER,
+                                      &recognition_res, &lattices);
+    CU_ASSERT_FALSE(is_ok);
+
+    is_ok = decoder_generate_lattices(decoder, NULL, FILES_NUMBER,
+                                      &recognition_res, &lattices);
+    CU_ASSERT_FALSE(is_ok);
+
+    is_ok = decoder_generate_lattices(decoder, src_mlf_1, 0,
+                                      &recognition_res, &lattices);
+    CU_ASSERT_FALSE(is_ok);
+
+    is_ok = decoder_generate_lattices(decoder, src_mlf_1, FILES_NUMBER,
+                                      NULL, &lattices);
+    CU_ASSERT_FALSE(is_ok);
+
+    is_ok = decoder_generate_lattices(decoder, src_mlf_1, FILES_NUMBER,
+                                      &recognition_res, NULL);
+    CU_ASSERT_FALSE(is_ok);
+
+    decoder_destroy(&decoder);
+}
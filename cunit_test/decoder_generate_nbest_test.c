@@ -0,0 +1,389 @@
+#include <float.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <CUnit/Basic.h>
+#include <CUnit/CUnit.h>
+
+#include "../bond005_lvcsr_lib.h"
+#include "decoder_generate_nbest_test.h"
+
+#define FILES_NUMBER 1
+#define INP_MLF_PART_NAME "test_record.lab"
+#define REC_MLF_PART_NAME "test_record.rec"
+#define NBEST_SIZE 3
+#define PHONEMES_VOCABULARY_SIZE 4
+#define WORDS_VOCABULARY_SIZE 3
+
+static float confusion_penalties[] = {
+    0.95, 0.02, 0.02, 0.01,
+    0.03, 0.80, 0.05, 0.12,
+    0.05, 0.12, 0.75, 0.08,
+    0.04, 0.04, 0.11, 0.81
+};
+static TLinearWordsLexicon *words_lexicon = NULL;
+static TCompiledLanguageModel language_model;
+static float lambda = 1.0;
+static TMLFFilePart *src_mlf_1 = NULL, *src_mlf_2 = NULL;
+static TDecoderModels models;
+static TDecoderParameters parameters;
+
+/* This function checks the N-best list: it must have the given name and the
+ * given best words sequence, its hypotheses must be different, and they must
+ * be sorted by descending of their scores. */
+static int check_nbest_list(TNBestList nbest_list, char *name,
+                            int best_words[], int best_words_number)
+{
+    int i, j, k, is_same;
+    TWordsHypothesis *hypotheses = nbest_list.hypotheses;
+
+    if ((nbest_list.name == NULL) || (hypotheses == NULL))
+    {
+        return 0;
+    }
+    if (strcmp(nbest_list.name, name) != 0)
+    {
+        return 0;
+    }
+    if ((nbest_list.hypotheses_number < 1)
+            || (nbest_list.hypotheses_number > NBEST_SIZE))
+    {
+        return 0;
+    }
+    if (hypotheses[0].words_number != best_words_number)
+    {
+        return 0;
+    }
+    for (k = 0; k < best_words_number; k++)
+    {
+        if (hypotheses[0].words[k].node_data != best_words[k])
+        {
+            return 0;
+        }
+    }
+    for (i = 1; i < nbest_list.hypotheses_number; i++)
+    {
+        if (hypotheses[i].score > hypotheses[i-1].score)
+        {
+            return 0;
+        }
+        for (j = 0; j < i; j++)
+        {
+            if (hypotheses[i].words_number != hypotheses[j].words_number)
+            {
+                continue;
+            }
+            is_same = 1;
+            for (k = 0; k < hypotheses[i].words_number; k++)
+            {
+                if (hypotheses[i].words[k].node_data
+                        != hypotheses[j].words[k].node_data)
+                {
+                    is_same = 0;
+                    break;
+                }
+            }
+            if (is_same)
+            {
+                return 0;
+            }
+        }
+    }
+
+    return 1;
+}
+
+int prepare_for_testing_of_decoder_generate_nbest()
+{
+    CU_pSuite pSuite = NULL;
+
+    pSuite = CU_add_suite("Test suite for decoder_generate_nbest()",
+                          init_suite_decoder_generate_nbest,
+                          clean_suite_decoder_generate_nbest);
+    if (NULL == pSuite)
+    {
+        CU_cleanup_registry();
+        return 0;
+    }
+
+    if ((NULL == CU_add_test(pSuite, "Valid partition 1",
+                             decoder_generate_nbest_valid_test_1))
+            || (NULL == CU_add_test(pSuite, "Valid partition 2",
+                                    decoder_generate_nbest_valid_test_2))
+            || (NULL == CU_add_test(pSuite, "Invalid partitions",
+                                    decoder_generate_nbest_invalid_test_1)))
+    {
+        CU_cleanup_registry();
+        return 0;
+    }
+
+    return 1;
+}
+
+int init_suite_decoder_generate_nbest()
+{
+    int i, n;
+    TLanguageModel source_model;
+
+    for (i = 0; i < (PHONEMES_VOCABULARY_SIZE * PHONEMES_VOCABULARY_SIZE); i++)
+    {
+        if (confusion_penalties[i] > 0.0)
+        {
+            confusion_penalties[i] = log10(confusion_penalties[i]);
+        }
+        else
+        {
+            confusion_penalties[i] = -FLT_MAX;
+        }
+    }
+
+    words_lexicon = malloc(WORDS_VOCABULARY_SIZE*sizeof(TLinearWordsLexicon));
+    words_lexicon[0].word_index = 0;
+    words_lexicon[0].phonemes_number = 2 + 1;
+    words_lexicon[0].phonemes_indexes = malloc((2 + 1) * sizeof(int));
+    words_lexicon[0].phonemes_indexes[0] = 1;
+    words_lexicon[0].phonemes_indexes[1] = 2;
+    words_lexicon[0].phonemes_indexes[2] = 0;
+    words_lexicon[1].word_index = 1;
+    words_lexicon[1].phonemes_number = 2 + 1;
+    words_lexicon[1].phonemes_indexes = malloc((2 + 1) * sizeof(int));
+    words_lexicon[1].phonemes_indexes[0] = 3;
+    words_lexicon[1].phonemes_indexes[1] = 2;
+    words_lexicon[1].phonemes_indexes[2] = 0;
+    words_lexicon[2].word_index = 2;
+    words_lexicon[2].phonemes_number = 3 + 1;
+    words_lexicon[2].phonemes_indexes = malloc((3 + 1) * sizeof(int));
+    words_lexicon[2].phonemes_indexes[0] = 2;
+    words_lexicon[2].phonemes_indexes[1] = 3;
+    words_lexicon[2].phonemes_indexes[2] = 1;
+    words_lexicon[2].phonemes_indexes[3] = 0;
+
+    source_model.unigrams_number = 3;
+    source_model.unigrams_probabilities = malloc(3*sizeof(float));
+    source_model.unigrams_probabilities[0] = 0.4;
+    source_model.unigrams_probabilities[1] = 0.25;
+    source_model.unigrams_probabilities[2] = 0.35;
+    source_model.bigrams = malloc(3*sizeof(TWordBigram));
+    source_model.bigrams[0].begins_number = 2;
+    source_model.bigrams[0].begins = malloc(2*sizeof(TWordBigramBegin));
+    //1->0
+    source_model.bigrams[0].begins[0].word_i = 1;
+    source_model.bigrams[0].begins[0].probability = 0.5;
+    //2->0
+    source_model.bigrams[0].begins[1].word_i = 2;
+    source_model.bigrams[0].begins[1].probability = 0.1;
+    source_model.bigrams[1].begins_number = 2;
+    source_model.bigrams[1].begins = malloc(2*sizeof(TWordBigramBegin));
+    //0->1
+    source_model.bigrams[1].begins[0].word_i = 0;
+    source_model.bigrams[1].begins[0].probability = 0.2;
+    //2->1
+    source_model.bigrams[1].begins[1].word_i = 2;
+    source_model.bigrams[1].begins[1].probability = 0.9;
+    source_model.bigrams[2].begins_number = 2;
+    source_model.bigrams[2].begins = malloc(2*sizeof(TWordBigramBegin));
+    //0->2
+    source_model.bigrams[2].begins[0].word_i = 0;
+    source_model.bigrams[2].begins[0].probability = 0.8;
+    //1->2
+    source_model.bigrams[2].begins[1].word_i = 1;
+    source_model.bigrams[2].begins[1].probability = 0.5;
+    compile_language_model(source_model, lambda, &language_model);
+    free_language_model(&source_model);
+
+    models.phonemes_vocabulary_size = PHONEMES_VOCABULARY_SIZE;
+    models.confusion_penalties_matrix = confusion_penalties;
+    models.words_lexicon = words_lexicon;
+    models.words_lexicon_size = WORDS_VOCABULARY_SIZE;
+    models.words_tree_root = NULL;
+    models.language_model = language_model;
+    parameters = decoder_get_default_parameters();
+
+    n = strlen(INP_MLF_PART_NAME);
+    src_mlf_1 = malloc(sizeof(TMLFFilePart));
+    src_mlf_1[0].name = malloc((n+1) * sizeof(char));
+    memset(src_mlf_1[0].name, 0, (n+1) * sizeof(char));
+    strcpy(src_mlf_1[0].name, INP_MLF_PART_NAME);
+    src_mlf_1[0].transcription_size = 7;
+    src_mlf_1[0].transcription = malloc(7*sizeof(TTranscriptionNode));
+    src_mlf_1[0].transcription[0].start_time = 0;
+    src_mlf_1[0].transcription[0].end_time = 100000000;
+    src_mlf_1[0].transcription[0].node_data = 0;
+    src_mlf_1[0].transcription[0].probability = 0.9;
+    src_mlf_1[0].transcription[1].start_time = 100000000;
+    src_mlf_1[0].transcription[1].end_time = 150000000;
+    src_mlf_1[0].transcription[1].node_data = 1;
+    src_mlf_1[0].transcription[1].probability = 0.8;
+    src_mlf_1[0].transcription[2].start_time = 150000000;
+    src_mlf_1[0].transcription[2].end_time = 160000000;
+    src_mlf_1[0].transcription[2].node_data = 3;
+    src_mlf_1[0].transcription[2].probability = 0.6;
+    src_mlf_1[0].transcription[3].start_time = 160000000;
+    src_mlf_1[0].transcription[3].end_time = 190000000;
+    src_mlf_1[0].transcription[3].node_data = 2;
+    src_mlf_1[0].transcription[3].probability = 0.75;
+    src_mlf_1[0].transcription[4].start_time = 190000000;
+    src_mlf_1[0].transcription[4].end_time = 240000000;
+    src_mlf_1[0].transcription[4].node_data = 3;
+    src_mlf_1[0].transcription[4].probability = 0.9;
+    src_mlf_1[0].transcription[5].start_time = 240000000;
+    src_mlf_1[0].transcription[5].end_time = 260000000;
+    src_mlf_1[0].transcription[5].node_data = 1;
+    src_mlf_1[0].transcription[5].probability = 0.7;
+    src_mlf_1[0].transcription[6].start_time = 260000000;
+    src_mlf_1[0].transcription[6].end_time = 300000000;
+    src_mlf_1[0].transcription[6].node_data = 0;
+    src_mlf_1[0].transcription[6].probability = 0.9;
+
+    n = strlen(INP_MLF_PART_NAME);
+    src_mlf_2 = malloc(sizeof(TMLFFilePart));
+    src_mlf_2[0].name = malloc((n+1) * sizeof(char));
+    memset(src_mlf_2[0].name, 0, (n+1) * sizeof(char));
+    strcpy(src_mlf_2[0].name, INP_MLF_PART_NAME);
+    src_mlf_2[0].transcription_size = 9;
+    src_mlf_2[0].transcription = malloc(9*sizeof(TTranscriptionNode));
+    src_mlf_2[0].transcription[0].start_time = 0;
+    src_mlf_2[0].transcription[0].end_time = 100000000;
+    src_mlf_2[0].transcription[0].node_data = 0;
+    src_mlf_2[0].transcription[0].probability = 0.9;
+    src_mlf_2[0].transcription[1].start_time = 100000000;
+    src_mlf_2[0].transcription[1].end_time = 150000000;
+    src_mlf_2[0].transcription[1].node_data = 1;
+    src_mlf_2[0].transcription[1].probability = 0.8;
+    src_mlf_2[0].transcription[2].start_time = 150000000;
+    src_mlf_2[0].transcription[2].end_time = 160000000;
+    src_mlf_2[0].transcription[2].node_data = 3;
+    src_mlf_2[0].transcription[2].probability = 0.6;
+    src_mlf_2[0].transcription[3].start_time = 160000000;
+    src_mlf_2[0].transcription[3].end_time = 190000000;
+    src_mlf_2[0].transcription[3].node_data = 2;
+    src_mlf_2[0].transcription[3].probability = 0.75;
+    src_mlf_2[0].transcription[4].start_time = 190000000;
+    src_mlf_2[0].transcription[4].end_time = 280000000;
+    src_mlf_2[0].transcription[4].node_data = 0;
+    src_mlf_2[0].transcription[4].probability = 0.97;
+    src_mlf_2[0].transcription[5].start_time = 280000000;
+    src_mlf_2[0].transcription[5].end_time = 300000000;
+    src_mlf_2[0].transcription[5].node_data = 2;
+    src_mlf_2[0].transcription[5].probability = 0.83;
+    src_mlf_2[0].transcription[6].start_time = 300000000;
+    src_mlf_2[0].transcription[6].end_time = 350000000;
+    src_mlf_2[0].transcription[6].node_data = 3;
+    src_mlf_2[0].transcription[6].probability = 0.9;
+    src_mlf_2[0].transcription[7].start_time = 350000000;
+    src_mlf_2[0].transcription[7].end_time = 370000000;
+    src_mlf_2[0].transcription[7].node_data = 1;
+    src_mlf_2[0].transcription[7].probability = 0.7;
+    src_mlf_2[0].transcription[8].start_time = 370000000;
+    src_mlf_2[0].transcription[8].end_time = 410000000;
+    src_mlf_2[0].transcription[8].node_data = 0;
+    src_mlf_2[0].transcription[8].probability = 0.9;
+
+    return 0;
+}
+
+int clean_suite_decoder_generate_nbest()
+{
+    free_compiled_language_model(&language_model);
+    free_linear_words_lexicon(&words_lexicon, WORDS_VOCABULARY_SIZE);
+    free_MLF(&src_mlf_1, FILES_NUMBER);
+    free_MLF(&src_mlf_2, FILES_NUMBER);
+    return 0;
+}
+
+void decoder_generate_nbest_valid_test_1()
+{
+    TNBestList *nbest_lists = NULL;
+    PDecoder decoder = NULL;
+    int best_words[] = { 0, 2 };
+    int is_ok = 0, is_correct_1 = 0, is_correct_2 = 0;
+
+    decoder = decoder_create(models, parameters);
+    CU_ASSERT_PTR_NOT_NULL_FATAL(decoder);
+
+    is_ok = decoder_generate_nbest(decoder, src_mlf_1, FILES_NUMBER,
+                                   NBEST_SIZE, &nbest_lists);
+    if (is_ok)
+    {
+        is_correct_1 = check_nbest_list(nbest_lists[0], REC_MLF_PART_NAME,
+                                        best_words, 2);
+        free_nbest_lists(&nbest_lists, FILES_NUMBER);
+        is_ok = decoder_generate_nbest(decoder, src_mlf_2, FILES_NUMBER,
+                                       NBEST_SIZE, &nbest_lists);
+    }
+    if (is_ok)
+    {
+        is_correct_2 = check_nbest_list(nbest_lists[0], REC_MLF_PART_NAME,
+                                        best_words, 2);
+        free_nbest_lists(&nbest_lists, FILES_NUMBER);
+    }
+    decoder_destroy(&decoder);
+
+    CU_ASSERT_TRUE_FATAL(is_ok);
+    CU_ASSERT_TRUE_FATAL(is_correct_1);
+    CU_ASSERT_TRUE_FATAL(is_correct_2);
+    CU_ASSERT_PTR_NULL_FATAL(nbest_lists);
+}
+
+void decoder_generate_nbest_valid_test_2()
+{
+    TMLFFilePart src_mlf[2];
+    TNBestList *nbest_lists = NULL;
+    TDecoderParameters parallel_parameters = parameters;
+    PDecoder decoder = NULL;
+    int best_words[] = { 0, 2 };
+    int is_ok = 0, is_correct_1 = 0, is_correct_2 = 0;
+
+    parallel_parameters.threads_number = 2;
+    decoder = decoder_create(models, parallel_parameters);
+    CU_ASSERT_PTR_NOT_NULL_FATAL(decoder);
+
+    src_mlf[0] = src_mlf_2[0];
+    src_mlf[1] = src_mlf_1[0];
+    is_ok = decoder_generate_nbest(decoder, src_mlf, 2, NBEST_SIZE,
+                                   &nbest_lists);
+    if (is_ok)
+    {
+        is_correct_1 = check_nbest_list(nbest_lists[0], REC_MLF_PART_NAME,
+                                        best_words, 2);
+        is_correct_2 = check_nbest_list(nbest_lists[1], REC_MLF_PART_NAME,
+                                        best_words, 2);
+        free_nbest_lists(&nbest_lists, 2);
+    }
+    decoder_destroy(&decoder);
+
+    CU_ASSERT_TRUE_FATAL(is_ok);
+    CU_ASSERT_TRUE_FATAL(is_correct_1);
+    CU_ASSERT_TRUE_FATAL(is_correct_2);
+}
+
+void decoder_generate_nbest_invalid_test_1()
+{
+    TNBestList *nbest_lists = NULL;
+    PDecoder decoder = decoder_create(models, parameters);
+    int is_ok = 1;
+
+    CU_ASSERT_PTR_NOT_NULL_FATAL(decoder);
+
+    is_ok = decoder_generate_nbest(NULL, src_mlf_1, FILES_NUMBER, NBEST_SIZE,
+                                   &nbest_lists);
+    CU_ASSERT_FALSE(is_ok);
+
+    is_ok = decoder_generate_nbest(decoder, NULL, FILES_NUMBER, NBEST_SIZE,
+                                   &nbest_lists);
+    CU_ASSERT_FALSE(is_ok);
+
+    is_ok = decoder_generate_nbest(decoder, src_mlf_1, 0, NBEST_SIZE,
+                                   &nbest_lists);
+    CU_ASSERT_FALSE(is_ok);
+
+    is_ok = decoder_generate_nbest(decoder, src_mlf_1, FILES_NUMBER, 0,
+                                   &nbest_lists);
+    CU_ASSERT_FALSE(is_ok);
+
+    is_ok = decoder_generate_nbest(decoder, src_mlf_1, FILES_NUMBER,
+                                   NBEST_SIZE, NULL);
+    CU_ASSERT_FALSE(is_ok);
+
+    decoder_destroy(&decoder);
+}
@@ -0,0 +1,11 @@
+#ifndef DECODER_GENERATE_NBEST_TEST_H
+#define DECODER_GENERATE_NBEST_TEST_H
+
+int prepare_for_testing_of_decoder_generate_nbest();
+int init_suite_decoder_generate_nbest();
+int clean_suite_decoder_generate_nbest();
+void decoder_generate_nbest_valid_test_1();
+void decoder_generate_nbest_valid_test_2();
+void decoder_generate_nbest_invalid_test_1();
+
+#endif // DECODER_GENERATE_NBEST_TEST_H
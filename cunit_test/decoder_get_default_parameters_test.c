@@ -0,0 +1,136 @@
+#include <float.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <CUnit/Basic.h>
+#include <CUnit/CUnit.h>
+
+#include "../bond005_lvcsr_lib.h"
+#include "decoder_get_default_parameters_test.h"
+
+#define PHONEMES_VOCABULARY_SIZE 4
+#define WORDS_VOCABULARY_SIZE 2
+
+static float confusion_penalties[] = {
+    0.95, 0.02, 0.02, 0.01,
+    0.03, 0.80, 0.05, 0.12,
+    0.05, 0.12, 0.75, 0.08,
+    0.04, 0.04, 0.11, 0.81
+};
+static int word_0[] = {1, 2, 0};
+static int word_1[] = {3, 2, 0};
+static TLinearWordsLexicon words_lexicon[WORDS_VOCABULARY_SIZE];
+static TCompiledLanguageModel language_model;
+static TDecoderModels models;
+
+int prepare_for_testing_of_decoder_get_default_parameters()
+{
+    CU_pSuite pSuite = NULL;
+
+    pSuite = CU_add_suite("Test suite for decoder_get_default_parameters()",
+                          init_suite_decoder_get_default_parameters,
+                          clean_suite_decoder_get_default_parameters);
+    if (NULL == pSuite)
+    {
+        CU_cleanup_registry();
+        return 0;
+    }
+
+    if ((NULL == CU_add_test(pSuite, "Valid partition 1",
+                             decoder_get_default_parameters_valid_test_1))
+            || (NULL == CU_add_test(pSuite, "Valid partition 2",
+                                    decoder_get_default_parameters_valid_test_2)))
+    {
+        CU_cleanup_registry();
+        return 0;
+    }
+
+    return 1;
+}
+
+int init_suite_decoder_get_default_parameters()
+{
+    int i;
+    TLanguageModel source_model;
+
+    for (i = 0; i < (PHONEMES_VOCABULARY_SIZE * PHONEMES_VOCABULARY_SIZE); i++)
+    {
+        if (confusion_penalties[i] > 0.0)
+        {
+            confusion_penalties[i] = log10(confusion_penalties[i]);
+        }
+        else
+        {
+            confusion_penalties[i] = -FLT_MAX;
+        }
+    }
+
+    words_lexicon[0].word_index = 0;
+    words_lexicon[0].phonemes_number = 3;
+    words_lexicon[0].phonemes_indexes = word_0;
+    words_lexicon[1].word_index = 1;
+    words_lexicon[1].phonemes_number = 3;
+    words_lexicon[1].phonemes_indexes = word_1;
+
+    source_model.unigrams_number = 2;
+    source_model.unigrams_probabilities = malloc(2*sizeof(float));
+    source_model.unigrams_probabilities[0] = 0.4;
+    source_model.unigrams_probabilities[1] = 0.6;
+    source_model.bigrams = malloc(2*sizeof(TWordBigram));
+    source_model.bigrams[0].begins_number = 0;
+    source_model.bigrams[0].begins = NULL;
+    source_model.bigrams[1].begins_number = 0;
+    source_model.bigrams[1].begins = NULL;
+    compile_language_model(source_model, 1.0, &language_model);
+    free_language_model(&source_model);
+
+    models.phonemes_vocabulary_size = PHONEMES_VOCABULARY_SIZE;
+    models.confusion_penalties_matrix = confusion_penalties;
+    models.words_lexicon = words_lexicon;
+    models.words_lexicon_size = WORDS_VOCABULARY_SIZE;
+    models.words_tree_root = NULL;
+    models.language_model = language_model;
+
+    return 0;
+}
+
+int clean_suite_decoder_get_default_parameters()
+{
+    free_compiled_language_model(&language_model);
+    return 0;
+}
+
+void decoder_get_default_parameters_valid_test_1()
+{
+    TDecoderParameters parameters = decoder_get_default_parameters();
+
+    CU_ASSERT_DOUBLE_EQUAL(parameters.pruning_coeff, 0.0, FLT_EPSILON);
+    CU_ASSERT_EQUAL(parameters.histogram_size, DEFAULT_HISTOGRAM_SIZE);
+    CU_ASSERT_DOUBLE_EQUAL(parameters.beam_width, 0.0, FLT_EPSILON);
+    CU_ASSERT_EQUAL(parameters.max_active_hypotheses, 0);
+    CU_ASSERT_DOUBLE_EQUAL(parameters.word_end_beam, 0.0, FLT_EPSILON);
+    CU_ASSERT_DOUBLE_EQUAL(parameters.lattice_beam, 0.0, FLT_EPSILON);
+    CU_ASSERT_EQUAL(parameters.lattice_size, DEFAULT_LATTICE_SIZE);
+    CU_ASSERT_EQUAL(parameters.threads_number, 1);
+    CU_ASSERT_DOUBLE_EQUAL(parameters.frame_duration, DEFAULT_FRAME_DURATION,
+                           FLT_EPSILON);
+    CU_ASSERT_EQUAL(parameters.max_repeats_of_phoneme,
+                    DEFAULT_MAX_REPEATS_OF_PHONEME);
+    CU_ASSERT_EQUAL(parameters.use_segments, 0);
+    CU_ASSERT_EQUAL(parameters.max_emission_table_size,
+                    DEFAULT_MAX_EMISSION_TABLE_SIZE);
+    CU_ASSERT_EQUAL(parameters.fixed_point_bits, 0);
+    CU_ASSERT_EQUAL(parameters.use_lm_lookahead, 0);
+    CU_ASSERT_EQUAL(parameters.fast_match_depth, DEFAULT_FAST_MATCH_DEPTH);
+    CU_ASSERT_EQUAL(parameters.fast_match_size, 0);
+}
+
+void decoder_get_default_parameters_valid_test_2()
+{
+    PDecoder decoder = NULL;
+
+    decoder = decoder_create(models, decoder_get_default_parameters());
+    CU_ASSERT_PTR_NOT_NULL_FATAL(decoder);
+    decoder_destroy(&decoder);
+    CU_ASSERT_PTR_NULL_FATAL(decoder);
+}
@@ -0,0 +1,10 @@
+#ifndef DECODER_GET_DEFAULT_PARAMETERS_TEST_H
+#define DECODER_GET_DEFAULT_PARAMETERS_TEST_H
+
+int prepare_for_testing_of_decoder_get_default_parameters();
+int init_suite_decoder_get_default_parameters();
+int clean_suite_decoder_get_default_parameters();
+void decoder_get_default_parameters_valid_test_1();
+void decoder_get_default_parameters_valid_test_2();
+
+#endif // DECODER_GET_DEFAULT_PARAMETERS_TEST_H
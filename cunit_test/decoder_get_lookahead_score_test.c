@@ -0,0 +1,179 @@
+#include <float.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <CUnit/Basic.h>
+#include <CUnit/CUnit.h>
+
+#include "../bond005_lvcsr_lib.h"
+#include "decoder_get_lookahead_score_test.h"
+
+#define PHONEMES_VOCABULARY_SIZE 4
+#define WORDS_VOCABULARY_SIZE 3
+
+static float confusion_penalties[] = {
+    0.95, 0.02, 0.02, 0.01,
+    0.03, 0.80, 0.05, 0.12,
+    0.05, 0.12, 0.75, 0.08,
+    0.04, 0.04, 0.11, 0.81
+};
+static int word_0[] = {1, 2};
+static int word_1[] = {1, 3};
+static int word_2[] = {2, 3, 1};
+static PWordsTreeNode words_tree = NULL;
+static TCompiledLanguageModel language_model;
+static float lambda = 0.5;
+static TDecoderModels models;
+static TDecoderParameters parameters;
+
+int prepare_for_testing_of_decoder_get_lookahead_score()
+{
+    CU_pSuite pSuite = NULL;
+
+    pSuite = CU_add_suite("Test suite for decoder_get_lookahead_score()",
+                          init_suite_decoder_get_lookahead_score,
+                          clean_suite_decoder_get_lookahead_score);
+    if (NULL == pSuite)
+    {
+        CU_cleanup_registry();
+        return 0;
+    }
+
+    if ((NULL == CU_add_test(pSuite, "Valid partition 1",
+                             decoder_get_lookahead_score_valid_test_1))
+            || (NULL == CU_add_test(pSuite, "Invalid partitions",
+                                    decoder_get_lookahead_score_invalid_test_1)))
+    {
+        CU_cleanup_registry();
+        return 0;
+    }
+
+    return 1;
+}
+
+int init_suite_decoder_get_lookahead_score()
+{
+    int i;
+    TLanguageModel source_model;
+
+    for (i = 0; i < (PHONEMES_VOCABULARY_SIZE * PHONEMES_VOCABULARY_SIZE); i++)
+    {
+        if (confusion_penalties[i] > 0.0)
+        {
+            confusion_penalties[i] = log10(confusion_penalties[i]);
+        }
+        else
+        {
+            confusion_penalties[i] = -FLT_MAX;
+        }
+    }
+
+    /* the first two words have the common first phoneme */
+    words_tree = malloc(sizeof(TWordsTreeNode));
+    words_tree->node_data = -1;
+    words_tree->node_type = INIT_NODE;
+    words_tree->number_of_next_nodes = 0;
+    words_tree->next_nodes = NULL;
+    add_word_to_words_tree(0, word_0, 2, words_tree);
+    add_word_to_words_tree(1, word_1, 2, words_tree);
+    add_word_to_words_tree(2, word_2, 3, words_tree);
+
+    source_model.unigrams_number = 3;
+    source_model.unigrams_probabilities = malloc(3*sizeof(float));
+    source_model.unigrams_probabilities[0] = 0.15;
+    source_model.unigrams_probabilities[1] = 0.25;
+    source_model.unigrams_probabilities[2] = 0.6;
+    source_model.bigrams = malloc(3*sizeof(TWordBigram));
+    source_model.bigrams[0].begins_number = 1;
+    source_model.bigrams[0].begins = malloc(1*sizeof(TWordBigramBegin));
+    //2->0
+    source_model.bigrams[0].begins[0].word_i = 2;
+    source_model.bigrams[0].begins[0].probability = 0.9;
+    source_model.bigrams[1].begins_number = 0;
+    source_model.bigrams[1].begins = NULL;
+    source_model.bigrams[2].begins_number = 0;
+    source_model.bigrams[2].begins = NULL;
+    compile_language_model(source_model, lambda, &language_model);
+    free_language_model(&source_model);
+
+    models.phonemes_vocabulary_size = PHONEMES_VOCABULARY_SIZE;
+    models.confusion_penalties_matrix = confusion_penalties;
+    models.words_lexicon = NULL;
+    models.words_lexicon_size = 0;
+    models.words_tree_root = words_tree;
+    models.language_model = language_model;
+    parameters = decoder_get_default_parameters();
+    parameters.use_lm_lookahead = 1;
+
+    return 0;
+}
+
+int clean_suite_decoder_get_lookahead_score()
+{
+    free_compiled_language_model(&language_model);
+    free_words_tree(&words_tree);
+    return 0;
+}
+
+void decoder_get_lookahead_score_valid_test_1()
+{
+    PDecoder decoder = decoder_create(models, parameters);
+    int prefix_1[] = {1}, prefix_2[] = {1, 3}, prefix_3[] = {2, 3};
+    float score_1 = 0.0, score_2 = 0.0, score_3 = 0.0;
+    int is_ok_1 = 0, is_ok_2 = 0, is_ok_3 = 0;
+
+    CU_ASSERT_PTR_NOT_NULL_FATAL(decoder);
+
+    /* the score of each node is the best score of words which are reachable
+       from it, and the bigram 2->0 doesn't take part in it */
+    is_ok_1 = decoder_get_lookahead_score(decoder, prefix_1, 1, &score_1);
+    is_ok_2 = decoder_get_lookahead_score(decoder, prefix_2, 2, &score_2);
+    is_ok_3 = decoder_get_lookahead_score(decoder, prefix_3, 2, &score_3);
+    decoder_destroy(&decoder);
+
+    CU_ASSERT_TRUE_FATAL(is_ok_1);
+    CU_ASSERT_TRUE_FATAL(is_ok_2);
+    CU_ASSERT_TRUE_FATAL(is_ok_3);
+    CU_ASSERT_DOUBLE_EQUAL(score_1, log10(0.5 * 0.25), FLT_EPSILON);
+    CU_ASSERT_DOUBLE_EQUAL(score_2, log10(0.5 * 0.25), FLT_EPSILON);
+    CU_ASSERT_DOUBLE_EQUAL(score_3, log10(0.5 * 0.6), FLT_EPSILON);
+}
+
+void decoder_get_lookahead_score_invalid_test_1()
+{
+    TDecoderParameters other_parameters = parameters;
+    PDecoder decoder = decoder_create(models, parameters);
+    PDecoder other_decoder = NULL;
+    int prefix[] = {1, 2}, long_prefix[] = {1, 2, 3}, unknown_prefix[] = {3};
+    float score = 0.0;
+    int is_ok = 1;
+
+    CU_ASSERT_PTR_NOT_NULL_FATAL(decoder);
+
+    is_ok = decoder_get_lookahead_score(NULL, prefix, 2, &score);
+    CU_ASSERT_FALSE(is_ok);
+
+    is_ok = decoder_get_lookahead_score(decoder, NULL, 2, &score);
+    CU_ASSERT_FALSE(is_ok);
+
+    is_ok = decoder_get_lookahead_score(decoder, prefix, 0, &score);
+    CU_ASSERT_FALSE(is_ok);
+
+    is_ok = decoder_get_lookahead_score(decoder, prefix, 2, NULL);
+    CU_ASSERT_FALSE(is_ok);
+
+    is_ok = decoder_get_lookahead_score(decoder, unknown_prefix, 1, &score);
+    CU_ASSERT_FALSE(is_ok);
+
+    is_ok = decoder_get_lookahead_score(decoder, long_prefix, 3, &score);
+    CU_ASSERT_FALSE(is_ok);
+
+    decoder_destroy(&decoder);
+
+    other_parameters.use_lm_lookahead = 0;
+    other_decoder = decoder_create(models, other_parameters);
+    CU_ASSERT_PTR_NOT_NULL_FATAL(other_decoder);
+    is_ok = decoder_get_lookahead_score(other_decoder, prefix, 2, &score);
+    CU_ASSERT_FALSE(is_ok);
+    decoder_destroy(&other_decoder);
+}
@@ -0,0 +1,10 @@
+#ifndef DECODER_GET_LOOKAHEAD_SCORE_TEST_H
+#define DECODER_GET_LOOKAHEAD_SCORE_TEST_H
+
+int prepare_for_testing_of_decoder_get_lookahead_score();
+int init_suite_decoder_get_lookahead_score();
+int clean_suite_decoder_get_lookahead_score();
+void decoder_get_lookahead_score_valid_test_1();
+void decoder_get_lookahead_score_invalid_test_1();
+
+#endif // DECODER_GET_LOOKAHEAD_SCORE_TEST_H
@@ -0,0 +1,11 @@
+#ifndef DECODER_GET_PARTIAL_RESULT_TEST_H
+#define DECODER_GET_PARTIAL_RESULT_TEST_H
+
+int prepare_for_testing_of_decoder_get_partial_result();
+int init_suite_decoder_get_partial_result();
+int clean_suite_decoder_get_partial_result();
+void decoder_get_partial_result_valid_test_1();
+void decoder_get_partial_result_valid_test_2();
+void decoder_get_partial_result_invalid_test_1();
+
+#endif // DECODER_GET_PARTIAL_RESULT_TEST_H
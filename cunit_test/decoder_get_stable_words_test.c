@@ -0,0 +1,310 @@
+#include <float.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <CUnit/Basic.h>
+#include <CUnit/CUnit.h>
+
+#include "../bond005_lvcsr_lib.h"
+#include "decoder_get_stable_words_test.h"
+
+#define FILES_NUMBER 1
+#define INP_MLF_PART_NAME "test_record.lab"
+#define PHONEMES_VOCABULARY_SIZE 4
+#define WORDS_VOCABULARY_SIZE 3
+#define PARTS_NUMBER 4
+
+static float confusion_penalties[] = {
+    0.95, 0.02, 0.02, 0.01,
+    0.03, 0.80, 0.05, 0.12,
+    0.05, 0.12, 0.75, 0.08,
+    0.04, 0.04, 0.11, 0.81
+};
+static TLinearWordsLexicon *words_lexicon = NULL;
+static TCompiledLanguageModel language_model;
+static float lambda = 1.0;
+static TMLFFilePart *src_mlf = NULL;
+static TDecoderModels models;
+static TDecoderParameters parameters;
+
+int prepare_for_testing_of_decoder_get_stable_words()
+{
+    CU_pSuite pSuite = NULL;
+
+    pSuite = CU_add_suite("Test suite for decoder_get_stable_words()",
+                          init_suite_decoder_get_stable_words,
+                          clean_suite_decoder_get_stable_words);
+    if (NULL == pSuite)
+    {
+        CU_cleanup_registry();
+        return 0;
+    }
+
+    if ((NULL == CU_add_test(pSuite, "Valid partition 1",
+                             decoder_get_stable_words_valid_test_1))
+            || (NULL == CU_add_test(pSuite, "Valid partition 2",
+                                    decoder_get_stable_words_valid_test_2))
+            || (NULL == CU_add_test(pSuite, "Invalid partitions",
+                                    decoder_get_stable_words_invalid_test_1)))
+    {
+        CU_cleanup_registry();
+        return 0;
+    }
+
+    return 1;
+}
+
+int init_suite_decoder_get_stable_words()
+{
+    int i, n;
+    TLanguageModel source_model;
+
+    for (i = 0; i < (PHONEMES_VOCABULARY_SIZE * PHONEMES_VOCABULARY_SIZE); i++)
+    {
+        if (confusion_penalties[i] > 0.0)
+        {
+            confusion_penalties[i] = log10(confusion_penalties[i]);
+        }
+        else
+        {
+            confusion_penalties[i] = -FLT_MAX;
+        }
+    }
+
+    words_lexicon = malloc(WORDS_VOCABULARY_SIZE*sizeof(TLinearWordsLexicon));
+    words_lexicon[0].word_index = 0;
+    words_lexicon[0].phonemes_number = 2 + 1;
+    words_lexicon[0].phonemes_indexes = malloc((2 + 1) * sizeof(int));
+    words_lexicon[0].phonemes_indexes[0] = 1;
+    words_lexicon[0].phonemes_indexes[1] = 2;
+    words_lexicon[0].phonemes_indexes[2] = 0;
+    words_lexicon[1].word_index = 1;
+    words_lexicon[1].phonemes_number = 2 + 1;
+    words_lexicon[1].phonemes_indexes = malloc((2 + 1) * sizeof(int));
+    words_lexicon[1].phonemes_indexes[0] = 3;
+    words_lexicon[1].phonemes_indexes[1] = 2;
+    words_lexicon[1].phonemes_indexes[2] = 0;
+    words_lexicon[2].word_index = 2;
+    words_lexicon[2].phonemes_number = 3 + 1;
+    words_lexicon[2].phonemes_indexes = malloc((3 + 1) * sizeof(int));
+    words_lexicon[2].phonemes_indexes[0] = 2;
+    words_lexicon[2].phonemes_indexes[1] = 3;
+    words_lexicon[2].phonemes_indexes[2] = 1;
+    words_lexicon[2].phonemes_indexes[3] = 0;
+
+    source_model.unigrams_number = 3;
+    source_model.unigrams_probabilities = malloc(3*sizeof(float));
+    source_model.unigrams_probabilities[0] = 0.4;
+    source_model.unigrams_probabilities[1] = 0.25;
+    source_model.unigrams_probabilities[2] = 0.35;
+    source_model.bigrams = malloc(3*sizeof(TWordBigram));
+    source_model.bigrams[0].begins_number = 2;
+    source_model.bigrams[0].begins = malloc(2*sizeof(TWordBigramBegin));
+    //1->0
+    source_model.bigrams[0].begins[0].word_i = 1;
+    source_model.bigrams[0].begins[0].probability = 0.5;
+    //2->0
+    source_model.bigrams[0].begins[1].word_i = 2;
+    source_model.bigrams[0].begins[1].probability = 0.1;
+    source_model.bigrams[1].begins_number = 2;
+    source_model.bigrams[1].begins = malloc(2*sizeof(TWordBigramBegin));
+    //0->1
+    source_model.bigrams[1].begins[0].word_i = 0;
+    source_model.bigrams[1].begins[0].probability = 0.2;
+    //2->1
+    source_model.bigrams[1].begins[1].word_i = 2;
+    source_model.bigrams[1].begins[1].probability = 0.9;
+    source_model.bigrams[2].begins_number = 2;
+    source_model.bigrams[2].begins = malloc(2*sizeof(TWordBigramBegin));
+    //0->2
+    source_model.bigrams[2].begins[0].word_i = 0;
+    source_model.bigrams[2].begins[0].probability = 0.8;
+    //1->2
+    source_model.bigrams[2].begins[1].word_i = 1;
+    source_model.bigrams[2].begins[1].probability = 0.5;
+    compile_language_model(source_model, lambda, &language_model);
+    free_language_model(&source_model);
+
+    models.phonemes_vocabulary_size = PHONEMES_VOCABULARY_SIZE;
+    models.confusion_penalties_matrix = confusion_penalties;
+    models.words_lexicon = words_lexicon;
+    models.words_lexicon_size = WORDS_VOCABULARY_SIZE;
+    models.words_tree_root = NULL;
+    models.language_model = language_model;
+    parameters = decoder_get_default_parameters();
+
+    n = strlen(INP_MLF_PART_NAME);
+    src_mlf = malloc(sizeof(TMLFFilePart));
+    src_mlf[0].name = malloc((n+1) * sizeof(char));
+    memset(src_mlf[0].name, 0, (n+1) * sizeof(char));
+    strcpy(src_mlf[0].name, INP_MLF_PART_NAME);
+    src_mlf[0].transcription_size = 9;
+    src_mlf[0].transcription = malloc(9*sizeof(TTranscriptionNode));
+    src_mlf[0].transcription[0].start_time = 0;
+    src_mlf[0].transcription[0].end_time = 100000000;
+    src_mlf[0].transcription[0].node_data = 0;
+    src_mlf[0].transcription[0].probability = 0.9;
+    src_mlf[0].transcription[1].start_time = 100000000;
+    src_mlf[0].transcription[1].end_time = 150000000;
+    src_mlf[0].transcription[1].node_data = 1;
+    src_mlf[0].transcription[1].probability = 0.8;
+    src_mlf[0].transcription[2].start_time = 150000000;
+    src_mlf[0].transcription[2].end_time = 160000000;
+    src_mlf[0].transcription[2].node_data = 3;
+    src_mlf[0].transcription[2].probability = 0.6;
+    src_mlf[0].transcription[3].start_time = 160000000;
+    src_mlf[0].transcription[3].end_time = 190000000;
+    src_mlf[0].transcription[3].node_data = 2;
+    src_mlf[0].transcription[3].probability = 0.75;
+    src_mlf[0].transcription[4].start_time = 190000000;
+    src_mlf[0].transcription[4].end_time = 280000000;
+    src_mlf[0].transcription[4].node_data = 0;
+    src_mlf[0].transcription[4].probability = 0.97;
+    src_mlf[0].transcription[5].start_time = 280000000;
+    src_mlf[0].transcription[5].end_time = 300000000;
+    src_mlf[0].transcription[5].node_data = 2;
+    src_mlf[0].transcription[5].probability = 0.83;
+    src_mlf[0].transcription[6].start_time = 300000000;
+    src_mlf[0].transcription[6].end_time = 350000000;
+    src_mlf[0].transcription[6].node_data = 3;
+    src_mlf[0].transcription[6].probability = 0.9;
+    src_mlf[0].transcription[7].start_time = 350000000;
+    src_mlf[0].transcription[7].end_time = 370000000;
+    src_mlf[0].transcription[7].node_data = 1;
+    src_mlf[0].transcription[7].probability = 0.7;
+    src_mlf[0].transcription[8].start_time = 370000000;
+    src_mlf[0].transcription[8].end_time = 410000000;
+    src_mlf[0].transcription[8].node_data = 0;
+    src_mlf[0].transcription[8].probability = 0.9;
+
+    return 0;
+}
+
+int clean_suite_decoder_get_stable_words()
+{
+    free_compiled_language_model(&language_model);
+    free_linear_words_lexicon(&words_lexicon, WORDS_VOCABULARY_SIZE);
+    free_MLF(&src_mlf, FILES_NUMBER);
+    return 0;
+}
+
+void decoder_get_stable_words_valid_test_1()
+{
+    TTranscriptionNode *words = NULL;
+    PDecoder decoder = decoder_create(models, parameters);
+    int is_ok = 0, words_number = -1;
+
+    CU_ASSERT_PTR_NOT_NULL_FATAL(decoder);
+
+    /* nothing is pushed, so there are no stable words */
+    is_ok = decoder_get_stable_words(decoder, &words, &words_number);
+    decoder_destroy(&decoder);
+
+    CU_ASSERT_TRUE_FATAL(is_ok);
+    CU_ASSERT_EQUAL_FATAL(words_number, 0);
+    CU_ASSERT_PTR_NULL_FATAL(words);
+}
+
+void decoder_get_stable_words_valid_test_2()
+{
+    TTranscriptionNode *words = NULL, *target_words = NULL;
+    PDecoder decoder = decoder_create(models, parameters);
+    PDecoder target_decoder = decoder_create(models, parameters);
+    int is_ok = 0, words_number = 0, target_words_number = 0;
+    int taken_words_number = 0, i, j, is_equal = 1;
+
+    CU_ASSERT_PTR_NOT_NULL_FATAL(decoder);
+    CU_ASSERT_PTR_NOT_NULL_FATAL(target_decoder);
+
+    /* the long utterance is recognized twice: without taking of stable words,
+       and with taking of them after each part of this utterance */
+    is_ok = 1;
+    for (i = 0; is_ok && (i < PARTS_NUMBER); i++)
+    {
+        is_ok = decoder_push(target_decoder, src_mlf[0].transcription,
+                             src_mlf[0].transcription_size);
+    }
+    if (is_ok)
+    {
+        is_ok = decoder_finalize(target_decoder, &target_words,
+                                 &target_words_number);
+    }
+    for (i = 0; is_ok && (i <= PARTS_NUMBER); i++)
+    {
+        if (i < PARTS_NUMBER)
+        {
+            is_ok = decoder_push(decoder, src_mlf[0].transcription,
+                                 src_mlf[0].transcription_size);
+            if (is_ok)
+            {
+                is_ok = decoder_get_stable_words(decoder, &words,
+                                                 &words_number);
+            }
+        }
+        else
+        {
+            is_ok = decoder_finalize(decoder, &words, &words_number);
+        }
+        if (!is_ok)
+        {
+            break;
+        }
+        for (j = 0; j < words_number; j++)
+        {
+            if ((taken_words_number >= target_words_number)
+                    || (words[j].node_data
+                        != target_words[taken_words_number].node_data))
+            {
+                is_equal = 0;
+            }
+            taken_words_number++;
+        }
+        if (words != NULL)
+        {
+            free(words);
+            words = NULL;
+        }
+        if (i == (PARTS_NUMBER - 1))
+        {
+            /* some words must be stable before the utterance end */
+            if (taken_words_number == 0)
+            {
+                is_equal = 0;
+            }
+        }
+    }
+    if (taken_words_number != target_words_number)
+    {
+        is_equal = 0;
+    }
+    if (target_words != NULL)
+    {
+        free(target_words);
+    }
+    decoder_destroy(&decoder);
+    decoder_destroy(&target_decoder);
+
+    CU_ASSERT_TRUE_FATAL(is_ok);
+    CU_ASSERT_TRUE_FATAL(target_words_number > 0);
+    CU_ASSERT_TRUE_FATAL(is_equal);
+}
+
+void decoder_get_stable_words_invalid_test_1()
+{
+    TTranscriptionNode *words = NULL;
+    PDecoder decoder = decoder_create(models, parameters);
+    int is_ok = 1, words_number = 0;
+
+    CU_ASSERT_PTR_NOT_NULL_FATAL(decoder);
+
+    is_ok = decoder_get_stable_words(NULL, &words, &words_number);
+    CU_ASSERT_FALSE(is_ok);
+
+    is_ok = decoder_get_stable_words(decoder, NULL, &words_number);
+    CU_ASSERT_FALSE(is_ok);
+
+    is_ok = decoder_get_stable_words(decoder, &words, NULL);
+    CU_ASSERT_FALSE(is_ok);
+
+    decoder_destroy(&decoder);
+}
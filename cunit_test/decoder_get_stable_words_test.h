@@ -0,0 +1,11 @@
+#ifndef DECODER_GET_STABLE_WORDS_TEST_H
+#define DECODER_GET_STABLE_WORDS_TEST_H
+
+int prepare_for_testing_of_decoder_get_stable_words();
+int init_suite_decoder_get_stable_words();
+int clean_suite_decoder_get_stable_words();
+void decoder_get_stable_words_valid_test_1();
+void decoder_get_stable_words_valid_test_2();
+void decoder_get_stable_words_invalid_test_1();
+
+#endif // DECODER_GET_STABLE_WORDS_TEST_H
@@ -0,0 +1,11 @@
+#ifndef DECODER_PUSH_TEST_H
+#define DECODER_PUSH_TEST_H
+
+int prepare_for_testing_of_decoder_push();
+int init_suite_decoder_push();
+int clean_suite_decoder_push();
+void decoder_push_valid_test_1();
+void decoder_push_valid_test_2();
+void decoder_push_invalid_test_1();
+
+#endif // DECODER_PUSH_TEST_H
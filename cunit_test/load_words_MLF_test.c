@@ -1,4 +1,5 @@
 #include <float.h>
+#include <math.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
@@ -15,6 +16,15 @@ static char *name_of_correct_MLF_file = "correct_words_data.mlf";
 static char *name_of_incorrect_MLF_file_1 = "incorrect_words_data1.mlf";
 static char *name_of_incorrect_MLF_file_2 = "incorrect_words_data2.mlf";
 static char *name_of_incorrect_MLF_file_3 = "incorrect_words_data3.mlf";
+static char *name_of_timed_MLF_file = "timed_words_data.mlf";
+static char *timed_MLF_text =
+        "#!MLF!#\n"
+        "\"timed_words.rec\"\n"
+        "0 500000 aaa -1.0000\n"
+        " 500000  1500000 ccc \n"
+        "bbb\n"
+        "1500000 2000000 jjj -0.5000 xyz\n"
+        ".\n";
 static TMLFFilePart *target_MLF = NULL;
 static int target_MLF_size = 3;
 static char *words_vocabulary[VOCABULARY_SIZE];
@@ -46,6 +56,7 @@ static int create_MLF_transcription(PTranscriptionNode *created_transcription)
         transcription[j].end_time = 0;
         transcription[j].node_data = rand() % VOCABULARY_SIZE;
         transcription[j].probability = 1.0;
+        transcription[j].score = 0.0;
     }
 
     return res;
@@ -253,6 +264,21 @@ static int create_incorrect_MLF_file_3()
     return res;
 }
 
+static int create_timed_MLF_file()
+{
+    FILE *MLF_file_handle = NULL;
+    int res = 0;
+
+    MLF_file_handle = fopen(name_of_timed_MLF_file, "w");
+    if (MLF_file_handle == NULL)
+    {
+        return 0;
+    }
+    res = (fprintf(MLF_file_handle, "%s", timed_MLF_text) > 0);
+    fclose(MLF_file_handle);
+    return res;
+}
+
 static int compare_two_MLF(TMLFFilePart *mlf1, int mlf1_size,
                            TMLFFilePart *mlf2, int mlf2_size)
 {
@@ -319,8 +345,8 @@ static int compare_two_MLF(TMLFFilePart *mlf1, int mlf1_size,
                     res = 0;
                     break;
                 }
-                if (fabs(mlf1[i].transcription[j].probability
-                         - mlf2[i].transcription[j].probability) > FLT_EPSILON)
+                if (fabs(mlf1[i].transcription[j].score
+                         - mlf2[i].transcription[j].score) > FLT_EPSILON)
                 {
                     res = 0;
                     break;
@@ -357,6 +383,8 @@ int prepare_for_testing_of_load_words_MLF()
                                     load_words_MLF_valid_test_3))
             || (NULL == CU_add_test(pSuite, "Valid partition 4",
                                     load_words_MLF_valid_test_4))
+            || (NULL == CU_add_test(pSuite, "Valid partition 5",
+                                    load_words_MLF_valid_test_5))
             || (NULL == CU_add_test(pSuite, "Invalid partitions",
                                     load_words_MLF_invalid_test_1)))
     {
@@ -372,7 +400,8 @@ int init_suite_load_words_MLF()
     create_words_vocabulary();
     create_target_MLF();
     if (create_correct_MLF_file() && create_incorrect_MLF_file_1()
-            && create_incorrect_MLF_file_2() && create_incorrect_MLF_file_3())
+            && create_incorrect_MLF_file_2() && create_incorrect_MLF_file_3()
+            && create_timed_MLF_file())
     {
         return 0;
     }
@@ -395,6 +424,7 @@ int clean_suite_load_words_MLF()
     remove(name_of_incorrect_MLF_file_1);
     remove(name_of_incorrect_MLF_file_2);
     remove(name_of_incorrect_MLF_file_3);
+    remove(name_of_timed_MLF_file);
     return 0;
 }
 
@@ -454,6 +484,38 @@ void load_words_MLF_valid_test_4()
     CU_ASSERT_TRUE_FATAL(is_null);
 }
 
+void load_words_MLF_valid_test_5()
+{
+    TMLFFilePart *data = NULL;
+    int data_size = 0, is_correct = 0;
+
+    data_size = load_words_MLF(name_of_timed_MLF_file, words_vocabulary,
+                               VOCABULARY_SIZE, &data);
+    if ((data_size == 1) && (data[0].transcription_size == 3))
+    {
+        is_correct = (strcmp(data[0].name, "timed_words.rec") == 0)
+                && (data[0].transcription[0].node_data == 0)
+                && (data[0].transcription[0].start_time == 0)
+                && (data[0].transcription[0].end_time == 500000)
+                && (fabs(data[0].transcription[0].score + 1.0)
+                    <= FLT_EPSILON)
+                && (data[0].transcription[1].node_data == 2)
+                && (data[0].transcription[1].start_time == 500000)
+                && (data[0].transcription[1].end_time == 1500000)
+                && (fabs(data[0].transcription[1].score)
+                    <= FLT_EPSILON)
+                && (data[0].transcription[2].node_data == 1)
+                && (data[0].transcription[2].start_time == 0)
+                && (data[0].transcription[2].end_time == 0)
+                && (fabs(data[0].transcription[2].score)
+                    <= FLT_EPSILON);
+    }
+    free_MLF(&data, data_size);
+
+    CU_ASSERT_EQUAL_FATAL(1, data_size);
+    CU_ASSERT_TRUE_FATAL(is_correct);
+}
+
 void load_words_MLF_invalid_test_1()
 {
     TMLFFilePart *data = NULL;
@@ -8,6 +8,7 @@ void load_words_MLF_valid_test_1();
 void load_words_MLF_valid_test_2();
 void load_words_MLF_valid_test_3();
 void load_words_MLF_valid_test_4();
+void load_words_MLF_valid_test_5();
 void load_words_MLF_invalid_test_1();
 
 #endif // LOAD_WORDS_MLF_TEST_H
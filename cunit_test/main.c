@@ -8,6 +8,17 @@
 #include "create_words_vocabulary_tree_test.h"
 #include "find_in_vocabulary_test.h"
 #include "get_bigram_probability_test.h"
+#include "compile_language_model_test.h"
+#include "decoder_create_test.h"
+#include "decoder_decode_test.h"
+#include "decoder_generate_lattices_test.h"
+#include "decoder_generate_nbest_test.h"
+#include "decoder_get_stable_words_test.h"
+#include "decoder_get_lookahead_score_test.h"
+#include "decoder_get_default_parameters_test.h"
+#include "decoder_finalize_test.h"
+#include "decoder_get_partial_result_test.h"
+#include "decoder_push_test.h"
 #include "load_language_model_test.h"
 #include "load_phonemes_MLF_test.h"
 #include "load_phonemes_vocabulary_test.h"
@@ -17,7 +28,10 @@
 #include "prepare_filename_test.h"
 #include "read_string_test.h"
 #include "recognize_words_test.h"
+#include "recognize_words_by_words_tree_test.h"
 #include "save_language_model_test.h"
+#include "save_nbest_MLF_test.h"
+#include "save_word_lattice_test.h"
 #include "save_words_MLF_test.h"
 #include "select_word_and_transcription_test.h"
 #include "string_to_transcription_node_test.h"
@@ -102,6 +116,10 @@ int main()
     {
         return CU_get_error();
     }
+    if (!prepare_for_testing_of_compile_language_model())
+    {
+        return CU_get_error();
+    }
     if (!prepare_for_testing_of_calculate_language_model())
     {
         return CU_get_error();
@@ -114,6 +132,58 @@ int main()
     {
         return CU_get_error();
     }
+    if (!prepare_for_testing_of_recognize_words_by_words_tree())
+    {
+        return CU_get_error();
+    }
+    if (!prepare_for_testing_of_decoder_create())
+    {
+        return CU_get_error();
+    }
+    if (!prepare_for_testing_of_decoder_decode())
+    {
+        return CU_get_error();
+    }
+    if (!prepare_for_testing_of_decoder_generate_lattices())
+    {
+        return CU_get_error();
+    }
+    if (!prepare_for_testing_of_save_word_lattice())
+    {
+        return CU_get_error();
+    }
+    if (!prepare_for_testing_of_decoder_generate_nbest())
+    {
+        return CU_get_error();
+    }
+    if (!prepare_for_testing_of_save_nbest_MLF())
+    {
+        return CU_get_error();
+    }
+    if (!prepare_for_testing_of_decoder_push())
+    {
+        return CU_get_error();
+    }
+    if (!prepare_for_testing_of_decoder_get_partial_result())
+    {
+        return CU_get_error();
+    }
+    if (!prepare_for_testing_of_decoder_get_stable_words())
+    {
+        return CU_get_error();
+    }
+    if (!prepare_for_testing_of_decoder_finalize())
+    {
+        return CU_get_error();
+    }
+    if (!prepare_for_testing_of_decoder_get_lookahead_score())
+    {
+        return CU_get_error();
+    }
+    if (!prepare_for_testing_of_decoder_get_default_parameters())
+    {
+        return CU_get_error();
+    }
 
     CU_basic_set_mode(CU_BRM_VERBOSE);
     CU_basic_run_tests();
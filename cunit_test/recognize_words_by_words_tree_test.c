@@ -0,0 +1,569 @@
+#include <float.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <CUnit/Basic.h>
+#include <CUnit/CUnit.h>
+
+#include "../bond005_lvcsr_lib.h"
+#include "recognize_words_by_words_tree_test.h"
+
+#define FILES_NUMBER 1
+#define INP_MLF_PART_NAME "test_record.lab"
+#define REC_MLF_PART_NAME "test_record.rec"
+#define PHONEMES_VOCABULARY_SIZE 4
+#define SCORE_EPSILON 1e-5
+
+static float confusion_penalties[] = {
+    0.95, 0.02, 0.02, 0.01,
+    0.03, 0.80, 0.05, 0.12,
+    0.05, 0.12, 0.75, 0.08,
+    0.04, 0.04, 0.11, 0.81
+};
+static int word_0[] = {1, 2};
+static int word_1[] = {3, 2};
+static int word_2[] = {2, 3, 1};
+static PWordsTreeNode words_tree = NULL;
+static TCompiledLanguageModel language_model;
+static float lambda = 1.0;
+static int threads_number = 1;
+static int incorrect_threads_number = 0;
+static float pruning_coeff = 0.0;
+static int histogram_size = DEFAULT_HISTOGRAM_SIZE;
+static int incorrect_histogram_size = 1;
+static float beam_width = 0.0;
+static float incorrect_beam_width = -1.0;
+static int max_active_hypotheses = 0;
+static int incorrect_max_active_hypotheses = -1;
+static float word_end_beam = 0.0;
+static float incorrect_word_end_beam = -1.0;
+static float incorrect_pruning_coeff_1 = -1.0;
+static float incorrect_pruning_coeff_2 = 1.5;
+static TMLFFilePart *src_mlf_1 = NULL, *src_mlf_2 = NULL;
+static TMLFFilePart *target_res_mlf = NULL;
+
+static int compare_two_MLF(TMLFFilePart *mlf1, int mlf1_size,
+                           TMLFFilePart *mlf2, int mlf2_size)
+{
+    int i, j, res = 1;
+
+    if (mlf1_size != mlf2_size)
+    {
+        return 0;
+    }
+    if (mlf1_size < 0)
+    {
+        return 0;
+    }
+    if (mlf1_size == 0)
+    {
+        return 1;
+    }
+    if ((mlf1 == NULL) || (mlf2 == NULL))
+    {
+        return 0;
+    }
+
+    for (i = 0; i < mlf1_size; i++)
+    {
+        if ((mlf1[i].name == NULL) || (mlf2[i].name == NULL))
+        {
+            res = 0;
+            break;
+        }
+        if (strcmp(mlf1[i].name, mlf2[i].name) != 0)
+        {
+            res = 0;
+            break;
+        }
+        if (mlf1[i].transcription_size != mlf2[i].transcription_size)
+        {
+            res = 0;
+            break;
+        }
+        if (mlf1[i].transcription_size < 0)
+        {
+            res = 0;
+            break;
+        }
+        if (mlf1[i].transcription_size > 0)
+        {
+            for (j = 0; j < mlf1[i].transcription_size; j++)
+            {
+                if (mlf1[i].transcription[j].start_time
+                        != mlf2[i].transcription[j].start_time)
+                {
+                    res = 0;
+                    break;
+                }
+                if (mlf1[i].transcription[j].end_time
+                        != mlf2[i].transcription[j].end_time)
+                {
+                    res = 0;
+                    break;
+                }
+                if (mlf1[i].transcription[j].node_data
+                        != mlf2[i].transcription[j].node_data)
+                {
+                    res = 0;
+                    break;
+                }
+                if (fabs(mlf1[i].transcription[j].score
+                         - mlf2[i].transcription[j].score) > SCORE_EPSILON)
+                {
+                    res = 0;
+                    break;
+                }
+            }
+            if (!res)
+            {
+                break;
+            }
+        }
+    }
+
+    return res;
+}
+
+int prepare_for_testing_of_recognize_words_by_words_tree()
+{
+    CU_pSuite pSuite = NULL;
+
+    pSuite = CU_add_suite("Test suite for recognize_words_by_words_tree()",
+                          init_suite_recognize_words_by_words_tree,
+                          clean_suite_recognize_words_by_words_tree);
+    if (NULL == pSuite)
+    {
+        CU_cleanup_registry();
+        return 0;
+    }
+
+    if ((NULL == CU_add_test(pSuite, "Valid partition 1",
+                             recognize_words_by_words_tree_valid_test_1))
+            || (NULL == CU_add_test(pSuite, "Valid partition 2",
+                                    recognize_words_by_words_tree_valid_test_2))
+            || (NULL == CU_add_test(pSuite, "Valid partition 3",
+                                    recognize_words_by_words_tree_valid_test_3))
+            || (NULL == CU_add_test(pSuite, "Valid partition 4",
+                                    recognize_words_by_words_tree_valid_test_4))
+            || (NULL == CU_add_test(pSuite, "Invalid partitions",
+                                    recognize_words_by_words_tree_invalid_test_1)))
+    {
+        CU_cleanup_registry();
+        return 0;
+    }
+
+    return 1;
+}
+
+int init_suite_recognize_words_by_words_tree()
+{
+    int i, n;
+    TLanguageModel source_model;
+
+    for (i = 0; i < (PHONEMES_VOCABULARY_SIZE * PHONEMES_VOCABULARY_SIZE); i++)
+    {
+        if (confusion_penalties[i] > 0.0)
+        {
+            confusion_penalties[i] = log10(confusion_penalties[i]);
+        }
+        else
+        {
+            confusion_penalties[i] = -FLT_MAX;
+        }
+    }
+
+    words_tree = malloc(sizeof(TWordsTreeNode));
+    words_tree->node_data = -1;
+    words_tree->node_type = INIT_NODE;
+    words_tree->number_of_next_nodes = 0;
+    words_tree->next_nodes = NULL;
+    add_word_to_words_tree(0, word_0, 2, words_tree);
+    add_word_to_words_tree(1, word_1, 2, words_tree);
+    add_word_to_words_tree(2, word_2, 3, words_tree);
+
+    source_model.unigrams_number = 3;
+    source_model.unigrams_probabilities = malloc(3*sizeof(float));
+    source_model.unigrams_probabilities[0] = 0.4;
+    source_model.unigrams_probabilities[1] = 0.25;
+    source_model.unigrams_probabilities[2] = 0.35;
+    source_model.bigrams = malloc(3*sizeof(TWordBigram));
+    source_model.bigrams[0].begins_number = 2;
+    source_model.bigrams[0].begins = malloc(2*sizeof(TWordBigramBegin));
+    //1->0
+    source_model.bigrams[0].begins[0].word_i = 1;
+    source_model.bigrams[0].begins[0].probability = 0.5;
+    //2->0
+    source_model.bigrams[0].begins[1].word_i = 2;
+    source_model.bigrams[0].begins[1].probability = 0.1;
+    source_model.bigrams[1].begins_number = 2;
+    source_model.bigrams[1].begins = malloc(2*sizeof(TWordBigramBegin));
+    //0->1
+    source_model.bigrams[1].begins[0].word_i = 0;
+    source_model.bigrams[1].begins[0].probability = 0.2;
+    //2->1
+    source_model.bigrams[1].begins[1].word_i = 2;
+    source_model.bigrams[1].begins[1].probability = 0.9;
+    source_model.bigrams[2].begins_number = 2;
+    source_model.bigrams[2].begins = malloc(2*sizeof(TWordBigramBegin));
+    //0->2
+    source_model.bigrams[2].begins[0].word_i = 0;
+    source_model.bigrams[2].begins[0].probability = 0.8;
+    //1->2
+    source_model.bigrams[2].begins[1].word_i = 1;
+    source_model.bigrams[2].begins[1].probability = 0.5;
+    compile_language_model(source_model, lambda, &language_model);
+    free_language_model(&source_model);
+
+    n = strlen(INP_MLF_PART_NAME);
+    src_mlf_1 = malloc(sizeof(TMLFFilePart));
+    src_mlf_1[0].name = malloc((n+1) * sizeof(char));
+    memset(src_mlf_1[0].name, 0, (n+1) * sizeof(char));
+    strcpy(src_mlf_1[0].name, INP_MLF_PART_NAME);
+    src_mlf_1[0].transcription_size = 7;
+    src_mlf_1[0].transcription = malloc(7*sizeof(TTranscriptionNode));
+    src_mlf_1[0].transcription[0].start_time = 0;
+    src_mlf_1[0].transcription[0].end_time = 100000000;
+    src_mlf_1[0].transcription[0].node_data = 0;
+    src_mlf_1[0].transcription[0].probability = 0.9;
+    src_mlf_1[0].transcription[1].start_time = 100000000;
+    src_mlf_1[0].transcription[1].end_time = 150000000;
+    src_mlf_1[0].transcription[1].node_data = 1;
+    src_mlf_1[0].transcription[1].probability = 0.8;
+    src_mlf_1[0].transcription[2].start_time = 150000000;
+    src_mlf_1[0].transcription[2].end_time = 160000000;
+    src_mlf_1[0].transcription[2].node_data = 3;
+    src_mlf_1[0].transcription[2].probability = 0.6;
+    src_mlf_1[0].transcription[3].start_time = 160000000;
+    src_mlf_1[0].transcription[3].end_time = 190000000;
+    src_mlf_1[0].transcription[3].node_data = 2;
+    src_mlf_1[0].transcription[3].probability = 0.75;
+    src_mlf_1[0].transcription[4].start_time = 190000000;
+    src_mlf_1[0].transcription[4].end_time = 240000000;
+    src_mlf_1[0].transcription[4].node_data = 3;
+    src_mlf_1[0].transcription[4].probability = 0.9;
+    src_mlf_1[0].transcription[5].start_time = 240000000;
+    src_mlf_1[0].transcription[5].end_time = 260000000;
+    src_mlf_1[0].transcription[5].node_data = 1;
+    src_mlf_1[0].transcription[5].probability = 0.7;
+    src_mlf_1[0].transcription[6].start_time = 260000000;
+    src_mlf_1[0].transcription[6].end_time = 300000000;
+    src_mlf_1[0].transcription[6].node_data = 0;
+    src_mlf_1[0].transcription[6].probability = 0.9;
+
+    n = strlen(INP_MLF_PART_NAME);
+    src_mlf_2 = malloc(sizeof(TMLFFilePart));
+    src_mlf_2[0].name = malloc((n+1) * sizeof(char));
+    memset(src_mlf_2[0].name, 0, (n+1) * sizeof(char));
+    strcpy(src_mlf_2[0].name, INP_MLF_PART_NAME);
+    src_mlf_2[0].transcription_size = 9;
+    src_mlf_2[0].transcription = malloc(9*sizeof(TTranscriptionNode));
+    src_mlf_2[0].transcription[0].start_time = 0;
+    src_mlf_2[0].transcription[0].end_time = 100000000;
+    src_mlf_2[0].transcription[0].node_data = 0;
+    src_mlf_2[0].transcription[0].probability = 0.9;
+    src_mlf_2[0].transcription[1].start_time = 100000000;
+    src_mlf_2[0].transcription[1].end_time = 150000000;
+    src_mlf_2[0].transcription[1].node_data = 1;
+    src_mlf_2[0].transcription[1].probability = 0.8;
+    src_mlf_2[0].transcription[2].start_time = 150000000;
+    src_mlf_2[0].transcription[2].end_time = 160000000;
+    src_mlf_2[0].transcription[2].node_data = 3;
+    src_mlf_2[0].transcription[2].probability = 0.6;
+    src_mlf_2[0].transcription[3].start_time = 160000000;
+    src_mlf_2[0].transcription[3].end_time = 190000000;
+    src_mlf_2[0].transcription[3].node_data = 2;
+    src_mlf_2[0].transcription[3].probability = 0.75;
+    src_mlf_2[0].transcription[4].start_time = 190000000;
+    src_mlf_2[0].transcription[4].end_time = 280000000;
+    src_mlf_2[0].transcription[4].node_data = 0;
+    src_mlf_2[0].transcription[4].probability = 0.97;
+    src_mlf_2[0].transcription[5].start_time = 280000000;
+    src_mlf_2[0].transcription[5].end_time = 300000000;
+    src_mlf_2[0].transcription[5].node_data = 2;
+    src_mlf_2[0].transcription[5].probability = 0.83;
+    src_mlf_2[0].transcription[6].start_time = 300000000;
+    src_mlf_2[0].transcription[6].end_time = 350000000;
+    src_mlf_2[0].transcription[6].node_data = 3;
+    src_mlf_2[0].transcription[6].probability = 0.9;
+    src_mlf_2[0].transcription[7].start_time = 350000000;
+    src_mlf_2[0].transcription[7].end_time = 370000000;
+    src_mlf_2[0].transcription[7].node_data = 1;
+    src_mlf_2[0].transcription[7].probability = 0.7;
+    src_mlf_2[0].transcription[8].start_time = 370000000;
+    src_mlf_2[0].transcription[8].end_time = 410000000;
+    src_mlf_2[0].transcription[8].node_data = 0;
+    src_mlf_2[0].transcription[8].probability = 0.9;
+
+    n = strlen(REC_MLF_PART_NAME);
+    target_res_mlf = malloc(2*sizeof(TMLFFilePart));
+    target_res_mlf[0].name = malloc((n+1) * sizeof(char));
+    memset(target_res_mlf[0].name, 0, (n+1) * sizeof(char));
+    strcpy(target_res_mlf[0].name, REC_MLF_PART_NAME);
+    target_res_mlf[0].transcription_size = 3;
+    target_res_mlf[0].transcription = malloc(3*sizeof(TTranscriptionNode));
+    target_res_mlf[0].transcription[0].start_time = 100000000;
+    target_res_mlf[0].transcription[0].end_time = 150000000;
+    target_res_mlf[0].transcription[0].node_data = 0;
+    target_res_mlf[0].transcription[0].score = -1.21154880;
+    target_res_mlf[0].transcription[1].start_time = 150000000;
+    target_res_mlf[0].transcription[1].end_time = 175000000;
+    target_res_mlf[0].transcription[1].node_data = 1;
+    target_res_mlf[0].transcription[1].score = -1.57557487;
+    target_res_mlf[0].transcription[2].start_time = 175000000;
+    target_res_mlf[0].transcription[2].end_time = 260000000;
+    target_res_mlf[0].transcription[2].node_data = 2;
+    target_res_mlf[0].transcription[2].score = -1.32907629;
+    target_res_mlf[1].name = malloc((n+1) * sizeof(char));
+    memset(target_res_mlf[1].name, 0, (n+1) * sizeof(char));
+    strcpy(target_res_mlf[1].name, REC_MLF_PART_NAME);
+    target_res_mlf[1].transcription_size = 3;
+    target_res_mlf[1].transcription = malloc(3*sizeof(TTranscriptionNode));
+    target_res_mlf[1].transcription[0].start_time = 100000000;
+    target_res_mlf[1].transcription[0].end_time = 150000000;
+    target_res_mlf[1].transcription[0].node_data = 0;
+    target_res_mlf[1].transcription[0].score = -1.21154880;
+    target_res_mlf[1].transcription[1].start_time = 150000000;
+    target_res_mlf[1].transcription[1].end_time = 280000000;
+    target_res_mlf[1].transcription[1].node_data = 1;
+    target_res_mlf[1].transcription[1].score = -1.89646150;
+    target_res_mlf[1].transcription[2].start_time = 280000000;
+    target_res_mlf[1].transcription[2].end_time = 370000000;
+    target_res_mlf[1].transcription[2].node_data = 2;
+    target_res_mlf[1].transcription[2].score = -1.49092007;
+
+    return 0;
+}
+
+int clean_suite_recognize_words_by_words_tree()
+{
+    free_compiled_language_model(&language_model);
+    free_words_tree(&words_tree);
+    free_MLF(&src_mlf_1, FILES_NUMBER);
+    free_MLF(&src_mlf_2, FILES_NUMBER);
+    free_MLF(&target_res_mlf, 2);
+    return 0;
+}
+
+void recognize_words_by_words_tree_valid_test_1()
+{
+    TMLFFilePart *recognition_res = NULL;
+    int is_ok = 0, is_equal = 0;
+
+    is_ok = recognize_words_by_words_tree(
+                            src_mlf_1, FILES_NUMBER, PHONEMES_VOCABULARY_SIZE,
+                            confusion_penalties, words_tree, pruning_coeff,
+                            histogram_size, beam_width, max_active_hypotheses,
+                            word_end_beam, language_model, threads_number,
+                            &recognition_res);
+    if (is_ok)
+    {
+        is_equal = compare_two_MLF(recognition_res, FILES_NUMBER,
+                                   target_res_mlf, FILES_NUMBER);
+    }
+    free_MLF(&recognition_res, FILES_NUMBER);
+
+    CU_ASSERT_TRUE_FATAL(is_ok);
+    CU_ASSERT_TRUE_FATAL(is_equal);
+}
+
+void recognize_words_by_words_tree_valid_test_2()
+{
+    TMLFFilePart *recognition_res = NULL;
+    int is_ok = 0, is_equal = 0;
+
+    is_ok = recognize_words_by_words_tree(
+                            src_mlf_2, FILES_NUMBER, PHONEMES_VOCABULARY_SIZE,
+                            confusion_penalties, words_tree, pruning_coeff,
+                            histogram_size, beam_width, max_active_hypotheses,
+                            word_end_beam, language_model, threads_number,
+                            &recognition_res);
+    if (is_ok)
+    {
+        is_equal = compare_two_MLF(recognition_res, FILES_NUMBER,
+                                   target_res_mlf + 1, FILES_NUMBER);
+    }
+    free_MLF(&recognition_res, FILES_NUMBER);
+
+    CU_ASSERT_TRUE_FATAL(is_ok);
+    CU_ASSERT_TRUE_FATAL(is_equal);
+}
+
+void recognize_words_by_words_tree_valid_test_3()
+{
+    TMLFFilePart src_mlf[2];
+    TMLFFilePart *recognition_res = NULL;
+    int is_ok = 0, is_equal_1 = 0, is_equal_2 = 0;
+
+    src_mlf[0] = src_mlf_1[0];
+    src_mlf[1] = src_mlf_2[0];
+    is_ok = recognize_words_by_words_tree(
+                src_mlf, 2, PHONEMES_VOCABULARY_SIZE, confusion_penalties,
+                words_tree, pruning_coeff, histogram_size, beam_width,
+                max_active_hypotheses, word_end_beam, language_model, 2,
+                &recognition_res);
+    if (is_ok)
+    {
+        is_equal_1 = compare_two_MLF(recognition_res, FILES_NUMBER,
+                                     target_res_mlf, FILES_NUMBER);
+        is_equal_2 = compare_two_MLF(recognition_res + 1, FILES_NUMBER,
+                                     target_res_mlf + 1, FILES_NUMBER);
+    }
+    free_MLF(&recognition_res, 2);
+
+    CU_ASSERT_TRUE_FATAL(is_ok);
+    CU_ASSERT_TRUE_FATAL(is_equal_1);
+    CU_ASSERT_TRUE_FATAL(is_equal_2);
+}
+
+void recognize_words_by_words_tree_valid_test_4()
+{
+    TMLFFilePart *recognition_res = NULL;
+    int is_ok = 0, is_equal = 0;
+
+    is_ok = recognize_words_by_words_tree(
+                src_mlf_1, FILES_NUMBER, PHONEMES_VOCABULARY_SIZE,
+                confusion_penalties, words_tree, pruning_coeff, histogram_size,
+                2.0, 8, 1.0, language_model, threads_number, &recognition_res);
+    if (is_ok)
+    {
+        is_equal = compare_two_MLF(recognition_res, FILES_NUMBER,
+                                   target_res_mlf, FILES_NUMBER);
+    }
+    free_MLF(&recognition_res, FILES_NUMBER);
+
+    CU_ASSERT_TRUE_FATAL(is_ok);
+    CU_ASSERT_TRUE_FATAL(is_equal);
+}
+
+void recognize_words_by_words_tree_invalid_test_1()
+{
+    TMLFFilePart *recognition_res = NULL;
+    int is_ok = 1;
+    TCompiledLanguageModel incorrect_model = language_model;
+
+    incorrect_model.backoff_scores = NULL;
+
+    is_ok = recognize_words_by_words_tree(
+                            NULL, FILES_NUMBER, PHONEMES_VOCABULARY_SIZE,
+                            confusion_penalties, words_tree, pruning_coeff,
+                            histogram_size, beam_width, max_active_hypotheses,
+                            word_end_beam, language_model, threads_number,
+                            &recognition_res);
+    free_MLF(&recognition_res, FILES_NUMBER);
+    CU_ASSERT_FALSE_FATAL(is_ok);
+
+    is_ok = recognize_words_by_words_tree(
+                            src_mlf_1, 0, PHONEMES_VOCABULARY_SIZE,
+                            confusion_penalties, words_tree, pruning_coeff,
+                            histogram_size, beam_width, max_active_hypotheses,
+                            word_end_beam, language_model, threads_number,
+                            &recognition_res);
+    free_MLF(&recognition_res, FILES_NUMBER);
+    CU_ASSERT_FALSE_FATAL(is_ok);
+
+    is_ok = recognize_words_by_words_tree(
+                            src_mlf_1, FILES_NUMBER, 0, confusion_penalties,
+                            words_tree, pruning_coeff, histogram_size,
+                            beam_width, max_active_hypotheses, word_end_beam,
+                            language_model, threads_number, &recognition_res);
+    free_MLF(&recognition_res, FILES_NUMBER);
+    CU_ASSERT_FALSE_FATAL(is_ok);
+
+    is_ok = recognize_words_by_words_tree(
+                            src_mlf_1, FILES_NUMBER, PHONEMES_VOCABULARY_SIZE,
+                            NULL, words_tree, pruning_coeff, histogram_size,
+                            beam_width, max_active_hypotheses, word_end_beam,
+                            language_model, threads_number, &recognition_res);
+    free_MLF(&recognition_res, FILES_NUMBER);
+    CU_ASSERT_FALSE_FATAL(is_ok);
+
+    is_ok = recognize_words_by_words_tree(
+                            src_mlf_1, FILES_NUMBER, PHONEMES_VOCABULARY_SIZE,
+                            confusion_penalties, NULL, pruning_coeff,
+                            histogram_size, beam_width, max_active_hypotheses,
+                            word_end_beam, language_model, threads_number,
+                            &recognition_res);
+    free_MLF(&recognition_res, FILES_NUMBER);
+    CU_ASSERT_FALSE_FATAL(is_ok);
+
+    is_ok = recognize_words_by_words_tree(
+                            src_mlf_1, FILES_NUMBER, PHONEMES_VOCABULARY_SIZE,
+                            confusion_penalties, words_tree,
+                            incorrect_pruning_coeff_1, histogram_size,
+                            beam_width, max_active_hypotheses, word_end_beam,
+                            language_model, threads_number, &recognition_res);
+    free_MLF(&recognition_res, FILES_NUMBER);
+    CU_ASSERT_FALSE_FATAL(is_ok);
+
+    is_ok = recognize_words_by_words_tree(
+                            src_mlf_1, FILES_NUMBER, PHONEMES_VOCABULARY_SIZE,
+                            confusion_penalties, words_tree,
+                            incorrect_pruning_coeff_2, histogram_size,
+                            beam_width, max_active_hypotheses, word_end_beam,
+                            language_model, threads_number, &recognition_res);
+    free_MLF(&recognition_res, FILES_NUMBER);
+    CU_ASSERT_FALSE_FATAL(is_ok);
+
+    is_ok = recognize_words_by_words_tree(
+                            src_mlf_1, FILES_NUMBER, PHONEMES_VOCABULARY_SIZE,
+                            confusion_penalties, words_tree, pruning_coeff,
+                            incorrect_histogram_size, beam_width,
+                            max_active_hypotheses, word_end_beam,
+                            language_model, threads_number, &recognition_res);
+    free_MLF(&recognition_res, FILES_NUMBER);
+    CU_ASSERT_FALSE_FATAL(is_ok);
+
+    is_ok = recognize_words_by_words_tree(
+                            src_mlf_1, FILES_NUMBER, PHONEMES_VOCABULARY_SIZE,
+                            confusion_penalties, words_tree, pruning_coeff,
+                            histogram_size, incorrect_beam_width,
+                            max_active_hypotheses, word_end_beam,
+                            language_model, threads_number, &recognition_res);
+    free_MLF(&recognition_res, FILES_NUMBER);
+    CU_ASSERT_FALSE_FATAL(is_ok);
+
+    is_ok = recognize_words_by_words_tree(
+                            src_mlf_1, FILES_NUMBER, PHONEMES_VOCABULARY_SIZE,
+                            confusion_penalties, words_tree, pruning_coeff,
+                            histogram_size, beam_width,
+                            incorrect_max_active_hypotheses, word_end_beam,
+                            language_model, threads_number, &recognition_res);
+    free_MLF(&recognition_res, FILES_NUMBER);
+    CU_ASSERT_FALSE_FATAL(is_ok);
+
+    is_ok = recognize_words_by_words_tree(
+                            src_mlf_1, FILES_NUMBER, PHONEMES_VOCABULARY_SIZE,
+                            confusion_penalties, words_tree, pruning_coeff,
+                            histogram_size, beam_width, max_active_hypotheses,
+                            incorrect_word_end_beam, language_model,
+                            threads_number, &recognition_res);
+    free_MLF(&recognition_res, FILES_NUMBER);
+    CU_ASSERT_FALSE_FATAL(is_ok);
+
+    is_ok = recognize_words_by_words_tree(
+                            src_mlf_1, FILES_NUMBER, PHONEMES_VOCABULARY_SIZE,
+                            confusion_penalties, words_tree, pruning_coeff,
+                            histogram_size, beam_width, max_active_hypotheses,
+                            word_end_beam, incorrect_model, threads_number,
+                            &recognition_res);
+    free_MLF(&recognition_res, FILES_NUMBER);
+    CU_ASSERT_FALSE_FATAL(is_ok);
+
+    is_ok = recognize_words_by_words_tree(
+                            src_mlf_1, FILES_NUMBER, PHONEMES_VOCABULARY_SIZE,
+                            confusion_penalties, words_tree, pruning_coeff,
+                            histogram_size, beam_width, max_active_hypotheses,
+                            word_end_beam, language_model,
+                            incorrect_threads_number, &recognition_res);
+    free_MLF(&recognition_res, FILES_NUMBER);
+    CU_ASSERT_FALSE_FATAL(is_ok);
+
+    is_ok = recognize_words_by_words_tree(
+                            src_mlf_1, FILES_NUMBER, PHONEMES_VOCABULARY_SIZE,
+                            confusion_penalties, words_tree, pruning_coeff,
+                            histogram_size, beam_width, max_active_hypotheses,
+                            word_end_beam, language_model, threads_number,
+                            NULL);
+    CU_ASSERT_FALSE_FATAL(is_ok);
+}
@@ -0,0 +1,13 @@
+#ifndef RECOGNIZE_WORDS_BY_WORDS_TREE_TEST_H
+#define RECOGNIZE_WORDS_BY_WORDS_TREE_TEST_H
+
+int prepare_for_testing_of_recognize_words_by_words_tree();
+int init_suite_recognize_words_by_words_tree();
+int clean_suite_recognize_words_by_words_tree();
+void recognize_words_by_words_tree_valid_test_1();
+void recognize_words_by_words_tree_valid_test_2();
+void recognize_words_by_words_tree_valid_test_3();
+void recognize_words_by_words_tree_valid_test_4();
+void recognize_words_by_words_tree_invalid_test_1();
+
+#endif // RECOGNIZE_WORDS_BY_WORDS_TREE_TEST_H
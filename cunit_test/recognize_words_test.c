@@ -13,6 +13,7 @@
 #define REC_MLF_PART_NAME "test_record.rec"
 #define PHONEMES_VOCABULARY_SIZE 4
 #define WORDS_VOCABULARY_SIZE 3
+#define SCORE_EPSILON 1e-5
 
 static float confusion_penalties[] = {
     0.95, 0.02, 0.02, 0.01,
@@ -21,11 +22,19 @@ static float confusion_penalties[] = {
     0.04, 0.04, 0.11, 0.81
 };
 static TLinearWordsLexicon *words_lexicon = NULL;
-static TLanguageModel language_model;
+static TCompiledLanguageModel language_model;
 static float lambda = 1.0;
-static float incorrect_lambda_1 = -1.0;
-static float incorrect_lambda_2 = 1.5;
+static int threads_number = 1;
+static int incorrect_threads_number = 0;
 static float pruning_coeff = 0.0;
+static int histogram_size = DEFAULT_HISTOGRAM_SIZE;
+static int incorrect_histogram_size = 1;
+static float beam_width = 0.0;
+static float incorrect_beam_width = -1.0;
+static int max_active_hypotheses = 0;
+static int incorrect_max_active_hypotheses = -1;
+static float word_end_beam = 0.0;
+static float incorrect_word_end_beam = -1.0;
 static float incorrect_pruning_coeff_1 = -1.0;
 static float incorrect_pruning_coeff_2 = 1.5;
 static TMLFFilePart *src_mlf_1 = NULL, *src_mlf_2 = NULL;
@@ -97,8 +106,8 @@ static int compare_two_MLF(TMLFFilePart *mlf1, int mlf1_size,
                     res = 0;
                     break;
                 }
-                if (fabs(mlf1[i].transcription[j].probability
-                         - mlf2[i].transcription[j].probability) > FLT_EPSILON)
+                if (fabs(mlf1[i].transcription[j].score
+                         - mlf2[i].transcription[j].score) > SCORE_EPSILON)
                 {
                     res = 0;
                     break;
@@ -131,6 +140,12 @@ int prepare_for_testing_of_recognize_words()
                              recognize_words_valid_test_1))
             || (NULL == CU_add_test(pSuite, "Valid partition 2",
                                     recognize_words_valid_test_2))
+            || (NULL == CU_add_test(pSuite, "Valid partition 3",
+                                    recognize_words_valid_test_3))
+            || (NULL == CU_add_test(pSuite, "Valid partition 4",
+                                    recognize_words_valid_test_4))
+            || (NULL == CU_add_test(pSuite, "Valid partition 5",
+                                    recognize_words_valid_test_5))
             || (NULL == CU_add_test(pSuite, "Invalid partitions",
                                     recognize_words_invalid_test_1)))
     {
@@ -144,6 +159,7 @@ int prepare_for_testing_of_recognize_words()
 int init_suite_recognize_words()
 {
     int i, n;
+    TLanguageModel source_model;
 
     for (i = 0; i < (PHONEMES_VOCABULARY_SIZE * PHONEMES_VOCABULARY_SIZE); i++)
     {
@@ -178,36 +194,38 @@ int init_suite_recognize_words()
     words_lexicon[2].phonemes_indexes[2] = 1;
     words_lexicon[2].phonemes_indexes[3] = 0;
 
-    language_model.unigrams_number = 3;
-    language_model.unigrams_probabilities = malloc(3*sizeof(float));
-    language_model.unigrams_probabilities[0] = 0.4;
-    language_model.unigrams_probabilities[1] = 0.25;
-    language_model.unigrams_probabilities[2] = 0.35;
-    language_model.bigrams = malloc(3*sizeof(TWordBigram));
-    language_model.bigrams[0].begins_number = 2;
-    language_model.bigrams[0].begins = malloc(2*sizeof(TWordBigramBegin));
+    source_model.unigrams_number = 3;
+    source_model.unigrams_probabilities = malloc(3*sizeof(float));
+    source_model.unigrams_probabilities[0] = 0.4;
+    source_model.unigrams_probabilities[1] = 0.25;
+    source_model.unigrams_probabilities[2] = 0.35;
+    source_model.bigrams = malloc(3*sizeof(TWordBigram));
+    source_model.bigrams[0].begins_number = 2;
+    source_model.bigrams[0].begins = malloc(2*sizeof(TWordBigramBegin));
     //1->0
-    language_model.bigrams[0].begins[0].word_i = 1;
-    language_model.bigrams[0].begins[0].probability = 0.5;
+    source_model.bigrams[0].begins[0].word_i = 1;
+    source_model.bigrams[0].begins[0].probability = 0.5;
     //2->0
-    language_model.bigrams[0].begins[1].word_i = 2;
-    language_model.bigrams[0].begins[1].probability = 0.1;
-    language_model.bigrams[1].begins_number = 2;
-    language_model.bigrams[1].begins = malloc(2*sizeof(TWordBigramBegin));
+    source_model.bigrams[0].begins[1].word_i = 2;
+    source_model.bigrams[0].begins[1].probability = 0.1;
+    source_model.bigrams[1].begins_number = 2;
+    source_model.bigrams[1].begins = malloc(2*sizeof(TWordBigramBegin));
     //0->1
-    language_model.bigrams[1].begins[0].word_i = 0;
-    language_model.bigrams[1].begins[0].probability = 0.2;
+    source_model.bigrams[1].begins[0].word_i = 0;
+    source_model.bigrams[1].begins[0].probability = 0.2;
     //2->1
-    language_model.bigrams[1].begins[1].word_i = 2;
-    language_model.bigrams[1].begins[1].probability = 0.9;
-    language_model.bigrams[2].begins_number = 2;
-    language_model.bigrams[2].begins = malloc(2*sizeof(TWordBigramBegin));
+    source_model.bigrams[1].begins[1].word_i = 2;
+    source_model.bigrams[1].begins[1].probability = 0.9;
+    source_model.bigrams[2].begins_number = 2;
+    source_model.bigrams[2].begins = malloc(2*sizeof(TWordBigramBegin));
     //0->2
-    language_model.bigrams[2].begins[0].word_i = 0;
-    language_model.bigrams[2].begins[0].probability = 0.8;
+    source_model.bigrams[2].begins[0].word_i = 0;
+    source_model.bigrams[2].begins[0].probability = 0.8;
     //1->2
-    language_model.bigrams[2].begins[1].word_i = 1;
-    language_model.bigrams[2].begins[1].probability = 0.5;
+    source_model.bigrams[2].begins[1].word_i = 1;
+    source_model.bigrams[2].begins[1].probability = 0.5;
+    compile_language_model(source_model, lambda, &language_model);
+    free_language_model(&source_model);
 
     n = strlen(INP_MLF_PART_NAME);
     src_mlf_1 = malloc(sizeof(TMLFFilePart));
@@ -290,31 +308,44 @@ int init_suite_recognize_words()
     src_mlf_2[0].transcription[8].probability = 0.9;
 
     n = strlen(REC_MLF_PART_NAME);
-    target_res_mlf = malloc(sizeof(TMLFFilePart));
+    target_res_mlf = malloc(2*sizeof(TMLFFilePart));
     target_res_mlf[0].name = malloc((n+1) * sizeof(char));
     memset(target_res_mlf[0].name, 0, (n+1) * sizeof(char));
     strcpy(target_res_mlf[0].name, REC_MLF_PART_NAME);
     target_res_mlf[0].transcription_size = 2;
     target_res_mlf[0].transcription = malloc(2*sizeof(TTranscriptionNode));
-    target_res_mlf[0].transcription[0].start_time = 0;
-    target_res_mlf[0].transcription[0].end_time = 0;
+    target_res_mlf[0].transcription[0].start_time = 100000000;
+    target_res_mlf[0].transcription[0].end_time = 155000000;
     target_res_mlf[0].transcription[0].node_data = 0;
-    target_res_mlf[0].transcription[0].probability = 1.0;
-    target_res_mlf[0].transcription[1].start_time = 0;
-    target_res_mlf[0].transcription[1].end_time = 0;
+    target_res_mlf[0].transcription[0].score = -1.70639872;
+    target_res_mlf[0].transcription[1].start_time = 155000000;
+    target_res_mlf[0].transcription[1].end_time = 260000000;
     target_res_mlf[0].transcription[1].node_data = 2;
-    target_res_mlf[0].transcription[1].probability = 1.0;
+    target_res_mlf[0].transcription[1].score = -2.34140992;
+    target_res_mlf[1].name = malloc((n+1) * sizeof(char));
+    memset(target_res_mlf[1].name, 0, (n+1) * sizeof(char));
+    strcpy(target_res_mlf[1].name, REC_MLF_PART_NAME);
+    target_res_mlf[1].transcription_size = 2;
+    target_res_mlf[1].transcription = malloc(2*sizeof(TTranscriptionNode));
+    target_res_mlf[1].transcription[0].start_time = 100000000;
+    target_res_mlf[1].transcription[0].end_time = 190000000;
+    target_res_mlf[1].transcription[0].node_data = 0;
+    target_res_mlf[1].transcription[0].score = -3.03700137;
+    target_res_mlf[1].transcription[1].start_time = 190000000;
+    target_res_mlf[1].transcription[1].end_time = 370000000;
+    target_res_mlf[1].transcription[1].node_data = 2;
+    target_res_mlf[1].transcription[1].score = -1.49353767;
 
     return 0;
 }
 
 int clean_suite_recognize_words()
 {
-    free_language_model(&language_model);
+    free_compiled_language_model(&language_model);
     free_linear_words_lexicon(&words_lexicon, WORDS_VOCABULARY_SIZE);
     free_MLF(&src_mlf_1, FILES_NUMBER);
     free_MLF(&src_mlf_2, FILES_NUMBER);
-    free_MLF(&target_res_mlf, FILES_NUMBER);
+    free_MLF(&target_res_mlf, 2);
     return 0;
 }
 
@@ -326,7 +357,9 @@ void recognize_words_valid_test_1()
     is_ok = recognize_words(src_mlf_1, FILES_NUMBER, PHONEMES_VOCABULARY_SIZE,
                             confusion_penalties, words_lexicon,
                             WORDS_VOCABULARY_SIZE, pruning_coeff,
-                            language_model, lambda, &recognition_res);
+                            histogram_size, beam_width, max_active_hypotheses,
+                            word_end_beam, language_model, threads_number,
+                            &recognition_res);
     if (is_ok)
     {
         is_equal = compare_two_MLF(recognition_res, FILES_NUMBER,
@@ -346,7 +379,57 @@ void recognize_words_valid_test_2()
     is_ok = recognize_words(src_mlf_2, FILES_NUMBER, PHONEMES_VOCABULARY_SIZE,
                             confusion_penalties, words_lexicon,
                             WORDS_VOCABULARY_SIZE, pruning_coeff,
-                            language_model, lambda, &recognition_res);
+                            histogram_size, beam_width, max_active_hypotheses,
+                            word_end_beam, language_model, threads_number,
+                            &recognition_res);
+    if (is_ok)
+    {
+        is_equal = compare_two_MLF(recognition_res, FILES_NUMBER,
+                                   target_res_mlf + 1, FILES_NUMBER);
+    }
+    free_MLF(&recognition_res, FILES_NUMBER);
+
+    CU_ASSERT_TRUE_FATAL(is_ok);
+    CU_ASSERT_TRUE_FATAL(is_equal);
+}
+
+void recognize_words_valid_test_3()
+{
+    TMLFFilePart src_mlf[2];
+    TMLFFilePart *recognition_res = NULL;
+    int is_ok = 0, is_equal_1 = 0, is_equal_2 = 0;
+
+    src_mlf[0] = src_mlf_1[0];
+    src_mlf[1] = src_mlf_2[0];
+    is_ok = recognize_words(
+                src_mlf, 2, PHONEMES_VOCABULARY_SIZE, confusion_penalties,
+                words_lexicon, WORDS_VOCABULARY_SIZE, pruning_coeff,
+                histogram_size, beam_width, max_active_hypotheses,
+                word_end_beam, language_model, 2, &recognition_res);
+    if (is_ok)
+    {
+        is_equal_1 = compare_two_MLF(recognition_res, FILES_NUMBER,
+                                     target_res_mlf, FILES_NUMBER);
+        is_equal_2 = compare_two_MLF(recognition_res + 1, FILES_NUMBER,
+                                     target_res_mlf + 1, FILES_NUMBER);
+    }
+    free_MLF(&recognition_res, 2);
+
+    CU_ASSERT_TRUE_FATAL(is_ok);
+    CU_ASSERT_TRUE_FATAL(is_equal_1);
+    CU_ASSERT_TRUE_FATAL(is_equal_2);
+}
+
+void recognize_words_valid_test_4()
+{
+    TMLFFilePart *recognition_res = NULL;
+    int is_ok = 0, is_equal = 0;
+
+    is_ok = recognize_words(
+                src_mlf_1, FILES_NUMBER, PHONEMES_VOCABULARY_SIZE,
+                confusion_penalties, words_lexicon, WORDS_VOCABULARY_SIZE,
+                pruning_coeff, histogram_size, 2.0, 8, 1.0, language_model,
+                threads_number, &recognition_res);
     if (is_ok)
     {
         is_equal = compare_two_MLF(recognition_res, FILES_NUMBER,
@@ -358,88 +441,191 @@ void recognize_words_valid_test_2()
     CU_ASSERT_TRUE_FATAL(is_equal);
 }
 
+void recognize_words_valid_test_5()
+{
+    /* the utterance starts with a word of one phoneme, i.e. the word which
+       consists of its last state only */
+    int phonemes_of_word_0[] = {1};
+    int phonemes_of_word_1[] = {2, 1};
+    int input_phonemes[] = {1, 1, 2, 1};
+    float unigrams_probabilities[] = {0.5, 0.5};
+    TWordBigram bigrams[2] = {{0, NULL}, {0, NULL}};
+    TLinearWordsLexicon short_words_lexicon[2];
+    TLanguageModel source_model;
+    TCompiledLanguageModel short_words_model;
+    TTranscriptionNode source_transcription[4];
+    TTranscriptionNode target_transcription[1];
+    TMLFFilePart src_mlf, target_mlf;
+    TMLFFilePart *recognition_res = NULL;
+    int i, is_ok = 0, is_equal = 0;
+
+    short_words_lexicon[0].word_index = 0;
+    short_words_lexicon[0].phonemes_number = 1;
+    short_words_lexicon[0].phonemes_indexes = phonemes_of_word_0;
+    short_words_lexicon[1].word_index = 1;
+    short_words_lexicon[1].phonemes_number = 2;
+    short_words_lexicon[1].phonemes_indexes = phonemes_of_word_1;
+
+    source_model.unigrams_number = 2;
+    source_model.unigrams_probabilities = unigrams_probabilities;
+    source_model.bigrams = bigrams;
+    CU_ASSERT_TRUE_FATAL(compile_language_model(source_model, 0.5,
+                                                &short_words_model));
+
+    src_mlf.name = INP_MLF_PART_NAME;
+    src_mlf.transcription = source_transcription;
+    src_mlf.transcription_size = 4;
+    for (i = 0; i < 4; i++)
+    {
+        source_transcription[i].node_data = input_phonemes[i];
+        source_transcription[i].start_time = i * 100000;
+        source_transcription[i].end_time = (i + 1) * 100000;
+        source_transcription[i].probability = 0.9;
+    }
+
+    target_mlf.name = REC_MLF_PART_NAME;
+    target_mlf.transcription = target_transcription;
+    target_mlf.transcription_size = 1;
+    target_transcription[0].node_data = 1;
+    target_transcription[0].start_time = 0;
+    target_transcription[0].end_time = 400000;
+    target_transcription[0].score = -1.20075881;
+
+    is_ok = recognize_words(&src_mlf, FILES_NUMBER, PHONEMES_VOCABULARY_SIZE,
+                            confusion_penalties, short_words_lexicon, 2,
+                            pruning_coeff, histogram_size, beam_width,
+                            max_active_hypotheses, word_end_beam,
+                            short_words_model, threads_number,
+                            &recognition_res);
+    if (is_ok)
+    {
+        is_equal = compare_two_MLF(recognition_res, FILES_NUMBER,
+                                   &target_mlf, FILES_NUMBER);
+    }
+    free_MLF(&recognition_res, FILES_NUMBER);
+    free_compiled_language_model(&short_words_model);
+
+    CU_ASSERT_TRUE_FATAL(is_ok);
+    CU_ASSERT_TRUE_FATAL(is_equal);
+}
+
 void recognize_words_invalid_test_1()
 {
     TMLFFilePart *recognition_res = NULL;
     int is_ok = 1;
-    TLanguageModel incorrect_model = language_model;
+    TCompiledLanguageModel incorrect_model = language_model;
 
-    incorrect_model.bigrams = NULL;
+    incorrect_model.backoff_scores = NULL;
 
     is_ok = recognize_words(NULL, FILES_NUMBER, PHONEMES_VOCABULARY_SIZE,
                             confusion_penalties, words_lexicon,
                             WORDS_VOCABULARY_SIZE, pruning_coeff,
-                            language_model, lambda, &recognition_res);
+                            histogram_size, beam_width, max_active_hypotheses,
+                            word_end_beam, language_model, threads_number,
+                            &recognition_res);
     free_MLF(&recognition_res, FILES_NUMBER);
     CU_ASSERT_FALSE_FATAL(is_ok);
 
     is_ok = recognize_words(src_mlf_1, 0, PHONEMES_VOCABULARY_SIZE,
                             confusion_penalties, words_lexicon,
                             WORDS_VOCABULARY_SIZE, pruning_coeff,
-                            language_model, lambda, &recognition_res);
+                            histogram_size, beam_width, max_active_hypotheses,
+                            word_end_beam, language_model, threads_number,
+                            &recognition_res);
     free_MLF(&recognition_res, FILES_NUMBER);
     CU_ASSERT_FALSE_FATAL(is_ok);
 
-    is_ok = recognize_words(src_mlf_1, FILES_NUMBER, 0,
-                            confusion_penalties, words_lexicon,
-                            WORDS_VOCABULARY_SIZE, pruning_coeff,
-                            language_model, lambda, &recognition_res);
+    is_ok = recognize_words(src_mlf_1, FILES_NUMBER, 0, confusion_penalties,
+                            words_lexicon, WORDS_VOCABULARY_SIZE,
+                            pruning_coeff, histogram_size, beam_width,
+                            max_active_hypotheses, word_end_beam,
+                            language_model, threads_number, &recognition_res);
     free_MLF(&recognition_res, FILES_NUMBER);
     CU_ASSERT_FALSE_FATAL(is_ok);
 
     is_ok = recognize_words(src_mlf_1, FILES_NUMBER, PHONEMES_VOCABULARY_SIZE,
                             NULL, words_lexicon, WORDS_VOCABULARY_SIZE,
-                            pruning_coeff, language_model, lambda,
-                            &recognition_res);
+                            pruning_coeff, histogram_size, beam_width,
+                            max_active_hypotheses, word_end_beam,
+                            language_model, threads_number, &recognition_res);
     free_MLF(&recognition_res, FILES_NUMBER);
     CU_ASSERT_FALSE_FATAL(is_ok);
 
     is_ok = recognize_words(src_mlf_1, FILES_NUMBER, PHONEMES_VOCABULARY_SIZE,
                             confusion_penalties, words_lexicon, 0,
-                            pruning_coeff, language_model, lambda,
-                            &recognition_res);
+                            pruning_coeff, histogram_size, beam_width,
+                            max_active_hypotheses, word_end_beam,
+                            language_model, threads_number, &recognition_res);
     free_MLF(&recognition_res, FILES_NUMBER);
     CU_ASSERT_FALSE_FATAL(is_ok);
 
     is_ok = recognize_words(src_mlf_1, FILES_NUMBER, PHONEMES_VOCABULARY_SIZE,
                             confusion_penalties, NULL, WORDS_VOCABULARY_SIZE,
-                            pruning_coeff, language_model, lambda,
-                            &recognition_res);
+                            pruning_coeff, histogram_size, beam_width,
+                            max_active_hypotheses, word_end_beam,
+                            language_model, threads_number, &recognition_res);
     free_MLF(&recognition_res, FILES_NUMBER);
     CU_ASSERT_FALSE_FATAL(is_ok);
 
     is_ok = recognize_words(src_mlf_1, FILES_NUMBER, PHONEMES_VOCABULARY_SIZE,
                             confusion_penalties, words_lexicon,
                             WORDS_VOCABULARY_SIZE, incorrect_pruning_coeff_1,
-                            language_model, lambda, &recognition_res);
+                            histogram_size, beam_width, max_active_hypotheses,
+                            word_end_beam, language_model, threads_number,
+                            &recognition_res);
     free_MLF(&recognition_res, FILES_NUMBER);
     CU_ASSERT_FALSE_FATAL(is_ok);
 
     is_ok = recognize_words(src_mlf_1, FILES_NUMBER, PHONEMES_VOCABULARY_SIZE,
                             confusion_penalties, words_lexicon,
                             WORDS_VOCABULARY_SIZE, incorrect_pruning_coeff_2,
-                            language_model, lambda, &recognition_res);
+                            histogram_size, beam_width, max_active_hypotheses,
+                            word_end_beam, language_model, threads_number,
+                            &recognition_res);
+    free_MLF(&recognition_res, FILES_NUMBER);
+    CU_ASSERT_FALSE_FATAL(is_ok);
+
+    is_ok = recognize_words(src_mlf_1, FILES_NUMBER, PHONEMES_VOCABULARY_SIZE,
+                            confusion_penalties, words_lexicon,
+                            WORDS_VOCABULARY_SIZE, pruning_coeff,
+                            incorrect_histogram_size, beam_width,
+                            max_active_hypotheses, word_end_beam,
+                            language_model, threads_number, &recognition_res);
     free_MLF(&recognition_res, FILES_NUMBER);
     CU_ASSERT_FALSE_FATAL(is_ok);
 
     is_ok = recognize_words(src_mlf_1, FILES_NUMBER, PHONEMES_VOCABULARY_SIZE,
                             confusion_penalties, words_lexicon,
                             WORDS_VOCABULARY_SIZE, pruning_coeff,
-                            incorrect_model, lambda, &recognition_res);
+                            histogram_size, incorrect_beam_width,
+                            max_active_hypotheses, word_end_beam,
+                            language_model, threads_number, &recognition_res);
     free_MLF(&recognition_res, FILES_NUMBER);
     CU_ASSERT_FALSE_FATAL(is_ok);
 
     is_ok = recognize_words(src_mlf_1, FILES_NUMBER, PHONEMES_VOCABULARY_SIZE,
                             confusion_penalties, words_lexicon,
                             WORDS_VOCABULARY_SIZE, pruning_coeff,
-                            language_model, incorrect_lambda_1, &recognition_res);
+                            histogram_size, beam_width,
+                            incorrect_max_active_hypotheses, word_end_beam,
+                            language_model, threads_number, &recognition_res);
     free_MLF(&recognition_res, FILES_NUMBER);
     CU_ASSERT_FALSE_FATAL(is_ok);
 
     is_ok = recognize_words(src_mlf_1, FILES_NUMBER, PHONEMES_VOCABULARY_SIZE,
                             confusion_penalties, words_lexicon,
                             WORDS_VOCABULARY_SIZE, pruning_coeff,
-                            language_model, incorrect_lambda_2,
+                            histogram_size, beam_width, max_active_hypotheses,
+                            incorrect_word_end_beam, language_model,
+                            threads_number, &recognition_res);
+    free_MLF(&recognition_res, FILES_NUMBER);
+    CU_ASSERT_FALSE_FATAL(is_ok);
+
+    is_ok = recognize_words(src_mlf_1, FILES_NUMBER, PHONEMES_VOCABULARY_SIZE,
+                            confusion_penalties, words_lexicon,
+                            WORDS_VOCABULARY_SIZE, pruning_coeff,
+                            histogram_size, beam_width, max_active_hypotheses,
+                            word_end_beam, incorrect_model, threads_number,
                             &recognition_res);
     free_MLF(&recognition_res, FILES_NUMBER);
     CU_ASSERT_FALSE_FATAL(is_ok);
@@ -447,6 +633,17 @@ void recognize_words_invalid_test_1()
     is_ok = recognize_words(src_mlf_1, FILES_NUMBER, PHONEMES_VOCABULARY_SIZE,
                             confusion_penalties, words_lexicon,
                             WORDS_VOCABULARY_SIZE, pruning_coeff,
-                            language_model, lambda, NULL);
+                            histogram_size, beam_width, max_active_hypotheses,
+                            word_end_beam, language_model,
+                            incorrect_threads_number, &recognition_res);
+    free_MLF(&recognition_res, FILES_NUMBER);
+    CU_ASSERT_FALSE_FATAL(is_ok);
+
+    is_ok = recognize_words(src_mlf_1, FILES_NUMBER, PHONEMES_VOCABULARY_SIZE,
+                            confusion_penalties, words_lexicon,
+                            WORDS_VOCABULARY_SIZE, pruning_coeff,
+                            histogram_size, beam_width, max_active_hypotheses,
+                            word_end_beam, language_model, threads_number,
+                            NULL);
     CU_ASSERT_FALSE_FATAL(is_ok);
 }
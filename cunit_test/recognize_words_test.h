@@ -6,6 +6,9 @@ int init_suite_recognize_words();
 int clean_suite_recognize_words();
 void recognize_words_valid_test_1();
 void recognize_words_valid_test_2();
+void recognize_words_valid_test_3();
+void recognize_words_valid_test_4();
+void recognize_words_valid_test_5();
 void recognize_words_invalid_test_1();
 
 #endif // RECOGNIZE_WORDS_TEST_H
@@ -0,0 +1,161 @@
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <CUnit/Basic.h>
+#include <CUnit/CUnit.h>
+
+#include "../bond005_lvcsr_lib.h"
+#include "save_nbest_MLF_test.h"
+
+#define VOCABULARY_SIZE 3
+#define LISTS_NUMBER 2
+#define MAX_FILE_SIZE 1024
+
+static char *name_of_MLF_file = "saved_nbest_data.mlf";
+static char *words_vocabulary[VOCABULARY_SIZE] = { "aaa", "bbb", "ccc" };
+static TNBestList *target_nbest_lists = NULL;
+static char *target_MLF_text =
+        "#!MLF!#\n"
+        "\"first_record.rec\"\n"
+        "0 500000 aaa -0.7500\n"
+        "500000 1000000 ccc -0.7500\n"
+        "///\n"
+        "0 500000 bbb -1.1250\n"
+        "500000 1000000 ccc -1.1250\n"
+        "///\n"
+        "0 500000 aaa -3.1250\n"
+        ".\n"
+        "\"second_record.rec\"\n"
+        "bbb\n"
+        ".\n";
+
+static void set_hypothesis(TWordsHypothesis *hypothesis, int words[],
+                           int words_number, float score,
+                           long unsigned word_duration)
+{
+    int i;
+
+    hypothesis->words = malloc(words_number * sizeof(TTranscriptionNode));
+    hypothesis->words_number = words_number;
+    hypothesis->score = score;
+    for (i = 0; i < words_number; i++)
+    {
+        hypothesis->words[i].start_time = i * word_duration;
+        hypothesis->words[i].end_time = (i + 1) * word_duration;
+        hypothesis->words[i].node_data = words[i];
+        hypothesis->words[i].score = score / words_number;
+        hypothesis->words[i].probability = pow(10.0,
+                                                hypothesis->words[i].score);
+    }
+}
+
+static void set_nbest_list(TNBestList *nbest_list, char *name,
+                           int hypotheses_number)
+{
+    nbest_list->name = malloc((strlen(name) + 1) * sizeof(char));
+    strcpy(nbest_list->name, name);
+    nbest_list->hypotheses_number = hypotheses_number;
+    nbest_list->hypotheses = malloc(hypotheses_number
+                                    * sizeof(TWordsHypothesis));
+}
+
+int prepare_for_testing_of_save_nbest_MLF()
+{
+    CU_pSuite pSuite = NULL;
+
+    pSuite = CU_add_suite("Test suite for save_nbest_MLF()",
+                          init_suite_save_nbest_MLF,
+                          clean_suite_save_nbest_MLF);
+    if (NULL == pSuite)
+    {
+        CU_cleanup_registry();
+        return 0;
+    }
+
+    if ((NULL == CU_add_test(pSuite, "Valid partition 1",
+                             save_nbest_MLF_valid_test_1))
+            || (NULL == CU_add_test(pSuite, "Invalid partitions",
+                                    save_nbest_MLF_invalid_test_1)))
+    {
+        CU_cleanup_registry();
+        return 0;
+    }
+
+    return 1;
+}
+
+int init_suite_save_nbest_MLF()
+{
+    int words_1[] = { 0, 2 }, words_2[] = { 1, 2 }, words_3[] = { 0 };
+    int words_4[] = { 1 };
+
+    target_nbest_lists = malloc(LISTS_NUMBER * sizeof(TNBestList));
+    set_nbest_list(&target_nbest_lists[0], "first_record.rec", 3);
+    set_hypothesis(&target_nbest_lists[0].hypotheses[0], words_1, 2, -1.5,
+                   500000);
+    set_hypothesis(&target_nbest_lists[0].hypotheses[1], words_2, 2, -2.25,
+                   500000);
+    set_hypothesis(&target_nbest_lists[0].hypotheses[2], words_3, 1, -3.125,
+                   500000);
+    set_nbest_list(&target_nbest_lists[1], "second_record.rec", 1);
+    set_hypothesis(&target_nbest_lists[1].hypotheses[0], words_4, 1, -0.75,
+                   0);
+    return 0;
+}
+
+int clean_suite_save_nbest_MLF()
+{
+    free_nbest_lists(&target_nbest_lists, LISTS_NUMBER);
+    remove(name_of_MLF_file);
+    return 0;
+}
+
+void save_nbest_MLF_valid_test_1()
+{
+    FILE *mlf_file = NULL;
+    char mlf_text[MAX_FILE_SIZE];
+    int n = 0;
+
+    CU_ASSERT_TRUE_FATAL(save_nbest_MLF(
+                             name_of_MLF_file, words_vocabulary,
+                             VOCABULARY_SIZE, target_nbest_lists,
+                             LISTS_NUMBER));
+
+    mlf_file = fopen(name_of_MLF_file, "r");
+    CU_ASSERT_PTR_NOT_NULL_FATAL(mlf_file);
+    n = fread(mlf_text, sizeof(char), MAX_FILE_SIZE - 1, mlf_file);
+    fclose(mlf_file);
+    mlf_text[n] = 0;
+
+    CU_ASSERT_STRING_EQUAL_FATAL(mlf_text, target_MLF_text);
+}
+
+void save_nbest_MLF_invalid_test_1()
+{
+    TNBestList invalid_list = target_nbest_lists[1];
+
+    CU_ASSERT_FALSE_FATAL(save_nbest_MLF(
+                              NULL, words_vocabulary, VOCABULARY_SIZE,
+                              target_nbest_lists, LISTS_NUMBER));
+    CU_ASSERT_FALSE_FATAL(save_nbest_MLF(
+                              name_of_MLF_file, NULL, VOCABULARY_SIZE,
+                              target_nbest_lists, LISTS_NUMBER));
+    CU_ASSERT_FALSE_FATAL(save_nbest_MLF(
+                              name_of_MLF_file, words_vocabulary, 0,
+                              target_nbest_lists, LISTS_NUMBER));
+    CU_ASSERT_FALSE_FATAL(save_nbest_MLF(
+                              name_of_MLF_file, words_vocabulary, 2,
+                              target_nbest_lists, LISTS_NUMBER));
+    CU_ASSERT_FALSE_FATAL(save_nbest_MLF(
+                              name_of_MLF_file, words_vocabulary,
+                              VOCABULARY_SIZE, NULL, LISTS_NUMBER));
+    CU_ASSERT_FALSE_FATAL(save_nbest_MLF(
+                              name_of_MLF_file, words_vocabulary,
+                              VOCABULARY_SIZE, target_nbest_lists, 0));
+
+    invalid_list.hypotheses_number = 0;
+    CU_ASSERT_FALSE_FATAL(save_nbest_MLF(
+                              name_of_MLF_file, words_vocabulary,
+                              VOCABULARY_SIZE, &invalid_list, 1));
+}
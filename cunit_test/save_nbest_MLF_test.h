@@ -0,0 +1,10 @@
+#ifndef SAVE_NBEST_MLF_TEST_H
+#define SAVE_NBEST_MLF_TEST_H
+
+int prepare_for_testing_of_save_nbest_MLF();
+int init_suite_save_nbest_MLF();
+int clean_suite_save_nbest_MLF();
+void save_nbest_MLF_valid_test_1();
+void save_nbest_MLF_invalid_test_1();
+
+#endif // SAVE_NBEST_MLF_TEST_H
@@ -0,0 +1,150 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <CUnit/Basic.h>
+#include <CUnit/CUnit.h>
+
+#include "../bond005_lvcsr_lib.h"
+#include "save_word_lattice_test.h"
+
+#define VOCABULARY_SIZE 3
+#define MAX_FILE_SIZE 1024
+
+static char *name_of_lattice_file = "saved_word_lattice.lat";
+static char *words_vocabulary[VOCABULARY_SIZE] = { "aaa", "bbb", "ccc" };
+static TWordLattice target_lattice;
+static char *target_lattice_text =
+        "VERSION=1.0\n"
+        "UTTERANCE=test_record.lat\n"
+        "base=10.0\n"
+        "N=5 L=5\n"
+        "I=0 t=0.00 W=!NULL\n"
+        "I=1 t=0.05 W=bbb\n"
+        "I=2 t=0.05 W=aaa\n"
+        "I=3 t=0.10 W=ccc\n"
+        "I=4 t=0.10 W=!NULL\n"
+        "J=0 S=0 E=1 a=-1.2500 l=0.0000\n"
+        "J=1 S=0 E=2 a=-1.7500 l=0.0000\n"
+        "J=2 S=1 E=3 a=-0.5000 l=-0.3010\n"
+        "J=3 S=2 E=3 a=-0.2500 l=-0.0969\n"
+        "J=4 S=3 E=4 a=0.0000 l=0.0000\n";
+
+static void set_lattice_node(int node_index, int word_index,
+                             long unsigned end_time)
+{
+    target_lattice.nodes[node_index].word_index = word_index;
+    target_lattice.nodes[node_index].end_time = end_time;
+}
+
+static void set_lattice_link(int link_index, int start_node, int end_node,
+                             float acoustic_score, float language_score)
+{
+    target_lattice.links[link_index].start_node = start_node;
+    target_lattice.links[link_index].end_node = end_node;
+    target_lattice.links[link_index].acoustic_score = acoustic_score;
+    target_lattice.links[link_index].language_score = language_score;
+}
+
+int prepare_for_testing_of_save_word_lattice()
+{
+    CU_pSuite pSuite = NULL;
+
+    pSuite = CU_add_suite("Test suite for save_word_lattice()",
+                          init_suite_save_word_lattice,
+                          clean_suite_save_word_lattice);
+    if (NULL == pSuite)
+    {
+        CU_cleanup_registry();
+        return 0;
+    }
+
+    if ((NULL == CU_add_test(pSuite, "Valid partition 1",
+                             save_word_lattice_valid_test_1))
+            || (NULL == CU_add_test(pSuite, "Invalid partitions",
+                                    save_word_lattice_invalid_test_1)))
+    {
+        CU_cleanup_registry();
+        return 0;
+    }
+
+    return 1;
+}
+
+int init_suite_save_word_lattice()
+{
+    char *name = "test_record.lat";
+
+    target_lattice.name = malloc((strlen(name) + 1) * sizeof(char));
+    strcpy(target_lattice.name, name);
+    target_lattice.nodes_number = 5;
+    target_lattice.nodes = malloc(5 * sizeof(TLatticeNode));
+    set_lattice_node(0, -1, 0);
+    set_lattice_node(1, 1, 500000);
+    set_lattice_node(2, 0, 500000);
+    set_lattice_node(3, 2, 1000000);
+    set_lattice_node(4, -1, 1000000);
+    target_lattice.links_number = 5;
+    target_lattice.links = malloc(5 * sizeof(TLatticeLink));
+    set_lattice_link(0, 0, 1, -1.25, 0.0);
+    set_lattice_link(1, 0, 2, -1.75, 0.0);
+    set_lattice_link(2, 1, 3, -0.5, -0.30103);
+    set_lattice_link(3, 2, 3, -0.25, -0.09691);
+    set_lattice_link(4, 3, 4, 0.0, 0.0);
+    return 0;
+}
+
+int clean_suite_save_word_lattice()
+{
+    free(target_lattice.name);
+    free(target_lattice.nodes);
+    free(target_lattice.links);
+    remove(name_of_lattice_file);
+    return 0;
+}
+
+void save_word_lattice_valid_test_1()
+{
+    FILE *lattice_file = NULL;
+    char lattice_text[MAX_FILE_SIZE];
+    int n = 0;
+
+    CU_ASSERT_TRUE_FATAL(save_word_lattice(
+                             name_of_lattice_file, target_lattice,
+                             words_vocabulary, VOCABULARY_SIZE));
+
+    lattice_file = fopen(name_of_lattice_file, "r");
+    CU_ASSERT_PTR_NOT_NULL_FATAL(lattice_file);
+    n = fread(lattice_text, sizeof(char), MAX_FILE_SIZE - 1, lattice_file);
+    fclose(lattice_file);
+    lattice_text[n] = 0;
+
+    CU_ASSERT_STRING_EQUAL_FATAL(lattice_text, target_lattice_text);
+}
+
+void save_word_lattice_invalid_test_1()
+{
+    TWordLattice invalid_lattice = target_lattice;
+
+    CU_ASSERT_FALSE_FATAL(save_word_lattice(
+                              NULL, target_lattice,
+                              words_vocabulary, VOCABULARY_SIZE));
+    CU_ASSERT_FALSE_FATAL(save_word_lattice(
+                              name_of_lattice_file, target_lattice,
+                              NULL, VOCABULARY_SIZE));
+    CU_ASSERT_FALSE_FATAL(save_word_lattice(
+                              name_of_lattice_file, target_lattice,
+                              words_vocabulary, 0));
+    CU_ASSERT_FALSE_FATAL(save_word_lattice(
+                              name_of_lattice_file, target_lattice,
+                              words_vocabulary, 2));
+
+    invalid_lattice.nodes = NULL;
+    CU_ASSERT_FALSE_FATAL(save_word_lattice(
+                              name_of_lattice_file, invalid_lattice,
+                              words_vocabulary, VOCABULARY_SIZE));
+    invalid_lattice.nodes = target_lattice.nodes;
+    invalid_lattice.links_number = 0;
+    CU_ASSERT_FALSE_FATAL(save_word_lattice(
+                              name_of_lattice_file, invalid_lattice,
+                              words_vocabulary, VOCABULARY_SIZE));
+}
@@ -0,0 +1,10 @@
+#ifndef SAVE_WORD_LATTICE_TEST_H
+#define SAVE_WORD_LATTICE_TEST_H
+
+int prepare_for_testing_of_save_word_lattice();
+int init_suite_save_word_lattice();
+int clean_suite_save_word_lattice();
+void save_word_lattice_valid_test_1();
+void save_word_lattice_invalid_test_1();
+
+#endif // SAVE_WORD_LATTICE_TEST_H
@@ -1,4 +1,5 @@
 #include <float.h>
+#include <math.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
@@ -43,11 +44,31 @@ static int create_MLF_transcription(PTranscriptionNode *created_transcription)
         transcription[j].end_time = 0;
         transcription[j].node_data = rand() % VOCABULARY_SIZE;
         transcription[j].probability = 1.0;
+        transcription[j].score = 0.0;
     }
 
     return res;
 }
 
+static void set_times_of_target_MLF()
+{
+    int i, j;
+    PTranscriptionNode transcription;
+
+    for (i = 0; i < target_MLF_size; i++)
+    {
+        transcription = target_MLF[i].transcription;
+        for (j = 0; j < target_MLF[i].transcription_size; j++)
+        {
+            transcription[j].start_time = j * 100000;
+            transcription[j].end_time = (j + 1) * 100000;
+            /* scores of some words are less than the log10 of FLT_MIN */
+            transcription[j].score = -(rand() % 5) * 20.0;
+            transcription[j].probability = pow(10.0, transcription[j].score);
+        }
+    }
+}
+
 static void create_target_MLF()
 {
     int i, n;
@@ -143,8 +164,8 @@ static int compare_two_MLF(TMLFFilePart *mlf1, int mlf1_size,
                     res = 0;
                     break;
                 }
-                if (fabs(mlf1[i].transcription[j].probability
-                         - mlf2[i].transcription[j].probability) > FLT_EPSILON)
+                if (fabs(mlf1[i].transcription[j].score
+                         - mlf2[i].transcription[j].score) > FLT_EPSILON)
                 {
                     res = 0;
                     break;
@@ -175,6 +196,8 @@ int prepare_for_testing_of_save_words_MLF()
 
     if ((NULL == CU_add_test(pSuite, "Valid partition 1",
                              save_words_MLF_valid_test_1))
+            || (NULL == CU_add_test(pSuite, "Valid partition 2",
+                                    save_words_MLF_valid_test_2))
             || (NULL == CU_add_test(pSuite, "Invalid partitions",
                                     save_words_MLF_invalid_test_1)))
     {
@@ -229,6 +252,28 @@ void save_words_MLF_valid_test_1()
     CU_ASSERT_TRUE_FATAL(MLF_are_same);
 }
 
+void save_words_MLF_valid_test_2()
+{
+    TMLFFilePart *data = NULL;
+    int data_size = 0, MLF_are_same = 0;
+
+    set_times_of_target_MLF();
+    CU_ASSERT_TRUE_FATAL(save_words_MLF(
+                             name_of_MLF_file,words_vocabulary,VOCABULARY_SIZE,
+                             target_MLF,target_MLF_size));
+
+    data_size = load_words_MLF(name_of_MLF_file, words_vocabulary,
+                               VOCABULARY_SIZE, &data);
+    if (data_size == target_MLF_size)
+    {
+        MLF_are_same = compare_two_MLF(data, data_size,
+                                       target_MLF, target_MLF_size);
+    }
+    free_MLF(&data, data_size);
+    CU_ASSERT_EQUAL_FATAL(target_MLF_size, data_size);
+    CU_ASSERT_TRUE_FATAL(MLF_are_same);
+}
+
 void save_words_MLF_invalid_test_1()
 {
     CU_ASSERT_FALSE_FATAL(save_words_MLF(
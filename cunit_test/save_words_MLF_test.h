@@ -5,6 +5,7 @@ int prepare_for_testing_of_save_words_MLF();
 int init_suite_save_words_MLF();
 int clean_suite_save_words_MLF();
 void save_words_MLF_valid_test_1();
+void save_words_MLF_valid_test_2();
 void save_words_MLF_invalid_test_1();
 
 #endif // SAVE_WORDS_MLF_TEST_H
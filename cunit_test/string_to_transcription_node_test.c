@@ -68,11 +68,13 @@ int init_suite_string_to_transcription_node()
     target_node1.end_time = 20;
     target_node1.node_data = 1;
     target_node1.probability = 0.5;
+    target_node1.score = -FLT_MAX;
 
     target_node2.start_time = 10;
     target_node2.end_time = 20;
     target_node2.node_data = 1;
     target_node2.probability = 1.0;
+    target_node2.score = -FLT_MAX;
 
     memset(incorrect_transcription_str1, 0, STR_SIZE);
     strcpy(incorrect_transcription_str1, "-10 20 b 0.5");
@@ -110,6 +112,7 @@ void string_to_transcription_node_valid_test_1()
 {
     TTranscriptionNode node;
 
+    node.score = 0.0;
     CU_ASSERT_TRUE_FATAL(string_to_transcription_node(
                              correct_transcription_str1, vocabulary,
                              VOCABULARY_SIZE, &node));
@@ -118,12 +121,14 @@ void string_to_transcription_node_valid_test_1()
     CU_ASSERT_EQUAL_FATAL(target_node1.node_data, node.node_data);
     CU_ASSERT_DOUBLE_EQUAL_FATAL(target_node1.probability, node.probability,
                                  FLT_EPSILON);
+    CU_ASSERT_EQUAL_FATAL(target_node1.score, node.score);
 }
 
 void string_to_transcription_node_valid_test_2()
 {
     TTranscriptionNode node;
 
+    node.score = 0.0;
     CU_ASSERT_TRUE_FATAL(string_to_transcription_node(
                              correct_transcription_str2, vocabulary,
                              VOCABULARY_SIZE, &node));
@@ -132,6 +137,7 @@ void string_to_transcription_node_valid_test_2()
     CU_ASSERT_EQUAL_FATAL(target_node2.node_data, node.node_data);
     CU_ASSERT_DOUBLE_EQUAL_FATAL(target_node2.probability, node.probability,
                                  FLT_EPSILON);
+    CU_ASSERT_EQUAL_FATAL(target_node2.score, node.score);
 }
 
 void string_to_transcription_node_invalid_test_1()